@@ -20,6 +20,7 @@ enum                    EErrorCode
   EERROR_NULL_PTR,
   EERROR_WINDOWS_ERR,
   EERROR_OUT_OF_RANGE,
+  EERROR_FILE_ERR,
 
   // NETWORK
   EERROR_NET_SOCKET_ERR,
@@ -36,6 +37,14 @@ enum                    EErrorCode
   EERROR_NET_SERVER_STATE,
   EERROR_NET_CLIENT_ERR,
   EERROR_NET_CLIENT_STATE,
+  EERROR_NET_SCHEDULER_STATE,
+  EERROR_NET_GATEWAY_ERR,
+  EERROR_NET_GATEWAY_STATE,
+  EERROR_NET_BUS_STATE,
+  EERROR_NET_PACER_STATE,
+  EERROR_NET_BUDGET,
+  EERROR_NET_CAPTURE_STATE,
+  EERROR_NET_IMPAIRMENT_STATE,
 
   // SQL
   EERROR_SQL_STATE,
@@ -71,6 +80,8 @@ namespace               ELib
 
   std::string           WindowsErrString(DWORD p_code);
 
+  extern const std::string EErrorDefinitions[]; /**< Names of EErrorCode. */
+
   /**
     @brief ELib object for exception handling.
     @details Retrieve last EError at initialization.
@@ -107,6 +118,7 @@ namespace               ELib
 #define mEERROR_S(p_errorCode)                          \
 {                                                       \
   mEERROR = p_errorCode;                                \
+  mEMETRICS_G.error(mEERROR);                           \
   mEERROR_G.m_functionName = __FUNCTION__;              \
   mEERROR_G.m_fileName = __FILE__;                      \
   mEERROR_G.m_lineNumber = __LINE__;                    \
@@ -8,5 +8,7 @@
 #pragma once
 
 #include "EGlobals/EError.h"
+#include "EGlobals/EMetrics.h"
 #include "EGlobals/EPrint.h"
 #include "EGlobals/EScaledTypes.h"
+#include "EGlobals/ETrace.h"
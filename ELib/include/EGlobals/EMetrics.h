@@ -0,0 +1,147 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for EMetrics handling tools.
+*/
+
+#pragma once
+
+#include <Windows.h>
+#include <string>
+#include "EGlobals/EError.h"
+#include "EGlobals/EScaledTypes.h"
+
+#define EMETRICS_SHARDS   (16)  /**< Shards of EMetrics. Threads are spread over them, so they rarely share a cache line. */
+#define EMETRICS_TYPES    (64)  /**< ENetPacketType counted one by one. Higher types share the last counter. */
+#define EMETRICS_BUCKETS  (64)  /**< Buckets of histograms. Bucket N counts values in [2^(N-1), 2^N[, bucket 0 counts 0. */
+#define EMETRICS_LATENCY_BUCKETS  (32)  /**< Buckets of latencies per ENetPacketType. Last bucket counts values over 2^30 ns. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                   ELib
+{
+
+  /**
+    @brief Counters of EMetrics. Only increase.
+  */
+  enum                      EMetricsCounter
+  {
+    EMETRICS_COUNTER_ACCEPTED       = 0,  /**< Connections accepted by ENetServer. */
+    EMETRICS_COUNTER_CLOSED,              /**< Connections closed by ENetSelector. */
+    EMETRICS_COUNTER_BYTES_IN,            /**< Bytes received by ENetSocket. */
+    EMETRICS_COUNTER_BYTES_OUT,           /**< Bytes sent by ENetSocket. */
+    EMETRICS_COUNTER_DATAGRAMS_IN,        /**< Datagrams received by ENetSocket. */
+    EMETRICS_COUNTER_DATAGRAMS_OUT,       /**< Datagrams sent by ENetSocket. */
+    EMETRICS_COUNTER_SQL_QUERIES,         /**< Queries executed by ESQL. */
+    EMETRICS_COUNTER_COUNT
+  };
+
+  /**
+    @brief Gauges of EMetrics. Moved up and down.
+  */
+  enum                      EMetricsGauge
+  {
+    EMETRICS_GAUGE_CONNECTIONS      = 0,  /**< Clients of all ENetSelectors. */
+    EMETRICS_GAUGE_SELECTORS,             /**< Running ENetSelectors. */
+    EMETRICS_GAUGE_QUEUED,                /**< ENetPacket waiting in all ENetPacketHandlers. */
+    EMETRICS_GAUGE_COUNT
+  };
+
+  /**
+    @brief Histograms of EMetrics, in nanoseconds.
+  */
+  enum                      EMetricsHistogram
+  {
+    EMETRICS_HISTOGRAM_RECV         = 0,  /**< Duration of ENetPacketHandler::recvPacket(). */
+    EMETRICS_HISTOGRAM_SQL,               /**< Duration of ESQL::query(). */
+    EMETRICS_HISTOGRAM_COUNT
+  };
+
+  /**
+    @brief Latencies of EMetrics per ENetPacketType, in nanoseconds.
+  */
+  enum                      EMetricsLatency
+  {
+    EMETRICS_LATENCY_QUEUE          = 0,  /**< ENetPacket received, until ENetPacketHandler::popPacket(). */
+    EMETRICS_LATENCY_HANDLER,             /**< ENetPacket popped, until its deletion by application. */
+    EMETRICS_LATENCY_COUNT
+  };
+
+  /**
+    @brief Values written by the threads of one shard. Aligned on cache line.
+  */
+  struct alignas(64)        EMetricsShard
+  {
+    volatile LONG64         m_counters[EMETRICS_COUNTER_COUNT];                       /**< Values of EMetricsCounter. */
+    volatile LONG64         m_gauges[EMETRICS_GAUGE_COUNT];                           /**< Moves of EMetricsGauge. */
+    volatile LONG64         m_packetsIn[EMETRICS_TYPES];                              /**< ENetPacket stored per ENetPacketType. */
+    volatile LONG64         m_packetsOut[EMETRICS_TYPES];                             /**< ENetPacket sent per ENetPacketType. */
+    volatile LONG64         m_errors[EERROR_COUNT];                                   /**< EError set per EErrorCode. */
+    volatile LONG64         m_buckets[EMETRICS_HISTOGRAM_COUNT][EMETRICS_BUCKETS];    /**< Buckets of EMetricsHistogram. */
+    volatile LONG64         m_sums[EMETRICS_HISTOGRAM_COUNT];                         /**< Sum of values of EMetricsHistogram. */
+    volatile LONG64         m_latencies[EMETRICS_LATENCY_COUNT][EMETRICS_TYPES][EMETRICS_LATENCY_BUCKETS];  /**< Buckets of EMetricsLatency per ENetPacketType. */
+  };
+
+  /**
+    @brief Merged values of every shard of EMetrics.
+  */
+  struct                    EMetricsSnapshot
+  {
+    uint64                  m_counters[EMETRICS_COUNTER_COUNT];                       /**< Values of EMetricsCounter. */
+    int64                   m_gauges[EMETRICS_GAUGE_COUNT];                           /**< Values of EMetricsGauge. */
+    uint64                  m_packetsIn[EMETRICS_TYPES];                              /**< ENetPacket stored per ENetPacketType. */
+    uint64                  m_packetsOut[EMETRICS_TYPES];                             /**< ENetPacket sent per ENetPacketType. */
+    uint64                  m_errors[EERROR_COUNT];                                   /**< EError set per EErrorCode. */
+    uint64                  m_buckets[EMETRICS_HISTOGRAM_COUNT][EMETRICS_BUCKETS];    /**< Buckets of EMetricsHistogram. */
+    uint64                  m_sums[EMETRICS_HISTOGRAM_COUNT];                         /**< Sum of values of EMetricsHistogram. */
+    uint64                  m_latencies[EMETRICS_LATENCY_COUNT][EMETRICS_TYPES][EMETRICS_LATENCY_BUCKETS];  /**< Buckets of EMetricsLatency per ENetPacketType. */
+    uint64                  getCount(EMetricsHistogram p_histogram) const;
+    uint64                  getPercentile(EMetricsHistogram p_histogram, double p_ratio) const;
+    uint64                  getCount(EMetricsLatency p_latency, uint32 p_type) const;
+    uint64                  getPercentile(EMetricsLatency p_latency, uint32 p_type, double p_ratio) const;
+    const std::string       toString() const;
+  };
+
+  /**
+    @brief ELib object for metrics.
+    @details Counters, gauges and histograms are written without lock: each thread adds into its own shard
+      with an interlocked operation, on a cache line rarely shared with another thread.
+    @details snapshot() merges shards while threads keep writing. Values of a snapshot are each exact,
+      but not taken at the same instant.
+    @details EErrorCode set by mEERROR_S() are counted, including each level of mEERROR_SH() histories.
+    @details Latencies of each ENetPacketType are measured from the receive timestamp of ENetPacket,
+      without application code.
+  */
+  class                     EMetrics
+  {
+  public:
+    EMetrics();
+    ~EMetrics();
+    void                    add(EMetricsCounter p_counter, uint64 p_value = 1);
+    void                    move(EMetricsGauge p_gauge, int64 p_delta);
+    void                    packetIn(uint32 p_type);
+    void                    packetOut(uint32 p_type);
+    void                    error(EErrorCode p_code);
+    void                    record(EMetricsHistogram p_histogram, uint64 p_value);
+    void                    time(EMetricsHistogram p_histogram, LONGLONG p_start);
+    void                    latency(EMetricsLatency p_latency, uint32 p_type, LONGLONG p_start, LONGLONG p_end);
+    void                    snapshot(EMetricsSnapshot &p_snapshot) const;
+
+  private:
+    EMetricsShard           &getShard();
+    uint64                  toNanoseconds(LONGLONG p_ticks);
+
+    EMetricsShard           m_shards[EMETRICS_SHARDS];  /**< Shards, written by threads. */
+  };
+
+  /**
+    @brief Global variable for metrics.
+    @details Access maccro is defined as mEMETRICS_G.
+    @details Zero-initialized before any constructor, so it can count EError of other globals.
+  */
+  extern EMetrics           __gEMetrics;
+
+}
+
+#define mEMETRICS_G         (ELib::__gEMetrics)
@@ -0,0 +1,98 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ETrace handling tools.
+*/
+
+#pragma once
+
+#include <Windows.h>
+#include <string>
+#include <vector>
+#include "EGlobals/EError.h"
+#include "EGlobals/EScaledTypes.h"
+
+#define ETRACE_CAPACITY   (8192)  /**< Spans kept by each thread. Oldest spans are overwritten. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                   ELib
+{
+
+  /**
+    @brief Stages traced by ETrace, from socket readiness to handler completion.
+  */
+  enum                      ETraceEvent
+  {
+    ETRACE_EVENT_SELECT             = 0,  /**< Wait of ENetSelector into select(). */
+    ETRACE_EVENT_FLUSH,                   /**< ENetSendQueue flush of a ready ENetSocket. Id is the ENetSocket. */
+    ETRACE_EVENT_RECV,                    /**< ENetPacketHandler::recvPacket() of a ready ENetSocket. Id is the ENetSocket. */
+    ETRACE_EVENT_QUEUE,                   /**< ENetPacket stored, until ENetPacketHandler::popPacket(). Id is the ENetPacketType. */
+    ETRACE_EVENT_HANDLER,                 /**< ENetPacket popped, until its deletion by application. Id is the ENetPacketType. */
+    ETRACE_EVENT_COUNT
+  };
+
+  /**
+    @brief One traced span.
+  */
+  struct                    ETraceSpan
+  {
+    ETraceEvent             m_event;  /**< Traced stage. */
+    uint64                  m_id;     /**< Identifier of traced object, depends on ETraceEvent. */
+    LONGLONG                m_start;  /**< Performance counter at start. */
+    LONGLONG                m_end;    /**< Performance counter at end. */
+  };
+
+  /**
+    @brief Ring of spans written by one thread.
+  */
+  struct                    ETraceBuffer
+  {
+    DWORD                   m_threadId;                 /**< Writing thread. */
+    HANDLE                  m_thread;                   /**< Writing thread, signalled when it exits. */
+    volatile LONG64         m_next;                     /**< Spans written since creation. */
+    ETraceSpan              m_spans[ETRACE_CAPACITY];   /**< Ring of spans. */
+  };
+
+  /**
+    @brief ELib object for trace spans.
+    @details Spans are written without lock into a ring owned by the calling thread, so tracing adds
+      two performance counter reads per sampled span.
+    @details Sampling: begin() returns 0 for spans not sampled, and end() ignores them. 1 of every N
+      spans of each thread is sampled, none if N is 0 (default).
+    @details dump() writes every ring as Chrome trace JSON, readable by chrome://tracing and Perfetto.
+      Rings are read while threads keep writing, so dump is best-effort: spans overwritten while read are skipped.
+      Disable sampling first for a complete dump.
+    @details Ring of an exited thread is reused by the next new traced thread, its spans are then lost.
+      Rings are as many as traced threads alive at once, not as threads created.
+  */
+  class                     ETrace
+  {
+  public:
+    ETrace();
+    ~ETrace();
+    void                    setSampling(uint32 p_rate);
+    LONGLONG                begin();
+    LONGLONG                end(ETraceEvent p_event, LONGLONG p_start, uint64 p_id = 0);
+    void                    dump(const std::string &p_path) const;
+
+  private:
+    ETraceBuffer            *getBuffer();
+
+    std::vector<ETraceBuffer*> m_buffers; /**< Ring of each traced thread. */
+    volatile LONG           m_sampling;   /**< 1 of m_sampling spans is traced, 0 for none. */
+    LONGLONG                m_origin;     /**< Performance counter at construction, origin of timestamps. */
+    LONGLONG                m_frequency;  /**< Performance counter frequency. */
+    HANDLE                  m_mutex;      /**< m_buffers semaphore. */
+  };
+
+  /**
+    @brief Global variable for trace spans.
+    @details Access maccro is defined as mETRACE_G.
+  */
+  extern ETrace             __gETrace;
+
+}
+
+#define mETRACE_G           (ELib::__gETrace)
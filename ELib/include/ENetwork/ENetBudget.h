@@ -0,0 +1,68 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetBudget Class.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include "EGlobals/EGlobal.h"
+
+#define ENETBUDGET_SHARDS (16)  /**< Shards of ENetBudget. Connections are spread over them by address, so they rarely share a mutex. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  class                         ENetSocket;
+
+  /**
+    @brief Reserved bytes of connections of a shard.
+  */
+  struct alignas(64)            ENetBudgetShard
+  {
+    std::unordered_map<const ENetSocket*,
+      uint64>                   m_usages; /**< Reserved bytes of each connection. */
+    HANDLE                      m_mutex;  /**< m_usages semaphore. */
+  };
+
+  /**
+    @brief ELib object for memory accounting of connections (Singleton).
+    @details Bytes are reserved for a connection before being allocated: payloads of received ENetPacket,
+      held until the ENetPacket is deleted, and frames waiting in its ENetSendQueue, held until they are sent.
+    @details A reservation fails if it would exceed the connection budget or the global budget. 0 means no budget.
+    @details Nothing is accounted while no budget is set. Connections are spread over ENETBUDGET_SHARDS shards,
+      each with its own mutex. Budgets, global usage and shed count are read and written atomically.
+    @details Shedding: ENetSelector stops reading a connection while a budget is exhausted (TCP flow control
+      slows the sender down), a received ENetPacket that does not fit closes its connection,
+      a posted ENetPacket that does not fit is dropped with EERROR_NET_BUDGET.
+  */
+  class                         ENetBudget
+  {
+  public:
+    ~ENetBudget();                                                                   /**< .... */
+    static ENetBudget           *getInstance();                                      /**< ..E. */
+    void                        setLimits(uint64 p_connection, uint64 p_global);     /**< .... */
+    bool                        reserve(const ENetSocket *p_socket, uint64 p_bytes); /**< .M.. */
+    void                        release(const ENetSocket *p_socket, uint64 p_bytes); /**< .M.. */
+    void                        forget(const ENetSocket *p_socket);                  /**< .M.. */
+    bool                        isAvailable(const ENetSocket *p_socket) const;       /**< .M.. */
+    uint64                      getUsage(const ENetSocket *p_socket) const;          /**< .M.. */
+    uint64                      getGlobalUsage() const;                              /**< .... */
+    uint64                      getShed() const;                                     /**< .... */
+
+  private:
+    ENetBudget();
+    ENetBudgetShard             &getShard(const ENetSocket *p_socket) const;         /**< .... */
+
+    mutable ENetBudgetShard     m_shards[ENETBUDGET_SHARDS]; /**< Shards of connections. */
+    volatile LONG64             m_connection;                /**< Budget of each connection, in bytes. */
+    volatile LONG64             m_global;                    /**< Budget of all connections, in bytes. */
+    volatile LONG64             m_usage;                     /**< Reserved bytes of all connections. */
+    volatile LONG64             m_shed;                      /**< Number of refused reservations. */
+  };
+
+}
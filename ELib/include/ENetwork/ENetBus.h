@@ -0,0 +1,118 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetBus Class.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetClient.h"
+#include "ENetwork/ENetServer.h"
+
+#define ENETBUS_FLUSH           (5)           /**< Milliseconds between two batches. */
+#define ENETBUS_BATCH_MAX       (32768)       /**< Batch size over which it is sent immediately. */
+#define ENETBUS_WINDOW          (64)          /**< Sequences remembered per node for deduplication. */
+#define ENETBUS_TOPIC_BROADCAST (0xFFFFFFFF)  /**< Topic delivered to every client with ENetServer::broadcast(). */
+#define ENETBUS_RETRY           (100)         /**< Milliseconds before reconnecting a lost peer, doubled on each failure. */
+#define ENETBUS_RETRY_MAX       (10000)       /**< Maximum milliseconds between two reconnections of a lost peer. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Function receiving messages of ENetBus, after local delivery.
+    @param p_origin Node publishing message.
+    @param p_topic Topic of message.
+    @param p_datas Datas of message.
+    @param p_len Datas length.
+    @param p_context Context given to ENetBus::setReceiver().
+  */
+  typedef void (*ENetBusReceiver)(uint32 p_origin, ENetTopicId p_topic, const char *p_datas, int32 p_len, void *p_context);
+
+  /**
+    @brief ELib object for server-to-server message bus.
+    @details Full mesh of nodes: each node keeps one persistent ENetClient to every peer and accepts peers on its own ENetServer.
+    @details publish() delivers locally, then batches the message: one ENetPacketBus per peer every ENETBUS_FLUSH milliseconds.
+      Nodes never forward messages of other nodes, a cluster-wide broadcast costs one hop per node.
+    @details Messages are delivered to ENetTopics members as ENetPacketRawDatas, ENETBUS_TOPIC_BROADCAST to every client of ENetServer.
+    @details Batches are deduplicated per origin node on a window of ENETBUS_WINDOW sequences (reconnections, duplicated links).
+    @details A lost peer is reconnected by run(), after ENETBUS_RETRY milliseconds doubled on each failure up to ENETBUS_RETRY_MAX.
+      Batches flushed while it is lost are not sent to it.
+    @details run() waits for ENetPacketBus of peers on the event of its ENetPacketHandler until next batch.
+  */
+  class                         ENetBus
+  {
+  public:
+    ENetBus(uint32 p_node);                                                                         /**< .... */
+    ~ENetBus();                                                                                     /**< .... */
+    void                        init(const std::string &p_hostname, uint16 p_port);                 /**< ..E. */
+    void                        addPeer(uint32 p_node, const std::string &p_hostname,               /**< .ME. */
+                                  uint16 p_port);
+    void                        removePeer(uint32 p_node);                                          /**< .ME. */
+    void                        start();                                                            /**< ..E. */
+    void                        stop();                                                             /**< B.E. */
+    void                        run();                                                              /**< BM.. */
+    void                        publish(ENetTopicId p_topic, const char *p_datas, int32 p_len);     /**< .ME. */
+    void                        setServer(ENetServer *p_server);                                    /**< .... */
+    void                        setReceiver(ENetBusReceiver p_receiver, void *p_context = nullptr); /**< .... */
+    uint32                      getNode() const;                                                    /**< .... */
+    uint32                      getPeerCount() const;                                               /**< .M.. */
+    uint64                      getDuplicates() const;                                              /**< .... */
+    bool                        isRunning() const;                                                  /**< .... */
+
+  private:
+    /**
+      @brief Deduplication window of an origin node.
+    */
+    struct                      ENetBusWindow
+    {
+      uint64                    m_last; /**< Highest sequence received. */
+      uint64                    m_mask; /**< Bit n set if sequence m_last - n was received. */
+    };
+
+    /**
+      @brief Link to a peer.
+    */
+    struct                      ENetBusPeer
+    {
+      ENetClient                *m_client;   /**< Connection to peer. */
+      std::string               m_hostname;  /**< Internet host address of peer. */
+      uint16                    m_port;      /**< Port of peer. */
+      uint64                    m_retry;     /**< GetTickCount64() of next reconnection. */
+      uint32                    m_backoff;   /**< Milliseconds between two reconnections. */
+    };
+
+    void                        flush();
+    void                        reconnect();
+    void                        receive(ENetPacketBus *p_packet);
+    void                        deliver(uint32 p_origin, ENetTopicId p_topic, const char *p_datas, int32 p_len);
+    bool                        isDuplicate(uint32 p_origin, uint64 p_sequence);
+
+    uint32                      m_node;       /**< Identifier of this node. */
+    ENetPacketHandler           m_handler;    /**< ENetPacket of peers. */
+    ENetServer                  m_listener;   /**< Server of peers. */
+    std::map<uint32,
+      ENetBusPeer>              m_peers;      /**< Link to each peer. */
+    std::string                 m_batch;      /**< Messages waiting for flush(). */
+    uint32                      m_count;      /**< Number of messages in m_batch. */
+    uint64                      m_sequence;   /**< Last sequence sent. */
+    std::unordered_map<uint32,
+      ENetBusWindow>            m_windows;    /**< Deduplication window of each origin. */
+    uint64                      m_duplicates; /**< Number of dropped duplicates. */
+    ENetServer                  *m_server;    /**< Server of local clients, nullptr for ENetServer Singleton. */
+    ENetBusReceiver             m_receiver;   /**< Function receiving messages. */
+    void                        *m_context;   /**< Context of m_receiver. */
+    HANDLE                      m_mutex;      /**< m_peers, m_batch and m_windows semaphore. */
+    HANDLE                      m_threadRun;  /**< run() thread. */
+    bool                        m_isRunning;  /**< State. */
+  };
+
+}
@@ -0,0 +1,85 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetCapture Class.
+*/
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetSocket.h"
+
+#define ENETCAPTURE_MAGIC       (0x50414345)        /**< "ECAP", first bytes of a capture file. */
+#define ENETCAPTURE_VERSION     (1)                 /**< Version of capture file format. */
+#define ENETCAPTURE_IDLE        (10)                /**< Milliseconds between two writes of ENetCapture::write(). */
+#define ENETCAPTURE_PENDING_MAX (64 * 1024 * 1024)  /**< Bytes waiting for write(), frames are dropped over it. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Header of a capture file.
+  */
+  struct                        ENetCaptureHeader
+  {
+    uint32                      m_magic;    /**< ENETCAPTURE_MAGIC. */
+    uint32                      m_version;  /**< ENETCAPTURE_VERSION. */
+  };
+
+  /**
+    @brief Header of a captured frame, followed by the frame.
+  */
+  struct                        ENetCaptureRecord
+  {
+    uint64                      m_time;       /**< Nanoseconds between ENetCapture::start() and reception. */
+    uint64                      m_connection; /**< ENetSocket source, 0 if none. */
+    uint32                      m_protocol;   /**< ENETSOCKET_FLAGS_PROTOCOLS of source. */
+    uint32                      m_len;        /**< Frame length. */
+  };
+
+  /**
+    @brief ELib object for capture of inbound traffic (Singleton).
+    @details While running, ENetPacketHandler records each decoded frame (ENetPacketType then datas) with its
+      reception time and source. A frame is recorded as it was received, so ENetPacketHandler::read()
+      or a connected ENetSocket can play it back.
+    @details Frames are appended to a buffer under mutex, written to the file by write() thread.
+      Frames are dropped while ENETCAPTURE_PENDING_MAX bytes are waiting.
+    @details File is a ENetCaptureHeader, then an ENetCaptureRecord and its frame per frame, in reception order.
+  */
+  class                         ENetCapture
+  {
+  public:
+    ~ENetCapture();                                                                 /**< .... */
+    static ENetCapture          *getInstance();                                     /**< ..E. */
+    void                        start(const std::string &p_path);                   /**< ..E. */
+    void                        stop();                                             /**< B.E. */
+    void                        write();                                            /**< BME. */
+    void                        record(const ENetSocket *p_src, LONGLONG p_received, /**< .M.. */
+                                  const char *p_frame, int32 p_len);
+    uint64                      getRecorded() const;                                /**< .... */
+    uint64                      getDropped() const;                                 /**< .... */
+    bool                        isRunning() const;                                  /**< .... */
+
+  private:
+    ENetCapture();
+    void                        flush();
+    void                        close();
+
+    std::string                 m_path;         /**< Path of capture file. */
+    std::ofstream               m_file;         /**< Capture file. */
+    std::string                 m_pending;      /**< Records waiting for write(). */
+    LONGLONG                    m_start;        /**< Performance counter at start(). */
+    LARGE_INTEGER               m_frequency;    /**< Performance counter frequency. */
+    uint64                      m_recorded;     /**< Frames recorded since start(). */
+    uint64                      m_dropped;      /**< Frames dropped since start(). */
+    HANDLE                      m_mutex;        /**< m_pending semaphore. */
+    HANDLE                      m_threadWrite;  /**< write() thread. */
+    bool                        m_isRunning;    /**< State. */
+  };
+
+}
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetCookie.h"
+#include "ENetwork/ENetFec.h"
 #include "ENetwork/ENetPacketHandler.h"
 
 /**
@@ -16,14 +18,20 @@ namespace               ELib
 {
 
   /**
-    @brief Elib object for network client side automation (Singleton).
+    @brief Elib object for network client side automation (Singleton, or one per connection).
+    @details Each instance owns its ENetSockets and stores ENetPacket in its own ENetPacketHandler.
+      getInstance() is the default context, using ENetPacketHandler Singleton.
     @details Call ENetClient::recvfrom() for incoming connectionless datas in its own thread.
     @details Call ENetClient::recv() for incoming connected datas in its own thread.
     @details Use ENetPacketHandler for ENetPacket storage.
+    @details joinDatagrams() registers to datagrams of ENetServer::sendDatagram(), through multicast group if possible.
+    @details Datagrams protected by ENetFec are unwrapped, and lost ones recovered, before ENetPacketHandler.
+    @details ENetCookie challenges of ENetServer are echoed, then registration of joinDatagrams() is sent again.
   */
   class                 ENetClient
   {
   public:
+    ENetClient(ENetPacketHandler *p_handler = nullptr);                       /**< .... */
     ~ENetClient();                                                            /**< .... */
     static ENetClient   *getInstance();                                       /**< ..E. */
     void                init(const std::string &p_hostname, uint16 p_port);   /**< ..E. */
@@ -32,15 +40,28 @@ namespace               ELib
     void                recvfrom();                                           /**< BME. */
     void                recv();                                               /**< BME. */
     void                send(ENetPacket *p_packet);                           /**< ..E. */
+    void                joinDatagrams(const std::string &p_group = "",        /**< ..E. */
+                          uint16 p_port = 0);
+    ENetPacketHandler   *getHandler() const;                                  /**< .... */
+    ENetSocket          *getSocket();                                         /**< .... */
+    void                setFec(uint8 p_count);                                /**< .... */
+    ENetFec             *getFec();                                            /**< .... */
+    void                flushFec(uint32 p_delay = 0);                         /**< .ME. */
     bool                isRunning();                                          /**< .... */
 
   private:
-    ENetClient();
+    void                sendServer(const char *p_datas, uint16 p_len);
+    void                sendJoin();
 
     ENetSocket          m_socketRecvfrom;   /**< recvfrom() ENetSocket. */
     HANDLE              m_threadRecvfrom;   /**< recvfrom() thread. */
     ENetSocket          m_socketRecv;       /**< recv() ENetSocket. */
     HANDLE              m_threadRecv;       /**< recv() thread. */
+    ENetPacketHandler   *m_handler;         /**< ENetPacket storage, nullptr for ENetPacketHandler Singleton. */
+    ENetFec             m_fec;              /**< Forward error correction of connectionless datas. */
+    bool                m_isJoined;         /**< joinDatagrams() has been called. */
+    bool                m_isMulticast;      /**< Multicast group has been joined. */
+    bool                m_isStartup;        /**< WSAStartup() succeeded. */
     bool                m_isRunning;        /**< State. */
   };
 
@@ -0,0 +1,64 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetCookie Class.
+*/
+
+#pragma once
+
+#include <unordered_set>
+#include "EGlobals/EGlobal.h"
+
+#define ENETCOOKIE_SIZE   (16)    /**< ENetPacketType, kind and cookie of a cookie datagram. */
+#define ENETCOOKIE_PERIOD (30000) /**< Milliseconds of validity of a cookie secret epoch. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Kinds of ENETPACKET_TYPE_COOKIE datagrams.
+  */
+  enum                          ENetCookieKind
+  {
+    ENETCOOKIE_KIND_HELLO       = 0,  /**< Client asks for a cookie. Padded to the size of the challenge: no amplification. */
+    ENETCOOKIE_KIND_CHALLENGE   = 1,  /**< Server gives the cookie of the address. */
+    ENETCOOKIE_KIND_ECHO        = 2   /**< Client proves it receives datas sent to its address. */
+  };
+
+  /**
+    @brief ELib object for stateless verification of connectionless sources.
+    @details Cookie of a source is a keyed hash (SipHash-2-4) of its address, its port and the current epoch.
+      Nothing is stored for a source until it echoes its cookie: spoofed sources cannot, they never receive it.
+    @details A cookie is valid during its epoch of ENETCOOKIE_PERIOD milliseconds and the following one.
+    @details Verified sources are kept by address, datagrams of other sources are rejected before any allocation.
+    @details Secret key is drawn at construction. Not thread-safe, used by the receiving thread only.
+  */
+  class                         ENetCookie
+  {
+  public:
+    ENetCookie();                                                                  /**< .... */
+    ~ENetCookie();                                                                 /**< .... */
+    uint64                      generate(uint32 p_address, uint16 p_port) const;   /**< .... */
+    bool                        check(uint32 p_address, uint16 p_port,             /**< .... */
+                                  uint64 p_cookie) const;
+    void                        verify(uint32 p_address, uint16 p_port);           /**< .... */
+    void                        forget(uint32 p_address, uint16 p_port);           /**< .... */
+    bool                        isVerified(uint32 p_address, uint16 p_port) const; /**< .... */
+    void                        setKey(uint64 p_key0, uint64 p_key1);              /**< .... */
+    uint32                      getVerifiedCount() const;                          /**< .... */
+    uint64                      getRejected() const;                               /**< .... */
+    void                        addRejected();                                     /**< .... */
+
+  private:
+    uint64                      hash(uint64 p_word0, uint64 p_word1) const;
+
+    uint64                      m_key0;     /**< First half of secret key. */
+    uint64                      m_key1;     /**< Second half of secret key. */
+    std::unordered_set<uint64>  m_verified; /**< Verified sources, address and port. */
+    uint64                      m_rejected; /**< Number of datagrams rejected from unverified sources. */
+  };
+
+}
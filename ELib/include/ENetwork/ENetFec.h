@@ -0,0 +1,127 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetFec Class.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetPacket.h"
+
+#define ENETFEC_HEADER    (12)                /**< ENetPacketType, block, index, count and length of a FEC datagram. */
+#define ENETFEC_BLOCK     (8)                 /**< Default datagrams protected by one parity datagram. */
+#define ENETFEC_BLOCK_MAX (64)                /**< Maximum datagrams of one block. */
+#define ENETFEC_WINDOW    (16)                /**< Blocks kept per source for recovery. */
+#define ENETFEC_PEERS_MAX (1024)              /**< Sources, and destinations, with a FEC state. */
+#define ENETFEC_BYTES_MAX (16 * 1024 * 1024)  /**< Bytes of received datagrams kept for recovery. */
+#define ENETFEC_IDLE      (30000)             /**< Milliseconds without datagram after which a FEC state is forgotten. */
+#define ENETFEC_SWEEP     (1000)              /**< Milliseconds between two expiries of idle FEC states. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  class                         ENetPacketHandler;
+
+  /**
+    @brief ELib object for forward error correction of connectionless datas.
+    @details Datagrams to a destination are grouped in blocks. Each datagram is wrapped in ENETPACKET_TYPE_FEC
+      with its block, its index and the block size. After the last datagram of a block, a parity datagram
+      (XOR of datagrams padded to the longest, and XOR of their lengths) is sent. Its header records the number
+      of datagrams it protects.
+    @details Receiver recovers one lost datagram per block as soon as the others and the parity are received, without retransmission.
+    @details Redundancy is one parity datagram for setBlockSize() datagrams. Smaller blocks survive more loss for more bandwidth.
+      Parity of a block is sent once the block is full, or earlier by flush(): the block is closed with the datagrams
+      already sent, so the last datagrams of a burst do not wait for the next ones to be protected.
+    @details Datagrams too large to be wrapped are sent without protection.
+    @details setLoss() drops received FEC datagrams on purpose, to measure recovery on a local link.
+    @details States of sources and destinations idle for ENETFEC_IDLE are forgotten. Over ENETFEC_PEERS_MAX states,
+      datagrams of new peers are sent and received without protection. Over ENETFEC_BYTES_MAX buffered bytes,
+      received datagrams are given without being kept for recovery. Spoofed sources cannot grow memory without limit.
+  */
+  class                         ENetFec
+  {
+  public:
+    ENetFec();                                                                 /**< .... */
+    ~ENetFec();                                                                /**< .... */
+    void                        encode(const char *p_datas, int32 p_len,       /**< .ME. */
+                                  const ENetSocket *p_dst, std::vector<std::string> &p_datagrams);
+    void                        decode(const char *p_datas, int32 p_len,       /**< .ME. */
+                                  const ENetSocket *p_src, std::vector<std::string> &p_datagrams);
+    void                        read(const char *p_datas, int32 p_len,         /**< .ME. */
+                                  const ENetSocket *p_src, ENetPacketHandler *p_handler);
+    void                        flush(ENetSocket *p_src, uint32 p_delay = 0);  /**< .ME. */
+    void                        setBlockSize(uint8 p_count);                   /**< .M.. */
+    void                        setLoss(double p_rate, uint64 p_seed = 1);     /**< .M.. */
+    uint8                       getBlockSize() const;                          /**< .... */
+    uint64                      getRecovered() const;                          /**< .... */
+    uint64                      getDropped() const;                            /**< .... */
+    uint64                      getBytes() const;                              /**< .... */
+
+  private:
+    /**
+      @brief Block being sent to a destination.
+    */
+    struct                      ENetFecEncoder
+    {
+      uint32                    m_block;  /**< Identifier of block. */
+      uint8                     m_index;  /**< Index of next datagram. */
+      uint8                     m_count;  /**< Datagrams of block. */
+      uint16                    m_length; /**< XOR of datagrams lengths. */
+      std::string               m_parity; /**< XOR of datagrams. */
+      uint64                    m_last;   /**< GetTickCount64() of last datagram. */
+      std::string               m_host;   /**< Hostname of destination. */
+      uint16                    m_port;   /**< Port of destination. */
+    };
+
+    /**
+      @brief Block being received from a source.
+    */
+    struct                      ENetFecBlock
+    {
+      std::vector<std::string>  m_datagrams; /**< Received datagrams by index. */
+      uint64                    m_mask;      /**< Bit n set if datagram n is known. */
+      uint8                     m_received;  /**< Number of known datagrams. */
+      uint8                     m_count;     /**< Datagrams of block. */
+      uint16                    m_length;    /**< XOR of datagrams lengths, from parity. */
+      std::string               m_parity;    /**< Parity datagram, empty until received. */
+      bool                      m_isParity;  /**< Parity has been received. */
+    };
+
+    /**
+      @brief Blocks being received from a source.
+    */
+    struct                      ENetFecSource
+    {
+      std::map<uint32,
+        ENetFecBlock>           m_blocks; /**< Recent blocks by identifier. */
+      uint64                    m_last;   /**< GetTickCount64() of last datagram. */
+    };
+
+    void                        recover(ENetFecBlock &p_block, std::vector<std::string> &p_datagrams);
+    void                        expire(uint64 p_now);
+    uint64                      getSize(const ENetFecBlock &p_block) const;
+    std::string                 wrap(uint32 p_block, uint8 p_index, uint8 p_count, uint16 p_length,
+                                  const char *p_datas, int32 p_len) const;
+
+    uint8                       m_count;     /**< Datagrams of next blocks. */
+    std::map<std::string,
+      ENetFecEncoder>           m_encoders;  /**< Current block of each destination. */
+    std::map<std::string,
+      ENetFecSource>            m_decoders;  /**< Recent blocks of each source. */
+    uint64                      m_bytes;     /**< Bytes of datagrams and parities kept by m_decoders. */
+    uint64                      m_sweep;     /**< GetTickCount64() of last expiry. */
+    double                      m_loss;      /**< Rate of received datagrams dropped on purpose. */
+    uint64                      m_seed;      /**< State of loss generator. */
+    uint64                      m_recovered; /**< Number of recovered datagrams. */
+    uint64                      m_dropped;   /**< Number of datagrams dropped on purpose. */
+    HANDLE                      m_mutex;     /**< m_encoders and m_decoders semaphore. */
+  };
+
+}
@@ -0,0 +1,101 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetGateway Class.
+*/
+
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetClient.h"
+#include "ENetwork/ENetHashRing.h"
+#include "ENetwork/ENetServer.h"
+
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Function giving the routing key (session, room...) of a client ENetPacketRawDatas.
+    @param p_packet ENetPacketRawDatas received from client.
+    @param p_stream Stream of client.
+    @param p_key Routing key. Holds the current key of stream (stream by default).
+    @param p_context Context given to ENetGateway::setRoute().
+    @return true if routing key has been changed.
+  */
+  typedef bool (*ENetGatewayRoute)(const ENetPacketRawDatas *p_packet, uint64 p_stream, uint64 &p_key, void *p_context);
+
+  /**
+    @brief ELib object for gateway (proxy) side automation.
+    @details Terminate client connections on its own ENetServer, forward their ENetPacketRawDatas to backends.
+    @details Backends are reached through one persistent ENetClient each: every client stream is multiplexed
+      over it in ENetPacketGateway, tagged with its stream identifier and routing key.
+    @details Backend of a stream is chosen by consistent hashing (ENetHashRing) of its routing key.
+      Adding or removing a backend only moves the streams owned by its points.
+    @details A moved stream is closed on its previous backend (ENETPACKETGATEWAY_FLAG_CLOSED), next datas open it on the new one.
+    @details Backends answer with ENetPacketGateway of same stream, delivered to client as ENetPacketRawDatas.
+    @details Front and backends have their own ENetPacketHandler: ENetGateway can live along other contexts in one process.
+      Its threads wait for the event of their ENetPacketHandler when its queues are empty.
+  */
+  class                         ENetGateway
+  {
+  public:
+    ENetGateway();                                                                             /**< .... */
+    ~ENetGateway();                                                                            /**< .... */
+    void                        init(const std::string &p_hostname, uint16 p_port);            /**< ..E. */
+    void                        addBackend(uint32 p_backend, const std::string &p_hostname,    /**< .ME. */
+                                  uint16 p_port, uint32 p_weight = 1);
+    void                        removeBackend(uint32 p_backend);                               /**< .ME. */
+    void                        start();                                                       /**< ..E. */
+    void                        stop();                                                        /**< B.E. */
+    void                        runFront();                                                    /**< BM.. */
+    void                        runBack();                                                     /**< BM.. */
+    void                        setRoute(ENetGatewayRoute p_route, void *p_context = nullptr); /**< .... */
+    uint32                      getStreamCount() const;                                        /**< .M.. */
+    uint32                      getBackendCount() const;                                       /**< .M.. */
+    bool                        isRunning() const;                                             /**< .... */
+
+  private:
+    /**
+      @brief Client connection seen by ENetGateway.
+    */
+    struct                      ENetGatewayStream
+    {
+      ENetSocket                *m_client;  /**< Connected ENetSocket of client. */
+      uint64                    m_key;      /**< Routing key. */
+      uint32                    m_backend;  /**< Backend of stream, if routed. */
+      bool                      m_isRouted; /**< Stream is open on m_backend. */
+    };
+
+    void                        forward(ENetPacket *p_packet);
+    void                        deliver(ENetPacketGateway *p_packet);
+    void                        route(uint64 p_id, ENetGatewayStream &p_stream, const char *p_datas, int32 p_len);
+    void                        close(uint64 p_id, ENetGatewayStream &p_stream);
+    void                        rebalance();
+    void                        dropBackend(uint32 p_backend);
+
+    ENetPacketHandler           m_frontHandler; /**< ENetPacket of clients. */
+    ENetServer                  m_front;        /**< Server of clients. */
+    ENetPacketHandler           m_backHandler;  /**< ENetPacket of backends. */
+    std::map<uint32,
+      ENetClient*>              m_backends;     /**< Connection to each backend. */
+    ENetHashRing                m_ring;         /**< Backends ring. */
+    std::unordered_map<uint64,
+      ENetGatewayStream>        m_streams;      /**< Client streams by identifier. */
+    std::unordered_map<const ENetSocket*,
+      uint64>                   m_ids;          /**< Stream identifier of each client. */
+    uint64                      m_nextStream;   /**< Last stream identifier. */
+    ENetGatewayRoute            m_route;        /**< Routing key function, nullptr to route by stream. */
+    void                        *m_context;     /**< Context of m_route. */
+    HANDLE                      m_mutex;        /**< m_backends, m_ring and streams semaphore. */
+    HANDLE                      m_threadFront;  /**< runFront() thread. */
+    HANDLE                      m_threadBack;   /**< runBack() thread. */
+    bool                        m_isRunning;    /**< State. */
+  };
+
+}
@@ -0,0 +1,44 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetHashRing Class.
+*/
+
+#pragma once
+
+#include <map>
+#include "EGlobals/EGlobal.h"
+
+#define ENETHASHRING_REPLICAS (128) /**< Default points of a node of weight 1 on the ring. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief ELib object for consistent hashing of keys (session, room...) over nodes (backends, shards...).
+    @details Each node owns weight * replicas points on a 64 bits ring. A key belongs to the first point following its hash.
+    @details Adding or removing a node only moves the keys of its own points: about 1/n of keys.
+    @details Not thread-safe, owner must lock it.
+  */
+  class                         ENetHashRing
+  {
+  public:
+    ENetHashRing(uint32 p_replicas = ENETHASHRING_REPLICAS);                 /**< .... */
+    ~ENetHashRing();                                                         /**< .... */
+    void                        addNode(uint32 p_node, uint32 p_weight = 1); /**< ..E. */
+    void                        removeNode(uint32 p_node);                   /**< ..E. */
+    bool                        getNode(uint64 p_key, uint32 &p_node) const; /**< .... */
+    bool                        hasNode(uint32 p_node) const;                /**< .... */
+    uint32                      getSize() const;                             /**< .... */
+    static uint64               hash(uint64 p_value);                        /**< .... */
+
+  private:
+    uint32                      m_replicas; /**< Points of a node of weight 1. */
+    std::map<uint64, uint32>    m_ring;     /**< Node of each point. */
+    std::map<uint32, uint32>    m_nodes;    /**< Weight of each node. */
+  };
+
+}
@@ -0,0 +1,106 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetImpairment Class.
+*/
+
+#pragma once
+
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetSocket.h"
+
+#define ENETIMPAIRMENT_IDLE      (1)     /**< Milliseconds slept by ENetImpairment::run() without due frame. */
+#define ENETIMPAIRMENT_QUEUE_MAX (65536) /**< Frames waiting. Newer datagrams are dropped over it, connected senders are held. */
+#define ENETIMPAIRMENT_SWEEP     (1000)  /**< Milliseconds between two removals of free links by ENetImpairment::run(). */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Settings of ENetImpairment.
+  */
+  struct                        ENetImpairmentSettings
+  {
+    uint32                      m_latency;    /**< Delay added to each frame, in microseconds. */
+    uint32                      m_jitter;     /**< Random delay in [-m_jitter, m_jitter] added to latency, in microseconds. */
+    double                      m_loss;       /**< Probability of dropping a datagram. */
+    double                      m_duplicate;  /**< Probability of sending a datagram twice. */
+    double                      m_reorder;    /**< Probability of sending a datagram without latency, before older ones. */
+    uint64                      m_rate;       /**< Bytes per second of each link, 0 for no limit. */
+  };
+
+  /**
+    @brief ELib object for network impairment of outbound datas.
+    @details Datas sent by an ENetSocket holding a running ENetImpairment are queued with a due time,
+      then sent by run() thread once due, so a single host can emulate a bad network without netem.
+    @details A link is a connected ENetSocket, or a destination of a connectionless ENetSocket.
+      Each link is a serial line of m_rate bytes per second: a frame leaves once the previous one is transmitted.
+    @details Connected datas are only delayed (latency, jitter, rate) and keep their order: loss, duplication
+      and reordering would corrupt the stream. Datagrams get every impairment.
+    @details Random draws come from a seeded generator, so a run can be reproduced.
+    @details Sending errors of run() are ignored. Frames of a closed ENetSocket are skipped by run(), links free for
+      ENETIMPAIRMENT_SWEEP milliseconds are removed.
+  */
+  class                         ENetImpairment
+  {
+  public:
+    ENetImpairment();                                                                       /**< .... */
+    ~ENetImpairment();                                                                      /**< .... */
+    void                        start();                                                    /**< ..E. */
+    void                        stop();                                                     /**< B.E. */
+    void                        run();                                                      /**< BM.. */
+    int32                       push(const ENetSocket *p_socket, const char *p_datas,       /**< BM.. */
+                                  uint16 p_len, uint32 p_address = 0, uint16 p_port = 0);
+    void                        forget(const ENetSocket *p_socket);                         /**< .M.. */
+    void                        setSettings(const ENetImpairmentSettings &p_settings);      /**< .M.. */
+    const ENetImpairmentSettings getSettings() const;                                       /**< .M.. */
+    void                        setSeed(uint32 p_seed);                                     /**< .M.. */
+    uint32                      getSize() const;                                            /**< .M.. */
+    uint64                      getDrops() const;                                           /**< .... */
+    uint64                      getDuplicates() const;                                      /**< .... */
+    bool                        isRunning() const;                                          /**< .... */
+
+  private:
+    /**
+      @brief Frame waiting to be sent.
+    */
+    struct                      ENetImpairmentFrame
+    {
+      LONGLONG                  m_due;      /**< Performance counter when frame is sent. */
+      uint64                    m_order;    /**< Push order, so frames due at once keep it. */
+      uint64                    m_socket;   /**< SOCKET of ENetSocket sending frame. */
+      uint32                    m_address;  /**< IPv4 address of destination of datagram, network byte order. */
+      uint16                    m_port;     /**< Port of destination of datagram, 0 for connected datas. */
+      std::string               m_datas;    /**< Frame. */
+      bool                      operator>(const ENetImpairmentFrame &p_frame) const;
+    };
+
+    LONGLONG                    schedule(const std::string &p_link, LONGLONG p_now, uint16 p_len, bool p_isOrdered);
+
+    ENetImpairmentSettings      m_settings;   /**< Impairments applied. */
+    std::priority_queue<ENetImpairmentFrame,
+      std::vector<ENetImpairmentFrame>,
+      std::greater<ENetImpairmentFrame>> m_frames; /**< Waiting frames, earliest due first. */
+    std::map<std::string,
+      LONGLONG>                 m_links;      /**< Performance counter when each link is free. */
+    std::map<uint64, uint64>    m_forgotten;  /**< Push order when each closed SOCKET was forgotten, older frames are skipped. */
+    LONGLONG                    m_sweep;      /**< Performance counter of next removal of free links. */
+    std::mt19937                m_random;     /**< Generator of random draws. */
+    uint64                      m_order;      /**< Frames pushed. */
+    uint64                      m_drops;      /**< Datagrams lost, or frames dropped on full queue. */
+    uint64                      m_duplicates; /**< Datagrams duplicated. */
+    LARGE_INTEGER               m_frequency;  /**< Performance counter frequency. */
+    HANDLE                      m_mutex;      /**< m_frames, m_links, m_forgotten and m_random semaphore. */
+    HANDLE                      m_threadRun;  /**< run() thread. */
+    bool                        m_isRunning;  /**< State. */
+  };
+
+}
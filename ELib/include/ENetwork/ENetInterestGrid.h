@@ -0,0 +1,81 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetInterestGrid Class.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetPacket.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Identifier of an entity (player, object...). Defined by user.
+  */
+  typedef uint32                ENetEntityId;
+
+  /**
+    @brief ELib object for spatial interest management.
+    @details Uniform grid of entity positions, each entity being linked to the ENetSocket of its owner.
+    @details Moves are incremental: an entity is only re-bucketed when it changes of cell.
+    @details ENetInterestGrid::publish() only walks cells overlapping the area of interest, or occupied cells when they are fewer.
+      ENetPacket is posted into ENetSendQueue of each receiver once grid semaphore is released.
+    @details Every instance is registered: ENetSelector removes entities of a closed client from every grid (removeAll()).
+  */
+  class                         ENetInterestGrid
+  {
+  public:
+    ENetInterestGrid(float p_cellSize = 64.0f);                                                               /**< .... */
+    ~ENetInterestGrid();                                                                                      /**< .... */
+    void                        setEntity(ENetEntityId p_entity, ENetSocket *p_client, float p_x, float p_y); /**< .ME. */
+    void                        removeEntity(ENetEntityId p_entity);                                          /**< .M.. */
+    void                        removeClient(const ENetSocket *p_client);                                     /**< .M.. */
+    static void                 removeAll(const ENetSocket *p_client);                                        /**< .M.. */
+    void                        publish(float p_x, float p_y, float p_radius, ENetPacket *p_packet,           /**< .ME. */
+                                  const ENetSocket *p_exclude = nullptr);
+    void                        publish(ENetEntityId p_entity, float p_radius, ENetPacket *p_packet);         /**< .ME. */
+    uint32                      getSize() const;                                                              /**< .M.. */
+
+  private:
+    /**
+      @brief Entity of the grid.
+    */
+    struct                      ENetEntity
+    {
+      ENetEntityId              m_id;        /**< User identifier. */
+      ENetSocket                *m_client;   /**< Owner ENetSocket. */
+      float                     m_x;         /**< Position on X axis. */
+      float                     m_y;         /**< Position on Y axis. */
+      uint64                    m_cell;      /**< Key of the containing cell. */
+      uint32                    m_cellIndex; /**< Index in the containing cell. */
+    };
+
+    int32                       getIndex(float p_value) const;
+    uint64                      getCell(float p_x, float p_y) const;
+    void                        insertCell(uint32 p_index);
+    void                        removeCell(uint32 p_index);
+    void                        removeIndex(uint32 p_index);
+    void                        collect(float p_x, float p_y, float p_radius, const ENetSocket *p_exclude,
+                                  std::vector<ENetSocket*> &p_targets) const;
+    void                        collect(const std::vector<uint32> &p_cell, float p_x, float p_y, float p_radius,
+                                  const ENetSocket *p_exclude, std::vector<ENetSocket*> &p_targets) const;
+    void                        send(ENetPacket *p_packet, const std::vector<ENetSocket*> &p_targets);
+
+    float                       m_cellSize; /**< Side length of a cell. */
+    std::vector<ENetEntity>     m_entities; /**< Contiguous ENetEntity list. */
+    std::unordered_map<ENetEntityId,
+      uint32>                   m_indexes; /**< Index of each entity in m_entities. */
+    std::unordered_map<uint64,
+      std::vector<uint32> >     m_cells;     /**< Indexes of entities in each cell. */
+    HANDLE                      m_mutexGrid; /**< Grid semaphore. */
+  };
+
+}
@@ -0,0 +1,97 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetPacer Class.
+*/
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetSocket.h"
+
+#define ENETPACER_BURST     (16384) /**< Default bytes a bucket can hold. */
+#define ENETPACER_QUEUE_MAX (1024)  /**< Datagrams waiting per peer, oldest are dropped over it. */
+#define ENETPACER_IDLE      (1)     /**< Milliseconds slept by ENetPacer::run() without datagram. */
+#define ENETPACER_WAIT_MAX  (100)   /**< Milliseconds slept at most by ENetPacer::run() waiting for tokens. */
+#define ENETPACER_PEER_IDLE (10000) /**< Milliseconds without datagram after which a destination is forgotten. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief ELib object for paced connectionless sending.
+    @details Datagrams pushed on a connectionless ENetSocket are queued per destination, then sent by run() thread.
+    @details Sending is shaped by token buckets: one for the whole ENetSocket (setRate()) and one per destination (setPeerRate()).
+      A bucket is refilled with its rate in bytes per second, up to its burst. A rate of 0 is not limited.
+    @details Destinations are served round robin, so a tick of fan-out is spread over time instead of one burst
+      overflowing switch and receiver buffers.
+    @details A bucket can go below zero for one datagram: datagrams larger than the burst are still sent.
+    @details While buckets are empty, run() sleeps until the first one has tokens again.
+    @details Destinations without datagram for ENETPACER_PEER_IDLE are forgotten.
+  */
+  class                         ENetPacer
+  {
+  public:
+    ENetPacer(ENetSocket *p_socket = nullptr);                                                /**< .... */
+    ~ENetPacer();                                                                             /**< .... */
+    void                        start();                                                      /**< ..E. */
+    void                        stop();                                                       /**< B.E. */
+    void                        run();                                                        /**< BM.. */
+    void                        push(const char *p_datas, int32 p_len,                        /**< .ME. */
+                                  const ENetSocket *p_dst);
+    void                        setSocket(ENetSocket *p_socket);                              /**< .... */
+    void                        setRate(uint64 p_rate, uint32 p_burst = ENETPACER_BURST);     /**< .M.. */
+    void                        setPeerRate(uint64 p_rate, uint32 p_burst = ENETPACER_BURST); /**< .M.. */
+    uint32                      getSize() const;                                              /**< .M.. */
+    uint64                      getDrops() const;                                             /**< .... */
+    bool                        isRunning() const;                                            /**< .... */
+
+  private:
+    /**
+      @brief Token bucket.
+    */
+    struct                      ENetPacerBucket
+    {
+      double                    m_tokens; /**< Bytes that can be sent. */
+      uint64                    m_rate;   /**< Bytes credited per second, 0 for no limit. */
+      uint32                    m_burst;  /**< Maximum of m_tokens. */
+      LONGLONG                  m_time;   /**< Performance counter of last refill. */
+    };
+
+    /**
+      @brief Destination of ENetPacer.
+    */
+    struct                      ENetPacerPeer
+    {
+      ENetSocket                *m_dst;      /**< Address of destination. */
+      std::deque<std::string>   m_datagrams; /**< Datagrams in sending order. */
+      ENetPacerBucket           m_bucket;    /**< Bucket of destination. */
+      LONGLONG                  m_time;      /**< Performance counter of last datagram pushed. */
+    };
+
+    void                        refill(ENetPacerBucket &p_bucket, LONGLONG p_time) const;
+    double                      getWait(const ENetPacerBucket &p_bucket) const;
+    void                        expire(LONGLONG p_time);
+
+    ENetSocket                  *m_socket;    /**< Connectionless ENetSocket sending datagrams. */
+    ENetPacerBucket             m_bucket;     /**< Bucket of m_socket. */
+    ENetPacerBucket             m_peerBucket; /**< Settings of destination buckets. */
+    std::map<std::string,
+      ENetPacerPeer>            m_peers;      /**< Destinations by address. */
+    std::string                 m_last;       /**< Address of last destination served. */
+    uint32                      m_size;       /**< Datagrams waiting. */
+    uint64                      m_drops;      /**< Datagrams dropped on full queues. */
+    LONGLONG                    m_sweep;      /**< Performance counter of last expiry of destinations. */
+    LARGE_INTEGER               m_frequency;  /**< Performance counter frequency. */
+    HANDLE                      m_mutex;      /**< m_peers and buckets semaphore. */
+    HANDLE                      m_threadRun;  /**< run() thread. */
+    bool                        m_isRunning;  /**< State. */
+  };
+
+}
@@ -6,25 +6,43 @@
 
 #pragma once
 
+#include <string>
 #include "EGlobals/EGlobal.h"
 #include "ENetwork/ENetSocket.h"
 
+#define ENETPACKETGATEWAY_FLAG_CLOSED (0x00000001) /**< Stream of ENetPacketGateway has been closed by its client. */
+#define ENETPACKETRAWDATAS_MAX        (65527)      /**< Datas length max of ENetPacketRawDatas, so the whole ENetPacket fits one ENetSocket::send(). */
+#define ENETPACKETRPC_MAX             (65511)      /**< Datas length max of ENetPacketRpc, so the whole ENetPacket fits one ENetSocket::send(). */
+#define ENETPACKETGATEWAY_MAX         (65507)      /**< Datas length max of ENetPacketGateway, so the whole ENetPacket fits one ENetSocket::send(). */
+#define ENETPACKETSTATS_MAX           (65527)      /**< Datas length max of ENetPacketStats, so the whole ENetPacket fits one ENetSocket::send(). */
+#define ENETPACKETBUS_MAX             (65513)      /**< Datas length max of ENetPacketBus, so the whole ENetPacket fits one ENetSocket::send(). */
+
 /**
   @brief General scope for ELib components.
 */
 namespace             ELib
 {
 
+  class               ENetBudget;
+
   /**
     @brief Reserved ENetPacketType.
     @brief Custom type can be define with value over ENETPACKET_TYPE_RESERVED.
   */
   enum                ENetPacketType
   {
-    ENETPACKET_TYPE_DISCONNECT  = 0x0000,
-    ENETPACKET_TYPE_CONNECT     = 0x0001,
-    ENETPACKET_TYPE_RAW_DATAS   = 0x0002,
-    ENETPACKET_TYPE_RESERVED    = 0x000F  /**< Reserved types range. */
+    ENETPACKET_TYPE_DISCONNECT   = 0x0000,
+    ENETPACKET_TYPE_CONNECT      = 0x0001,
+    ENETPACKET_TYPE_RAW_DATAS    = 0x0002,
+    ENETPACKET_TYPE_RPC_REQUEST  = 0x0003,
+    ENETPACKET_TYPE_RPC_RESPONSE = 0x0004,
+    ENETPACKET_TYPE_GATEWAY      = 0x0005,
+    ENETPACKET_TYPE_BUS          = 0x0006,
+    ENETPACKET_TYPE_DGRAM_JOIN   = 0x0007,  /**< Datagram registration, handled by ENetServer::recvfrom(). */
+    ENETPACKET_TYPE_FEC          = 0x0008,  /**< Datagram protected by ENetFec, unwrapped before ENetPacketHandler. */
+    ENETPACKET_TYPE_COOKIE       = 0x0009,  /**< ENetCookie handshake, handled by ENetServer::recvfrom() and ENetClient::recvfrom(). */
+    ENETPACKET_TYPE_STATS        = 0x000A,  /**< Admin statistics request and response, answered by ENetServer::admin(). */
+    ENETPACKET_TYPE_RESERVED     = 0x000F  /**< Reserved types range. */
   };
 
   /**
@@ -32,9 +50,17 @@ namespace             ELib
     @details Derived class for each type need to be provide to ENetPacketHandler automation.
     @details Default send() is provided. If not used, derived send() must send type.
     @details read() need to copy datas in its own space. Originals datas are deleted at automation.
+    @details post() queue the ENetPacket into ENetSendQueue of destination instead of sending it immediately.
+    @details Types carrying states can override getConflationKey(), so only the newest unsent ENetPacket per key is kept.
+    @details recv() reserves received payload in ENetBudget before allocating it, given back at deletion.
+    @details A sampled ENetPacket keeps the start of its current ETrace stage. Its deletion ends ETRACE_EVENT_HANDLER.
+    @details Received ENetPacket carries the performance counter of its reception, set by ENetPacketHandler.
+      Its EMETRICS_LATENCY_HANDLER is recorded at deletion, once popped.
   */
   class               ENetPacket
   {
+    friend class      ENetPacketHandler;
+
   public:
     ENetPacket(ENetPacketType p_type, ENetSocket *p_src);                         /**< /!\ .... */
     virtual ~ENetPacket();                                                        /**< /!\ .... */
@@ -42,13 +68,26 @@ namespace             ELib
     virtual void      read(const char *p_datas, int32 p_len) = 0;
     virtual void      send(ENetSocket *p_dst = nullptr) = 0;
     virtual void      send(const char *p_datas, int32 p_len, ENetSocket *p_dst);  /**< /!\ ..E. */
+    virtual bool      getConflationKey(uint64 &p_key) const;                      /**< .... */
+    void              post(ENetSocket *p_dst = nullptr);                          /**< ..E. */
     ENetPacketType    getType() const;                                            /**< /!\ .... */
     const ENetSocket  *getSource() const;                                         /**< /!\ .... */
     void              setSource(ENetSocket *p_src);                               /**< /!\ .... */
+    LONGLONG          getTrace() const;                                           /**< .... */
+    LONGLONG          getReceived() const;                                        /**< .... */
+    void              setTrace(LONGLONG p_trace);                                 /**< .... */
 
   protected:
-    ENetPacketType    m_type; /**< Type. */
-    ENetSocket        *m_src; /**< ENetPacket source. */
+    bool              reserve(int32 p_bytes);                                     /**< ..E. */
+
+    ENetPacketType    m_type;     /**< Type. */
+    ENetSocket        *m_src;     /**< ENetPacket source. */
+    bool              m_isPosted; /**< Indicate that send() must queue into ENetSendQueue. */
+    ENetBudget        *m_budget;  /**< ENetBudget holding received payload, nullptr if none. */
+    uint64            m_reserved; /**< Bytes reserved in m_budget. */
+    LONGLONG          m_trace;    /**< Start of current ETrace stage, 0 if not sampled. */
+    LONGLONG          m_received; /**< Performance counter at reception, 0 if not received. */
+    LONGLONG          m_popped;   /**< Performance counter at ENetPacketHandler::popPacket(), 0 if not popped. */
   };
 
   /**
@@ -98,4 +137,107 @@ namespace             ELib
     char              *m_datas; /**< Datas. */
   };
 
+  /**
+    @brief ENetPacket for ENetRpc requests and responses.
+    @details Method and correlation identifier, followed by a status and a buffer of datas preceded by its length.
+  */
+  class               ENetPacketRpc : public ENetPacket
+  {
+  public:
+    ENetPacketRpc(ENetPacketType p_type, ENetSocket *p_src = nullptr);            /**< .... */
+    ~ENetPacketRpc();                                                             /**< .... */
+    void              recv();                                                     /**< B.E. */
+    void              read(const char *p_datas = nullptr, int32 p_len = 0);       /**< ..E. */
+    void              send(ENetSocket *p_dst = nullptr);                          /**< ..E. */
+    uint32            getMethod() const;                                          /**< .... */
+    uint64            getId() const;                                              /**< .... */
+    uint32            getStatus() const;                                          /**< .... */
+    const std::string &getDatas() const;                                          /**< .... */
+    void              setMethod(uint32 p_method);                                 /**< .... */
+    void              setId(uint64 p_id);                                         /**< .... */
+    void              setStatus(uint32 p_status);                                 /**< .... */
+    void              setDatas(const char *p_datas, int32 p_len);                 /**< .... */
+
+  private:
+    uint32            m_method; /**< Method called. */
+    uint64            m_id;     /**< Correlation identifier. */
+    uint32            m_status; /**< ENetRpcStatus of response. */
+    std::string       m_datas;  /**< Arguments or result. */
+  };
+
+  /**
+    @brief ENetPacket multiplexing client streams between ENetGateway and its backends.
+    @details Stream and routing key, followed by flags and a buffer of datas preceded by its length.
+  */
+  class               ENetPacketGateway : public ENetPacket
+  {
+  public:
+    ENetPacketGateway(ENetSocket *p_src = nullptr);                               /**< .... */
+    ~ENetPacketGateway();                                                         /**< .... */
+    void              recv();                                                     /**< B.E. */
+    void              read(const char *p_datas = nullptr, int32 p_len = 0);       /**< ..E. */
+    void              send(ENetSocket *p_dst = nullptr);                          /**< ..E. */
+    uint64            getStream() const;                                          /**< .... */
+    uint64            getKey() const;                                             /**< .... */
+    uint32            getFlags() const;                                           /**< .... */
+    const std::string &getDatas() const;                                          /**< .... */
+    void              setStream(uint64 p_stream);                                 /**< .... */
+    void              setKey(uint64 p_key);                                       /**< .... */
+    void              setFlags(uint32 p_flags);                                   /**< .... */
+    void              setDatas(const char *p_datas, int32 p_len);                 /**< .... */
+
+  private:
+    uint64            m_stream; /**< Client stream identifier, local to ENetGateway. */
+    uint64            m_key;    /**< Routing key (session, room...). */
+    uint32            m_flags;  /**< ENETPACKETGATEWAY_FLAG_* of stream. */
+    std::string       m_datas;  /**< Datas of client. */
+  };
+
+  /**
+    @brief ENetPacket carrying a batch of ENetBus messages between nodes.
+    @details Origin node and sequence, followed by the number of messages and the batch preceded by its length.
+    @details Each message of batch is a topic, followed by its datas preceded by their length.
+  */
+  class               ENetPacketBus : public ENetPacket
+  {
+  public:
+    ENetPacketBus(ENetSocket *p_src = nullptr);                                   /**< .... */
+    ~ENetPacketBus();                                                             /**< .... */
+    void              recv();                                                     /**< B.E. */
+    void              read(const char *p_datas = nullptr, int32 p_len = 0);       /**< ..E. */
+    void              send(ENetSocket *p_dst = nullptr);                          /**< ..E. */
+    uint32            getOrigin() const;                                          /**< .... */
+    uint64            getSequence() const;                                        /**< .... */
+    uint32            getCount() const;                                           /**< .... */
+    const std::string &getDatas() const;                                          /**< .... */
+    void              setOrigin(uint32 p_origin);                                 /**< .... */
+    void              setSequence(uint64 p_sequence);                             /**< .... */
+    void              setDatas(const std::string &p_datas, uint32 p_count);       /**< .... */
+
+  private:
+    uint32            m_origin;   /**< Node publishing the batch. */
+    uint64            m_sequence; /**< Sequence of batch on its origin node. */
+    uint32            m_count;    /**< Number of messages. */
+    std::string       m_datas;    /**< Batch of messages. */
+  };
+
+  /**
+    @brief ENetPacket for admin statistics of ENetServer.
+    @details A buffer of datas preceded by its length: admin token of request, ENetStatsHeader snapshot of response.
+  */
+  class               ENetPacketStats : public ENetPacket
+  {
+  public:
+    ENetPacketStats(ENetSocket *p_src = nullptr);                                 /**< .... */
+    ~ENetPacketStats();                                                           /**< .... */
+    void              recv();                                                     /**< B.E. */
+    void              read(const char *p_datas = nullptr, int32 p_len = 0);       /**< ..E. */
+    void              send(ENetSocket *p_dst = nullptr);                          /**< ..E. */
+    const std::string &getDatas() const;                                          /**< .... */
+    void              setDatas(const std::string &p_datas);                       /**< .... */
+
+  private:
+    std::string       m_datas;  /**< Admin token or snapshot. */
+  };
+
 }
@@ -9,7 +9,9 @@
 #include <map>
 #include <queue>
 #include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetCapture.h"
 #include "ENetwork/ENetPacket.h"
+#include "ENetwork/ENetRateLimit.h"
 
 /**
   @brief General scope for ELib components.
@@ -25,28 +27,55 @@ namespace                     ELib
   typedef ENetPacket *(*ENetPacketGenerator)(ENetSocket *p_src);                                      /**< /!\ ..E. */
 
   /**
-    @brief ELib object for ENetPacket automation (Singleton).
+    @brief ELib object for ENetPacket automation (Singleton, or one per ENetShard).
     @details Automatically generate and store every ENetPacket of an application.
     @details Basics generators are provided. More can be provide with custom ENetPacketType.
+    @details Each ENetPacketType is carried by an ENetChannel (ENETCHANNEL_DEFAULT if not set).
+    @details Received ENetPacket are stored in the queue of their ENetChannel priority, popPacket() empties urgent queues first.
+    @details ENetChannel settings must be identical on both sides and set before starting automation.
+    @details Instances other than Singleton copy generators and ENetChannels of Singleton with copySettings().
+    @details Received ENetPacket over the limit of their ENetPacketType in ENetRateLimit are dropped.
+    @details Received ENetPacketStats are kept apart for ENetServer::admin() (setAdmin()), popPacket() never returns them.
+    @details getEvent() is signalled by every stored ENetPacket, getAdminEvent() by every kept ENetPacketStats.
+      Their consumer resets it before emptying the queues, then waits on it instead of polling.
   */
   class                       ENetPacketHandler
   {
   public:
-    ~ENetPacketHandler();
+    ENetPacketHandler();                                                                            /**< .... */
+    ~ENetPacketHandler();                                                                           /**< .... */
     static ENetPacketHandler  *getInstance();                                                       /**< /!\ ..E. */
     ENetPacket                *popPacket();                                                         /**< /!\ .M.. */
     void                      recvPacket(ENetSocket *p_src);                                        /**< /!\ BME. */
     void                      read(char *p_datas, int32 p_len, ENetSocket *p_src = nullptr);        /**< /!\ .ME. */
     void                      setGenerator(ENetPacketType p_type, ENetPacketGenerator p_generator); /**< /!\ ..E. */
     void                      cleanSocket(const ENetSocket *p_socket);                              /**< /!\ .M.. */
+    void                      setChannel(ENetPacketType p_type, ENetChannelId p_channel);           /**< ..E. */
+    void                      setChannelPriority(ENetChannelId p_channel, uint8 p_priority,         /**< ..E. */
+                                uint32 p_weight);
+    ENetChannel               getChannel(ENetPacketType p_type) const;                              /**< .... */
+    void                      copySettings(const ENetPacketHandler &p_model);                       /**< .... */
+    ENetRateLimit             *getRateLimit();                                                      /**< .... */
+    ENetPacket                *popAdmin();                                                          /**< .M.. */
+    void                      setAdmin(bool p_isAdmin);                                             /**< .... */
+    HANDLE                    getEvent() const;                                                     /**< .... */
+    HANDLE                    getAdminEvent() const;                                                /**< .... */
 
   private:
-    ENetPacketHandler();
+    void                      store(ENetPacket *p_packet, LONGLONG p_received);
 
     std::map<ENetPacketType,
       ENetPacketGenerator>    m_generators;   /**< ENetPacketGenerator map. */
-    std::queue<ENetPacket*>   m_packets;      /**< Received ENetPacket queue. */
+    std::map<ENetPacketType,
+      ENetChannelId>          m_types;        /**< ENetChannel of each ENetPacketType. */
+    ENetChannel               m_channels[ENETCHANNEL_MAX];          /**< ENetChannel settings. */
+    std::queue<ENetPacket*>   m_packets[ENETCHANNEL_PRIORITIES];    /**< Received ENetPacket queue of each priority. */
+    std::queue<ENetPacket*>   m_admin;        /**< Received ENetPacketStats queue, emptied by ENetServer::admin(). */
+    bool                      m_isAdmin;      /**< ENetPacketStats are kept into m_admin. */
+    ENetRateLimit             m_rateLimit;    /**< Rate limits of connected sources. */
     HANDLE                    m_mutexPackets; /**< m_packet semaphore. */
+    HANDLE                    m_eventPackets; /**< Signalled when a ENetPacket is stored, manual reset. */
+    HANDLE                    m_eventAdmin;   /**< Signalled when a ENetPacketStats is kept, manual reset. */
   };
 
 }
@@ -0,0 +1,80 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetRateLimit Class.
+*/
+
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetPacket.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Token bucket of ENetRateLimit, in ENetPacket.
+  */
+  struct                        ENetTokenBucket
+  {
+    double                      m_tokens; /**< ENetPacket that can be received. */
+    uint32                      m_rate;   /**< ENetPacket credited per second, 0 for no limit. */
+    uint32                      m_burst;  /**< Maximum of m_tokens. */
+    LONGLONG                    m_time;   /**< Performance counter of last refill. */
+  };
+
+  /**
+    @brief ELib object for rate limiting of connected clients.
+    @details Each connection has a token bucket for all its ENetPacket, and one per limited ENetPacketType.
+    @details A connection without token is deferred: ENetSelector stops reading it, its datas wait in the system
+      buffers and TCP flow control slows the sender down. Other connections are served normally.
+    @details An ENetPacket of a type without token is read, then dropped before reaching the queues of ENetPacketHandler.
+    @details ENETPACKET_TYPE_DISCONNECT is never limited.
+  */
+  class                         ENetRateLimit
+  {
+  public:
+    ENetRateLimit();                                                                                /**< .... */
+    ~ENetRateLimit();                                                                               /**< .... */
+    void                        setConnectionLimit(uint32 p_rate, uint32 p_burst);                  /**< .M.. */
+    void                        setTypeLimit(ENetPacketType p_type, uint32 p_rate, uint32 p_burst); /**< .M.. */
+    void                        copySettings(const ENetRateLimit &p_model);                         /**< .M.. */
+    bool                        isAllowed(const ENetSocket *p_client);                              /**< .M.. */
+    bool                        consume(const ENetSocket *p_client, ENetPacketType p_type);         /**< .M.. */
+    void                        forget(const ENetSocket *p_client);                                 /**< .M.. */
+    bool                        isEnabled() const;                                                  /**< .... */
+    uint64                      getDropped() const;                                                 /**< .... */
+    uint64                      getDeferred() const;                                                /**< .... */
+
+  private:
+    /**
+      @brief Buckets of a connection.
+    */
+    struct                      ENetRateState
+    {
+      ENetTokenBucket           m_bucket; /**< Bucket of all ENetPacket. */
+      std::map<ENetPacketType,
+        ENetTokenBucket>        m_types;  /**< Bucket of each limited ENetPacketType. */
+    };
+
+    ENetRateState               &getState(const ENetSocket *p_client);
+    void                        refill(ENetTokenBucket &p_bucket, LONGLONG p_time) const;
+
+    ENetTokenBucket             m_connection; /**< Settings of connection buckets. */
+    std::map<ENetPacketType,
+      ENetTokenBucket>          m_types;      /**< Settings of each limited ENetPacketType. */
+    std::unordered_map<const ENetSocket*,
+      ENetRateState>            m_states;     /**< Buckets of each connection. */
+    LARGE_INTEGER               m_frequency;  /**< Performance counter frequency. */
+    uint64                      m_dropped;    /**< ENetPacket dropped by type limits. */
+    uint64                      m_deferred;   /**< Connections deferred by connection limit. */
+    volatile LONG               m_isEnabled;  /**< 1 if connections or types are limited, written under m_mutex, read without it. */
+    HANDLE                      m_mutex;      /**< m_states semaphore. */
+  };
+
+}
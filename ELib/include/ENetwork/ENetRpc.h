@@ -0,0 +1,113 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetRpc Class.
+*/
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetPacket.h"
+
+#define ENETRPC_TIMEOUT_DEFAULT (5000) /**< Default deadline of a call in milliseconds. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Status of a ENetRpc call.
+  */
+  enum                          ENetRpcStatus
+  {
+    ENETRPC_STATUS_OK             = 0x0000,
+    ENETRPC_STATUS_ERROR          = 0x0001, /**< Set by ENetRpcHandler on failure. */
+    ENETRPC_STATUS_UNKNOWN_METHOD = 0x0002, /**< No ENetRpcHandler for method. */
+    ENETRPC_STATUS_TIMEOUT        = 0x0003, /**< Deadline reached without response. */
+    ENETRPC_STATUS_CANCELLED      = 0x0004  /**< ENetSocket disconnected before response. */
+  };
+
+  /**
+    @brief Function called on completion of a ENetRpc call.
+    @param p_status ENetRpcStatus of call.
+    @param p_response Response. nullptr on ENETRPC_STATUS_TIMEOUT and ENETRPC_STATUS_CANCELLED.
+    @param p_context Context given to ENetRpc::call().
+  */
+  typedef void (*ENetRpcCallback)(ENetRpcStatus p_status, const ENetPacketRpc *p_response, void *p_context);
+
+  /**
+    @brief Function serving a method of ENetRpc.
+    @details Fill response datas, and status if not ENETRPC_STATUS_OK.
+    @param p_request Request.
+    @param p_response Response to be sent.
+    @param p_context Context given to ENetRpc::setHandler().
+  */
+  typedef void (*ENetRpcHandler)(const ENetPacketRpc *p_request, ENetPacketRpc *p_response, void *p_context);
+
+  /**
+    @brief ELib object for request/response over ENetPacket (Singleton).
+    @details call() send a ENETPACKET_TYPE_RPC_REQUEST with a new correlation identifier and return immediately.
+    @details Any number of calls can be in flight on one connection, responses can arrive in any order.
+      A call is identified by its destination and correlation identifier: a response completes it only if it comes from the destination.
+    @details ENetPacketRpc popped from ENetPacketHandler must be given to process():
+      requests are served by their ENetRpcHandler, responses complete their call.
+    @details expire() must be called periodically to complete calls that reached their deadline.
+    @details Callbacks are invoked from process() and expire(), on the thread of the application. Connected protocols only.
+  */
+  class                         ENetRpc
+  {
+  public:
+    ~ENetRpc();                                                                               /**< .... */
+    static ENetRpc              *getInstance();                                               /**< ..E. */
+    uint64                      call(ENetSocket *p_dst, uint32 p_method, const char *p_datas, /**< .ME. */
+                                  int32 p_len, ENetRpcCallback p_callback, void *p_context = nullptr,
+                                  uint32 p_timeout = ENETRPC_TIMEOUT_DEFAULT);
+    bool                        process(ENetPacket *p_packet);                                /**< .ME. */
+    void                        expire();                                                     /**< .M.. */
+    void                        cancel(const ENetSocket *p_socket);                           /**< .M.. */
+    void                        setHandler(uint32 p_method, ENetRpcHandler p_handler,         /**< .M.. */
+                                  void *p_context = nullptr);
+    uint32                      getPending() const;                                           /**< .M.. */
+
+  private:
+    ENetRpc();
+
+    typedef std::pair<const ENetSocket*, uint64> ENetRpcKey; /**< ENetSocket destination and correlation identifier of a call. */
+
+    /**
+      @brief Call waiting for its response.
+    */
+    struct                      ENetRpcCall
+    {
+      const ENetSocket          *m_dst;        /**< ENetSocket destination. */
+      ENetRpcCallback           m_callback;    /**< Completion function. */
+      void                      *m_context;    /**< Context of completion function. */
+      uint64                    m_deadline;    /**< GetTickCount64() after which call is expired. */
+      bool                      m_isCancelled; /**< Indicate that destination disconnected. */
+    };
+
+    /**
+      @brief Handler of a method.
+    */
+    struct                      ENetRpcMethod
+    {
+      ENetRpcHandler            m_handler;  /**< Serving function. */
+      void                      *m_context; /**< Context of serving function. */
+    };
+
+    std::map<ENetRpcKey,
+      ENetRpcCall>              m_calls;      /**< Pending calls by destination and correlation identifier. */
+    std::set<std::pair<uint64,
+      ENetRpcKey> >             m_deadlines;  /**< Pending calls ordered by deadline. */
+    std::map<uint32,
+      ENetRpcMethod>            m_methods;    /**< ENetRpcHandler by method. */
+    uint64                      m_nextId;     /**< Next correlation identifier. */
+    HANDLE                      m_mutexCalls; /**< m_calls semaphore. */
+  };
+
+}
@@ -0,0 +1,239 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetScheduler Class.
+*/
+
+#pragma once
+
+#include <coroutine>
+#include <deque>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetPacketHandler.h"
+#include "ENetwork/ENetRpc.h"
+
+#define ENETSCHEDULER_POLL_MAX    (256)   /**< ENetPacket dispatched by one ENetScheduler::poll(). */
+#define ENETSCHEDULER_WAIT        (10)    /**< Maximum milliseconds waited by a thread without work, ENetRpc deadlines precision. */
+#define ENETSCHEDULER_MAILBOX_MAX (1024)  /**< ENetPacket kept by a mailbox not awaited, following ones are dropped. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Coroutine of ELib (session, protocol...).
+    @details Created suspended, started by ENetScheduler::spawn(). Its frame is freed when it returns.
+    @details An ENetTask never given to ENetScheduler::spawn() is never started nor freed.
+    @details A session coroutine removes the mailbox of its ENetSocket when it returns.
+  */
+  class                         ENetTask
+  {
+  public:
+    /**
+      @brief Promise of ENetTask, used by compiler.
+    */
+    struct                      promise_type
+    {
+      promise_type();                                                  /**< .... */
+      ENetTask                  get_return_object();                   /**< .... */
+      std::suspend_always       initial_suspend() noexcept;            /**< .... */
+      std::suspend_never        final_suspend() noexcept;              /**< .M.. */
+      void                      return_void();                         /**< .... */
+      void                      unhandled_exception();                 /**< .... */
+
+      const ENetSocket          *m_socket; /**< ENetSocket of session coroutine, nullptr for others. */
+    };
+
+    ENetTask(std::coroutine_handle<promise_type> p_handle);            /**< .... */
+    std::coroutine_handle<>     getHandle() const;                     /**< .... */
+    void                        setSocket(const ENetSocket *p_socket); /**< .... */
+
+  private:
+    std::coroutine_handle<promise_type> m_handle; /**< Coroutine. */
+  };
+
+  /**
+    @brief Awaiter for next ENetPacket of a ENetSocket.
+    @details Result is the ENetPacket, to be deleted by the coroutine. ENetPacketDisconnect ends the connection.
+  */
+  class                         ENetRecvAwaiter
+  {
+  public:
+    ENetRecvAwaiter(ENetSocket *p_socket);                                       /**< .... */
+    bool                        await_ready() const;                             /**< .... */
+    bool                        await_suspend(std::coroutine_handle<> p_handle); /**< .M.. */
+    ENetPacket                  *await_resume() const;                           /**< .... */
+
+  private:
+    ENetSocket                  *m_socket; /**< ENetSocket awaited. */
+    ENetPacket                  *m_packet; /**< ENetPacket received. */
+  };
+
+  /**
+    @brief Awaiter posting a ENetPacket. Never suspend.
+    @details Result is true on success.
+  */
+  class                         ENetSendAwaiter
+  {
+  public:
+    ENetSendAwaiter(ENetSocket *p_socket, ENetPacket *p_packet);                 /**< .... */
+    bool                        await_ready() const;                             /**< .... */
+    void                        await_suspend(std::coroutine_handle<> p_handle); /**< .... */
+    bool                        await_resume() const;                            /**< ..E. */
+
+  private:
+    ENetSocket                  *m_socket; /**< ENetSocket destination. */
+    ENetPacket                  *m_packet; /**< ENetPacket to be posted. */
+  };
+
+  /**
+    @brief Awaiter resuming after a delay.
+  */
+  class                         ENetSleepAwaiter
+  {
+  public:
+    ENetSleepAwaiter(uint32 p_delay);                                            /**< .... */
+    bool                        await_ready() const;                             /**< .... */
+    void                        await_suspend(std::coroutine_handle<> p_handle); /**< .M.. */
+    void                        await_resume() const;                            /**< .... */
+
+  private:
+    uint32                      m_delay; /**< Delay in milliseconds. */
+  };
+
+  /**
+    @brief Result of a ENetRpc call awaited by a coroutine.
+  */
+  struct                        ENetRpcResult
+  {
+    ENetRpcStatus               m_status; /**< ENetRpcStatus of call. */
+    std::string                 m_datas;  /**< Result of method. */
+  };
+
+  /**
+    @brief Awaiter for a ENetRpc call.
+    @details Result is the ENetRpcResult of the call, ENETRPC_STATUS_ERROR if call could not be sent.
+  */
+  class                         ENetRpcAwaiter
+  {
+  public:
+    ENetRpcAwaiter(ENetSocket *p_socket, uint32 p_method, const char *p_datas, int32 p_len, /**< .... */
+      uint32 p_timeout);
+    bool                        await_ready() const;                                        /**< .... */
+    bool                        await_suspend(std::coroutine_handle<> p_handle);            /**< .ME. */
+    ENetRpcResult               await_resume() const;                                       /**< .... */
+
+  private:
+    static void                 complete(ENetRpcStatus p_status, const ENetPacketRpc *p_response, void *p_context);
+
+    ENetSocket                  *m_socket; /**< ENetSocket destination. */
+    uint32                      m_method;  /**< Method called. */
+    const char                  *m_datas;  /**< Arguments of method. */
+    int32                       m_len;     /**< Arguments length. */
+    uint32                      m_timeout; /**< Deadline of call in milliseconds. */
+    std::coroutine_handle<>     m_handle;  /**< Coroutine awaiting. */
+    ENetRpcResult               m_result;  /**< Result of call. */
+  };
+
+  /**
+    @brief Connected ENetSocket seen from a coroutine.
+    @details Cheap to copy, does not own its ENetSocket.
+  */
+  class                         ENetConnection
+  {
+  public:
+    ENetConnection(ENetSocket *p_socket);                                              /**< .... */
+    ENetRecvAwaiter             recvPacket();                                          /**< .... */
+    ENetSendAwaiter             send(ENetPacket *p_packet);                            /**< .... */
+    ENetSleepAwaiter            sleep(uint32 p_delay);                                 /**< .... */
+    ENetRpcAwaiter              rpc(uint32 p_method, const char *p_datas, int32 p_len, /**< .... */
+                                  uint32 p_timeout = ENETRPC_TIMEOUT_DEFAULT);
+    ENetSocket                  *getSocket() const;                                    /**< .... */
+
+  private:
+    ENetSocket                  *m_socket; /**< Connected ENetSocket. */
+  };
+
+  /**
+    @brief Function creating the session coroutine of a new connection.
+    @param p_connection New connection.
+    @return Session coroutine.
+  */
+  typedef ENetTask (*ENetSession)(ENetConnection p_connection);
+
+  /**
+    @brief ELib object running coroutines over ENetPacketHandler automation (Singleton).
+    @details A few threads run every coroutine. A suspended coroutine only costs its frame, not a thread and its stack.
+    @details Once running, ENetScheduler owns ENetPacketHandler queues: ENetPacketRpc are given to ENetRpc::process(),
+      others are stored in the mailbox of their source until a coroutine awaits ENetConnection::recvPacket().
+    @details First ENetPacket of an unknown source spawns the ENetSession coroutine, if set.
+      Its mailbox is removed, with ENetPacket not yet awaited, when the session coroutine returns.
+    @details A mailbox keeps at most ENETSCHEDULER_MAILBOX_MAX ENetPacket, following ones are dropped (getDropped()),
+      except ENetPacketDisconnect. A coroutine still awaiting a mailbox removed by its session gets a ENetPacketDisconnect.
+    @details ENetPacketHandler is the one set by setHandler(), ENetPacketHandler Singleton if none.
+    @details Threads without work wait for the event of ENetPacketHandler, a scheduled coroutine or the next timer,
+      at most ENETSCHEDULER_WAIT milliseconds.
+    @details ENetRpc::expire() is called by the scheduler. Connected protocols only.
+  */
+  class                         ENetScheduler
+  {
+  public:
+    ~ENetScheduler();                                                       /**< .... */
+    static ENetScheduler        *getInstance();                             /**< ..E. */
+    void                        start(uint32 p_threads = 1);                /**< .ME. */
+    void                        stop();                                     /**< B.E. */
+    void                        run();                                      /**< BM.. */
+    void                        spawn(ENetTask p_task);                     /**< .M.. */
+    void                        schedule(std::coroutine_handle<> p_handle); /**< .M.. */
+    void                        setSession(ENetSession p_session);          /**< .... */
+    void                        setHandler(ENetPacketHandler *p_handler);   /**< .... */
+    ENetPacketHandler           *getHandler() const;                        /**< .... */
+    uint64                      getDropped() const;                         /**< .... */
+    bool                        isRunning() const;                          /**< .... */
+
+  private:
+    ENetScheduler();
+    bool                        poll();
+    void                        dispatch(ENetPacket *p_packet);
+    void                        addTimer(uint64 p_deadline, std::coroutine_handle<> p_handle);
+    bool                        takePacket(ENetSocket *p_socket, std::coroutine_handle<> p_handle, ENetPacket **p_slot);
+    void                        closeMailbox(const ENetSocket *p_socket, std::coroutine_handle<> p_session);
+
+    friend class                ENetRecvAwaiter;
+    friend class                ENetSleepAwaiter;
+    friend struct               ENetTask::promise_type;
+
+    /**
+      @brief ENetPacket of a ENetSocket waiting for its coroutine.
+    */
+    struct                      ENetMailbox
+    {
+      std::deque<ENetPacket*>   m_packets; /**< ENetPacket not yet awaited. */
+      std::coroutine_handle<>   m_waiter;  /**< Coroutine awaiting, if any. */
+      ENetPacket                **m_slot;  /**< Result of awaiting coroutine. */
+      std::coroutine_handle<>   m_session; /**< Session coroutine owning mailbox, if any. */
+    };
+
+    std::deque<
+      std::coroutine_handle<> > m_ready;           /**< Coroutines ready to be resumed. */
+    std::multimap<uint64,
+      std::coroutine_handle<> > m_timers;          /**< Sleeping coroutines by deadline. */
+    std::unordered_map<const ENetSocket*,
+      ENetMailbox>              m_mailboxes;       /**< Mailbox of each ENetSocket. */
+    ENetSession                 m_session;         /**< Session coroutine of new connections. */
+    ENetPacketHandler           *m_handler;        /**< ENetPacketHandler polled, nullptr for ENetPacketHandler Singleton. */
+    uint64                      m_dropped;         /**< ENetPacket dropped by full mailboxes. */
+    std::vector<HANDLE>         m_threads;         /**< run() threads. */
+    HANDLE                      m_mutexTasks;      /**< m_ready, m_timers and m_mailboxes semaphore. */
+    HANDLE                      m_mutexPoll;       /**< poll() semaphore, keep ENetPacket order per ENetSocket. */
+    HANDLE                      m_eventTasks;      /**< Signalled by schedule() and addTimer(), manual reset. */
+    bool                        m_isRunning;       /**< State. */
+  };
+
+}
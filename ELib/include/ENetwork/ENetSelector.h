@@ -10,6 +10,10 @@
 #include "EGlobals/EGlobal.h"
 #include "ENetPacketHandler.h"
 
+#define ENETSELECTOR_READ_BUDGET   (32)   /**< Maximum of ENetPacket received per select() iteration. */
+#define ENETSELECTOR_DEFER_TIMEOUT (1000) /**< Microseconds of select() timeout while a client is deferred. */
+#define ENETSELECTOR_CLIENTS_MAX   (min(ENETSOCKET_MAX_CLIENTS, FD_SETSIZE - 1)) /**< Clients of one ENetSelector: its wake ENetSocket takes one slot of the select() read set. */
+
 /**
   @brief General scope for ELib components.
 */
@@ -20,25 +24,36 @@ namespace                     ELib
     @brief ELib object for connected ENetSocket automation in ENetServer.
     @details Call ENetSelector::select() on its clients in its own thread.
     @details Automatically stopped when no client are contained.
+    @details Flush ENetSendQueue of its writable clients. ENetSelector::wake() interrupt select() when a queue is filled.
+    @details Received ENetPacket are stored into its ENetPacketHandler, ENetPacketHandler Singleton if none given.
+    @details Readable clients are served round robin, up to ENETSELECTOR_READ_BUDGET ENetPacket per iteration,
+      so one flooding client cannot starve the others. Clients over their ENetRateLimit connection limit are not read.
   */
   class                       ENetSelector
   {
   public:
-    ENetSelector();                                             /**< .... */
-    ~ENetSelector();                                            /**< .... */
-    void                      start();                          /**< ..E. */
-    void                      stop();                           /**< ..E. */
-    void                      select();                         /**< BME. */
-    bool                      addClient(ENetSocket *p_client);  /**< .ME. */
-    void                      broadcast(ENetPacket *p_packet);  /**< .ME. */
-    uint32                    getSize() const;                  /**< .... */
-    bool                      isRunning() const;                /**< .... */
-    const std::string         toString() const;                 /**< .M.. */
+    ENetSelector(ENetPacketHandler *p_handler = nullptr);        /**< .... */
+    ~ENetSelector();                                             /**< .... */
+    void                      start();                           /**< ..E. */
+    void                      stop();                            /**< ..E. */
+    void                      select();                          /**< BME. */
+    bool                      addClient(ENetSocket *p_client);   /**< .ME. */
+    void                      broadcast(ENetPacket *p_packet);   /**< .ME. */
+    void                      wake();                            /**< ..E. */
+    void                      setAffinity(DWORD_PTR p_affinity); /**< .... */
+    ENetPacketHandler         *getHandler() const;               /**< .... */
+    uint32                    getSize() const;                   /**< .... */
+    bool                      isRunning() const;                 /**< .... */
+    const std::string         toString() const;                  /**< .M.. */
 
   private:
     std::vector<ENetSocket*>  m_clients;        /**< ENetSocket list. */
+    size_t                    m_next;           /**< Index of first client to be read at next iteration. */
     HANDLE                    m_threadSelect;   /**< select() thread. */
     HANDLE                    m_mutexClients;   /**< m_client semaphore. */
+    ENetSocket                m_socketWake;     /**< Loopback ENetSocket waking up select(). */
+    ENetPacketHandler         *m_handler;       /**< ENetPacketHandler storing received ENetPacket. */
+    DWORD_PTR                 m_affinity;       /**< Processor affinity mask of select() thread, 0 for any. */
     bool                      m_isRunning;      /**< State. */
   };
 
@@ -0,0 +1,108 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetSendQueue Class.
+*/
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+#include "EGlobals/EGlobal.h"
+
+#define ENETSENDQUEUE_FLUSH_MAX (16384) /**< Bytes sent by ENetSendQueue::flush() before giving back the hand. */
+#define ENETSENDQUEUE_BATCH_MAX (65535) /**< Bytes of frames coalesced into one ENetSocket::send(). */
+#define ENETCHANNEL_MAX         (8)     /**< Number of channels on one connection. */
+#define ENETCHANNEL_PRIORITIES  (4)     /**< Number of priority levels. 0 is the most urgent. */
+#define ENETCHANNEL_CONTROL     (0)     /**< Default channel for control ENetPacket. */
+#define ENETCHANNEL_DEFAULT     (1)     /**< Default channel for application ENetPacket. */
+#define ENETCHANNEL_BULK        (2)     /**< Default channel for bulk transfers. */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  class                         ENetSocket;
+  class                         ENetSelector;
+
+  typedef uint8                 ENetChannelId;
+
+  /**
+    @brief Logical channel of a connection.
+    @details Channels of higher priority (lower value) are always sent first.
+    @details Channels of same priority share the connection according to their weight (bytes per round).
+  */
+  struct                        ENetChannel
+  {
+    ENetChannelId               m_id;       /**< Channel identifier. */
+    uint8                       m_priority; /**< Priority level. 0 is the most urgent. */
+    uint32                      m_weight;   /**< Bytes credited per round of scheduler. */
+  };
+
+  /**
+    @brief ELib object for outbound frames of a connected ENetSocket.
+    @details Filled by ENetPacket::post(), flushed by ENetSelector when its ENetSocket is writable.
+    @details Each ENetChannel has its own lane. Lanes are interleaved by a deficit round robin per priority level.
+    @details Conflated frames share a key (ENetPacketType and ENetPacket::getConflationKey()).
+    @details A conflated frame that is still unsent is replaced in place by a newer frame with the same key.
+    @details Memory per slow connection is then bounded by the number of keys, not by the number of updates.
+    @details Queued bytes are reserved in ENetBudget for their connection. A frame that does not fit is refused.
+  */
+  class                         ENetSendQueue
+  {
+  public:
+    ENetSendQueue();                                                                  /**< .... */
+    ~ENetSendQueue();                                                                 /**< .... */
+    bool                        push(const ENetSocket *p_dst, const char *p_datas,    /**< .M.. */
+                                  int32 p_len, uint32 p_type,
+                                  const ENetChannel &p_channel,
+                                  bool p_isConflated = false, uint64 p_key = 0);
+    void                        flush(ENetSocket *p_dst);                             /**< .ME. */
+    void                        setSelector(ENetSelector *p_selector);                /**< .M.. */
+    ENetSelector                *getSelector() const;                                 /**< .... */
+    bool                        isEmpty() const;                                      /**< .M.. */
+    uint32                      getSize() const;                                      /**< .M.. */
+    uint64                      getBytes() const;                                     /**< .M.. */
+
+  private:
+    /**
+      @brief Serialized ENetPacket waiting to be sent.
+    */
+    struct                      ENetFrame
+    {
+      std::string               m_datas;       /**< Serialized ENetPacket. */
+      uint32                    m_type;        /**< ENetPacketType of the frame. */
+      uint64                    m_key;         /**< Conflation key. */
+      bool                      m_isConflated; /**< Indicate if frame can be replaced. */
+    };
+
+    /**
+      @brief Frames of one ENetChannel.
+    */
+    struct                      ENetLane
+    {
+      std::deque<ENetFrame>     m_frames;      /**< Frames in sending order. */
+      uint64                    m_head;        /**< Sequence of m_frames front. */
+      uint64                    m_deficit;     /**< Bytes the lane can send during current round. */
+      uint8                     m_priority;    /**< Priority of the ENetChannel. */
+      uint32                    m_weight;      /**< Weight of the ENetChannel. */
+    };
+
+    ENetChannelId               selectLane();
+
+    ENetLane                    m_lanes[ENETCHANNEL_MAX]; /**< Lane of each ENetChannel. */
+    std::map<std::pair<uint32, uint64>,
+      std::pair<ENetChannelId,
+      uint64> >                 m_conflated;   /**< Lane and sequence of the unsent frame of each conflation key. */
+    ENetChannelId               m_current;     /**< Lane served by the scheduler. */
+    bool                        m_isCredited;  /**< Indicate if m_current received its weight for this round. */
+    uint32                      m_size;        /**< Frames waiting in lanes. */
+    uint64                      m_bytes;       /**< Bytes waiting in lanes. */
+    ENetSelector                *m_selector;   /**< ENetSelector flushing the queue. */
+    HANDLE                      m_mutexFrames; /**< m_lanes semaphore. */
+  };
+
+}
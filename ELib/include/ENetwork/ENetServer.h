@@ -6,8 +6,21 @@
 
 #pragma once
 
+#include <map>
 #include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetCookie.h"
+#include "ENetwork/ENetFec.h"
+#include "ENetwork/ENetImpairment.h"
+#include "ENetwork/ENetPacer.h"
 #include "ENetwork/ENetSelector.h"
+#include "ENetwork/ENetShard.h"
+#include "ENetwork/ENetTopics.h"
+
+#define ENETSERVER_ADMIN_IDLE (10)          /**< Milliseconds waited by ENetServer::admin() without request, over MAXIMUM_WAIT_OBJECTS admin queues. */
+#define ENETSTATS_VERSION     (1)           /**< Version of ENetStatsHeader snapshot. */
+#define ENETSTATS_NO_SHARD    (0xFFFFFFFF)  /**< ENetStatsGroup of an ENetSelector of ENetServer itself. */
+#define ENETSERVER_PEERS_MAX  (4096)        /**< Datagram peers registered at once. */
+#define ENETSERVER_PEER_IDLE  (60000)       /**< Milliseconds without datagram before a datagram peer is forgotten. */
 
 /**
   @brief General scope for ELib components.
@@ -16,15 +29,51 @@ namespace                       ELib
 {
 
   /**
-    @brief Elib object for network server side automation (Singleton).
+    @brief Header of an ENetPacketStats snapshot.
+    @details Followed by m_groups ENetStatsGroup, then by the EMetricsSnapshot of the process.
+  */
+  struct                        ENetStatsHeader
+  {
+    uint32                      m_version;  /**< ENETSTATS_VERSION. */
+    uint32                      m_groups;   /**< Number of ENetStatsGroup following. */
+    uint32                      m_shards;   /**< ENetShard count, 0 out of thread-per-core mode. */
+    uint32                      m_peers;    /**< Registered datagram peers. */
+    uint64                      m_uptime;   /**< Milliseconds since ENetServer::start(). */
+  };
+
+  /**
+    @brief Clients of an ENetSelector of ENetServer, or of all ENetSelectors of an ENetShard.
+  */
+  struct                        ENetStatsGroup
+  {
+    uint32                      m_shard;    /**< Index of ENetShard, ENETSTATS_NO_SHARD for an ENetSelector of ENetServer. */
+    uint32                      m_clients;  /**< Connected clients. */
+  };
+
+  /**
+    @brief Elib object for network server side automation (Singleton, or one per context).
+    @details Each instance owns its ENetSockets, ENetSelectors and ENetShards, and stores ENetPacket in its own ENetPacketHandler.
+      getInstance() is the default context, using ENetPacketHandler Singleton.
     @details Call ENetServer::recvfrom() for incoming connectionless datas in its own thread.
     @details Call ENetServer::accept() for incoming connections in its own thread.
     @details Automatically generate ENetSelector every MAX_CLIENTS to dispatch load.
     @details Use ENetPacketHandler for ENetPacket storage.
+    @details Thread-per-core mode (setShards()): accepted connections are handed round robin to ENetShards,
+      each owning its ENetSelectors and ENetPacketHandler on one core. Connectionless datas stay on ENetPacketHandler of ENetServer.
+    @details Datagram peers register with ENETPACKET_TYPE_DGRAM_JOIN, accepted only from sources verified by cookies (setCookies()).
+      sendDatagram() sends once to the multicast group (setMulticast()) for peers that joined it, and falls back to unicast for others.
+      Up to ENETSERVER_PEERS_MAX peers, forgotten after ENETSERVER_PEER_IDLE milliseconds without datagram.
+    @details Connectionless datas can be paced (setPacing()): sent by an ENetPacer instead of one burst per tick.
+    @details Connectionless datas can be protected by ENetFec parity (setFec(), flushFec()), received ones are always unwrapped.
+    @details With cookies (setCookies()), datagrams of a source are dropped before any allocation until it echoes its ENetCookie.
+    @details Sent datas can be impaired (setImpairment()) by an ENetImpairment, to test behaviour on a bad network.
+    @details With an admin token (setAdmin()), ENetPacketStats carrying the token are answered with getStats() by ENetServer::admin()
+      in its own thread, off the ENetSelector threads. Other ENetPacketStats are dropped.
   */
   class                         ENetServer
   {
   public:
+    ENetServer(ENetPacketHandler *p_handler = nullptr);                               /**< .... */
     ~ENetServer();                                                                    /**< .... */
     static ENetServer           *getInstance();                                       /**< ..E. */
     void                        init(const std::string &p_hostname, uint16 p_port);   /**< ..E. */
@@ -32,14 +81,52 @@ namespace                       ELib
     void                        stop();                                               /**< .ME. */
     void                        recvfrom();                                           /**< BME. */
     void                        accept();                                             /**< BME. */
+    void                        admin();                                              /**< BME. */
     void                        addClient(ENetSocket *p_client);                      /**< .ME. */
     void                        broadcast(ENetPacket *p_packet);                      /**< .ME. */
+    void                        publish(ENetTopicId p_topic, ENetPacket *p_packet);   /**< .ME. */
     void                        clearSelectors();                                     /**< .M.. */
+    void                        setShards(uint32 p_count);                            /**< .ME. */
+    ENetShard                   *getShard(uint32 p_index) const;                      /**< .... */
+    uint32                      getShardCount() const;                                /**< .... */
+    ENetPacketHandler           *getHandler() const;                                  /**< .... */
+    void                        setMulticast(const std::string &p_group,              /**< ..E. */
+                                  uint16 p_port, uint8 p_ttl = 1);
+    void                        sendDatagram(ENetPacket *p_packet);                   /**< .ME. */
+    uint32                      getDatagramPeerCount() const;                         /**< .M.. */
+    void                        setPacing(uint64 p_rate, uint64 p_peerRate,           /**< .M.. */
+                                  uint32 p_burst = ENETPACER_BURST);
+    ENetPacer                   *getPacer();                                          /**< .... */
+    void                        setFec(uint8 p_count);                                /**< .... */
+    ENetFec                     *getFec();                                            /**< .... */
+    void                        flushFec(uint32 p_delay = 0);                         /**< .ME. */
+    void                        setCookies(bool p_isCookie);                          /**< .... */
+    ENetCookie                  *getCookie();                                         /**< .... */
+    void                        setImpairment(                                        /**< .M.. */
+                                  const ENetImpairmentSettings &p_settings);
+    ENetImpairment              *getImpairment();                                     /**< .... */
+    void                        setAdmin(const std::string &p_token);                 /**< .... */
+    const std::string           getStats() const;                                     /**< .M.. */
     bool                        isRunning() const;                                    /**< .... */
     const std::string           toString() const;                                     /**< .M.. */
 
   private:
-    ENetServer();
+    void                        joinDatagram(const ENetSocket *p_peer, bool p_isMulticast);
+    void                        leaveDatagram(const ENetSocket *p_peer);
+    void                        touchDatagram(const ENetSocket *p_peer);
+    void                        expireDatagram(ULONGLONG p_time);
+    void                        answerCookie(char *p_datas, uint32 p_address, uint16 p_port);
+    void                        answerStats(const ENetPacketStats *p_request);
+
+    /**
+      @brief Registered datagram peer.
+    */
+    struct                      ENetDatagramPeer
+    {
+      ENetSocket                *m_socket;      /**< Address of peer. */
+      bool                      m_isMulticast;  /**< Peer receives the multicast group. */
+      ULONGLONG                 m_time;         /**< Tick count of last datagram of peer. */
+    };
 
     ENetSocket                  m_socketRecvfrom; /**< recvfrom() ENetSocket. */
     HANDLE                      m_threadRecvfrom; /**< recvfrom() thread. */
@@ -47,6 +134,22 @@ namespace                       ELib
     HANDLE                      m_threadAccept;   /**< accept() thread. */
     std::vector<ENetSelector*>  m_selectors;      /**< ENetSelector list. */
     HANDLE                      m_mutexSelectors; /**< m_selectors semaphore. */
+    std::vector<ENetShard*>     m_shards;         /**< ENetShard list, empty out of thread-per-core mode. */
+    uint32                      m_nextShard;      /**< ENetShard receiving next connection. */
+    ENetPacketHandler           *m_handler;       /**< ENetPacket storage, nullptr for ENetPacketHandler Singleton. */
+    ENetSocket                  m_group;          /**< Multicast group destination. */
+    bool                        m_isMulticast;    /**< Multicast group is set. */
+    std::map<std::string,
+      ENetDatagramPeer>         m_peers;          /**< Datagram peers by address. */
+    HANDLE                      m_mutexPeers;     /**< m_peers semaphore. */
+    ENetPacer                   m_pacer;          /**< Pacer of m_socketRecvfrom. */
+    ENetFec                     m_fec;            /**< Forward error correction of m_socketRecvfrom. */
+    ENetCookie                  m_cookie;         /**< Verified connectionless sources. */
+    ENetImpairment              m_impairment;     /**< Impairment of sent datas. */
+    bool                        m_isCookie;       /**< Connectionless sources must be verified. */
+    std::string                 m_adminToken;     /**< Token of ENetPacketStats requests, empty for no admin. */
+    HANDLE                      m_threadAdmin;    /**< admin() thread. */
+    ULONGLONG                   m_startTime;      /**< Tick count at start(). */
     bool                        m_isRunning;      /**< State. */
   };
 
@@ -0,0 +1,92 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetShard Class.
+*/
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetSelector.h"
+
+#define ENETSHARD_BATCH (256) /**< ENetPacket handled by one iteration of ENetShard::run(). */
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  class                         ENetShard;
+
+  /**
+    @brief Function handling a ENetPacket on the core of its ENetShard.
+    @details ENetPacket is deleted by ENetShard when function returns.
+    @param p_shard ENetShard owning the connection.
+    @param p_packet Received ENetPacket.
+    @param p_context Context given to ENetShard::setWorker().
+  */
+  typedef void (*ENetShardWorker)(ENetShard *p_shard, ENetPacket *p_packet, void *p_context);
+
+  /**
+    @brief Message sent to a ENetShard by another core.
+    @param p_shard ENetShard executing the message.
+    @param p_context Context given to ENetShard::post().
+  */
+  typedef void (*ENetShardTask)(ENetShard *p_shard, void *p_context);
+
+  /**
+    @brief ELib object for one core of a thread-per-core ENetServer.
+    @details Own its ENetPacketHandler queues, its ENetSelectors and their connections. Nothing is shared with other ENetShards.
+    @details ENetSelectors threads and run() thread are pinned on the core of the ENetShard.
+    @details run() executes ENetShardTask posted by other cores, then gives received ENetPacket to the ENetShardWorker.
+    @details Only post() and addClient() are called from other threads: cross-core communication is explicit.
+    @details Without work, run() waits for an ENetShardTask or, with an ENetShardWorker, for the event of its ENetPacketHandler.
+  */
+  class                         ENetShard
+  {
+  public:
+    ENetShard(uint32 p_id, DWORD_PTR p_affinity);                                               /**< .... */
+    ~ENetShard();                                                                               /**< .... */
+    void                        start();                                                        /**< ..E. */
+    void                        stop();                                                         /**< B.E. */
+    void                        run();                                                          /**< BME. */
+    void                        addClient(ENetSocket *p_client);                                /**< .ME. */
+    void                        post(ENetShardTask p_task, void *p_context);                    /**< .M.. */
+    void                        broadcast(ENetPacket *p_packet);                                /**< .ME. */
+    void                        setWorker(ENetShardWorker p_worker, void *p_context = nullptr); /**< .... */
+    ENetPacketHandler           *getHandler();                                                  /**< .... */
+    uint32                      getId() const;                                                  /**< .... */
+    uint32                      getSize() const;                                                /**< .M.. */
+    bool                        isRunning() const;                                              /**< .... */
+
+  private:
+    void                        clearSelectors();
+
+    /**
+      @brief ENetShardTask waiting for run().
+    */
+    struct                      ENetShardMessage
+    {
+      ENetShardTask             m_task;     /**< Function to be executed. */
+      void                      *m_context; /**< Context of function. */
+    };
+
+    uint32                      m_id;             /**< Index of ENetShard. */
+    DWORD_PTR                   m_affinity;       /**< Processor affinity mask of its threads. */
+    ENetPacketHandler           m_handler;        /**< Queues of received ENetPacket. */
+    std::vector<ENetSelector*>  m_selectors;      /**< ENetSelector list. */
+    HANDLE                      m_mutexSelectors; /**< m_selectors semaphore. */
+    std::deque<
+      ENetShardMessage>         m_messages;       /**< ENetShardTask posted by other cores. */
+    HANDLE                      m_mutexMessages;  /**< m_messages semaphore. */
+    HANDLE                      m_eventMessages;  /**< Signalled by post() and stop(), manual reset. */
+    ENetShardWorker             m_worker;         /**< Function handling received ENetPacket. */
+    void                        *m_context;       /**< Context of m_worker. */
+    HANDLE                      m_threadRun;      /**< run() thread. */
+    bool                        m_isRunning;      /**< State. */
+  };
+
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetSendQueue.h"
 
 #define ENETSOCKET_FAMILY       (AF_INET) /**< Socket family used in ELib (IPv4 only). */
 #define ENETSOCKET_MAX_CLIENTS  (64)      /**< Max number of client in the accept queue. */
@@ -19,6 +20,10 @@
 namespace                       ELib
 {
 
+  class                         ENetFec;
+  class                         ENetImpairment;
+  class                         ENetPacer;
+
   /**
     @brief Flags for states and protocols of ENetSocket.
   */
@@ -50,6 +55,10 @@ namespace                       ELib
     @brief ELib object for socket handling.
     @details Class for Socket functionalities and management.
     @details It can use multiple protocols and keep track of ENetSocket state.
+    @details Connectionless ENetSocket can join IP multicast groups. An uninitialized ENetSocket with an address is a destination.
+    @details Connectionless datas of ENetPacket are protected by the ENetFec, then paced by the ENetPacer of the ENetSocket, if any.
+    @details Sent datas go through the ENetImpairment of the ENetSocket while it is running, to emulate a bad network.
+    @details A connected ENetSocket can run on an in-memory stream instead of the kernel, to measure ELib alone.
   */
   class                         ENetSocket
   {
@@ -63,21 +72,46 @@ namespace                       ELib
     void                        connect(const std::string &p_hostname, uint16 p_port);              /**< /!\ ..E. */
     int32                       recv(char *p_datas, uint16 p_len);                                  /**< /!\ B.E. */
     int32                       recvfrom(char *p_datas, uint16 p_len, ENetSocket *p_src);           /**< /!\ B.E. */
+    int32                       recvfrom(char *p_datas, uint16 p_len,                               /**< B.E. */
+                                  uint32 &p_address, uint16 &p_port);
     int32                       send(const char *p_datas, uint16 p_len);                            /**< /!\ ..E. */
     int32                       sendto(const char *p_datas, uint16 p_len, const ENetSocket *p_dst); /**< /!\ ..E. */
+    int32                       sendto(const char *p_datas, uint16 p_len,                           /**< ..E. */
+                                  uint32 p_address, uint16 p_port);
     void                        shutdown(ENetSocketService p_service = ENETSOCKET_SERVICE_BOTH);    /**< /!\ ..E. */
     void                        close();                                                            /**< /!\ ..E. */
+    void                        setReuseAddress(bool p_isReused);                                   /**< ..E. */
+    void                        joinGroup(const std::string &p_group);                              /**< ..E. */
+    void                        leaveGroup(const std::string &p_group);                             /**< ..E. */
+    void                        setMulticastTtl(uint8 p_ttl);                                       /**< ..E. */
+    void                        setAddress(const std::string &p_hostname, uint16 p_port);           /**< .... */
+    void                        setAddress(uint32 p_address, uint16 p_port);                        /**< .... */
     const std::string           &getHostname() const;                                               /**< /!\ .... */
     uint16                      getPort() const;                                                    /**< /!\ .... */
     ENetSocketFlags             getFlags() const;                                                   /**< /!\ .... */
+    ENetSendQueue               *getSendQueue() const;                                              /**< .... */
+    void                        setPacer(ENetPacer *p_pacer);                                       /**< .... */
+    ENetPacer                   *getPacer() const;                                                  /**< .... */
+    void                        setFec(ENetFec *p_fec);                                             /**< .... */
+    ENetFec                     *getFec() const;                                                    /**< .... */
+    void                        setTap(std::string *p_tap);                                         /**< .... */
+    void                        setMemory(std::string *p_memory);                                   /**< .... */
+    void                        setImpairment(ENetImpairment *p_impairment);                        /**< .... */
+    ENetImpairment              *getImpairment() const;                                             /**< .... */
     operator                    uint64() const;                                                     /**< /!\ .... */
     const std::string           toString() const;                                                   /**< /!\ .... */
 
   private:
-    SOCKET                      m_socket;   /**< Unique identifier. */
-    std::string                 m_hostname; /**< Internet host address in number-and-dots notation. */
-    uint16                      m_port;     /**< Internet host port. */
-    ENetSocketFlags             m_flags;    /**< Flags for state and protocol. */
+    SOCKET                      m_socket;      /**< Unique identifier. */
+    std::string                 m_hostname;    /**< Internet host address in number-and-dots notation. */
+    uint16                      m_port;        /**< Internet host port. */
+    ENetSocketFlags             m_flags;       /**< Flags for state and protocol. */
+    ENetSendQueue               *m_sendQueue;  /**< Outbound frames of connected ENetSocket. */
+    ENetPacer                   *m_pacer;      /**< Pacer of connectionless datas, nullptr to send immediately. */
+    ENetFec                     *m_fec;        /**< Forward error correction of connectionless datas, nullptr for none. */
+    std::string                 *m_tap;        /**< Copy of received bytes for ENetCapture, nullptr for none. */
+    std::string                 *m_memory;     /**< In-memory stream replacing the kernel socket, nullptr for none. */
+    ENetImpairment              *m_impairment; /**< Impairment of sent datas, nullptr for none. */
   };
 
 }
@@ -0,0 +1,64 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Header for ENetTopics Class.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "EGlobals/EGlobal.h"
+#include "ENetwork/ENetPacket.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                       ELib
+{
+
+  /**
+    @brief Identifier of a topic (room, channel...). Defined by user.
+  */
+  typedef uint32                ENetTopicId;
+
+  /**
+    @brief ELib object for topic subscriptions (Singleton).
+    @details Keep for each topic a contiguous array of member ENetSockets.
+    @details Join and leave are O(1) (swap with last member), publish only walks the topic members.
+    @details ENetSelector automatically remove disconnected ENetSockets from every topic.
+  */
+  class                         ENetTopics
+  {
+  public:
+    ~ENetTopics();                                                                  /**< .... */
+    static ENetTopics           *getInstance();                                     /**< ..E. */
+    void                        join(ENetTopicId p_topic, ENetSocket *p_client);    /**< .ME. */
+    void                        leave(ENetTopicId p_topic, ENetSocket *p_client);   /**< .ME. */
+    void                        leaveAll(const ENetSocket *p_client);               /**< .M.. */
+    void                        publish(ENetTopicId p_topic, ENetPacket *p_packet); /**< .ME. */
+    uint32                      getSize(ENetTopicId p_topic) const;                 /**< .M.. */
+
+  private:
+    ENetTopics();
+    void                        removeMember(ENetTopicId p_topic, const ENetSocket *p_client);
+
+    /**
+      @brief Members of a topic.
+      @details m_positions give the index of each ENetSocket in m_members.
+    */
+    struct                      ENetTopic
+    {
+      std::vector<ENetSocket*>  m_members;    /**< Contiguous ENetSocket list. */
+      std::unordered_map<const ENetSocket*,
+        uint32>                 m_positions;  /**< Index of ENetSocket in m_members. */
+    };
+
+    std::unordered_map<ENetTopicId,
+      ENetTopic>                m_topics;       /**< ENetTopic list. */
+    std::unordered_map<const ENetSocket*,
+      std::vector<ENetTopicId> > m_memberships; /**< Joined topics of each ENetSocket. */
+    HANDLE                      m_mutexTopics;  /**< m_topics and m_memberships semaphore. */
+  };
+
+}
@@ -30,6 +30,8 @@ namespace             ELib
     "EERROR_MEMORY",
     "EERROR_NULL_PTR",
     "EERROR_WINDOWS_ERR",
+    "EERROR_OUT_OF_RANGE",
+    "EERROR_FILE_ERR",
 
     // NETWORK
     "EERROR_NET_SOCKET_ERR",
@@ -46,14 +48,21 @@ namespace             ELib
     "EERROR_NET_SERVER_STATE",
     "EERROR_NET_CLIENT_ERR",
     "EERROR_NET_CLIENT_STATE",
+    "EERROR_NET_SCHEDULER_STATE",
+    "EERROR_NET_GATEWAY_ERR",
+    "EERROR_NET_GATEWAY_STATE",
+    "EERROR_NET_BUS_STATE",
+    "EERROR_NET_PACER_STATE",
+    "EERROR_NET_BUDGET",
+    "EERROR_NET_CAPTURE_STATE",
+    "EERROR_NET_IMPAIRMENT_STATE",
 
     // SQL
-    "EERROR_SQL_MYSQL_ERROR",
-    "EERROR_SQL_NOT_CONNECTED",
-    "EERROR_SQL_FIELD_INVALID",
-    "EERROR_SQL_OUT_OF_RANGE",
-    "EERROR_SQL_WRONG_PADDING",
-    "EERROR_SQL_RESULT_FAILURE",
+    "EERROR_SQL_STATE",
+    "EERROR_SQL_MYSQL_ERR",
+    "EERROR_SQL_FIELD_ERR",
+    "EERROR_SQL_ROW_ERR",
+    "EERROR_SQL_RESULT_ERR",
 
     // END
     "EERROR_COUNT"
@@ -0,0 +1,432 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for EMetrics handling tools.
+*/
+
+#include <sstream>
+#include <intrin.h>
+#include "EGlobals/EGlobal.h"
+#include "EGlobals/EMetrics.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                   ELib
+{
+
+  /**
+    @brief Unique definition for global __gEMetrics.
+  */
+  ELib::EMetrics            __gEMetrics;
+
+  /**
+    @brief EMetricsCounter definitions.
+  */
+  const std::string         EMetricsCounterDefinitions[] =
+  {
+    "accepted",
+    "closed",
+    "bytes_in",
+    "bytes_out",
+    "datagrams_in",
+    "datagrams_out",
+    "sql_queries"
+  };
+
+  /**
+    @brief EMetricsGauge definitions.
+  */
+  const std::string         EMetricsGaugeDefinitions[] =
+  {
+    "connections",
+    "selectors",
+    "queued"
+  };
+
+  /**
+    @brief EMetricsHistogram definitions.
+  */
+  const std::string         EMetricsHistogramDefinitions[] =
+  {
+    "recv_ns",
+    "sql_ns"
+  };
+
+  /**
+    @brief EMetricsLatency definitions.
+  */
+  const std::string         EMetricsLatencyDefinitions[] =
+  {
+    "queue_ns",
+    "handler_ns"
+  };
+
+  /**
+    @brief Threads already given a shard, so next thread takes the next shard.
+  */
+  static volatile LONG      s_threads = 0;
+
+  /**
+    @brief Get count of values of buckets.
+    @param p_buckets Buckets.
+    @param p_size Number of buckets.
+    @return Count of values.
+  */
+  static uint64             countBuckets(const uint64 *p_buckets, uint32 p_size)
+  {
+    uint64                  l_count = 0;
+
+    for (uint32 l_bucket = 0; l_bucket < p_size; ++l_bucket)
+    {
+      l_count += p_buckets[l_bucket];
+    }
+
+    return (l_count);
+  }
+
+  /**
+    @brief Get a percentile of buckets.
+    @details Result is the upper bound of the bucket holding the percentile, so it is at most twice the exact value.
+    @param p_buckets Buckets.
+    @param p_size Number of buckets.
+    @param p_ratio Percentile, between 0 and 1.
+    @return Upper bound of percentile. 0 if buckets are empty.
+  */
+  static uint64             percentileBuckets(const uint64 *p_buckets, uint32 p_size, double p_ratio)
+  {
+    uint64                  l_count = countBuckets(p_buckets, p_size);
+    uint64                  l_rank = static_cast<uint64>(p_ratio * l_count);
+    uint64                  l_value = 0;
+    uint64                  l_seen = 0;
+
+    for (uint32 l_bucket = 0; (l_bucket < p_size) && (0 != l_count); ++l_bucket)
+    {
+      l_seen += p_buckets[l_bucket];
+      if (l_seen > l_rank)
+      {
+        l_value = (0 == l_bucket) ? 0 : ((1ULL << (l_bucket - 1)) << 1) - 1;
+        l_count = 0;
+      }
+    }
+
+    return (l_value);
+  }
+
+  /**
+    @brief Get bucket of a value.
+    @param p_value Value.
+    @param p_size Number of buckets. Values over the last bucket are counted in it.
+    @return Bucket of value.
+  */
+  static uint32             getBucket(uint64 p_value, uint32 p_size)
+  {
+    unsigned long           l_index = 0;
+    uint32                  l_bucket = 0;
+
+    if (0 != _BitScanReverse64(&l_index, p_value))
+    {
+      l_bucket = min(static_cast<uint32>(l_index + 1), p_size - 1);
+    }
+
+    return (l_bucket);
+  }
+
+  /**
+    @brief Get count of values of an histogram.
+    @param p_histogram EMetricsHistogram.
+    @return Count of values.
+  */
+  uint64                    EMetricsSnapshot::getCount(EMetricsHistogram p_histogram) const
+  {
+    return (countBuckets(m_buckets[p_histogram], EMETRICS_BUCKETS));
+  }
+
+  /**
+    @brief Get a percentile of an histogram.
+    @details Result is the upper bound of the bucket holding the percentile, so it is at most twice the exact value.
+    @param p_histogram EMetricsHistogram.
+    @param p_ratio Percentile, between 0 and 1.
+    @return Upper bound of percentile. 0 if histogram is empty.
+  */
+  uint64                    EMetricsSnapshot::getPercentile(EMetricsHistogram p_histogram, double p_ratio) const
+  {
+    return (percentileBuckets(m_buckets[p_histogram], EMETRICS_BUCKETS, p_ratio));
+  }
+
+  /**
+    @brief Get count of values of a latency.
+    @param p_latency EMetricsLatency.
+    @param p_type ENetPacketType. Higher types than EMETRICS_TYPES share the last one.
+    @return Count of values.
+  */
+  uint64                    EMetricsSnapshot::getCount(EMetricsLatency p_latency, uint32 p_type) const
+  {
+    return (countBuckets(m_latencies[p_latency][min(p_type, static_cast<uint32>(EMETRICS_TYPES - 1))], EMETRICS_LATENCY_BUCKETS));
+  }
+
+  /**
+    @brief Get a percentile of a latency.
+    @details Result is the upper bound of the bucket holding the percentile, so it is at most twice the exact value.
+    @param p_latency EMetricsLatency.
+    @param p_type ENetPacketType. Higher types than EMETRICS_TYPES share the last one.
+    @param p_ratio Percentile, between 0 and 1.
+    @return Upper bound of percentile. 0 if latency is empty.
+  */
+  uint64                    EMetricsSnapshot::getPercentile(EMetricsLatency p_latency, uint32 p_type, double p_ratio) const
+  {
+    return (percentileBuckets(m_latencies[p_latency][min(p_type, static_cast<uint32>(EMETRICS_TYPES - 1))], EMETRICS_LATENCY_BUCKETS, p_ratio));
+  }
+
+  /**
+    @brief Format EMetricsSnapshot, one "name value" per line.
+    @details Zero values of ENetPacketType, EErrorCode and latencies are skipped.
+    @return Formatted EMetricsSnapshot.
+  */
+  const std::string         EMetricsSnapshot::toString() const
+  {
+    std::ostringstream      l_stream;
+
+    for (uint32 l_counter = 0; l_counter < EMETRICS_COUNTER_COUNT; ++l_counter)
+    {
+      l_stream << EMetricsCounterDefinitions[l_counter] << " " << m_counters[l_counter] << std::endl;
+    }
+    for (uint32 l_gauge = 0; l_gauge < EMETRICS_GAUGE_COUNT; ++l_gauge)
+    {
+      l_stream << EMetricsGaugeDefinitions[l_gauge] << " " << m_gauges[l_gauge] << std::endl;
+    }
+    for (uint32 l_type = 0; l_type < EMETRICS_TYPES; ++l_type)
+    {
+      if ((0 != m_packetsIn[l_type])
+        || (0 != m_packetsOut[l_type]))
+      {
+        l_stream << "packets_in{type=" << l_type << "} " << m_packetsIn[l_type] << std::endl;
+        l_stream << "packets_out{type=" << l_type << "} " << m_packetsOut[l_type] << std::endl;
+      }
+    }
+    for (uint32 l_code = EERROR_NONE + 1; l_code < EERROR_COUNT; ++l_code)
+    {
+      if (0 != m_errors[l_code])
+      {
+        l_stream << "errors{code=" << EErrorDefinitions[l_code] << "} " << m_errors[l_code] << std::endl;
+      }
+    }
+    for (uint32 l_histogram = 0; l_histogram < EMETRICS_HISTOGRAM_COUNT; ++l_histogram)
+    {
+      EMetricsHistogram     l_id = static_cast<EMetricsHistogram>(l_histogram);
+
+      l_stream << EMetricsHistogramDefinitions[l_histogram] << "{count} " << getCount(l_id) << std::endl;
+      l_stream << EMetricsHistogramDefinitions[l_histogram] << "{sum} " << m_sums[l_histogram] << std::endl;
+      l_stream << EMetricsHistogramDefinitions[l_histogram] << "{p50} " << getPercentile(l_id, 0.5) << std::endl;
+      l_stream << EMetricsHistogramDefinitions[l_histogram] << "{p99} " << getPercentile(l_id, 0.99) << std::endl;
+      l_stream << EMetricsHistogramDefinitions[l_histogram] << "{p999} " << getPercentile(l_id, 0.999) << std::endl;
+    }
+    for (uint32 l_latency = 0; l_latency < EMETRICS_LATENCY_COUNT; ++l_latency)
+    {
+      EMetricsLatency       l_id = static_cast<EMetricsLatency>(l_latency);
+
+      for (uint32 l_type = 0; l_type < EMETRICS_TYPES; ++l_type)
+      {
+        if (0 != getCount(l_id, l_type))
+        {
+          l_stream << EMetricsLatencyDefinitions[l_latency] << "{type=" << l_type << ",count} " << getCount(l_id, l_type) << std::endl;
+          l_stream << EMetricsLatencyDefinitions[l_latency] << "{type=" << l_type << ",p50} " << getPercentile(l_id, l_type, 0.5) << std::endl;
+          l_stream << EMetricsLatencyDefinitions[l_latency] << "{type=" << l_type << ",p99} " << getPercentile(l_id, l_type, 0.99) << std::endl;
+          l_stream << EMetricsLatencyDefinitions[l_latency] << "{type=" << l_type << ",p999} " << getPercentile(l_id, l_type, 0.999) << std::endl;
+        }
+      }
+    }
+
+    return (l_stream.str());
+  }
+
+  /**
+    @brief Constructor for EMetrics.
+    @details Shards are not reset: global EMetrics can be written before its construction.
+  */
+  EMetrics::EMetrics()
+  {
+  }
+
+  /**
+    @brief Destructor for EMetrics.
+  */
+  EMetrics::~EMetrics()
+  {
+  }
+
+  /**
+    @brief Increase a counter.
+    @param p_counter EMetricsCounter.
+    @param p_value Value added.
+  */
+  void                      EMetrics::add(EMetricsCounter p_counter, uint64 p_value)
+  {
+    InterlockedExchangeAdd64(&getShard().m_counters[p_counter], static_cast<LONG64>(p_value));
+  }
+
+  /**
+    @brief Move a gauge.
+    @param p_gauge EMetricsGauge.
+    @param p_delta Value added, negative to decrease.
+  */
+  void                      EMetrics::move(EMetricsGauge p_gauge, int64 p_delta)
+  {
+    InterlockedExchangeAdd64(&getShard().m_gauges[p_gauge], p_delta);
+  }
+
+  /**
+    @brief Count an ENetPacket stored into an ENetPacketHandler.
+    @param p_type ENetPacketType.
+  */
+  void                      EMetrics::packetIn(uint32 p_type)
+  {
+    InterlockedExchangeAdd64(&getShard().m_packetsIn[min(p_type, static_cast<uint32>(EMETRICS_TYPES - 1))], 1);
+  }
+
+  /**
+    @brief Count an ENetPacket sent.
+    @param p_type ENetPacketType.
+  */
+  void                      EMetrics::packetOut(uint32 p_type)
+  {
+    InterlockedExchangeAdd64(&getShard().m_packetsOut[min(p_type, static_cast<uint32>(EMETRICS_TYPES - 1))], 1);
+  }
+
+  /**
+    @brief Count an EError.
+    @param p_code EErrorCode set.
+  */
+  void                      EMetrics::error(EErrorCode p_code)
+  {
+    if ((EERROR_NONE <= p_code)
+      && (EERROR_COUNT > p_code))
+    {
+      InterlockedExchangeAdd64(&getShard().m_errors[p_code], 1);
+    }
+  }
+
+  /**
+    @brief Record a value into an histogram.
+    @param p_histogram EMetricsHistogram.
+    @param p_value Value, in nanoseconds.
+  */
+  void                      EMetrics::record(EMetricsHistogram p_histogram, uint64 p_value)
+  {
+    EMetricsShard           &l_shard = getShard();
+
+    InterlockedExchangeAdd64(&l_shard.m_buckets[p_histogram][getBucket(p_value, EMETRICS_BUCKETS)], 1);
+    InterlockedExchangeAdd64(&l_shard.m_sums[p_histogram], static_cast<LONG64>(p_value));
+  }
+
+  /**
+    @brief Record time elapsed since a performance counter into an histogram.
+    @param p_histogram EMetricsHistogram.
+    @param p_start Performance counter at start.
+  */
+  void                      EMetrics::time(EMetricsHistogram p_histogram, LONGLONG p_start)
+  {
+    LARGE_INTEGER           l_now = { 0 };
+
+    QueryPerformanceCounter(&l_now);
+    record(p_histogram, toNanoseconds(l_now.QuadPart - p_start));
+  }
+
+  /**
+    @brief Record a latency of an ENetPacketType between two performance counters.
+    @param p_latency EMetricsLatency.
+    @param p_type ENetPacketType. Higher types than EMETRICS_TYPES share the last one.
+    @param p_start Performance counter at start.
+    @param p_end Performance counter at end.
+  */
+  void                      EMetrics::latency(EMetricsLatency p_latency, uint32 p_type, LONGLONG p_start, LONGLONG p_end)
+  {
+    uint64                  l_value = (p_end > p_start) ? toNanoseconds(p_end - p_start) : 0;
+
+    InterlockedExchangeAdd64(&getShard().m_latencies[p_latency][min(p_type, static_cast<uint32>(EMETRICS_TYPES - 1))][getBucket(l_value, EMETRICS_LATENCY_BUCKETS)], 1);
+  }
+
+  /**
+    @brief Merge shards into a snapshot.
+    @details Writers are never stopped: each value is read once, without lock.
+    @param p_snapshot EMetricsSnapshot to be filled.
+  */
+  void                      EMetrics::snapshot(EMetricsSnapshot &p_snapshot) const
+  {
+    memset(&p_snapshot, 0, sizeof(EMetricsSnapshot));
+    for (uint32 l_index = 0; l_index < EMETRICS_SHARDS; ++l_index)
+    {
+      const EMetricsShard   &l_shard = m_shards[l_index];
+
+      for (uint32 l_i = 0; l_i < EMETRICS_COUNTER_COUNT; ++l_i)
+      {
+        p_snapshot.m_counters[l_i] += l_shard.m_counters[l_i];
+      }
+      for (uint32 l_i = 0; l_i < EMETRICS_GAUGE_COUNT; ++l_i)
+      {
+        p_snapshot.m_gauges[l_i] += l_shard.m_gauges[l_i];
+      }
+      for (uint32 l_i = 0; l_i < EMETRICS_TYPES; ++l_i)
+      {
+        p_snapshot.m_packetsIn[l_i] += l_shard.m_packetsIn[l_i];
+        p_snapshot.m_packetsOut[l_i] += l_shard.m_packetsOut[l_i];
+      }
+      for (uint32 l_i = 0; l_i < EERROR_COUNT; ++l_i)
+      {
+        p_snapshot.m_errors[l_i] += l_shard.m_errors[l_i];
+      }
+      for (uint32 l_i = 0; l_i < EMETRICS_HISTOGRAM_COUNT; ++l_i)
+      {
+        for (uint32 l_bucket = 0; l_bucket < EMETRICS_BUCKETS; ++l_bucket)
+        {
+          p_snapshot.m_buckets[l_i][l_bucket] += l_shard.m_buckets[l_i][l_bucket];
+        }
+        p_snapshot.m_sums[l_i] += l_shard.m_sums[l_i];
+      }
+      for (uint32 l_i = 0; l_i < EMETRICS_LATENCY_COUNT; ++l_i)
+      {
+        for (uint32 l_type = 0; l_type < EMETRICS_TYPES; ++l_type)
+        {
+          for (uint32 l_bucket = 0; l_bucket < EMETRICS_LATENCY_BUCKETS; ++l_bucket)
+          {
+            p_snapshot.m_latencies[l_i][l_type][l_bucket] += l_shard.m_latencies[l_i][l_type][l_bucket];
+          }
+        }
+      }
+    }
+  }
+
+  /**
+    @brief Get shard of calling thread, given round robin on its first call.
+    @return Shard of calling thread.
+  */
+  EMetricsShard             &EMetrics::getShard()
+  {
+    static thread_local LONG l_index = -1;
+
+    if (-1 == l_index)
+    {
+      l_index = (InterlockedIncrement(&s_threads) - 1) % EMETRICS_SHARDS;
+    }
+
+    return (m_shards[l_index]);
+  }
+
+  /**
+    @brief Convert performance counter ticks to nanoseconds.
+    @param p_ticks Performance counter ticks.
+    @return Nanoseconds.
+  */
+  uint64                    EMetrics::toNanoseconds(LONGLONG p_ticks)
+  {
+    static LARGE_INTEGER    l_frequency = { 0 };
+
+    if (0 == l_frequency.QuadPart)
+    {
+      QueryPerformanceFrequency(&l_frequency);
+    }
+
+    return (static_cast<uint64>(p_ticks * 1000000000.0 / l_frequency.QuadPart));
+  }
+
+}
@@ -0,0 +1,222 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ETrace handling tools.
+*/
+
+#include <fstream>
+#include "EGlobals/EGlobal.h"
+#include "EGlobals/ETrace.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                   ELib
+{
+
+  /**
+    @brief Unique definition for global __gETrace.
+  */
+  ELib::ETrace              __gETrace;
+
+  /**
+    @brief ETraceEvent definitions.
+  */
+  const std::string         ETraceEventDefinitions[] =
+  {
+    "select",
+    "flush",
+    "recv",
+    "queue",
+    "handler"
+  };
+
+  /**
+    @brief Constructor for ETrace. Sampling is disabled.
+  */
+  ETrace::ETrace() :
+    m_buffers(),
+    m_sampling(0),
+    m_origin(0),
+    m_frequency(0),
+    m_mutex(nullptr)
+  {
+    LARGE_INTEGER           l_value = { 0 };
+
+    QueryPerformanceFrequency(&l_value);
+    m_frequency = l_value.QuadPart;
+    QueryPerformanceCounter(&l_value);
+    m_origin = l_value.QuadPart;
+    m_mutex = CreateMutex(nullptr, false, nullptr);
+  }
+
+  /**
+    @brief Destructor for ETrace.
+    @details Delete rings of every traced thread, release their thread handles.
+  */
+  ETrace::~ETrace()
+  {
+    m_sampling = 0;
+    WaitForSingleObject(m_mutex, INFINITE);
+    while (false == m_buffers.empty())
+    {
+      if (nullptr != m_buffers.back()->m_thread)
+      {
+        CloseHandle(m_buffers.back()->m_thread);
+      }
+      delete (m_buffers.back());
+      m_buffers.pop_back();
+    }
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Set sampling of spans.
+    @param p_rate 1 of p_rate spans of each thread is traced, 0 to disable tracing.
+  */
+  void                      ETrace::setSampling(uint32 p_rate)
+  {
+    InterlockedExchange(&m_sampling, static_cast<LONG>(p_rate));
+  }
+
+  /**
+    @brief Start a span.
+    @return Performance counter at start if span is sampled.
+    @return 0 otherwise.
+  */
+  LONGLONG                  ETrace::begin()
+  {
+    static thread_local uint32 l_count = 0;
+    LONG                    l_sampling = m_sampling;
+    LARGE_INTEGER           l_now = { 0 };
+
+    if ((0 != l_sampling)
+      && (0 == (++l_count % static_cast<uint32>(l_sampling))))
+    {
+      QueryPerformanceCounter(&l_now);
+    }
+
+    return (l_now.QuadPart);
+  }
+
+  /**
+    @brief End a span into the ring of calling thread.
+    @details Spans not sampled are ignored.
+    @details Span is published by an Interlocked increment of m_next, once it is written.
+    @param p_event Traced stage.
+    @param p_start Value returned by begin().
+    @param p_id Identifier of traced object.
+    @return Performance counter at end if span is sampled, so next stage can start from it.
+    @return 0 otherwise.
+  */
+  LONGLONG                  ETrace::end(ETraceEvent p_event, LONGLONG p_start, uint64 p_id)
+  {
+    LARGE_INTEGER           l_now = { 0 };
+
+    if (0 != p_start)
+    {
+      ETraceBuffer          *l_buffer = getBuffer();
+      ETraceSpan            &l_span = l_buffer->m_spans[l_buffer->m_next % ETRACE_CAPACITY];
+
+      QueryPerformanceCounter(&l_now);
+      l_span.m_event = p_event;
+      l_span.m_id = p_id;
+      l_span.m_start = p_start;
+      l_span.m_end = l_now.QuadPart;
+      InterlockedIncrement64(&l_buffer->m_next);
+    }
+
+    return (l_now.QuadPart);
+  }
+
+  /**
+    @brief Write spans of every thread as Chrome trace JSON. /!\ Mutex. /!\ EError.
+    @details Each span is a complete event ("ph":"X") of its thread, timestamps in microseconds since construction.
+    @details Best-effort while tracing runs: only published spans are read, and a span that may be overwritten while it is read
+      is skipped. Disable sampling first for a complete dump.
+    @param p_path Path of the JSON file, overwritten.
+  */
+  void                      ETrace::dump(const std::string &p_path) const
+  {
+    std::ofstream           l_file(p_path, std::ios::out | std::ios::trunc);
+
+    mEERROR_R();
+    if (false == l_file.is_open())
+    {
+      mEERROR_SA(EERROR_FILE_ERR, p_path);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      bool                  l_isFirst = true;
+
+      l_file << "{\"traceEvents\":[" << std::endl;
+      l_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ELib\"}}";
+      WaitForSingleObject(m_mutex, INFINITE);
+      for (std::vector<ETraceBuffer*>::const_iterator l_it = m_buffers.begin(); l_it != m_buffers.end(); ++l_it)
+      {
+        LONG64              l_next = InterlockedCompareExchange64(&(*l_it)->m_next, 0, 0);
+        LONG64              l_first = (ETRACE_CAPACITY < l_next) ? l_next - ETRACE_CAPACITY : 0;
+
+        for (LONG64 l_index = l_first; l_index < l_next; ++l_index)
+        {
+          ETraceSpan        l_span = (*l_it)->m_spans[l_index % ETRACE_CAPACITY];
+
+          if (l_index + ETRACE_CAPACITY > InterlockedCompareExchange64(&(*l_it)->m_next, 0, 0) + 1)
+          {
+            l_file << "," << std::endl << "{\"name\":\"" << ETraceEventDefinitions[l_span.m_event]
+              << "\",\"cat\":\"ELib\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (*l_it)->m_threadId
+              << ",\"ts\":" << (l_span.m_start - m_origin) * 1000000.0 / m_frequency
+              << ",\"dur\":" << (l_span.m_end - l_span.m_start) * 1000000.0 / m_frequency
+              << ",\"args\":{\"id\":" << l_span.m_id << "}}";
+          }
+        }
+      }
+      ReleaseMutex(m_mutex);
+      l_file << std::endl << "]}" << std::endl;
+      if (false == l_file.good())
+      {
+        mEERROR_SA(EERROR_FILE_ERR, p_path);
+      }
+    }
+  }
+
+  /**
+    @brief Get ring of calling thread, given on its first span. /!\ Mutex.
+    @details Ring of an exited thread is reused, a new one is created if every ring has a living thread.
+    @return Ring of calling thread.
+  */
+  ETraceBuffer              *ETrace::getBuffer()
+  {
+    static thread_local ETraceBuffer *l_buffer = nullptr;
+
+    if (nullptr == l_buffer)
+    {
+      HANDLE                l_thread = OpenThread(SYNCHRONIZE, false, GetCurrentThreadId());
+
+      WaitForSingleObject(m_mutex, INFINITE);
+      for (std::vector<ETraceBuffer*>::iterator l_it = m_buffers.begin(); (nullptr == l_buffer) && (l_it != m_buffers.end()); ++l_it)
+      {
+        if ((nullptr != (*l_it)->m_thread)
+          && (WAIT_OBJECT_0 == WaitForSingleObject((*l_it)->m_thread, 0)))
+        {
+          CloseHandle((*l_it)->m_thread);
+          l_buffer = *l_it;
+        }
+      }
+      if (nullptr == l_buffer)
+      {
+        l_buffer = new ETraceBuffer();
+        m_buffers.push_back(l_buffer);
+      }
+      l_buffer->m_threadId = GetCurrentThreadId();
+      l_buffer->m_thread = l_thread;
+      InterlockedExchange64(&l_buffer->m_next, 0);
+      ReleaseMutex(m_mutex);
+    }
+
+    return (l_buffer);
+  }
+
+}
@@ -0,0 +1,261 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetBudget Class.
+*/
+
+#include "ENetwork/ENetBudget.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Constructor for ENetBudget.
+  */
+  ENetBudget::ENetBudget() :
+    m_shards(),
+    m_connection(0),
+    m_global(0),
+    m_usage(0),
+    m_shed(0)
+  {
+  }
+
+  /**
+    @brief Destructor for ENetBudget.
+    @details Release mutex of its shards.
+  */
+  ENetBudget::~ENetBudget()
+  {
+    for (uint32 l_index = 0; l_index < ENETBUDGET_SHARDS; ++l_index)
+    {
+      ReleaseMutex(m_shards[l_index].m_mutex);
+      CloseHandle(m_shards[l_index].m_mutex);
+    }
+  }
+
+  /**
+    @brief Singleton for ENetBudget. /!\ EError.
+    @details Initialize mutex of its shards.
+    @return ENetBudget unique instance on success.
+    @return nullptr on failure.
+  */
+  ENetBudget                  *ENetBudget::getInstance()
+  {
+    static ENetBudget         *l_instance = nullptr;
+
+    mEERROR_R();
+    if (nullptr == l_instance)
+    {
+      ENetBudget              *l_budget = nullptr;
+      uint32                  l_index = 0;
+
+      l_budget = new ENetBudget();
+      if (nullptr != l_budget)
+      {
+        while ((EERROR_NONE == mEERROR) && (l_index < ENETBUDGET_SHARDS))
+        {
+          l_budget->m_shards[l_index].m_mutex = CreateMutex(nullptr, false, nullptr);
+          if (nullptr != l_budget->m_shards[l_index].m_mutex)
+          {
+            ++l_index;
+          }
+          else
+          {
+            mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+          }
+        }
+        if (EERROR_NONE == mEERROR)
+        {
+          l_instance = l_budget;
+        }
+        else
+        {
+          delete (l_budget);
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_MEMORY);
+      }
+    }
+
+    return (l_instance);
+  }
+
+  /**
+    @brief Set budgets.
+    @details Bytes already reserved are kept, even over new budgets.
+    @details Bytes allocated while there was no budget are not accounted.
+    @param p_connection Bytes reserved by each connection, 0 for no budget.
+    @param p_global Bytes reserved by all connections, 0 for no budget.
+  */
+  void                        ENetBudget::setLimits(uint64 p_connection, uint64 p_global)
+  {
+    InterlockedExchange64(&m_connection, static_cast<LONG64>(p_connection));
+    InterlockedExchange64(&m_global, static_cast<LONG64>(p_global));
+  }
+
+  /**
+    @brief Reserve bytes for a connection. /!\ Mutex.
+    @details Nothing is reserved, and no mutex is taken, while there is no budget.
+    @details Only shard of connection is locked. Global usage is added atomically, and taken back if it overflows.
+    @param p_socket Connected ENetSocket.
+    @param p_bytes Bytes to be allocated.
+    @return true if bytes fit both budgets, and are reserved, or if there is no budget.
+    @return false if a budget would be exceeded. Nothing is reserved.
+  */
+  bool                        ENetBudget::reserve(const ENetSocket *p_socket, uint64 p_bytes)
+  {
+    uint64                    l_connection = static_cast<uint64>(m_connection);
+    uint64                    l_global = static_cast<uint64>(m_global);
+    bool                      l_ret = true;
+
+    if ((0 != l_connection) || (0 != l_global))
+    {
+      ENetBudgetShard         &l_shard = getShard(p_socket);
+
+      WaitForSingleObject(l_shard.m_mutex, INFINITE);
+      uint64                  &l_usage = l_shard.m_usages[p_socket];
+
+      l_ret = false;
+      if ((0 == l_connection) || (l_connection >= l_usage + p_bytes))
+      {
+        uint64                l_total = static_cast<uint64>(InterlockedExchangeAdd64(&m_usage, static_cast<LONG64>(p_bytes))) + p_bytes;
+
+        if ((0 == l_global) || (l_global >= l_total))
+        {
+          l_usage += p_bytes;
+          l_ret = true;
+        }
+        else
+        {
+          InterlockedExchangeAdd64(&m_usage, -static_cast<LONG64>(p_bytes));
+        }
+      }
+      ReleaseMutex(l_shard.m_mutex);
+      if (false == l_ret)
+      {
+        InterlockedIncrement64(&m_shed);
+      }
+    }
+
+    return (l_ret);
+  }
+
+  /**
+    @brief Give back bytes reserved for a connection. /!\ Mutex.
+    @details Ignored if nothing is reserved by any connection, without taking a mutex.
+    @details Ignored if connection was forgotten: its bytes were already given back.
+    @param p_socket Connected ENetSocket.
+    @param p_bytes Bytes freed.
+  */
+  void                        ENetBudget::release(const ENetSocket *p_socket, uint64 p_bytes)
+  {
+    if (0 != m_usage)
+    {
+      ENetBudgetShard         &l_shard = getShard(p_socket);
+      std::unordered_map<const ENetSocket*, uint64>::iterator l_it;
+
+      WaitForSingleObject(l_shard.m_mutex, INFINITE);
+      l_it = l_shard.m_usages.find(p_socket);
+      if (l_shard.m_usages.end() != l_it)
+      {
+        p_bytes = min(p_bytes, l_it->second);
+        l_it->second -= p_bytes;
+        InterlockedExchangeAdd64(&m_usage, -static_cast<LONG64>(p_bytes));
+      }
+      ReleaseMutex(l_shard.m_mutex);
+    }
+  }
+
+  /**
+    @brief Give back every byte reserved for a closed connection. /!\ Mutex.
+    @param p_socket Connected ENetSocket.
+  */
+  void                        ENetBudget::forget(const ENetSocket *p_socket)
+  {
+    ENetBudgetShard           &l_shard = getShard(p_socket);
+    std::unordered_map<const ENetSocket*, uint64>::iterator l_it;
+
+    WaitForSingleObject(l_shard.m_mutex, INFINITE);
+    l_it = l_shard.m_usages.find(p_socket);
+    if (l_shard.m_usages.end() != l_it)
+    {
+      InterlockedExchangeAdd64(&m_usage, -static_cast<LONG64>(l_it->second));
+      l_shard.m_usages.erase(l_it);
+    }
+    ReleaseMutex(l_shard.m_mutex);
+  }
+
+  /**
+    @brief Check if a connection can receive datas. /!\ Mutex.
+    @details Shard of connection is locked only if there is a connection budget.
+    @param p_socket Connected ENetSocket.
+    @return true if neither connection budget nor global budget is exhausted.
+  */
+  bool                        ENetBudget::isAvailable(const ENetSocket *p_socket) const
+  {
+    uint64                    l_connection = static_cast<uint64>(m_connection);
+    uint64                    l_global = static_cast<uint64>(m_global);
+
+    return (((0 == l_global) || (l_global > static_cast<uint64>(m_usage)))
+      && ((0 == l_connection) || (l_connection > getUsage(p_socket))));
+  }
+
+  /**
+    @brief Get bytes reserved for a connection. /!\ Mutex.
+    @param p_socket Connected ENetSocket.
+    @return Reserved bytes.
+  */
+  uint64                      ENetBudget::getUsage(const ENetSocket *p_socket) const
+  {
+    ENetBudgetShard           &l_shard = getShard(p_socket);
+    std::unordered_map<const ENetSocket*, uint64>::const_iterator l_it;
+    uint64                    l_usage = 0;
+
+    WaitForSingleObject(l_shard.m_mutex, INFINITE);
+    l_it = l_shard.m_usages.find(p_socket);
+    if (l_shard.m_usages.end() != l_it)
+    {
+      l_usage = l_it->second;
+    }
+    ReleaseMutex(l_shard.m_mutex);
+
+    return (l_usage);
+  }
+
+  /**
+    @brief Get bytes reserved for all connections.
+    @return Reserved bytes.
+  */
+  uint64                      ENetBudget::getGlobalUsage() const
+  {
+    return (static_cast<uint64>(m_usage));
+  }
+
+  /**
+    @brief Get number of refused reservations.
+    @return Number of shed reservations.
+  */
+  uint64                      ENetBudget::getShed() const
+  {
+    return (static_cast<uint64>(m_shed));
+  }
+
+  /**
+    @brief Get shard of a connection, from its address.
+    @param p_socket Connected ENetSocket.
+    @return Shard holding reserved bytes of connection.
+  */
+  ENetBudgetShard             &ENetBudget::getShard(const ENetSocket *p_socket) const
+  {
+    uintptr_t                 l_address = reinterpret_cast<uintptr_t>(p_socket);
+
+    return (m_shards[((l_address >> 6) ^ (l_address >> 12)) % ENETBUDGET_SHARDS]);
+  }
+
+}
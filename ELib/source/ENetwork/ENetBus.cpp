@@ -0,0 +1,653 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetBus Class.
+*/
+
+#include "ENetwork/ENetBus.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Functor for ENetBus::run(). /!\ EError.
+    @param p_bus ENetBus caller.
+    @return Unused.
+  */
+  DWORD WINAPI                BusRunFunctor(LPVOID p_bus)
+  {
+    mEERROR_R();
+    if (nullptr != p_bus)
+    {
+      static_cast<ENetBus*>(p_bus)->run();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Constructor for ENetBus.
+    @details Initialize its mutex, copy settings of ENetPacketHandler Singleton in its ENetPacketHandler.
+    @details Sequences start from the clock, so a restarted node is not taken for a duplicate by its peers.
+    @param p_node Identifier of this node, unique in the cluster.
+  */
+  ENetBus::ENetBus(uint32 p_node) :
+    m_node(p_node),
+    m_handler(),
+    m_listener(&m_handler),
+    m_peers(),
+    m_batch(),
+    m_count(0),
+    m_sequence(0),
+    m_windows(),
+    m_duplicates(0),
+    m_server(nullptr),
+    m_receiver(nullptr),
+    m_context(nullptr),
+    m_mutex(nullptr),
+    m_threadRun(nullptr),
+    m_isRunning(false)
+  {
+    m_sequence = GetTickCount64() << 16;
+    m_mutex = CreateMutex(nullptr, false, nullptr);
+    if (nullptr != ENetPacketHandler::getInstance())
+    {
+      m_handler.copySettings(*ENetPacketHandler::getInstance());
+    }
+  }
+
+  /**
+    @brief Destructor for ENetBus.
+    @details Stop its thread, release its mutex, delete its ENetClients.
+  */
+  ENetBus::~ENetBus()
+  {
+    if (true == m_isRunning)
+    {
+      stop();
+    }
+    while (false == m_peers.empty())
+    {
+      delete (m_peers.begin()->second.m_client);
+      m_peers.erase(m_peers.begin());
+    }
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Initialize ENetBus. /!\ EError.
+    @details Prepare ENetServer accepting peers.
+    @param p_hostname Internet host address in number-and-dots notation.
+    @param p_port Port of the host.
+  */
+  void                        ENetBus::init(const std::string &p_hostname, uint16 p_port)
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_BUS_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_listener.init(p_hostname, p_port);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SERVER_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Connect a peer to ENetBus. /!\ Mutex. /!\ EError.
+    @details Every node must add every other node: links are one way, from publisher to receiver.
+    @param p_node Identifier of peer.
+    @param p_hostname Internet host address of peer in number-and-dots notation.
+    @param p_port Port of peer.
+  */
+  void                        ENetBus::addPeer(uint32 p_node, const std::string &p_hostname, uint16 p_port)
+  {
+    ENetClient                *l_client = nullptr;
+
+    mEERROR_R();
+    if (nullptr == m_mutex)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if (m_node == p_node)
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      l_client = new ENetClient(&m_handler);
+      if (nullptr != l_client)
+      {
+        l_client->init(p_hostname, p_port);
+        if (EERROR_NONE == mEERROR)
+        {
+          l_client->start();
+        }
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_CLIENT_ERR);
+          delete (l_client);
+          l_client = nullptr;
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_MEMORY);
+      }
+    }
+    if (EERROR_NONE == mEERROR)
+    {
+      WaitForSingleObject(m_mutex, INFINITE);
+      if (m_peers.end() == m_peers.find(p_node))
+      {
+        ENetBusPeer           l_peer = { l_client, p_hostname, p_port, 0, ENETBUS_RETRY };
+
+        m_peers[p_node] = l_peer;
+        mEPRINT_STD("ENetBus: Node " + std::to_string(m_node) + " linked to node " + std::to_string(p_node) + ".");
+      }
+      else
+      {
+        mEERROR_S(EERROR_OUT_OF_RANGE);
+        delete (l_client);
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Disconnect a peer from ENetBus. /!\ Mutex. /!\ EError.
+    @param p_node Identifier of peer.
+  */
+  void                        ENetBus::removePeer(uint32 p_node)
+  {
+    mEERROR_R();
+    if (nullptr == m_mutex)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::map<uint32, ENetBusPeer>::iterator l_peer;
+
+      WaitForSingleObject(m_mutex, INFINITE);
+      l_peer = m_peers.find(p_node);
+      if (m_peers.end() != l_peer)
+      {
+        m_handler.cleanSocket(l_peer->second.m_client->getSocket());
+        delete (l_peer->second.m_client);
+        m_peers.erase(l_peer);
+      }
+      else
+      {
+        mEERROR_S(EERROR_OUT_OF_RANGE);
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Start ENetBus automation. /!\ EError.
+    @details Start ENetServer accepting peers, create thread for run().
+  */
+  void                        ENetBus::start()
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_BUS_STATE);
+    }
+    if (nullptr == m_mutex)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_listener.start();
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SERVER_ERR);
+      }
+    }
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = true;
+      m_threadRun = CreateThread(nullptr, 0, BusRunFunctor, this, 0, nullptr);
+      if (nullptr != m_threadRun)
+      {
+        mEPRINT_STD("ENetBus: Node " + std::to_string(m_node) + " started successfully.");
+      }
+      else
+      {
+        m_isRunning = false;
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+      }
+    }
+  }
+
+  /**
+    @brief Stop ENetBus automation. /!\ Blocking. /!\ EError.
+    @details Wait for run() thread, which flushes last batch, stop ENetServer accepting peers.
+  */
+  void                        ENetBus::stop()
+  {
+    mEERROR_R();
+    if (false == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_BUS_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = false;
+      WaitForSingleObject(m_threadRun, INFINITE);
+      CloseHandle(m_threadRun);
+      m_threadRun = nullptr;
+      if (true == m_listener.isRunning())
+      {
+        m_listener.stop();
+      }
+      mEERROR_R();
+      mEPRINT_STD("ENetBus: Node " + std::to_string(m_node) + " stopped successfully.");
+    }
+  }
+
+  /**
+    @brief Loop of ENetBus. /!\ Blocking. /!\ Mutex.
+    @details Receive ENetPacketBus of peers, flush pending batch and reconnect lost peers every ENETBUS_FLUSH milliseconds.
+    @details Without ENetPacketBus, wait for the event of its ENetPacketHandler until next batch.
+  */
+  void                        ENetBus::run()
+  {
+    uint64                    l_flush = GetTickCount64() + ENETBUS_FLUSH;
+
+    while (true == m_isRunning)
+    {
+      ENetPacket              *l_packet = nullptr;
+      uint64                  l_now = 0;
+
+      ResetEvent(m_handler.getEvent());
+      l_packet = m_handler.popPacket();
+      if (nullptr != l_packet)
+      {
+        if (ENETPACKET_TYPE_BUS == l_packet->getType())
+        {
+          receive(static_cast<ENetPacketBus*>(l_packet));
+        }
+        delete (l_packet);
+      }
+      l_now = GetTickCount64();
+      if (l_flush <= l_now)
+      {
+        WaitForSingleObject(m_mutex, INFINITE);
+        flush();
+        ReleaseMutex(m_mutex);
+        reconnect();
+        l_flush = GetTickCount64() + ENETBUS_FLUSH;
+      }
+      else if (nullptr == l_packet)
+      {
+        WaitForSingleObject(m_handler.getEvent(), static_cast<DWORD>(l_flush - l_now));
+      }
+    }
+    WaitForSingleObject(m_mutex, INFINITE);
+    flush();
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Publish a message on every node. /!\ Mutex. /!\ EError.
+    @details Message is delivered locally at once, and sent to peers with next batch.
+    @param p_topic Topic of message, ENETBUS_TOPIC_BROADCAST for every client.
+    @param p_datas Datas of message.
+    @param p_len Datas length.
+  */
+  void                        ENetBus::publish(ENetTopicId p_topic, const char *p_datas, int32 p_len)
+  {
+    mEERROR_R();
+    if ((nullptr == p_datas)
+      && (0 != p_len))
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((0 > p_len)
+      || (ENETBUS_BATCH_MAX < p_len))
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      deliver(m_node, p_topic, p_datas, p_len);
+      WaitForSingleObject(m_mutex, INFINITE);
+      if (false == m_peers.empty())
+      {
+        if (ENETBUS_BATCH_MAX < (m_batch.size() + sizeof(ENetTopicId) + sizeof(int32) + p_len))
+        {
+          flush();
+        }
+        m_batch.append(reinterpret_cast<const char*>(&p_topic), sizeof(ENetTopicId));
+        m_batch.append(reinterpret_cast<const char*>(&p_len), sizeof(int32));
+        m_batch.append(p_datas, p_len);
+        ++m_count;
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Set ENetServer of local clients, used for ENETBUS_TOPIC_BROADCAST.
+    @param p_server ENetServer, nullptr for ENetServer Singleton.
+  */
+  void                        ENetBus::setServer(ENetServer *p_server)
+  {
+    m_server = p_server;
+  }
+
+  /**
+    @brief Set function receiving messages of ENetBus.
+    @param p_receiver ENetBusReceiver, nullptr for local delivery only.
+    @param p_context Context of function.
+  */
+  void                        ENetBus::setReceiver(ENetBusReceiver p_receiver, void *p_context)
+  {
+    m_receiver = p_receiver;
+    m_context = p_context;
+  }
+
+  /**
+    @brief Get identifier of this node.
+    @return Node identifier.
+  */
+  uint32                      ENetBus::getNode() const
+  {
+    return (m_node);
+  }
+
+  /**
+    @brief Get number of peers. /!\ Mutex.
+    @return Number of linked peers.
+  */
+  uint32                      ENetBus::getPeerCount() const
+  {
+    uint32                    l_count = 0;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_count = static_cast<uint32>(m_peers.size());
+    ReleaseMutex(m_mutex);
+
+    return (l_count);
+  }
+
+  /**
+    @brief Get number of batches dropped as duplicates.
+    @return Number of duplicates.
+  */
+  uint64                      ENetBus::getDuplicates() const
+  {
+    return (m_duplicates);
+  }
+
+  /**
+    @brief Get state of ENetBus.
+    @return State.
+  */
+  bool                        ENetBus::isRunning() const
+  {
+    return (m_isRunning);
+  }
+
+  /**
+    @brief Send pending batch to every peer. m_mutex must be held by caller.
+    @details Same ENetPacketBus, with a new sequence, is sent once on each link.
+  */
+  void                        ENetBus::flush()
+  {
+    mEERROR_R();
+    if (0 != m_count)
+    {
+      ENetPacketBus           l_packet;
+
+      l_packet.setOrigin(m_node);
+      l_packet.setSequence(++m_sequence);
+      l_packet.setDatas(m_batch, m_count);
+      for (std::map<uint32, ENetBusPeer>::iterator l_it = m_peers.begin(); l_it != m_peers.end(); ++l_it)
+      {
+        if (true == l_it->second.m_client->isRunning())
+        {
+          l_it->second.m_client->send(&l_packet);
+          if (EERROR_NONE != mEERROR)
+          {
+            mEERROR_SH(EERROR_NET_CLIENT_ERR);
+            mEERROR_R();
+          }
+        }
+      }
+      m_batch.clear();
+      m_count = 0;
+    }
+  }
+
+  /**
+    @brief Reconnect lost peers whose delay is over. /!\ Mutex. /!\ EError.
+    @details Connections are made without m_mutex, publish() is not blocked by an unreachable peer.
+    @details A new ENetClient replaces the lost one. On failure, delay of peer is doubled up to ENETBUS_RETRY_MAX.
+  */
+  void                        ENetBus::reconnect()
+  {
+    std::vector<std::pair<uint32, ENetBusPeer> > l_lost;
+    uint64                    l_now = GetTickCount64();
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    for (std::map<uint32, ENetBusPeer>::iterator l_it = m_peers.begin(); l_it != m_peers.end(); ++l_it)
+    {
+      if ((false == l_it->second.m_client->isRunning())
+        && (l_now >= l_it->second.m_retry))
+      {
+        l_lost.push_back(*l_it);
+      }
+    }
+    ReleaseMutex(m_mutex);
+    for (std::vector<std::pair<uint32, ENetBusPeer> >::iterator l_it = l_lost.begin(); l_it != l_lost.end(); ++l_it)
+    {
+      ENetClient              *l_client = nullptr;
+      std::map<uint32, ENetBusPeer>::iterator l_peer;
+
+      mEERROR_R();
+      l_client = new ENetClient(&m_handler);
+      if (nullptr != l_client)
+      {
+        l_client->init(l_it->second.m_hostname, l_it->second.m_port);
+        if (EERROR_NONE == mEERROR)
+        {
+          l_client->start();
+        }
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_CLIENT_ERR);
+          delete (l_client);
+          l_client = nullptr;
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_MEMORY);
+      }
+      WaitForSingleObject(m_mutex, INFINITE);
+      l_peer = m_peers.find(l_it->first);
+      if ((m_peers.end() != l_peer)
+        && (l_it->second.m_client == l_peer->second.m_client))
+      {
+        if (nullptr != l_client)
+        {
+          m_handler.cleanSocket(l_peer->second.m_client->getSocket());
+          delete (l_peer->second.m_client);
+          l_peer->second.m_client = l_client;
+          l_peer->second.m_backoff = ENETBUS_RETRY;
+          mEPRINT_STD("ENetBus: Node " + std::to_string(m_node) + " relinked to node " + std::to_string(l_it->first) + ".");
+        }
+        else
+        {
+          l_peer->second.m_retry = GetTickCount64() + l_peer->second.m_backoff;
+          l_peer->second.m_backoff = min(l_peer->second.m_backoff * 2, ENETBUS_RETRY_MAX);
+        }
+      }
+      else
+      {
+        delete (l_client);
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Deliver a batch of peer. /!\ Mutex.
+    @details Duplicated batches and malformed messages are dropped.
+    @param p_packet ENetPacketBus of peer.
+  */
+  void                        ENetBus::receive(ENetPacketBus *p_packet)
+  {
+    bool                      l_isDuplicate = false;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_isDuplicate = isDuplicate(p_packet->getOrigin(), p_packet->getSequence());
+    ReleaseMutex(m_mutex);
+    if (false == l_isDuplicate)
+    {
+      const std::string       &l_batch = p_packet->getDatas();
+      size_t                  l_pos = 0;
+
+      for (uint32 l_index = 0; l_index < p_packet->getCount(); ++l_index)
+      {
+        ENetTopicId           l_topic = 0;
+        int32                 l_len = 0;
+
+        if (l_batch.size() < (l_pos + sizeof(ENetTopicId) + sizeof(int32)))
+        {
+          break;
+        }
+        memcpy(&l_topic, l_batch.c_str() + l_pos, sizeof(ENetTopicId));
+        memcpy(&l_len, l_batch.c_str() + l_pos + sizeof(ENetTopicId), sizeof(int32));
+        l_pos += sizeof(ENetTopicId) + sizeof(int32);
+        if ((0 > l_len)
+          || (l_batch.size() < (l_pos + l_len)))
+        {
+          break;
+        }
+        deliver(p_packet->getOrigin(), l_topic, l_batch.c_str() + l_pos, l_len);
+        l_pos += l_len;
+      }
+    }
+  }
+
+  /**
+    @brief Deliver a message to local clients. /!\ Mutex. /!\ EError.
+    @details Message is sent as ENetPacketRawDatas to ENetTopics members or every client, then given to ENetBusReceiver.
+    @param p_origin Node publishing message.
+    @param p_topic Topic of message.
+    @param p_datas Datas of message.
+    @param p_len Datas length.
+  */
+  void                        ENetBus::deliver(uint32 p_origin, ENetTopicId p_topic, const char *p_datas, int32 p_len)
+  {
+    ENetPacketRawDatas        l_packet;
+    char                      *l_datas = nullptr;
+
+    mEERROR_R();
+    l_datas = new char[(0 < p_len) ? p_len : 1];
+    if (nullptr != l_datas)
+    {
+      memcpy(l_datas, p_datas, p_len);
+      l_packet.setDatas(l_datas, p_len);
+      if (ENETBUS_TOPIC_BROADCAST == p_topic)
+      {
+        ENetServer            *l_server = (nullptr != m_server) ? m_server : ENetServer::getInstance();
+
+        if (nullptr != l_server)
+        {
+          l_server->broadcast(&l_packet);
+        }
+      }
+      else if (nullptr != ENetTopics::getInstance())
+      {
+        ENetTopics::getInstance()->publish(p_topic, &l_packet);
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+    else
+    {
+      mEERROR_S(EERROR_MEMORY);
+    }
+    if (nullptr != m_receiver)
+    {
+      m_receiver(p_origin, p_topic, p_datas, p_len, m_context);
+    }
+  }
+
+  /**
+    @brief Check and record a batch sequence. m_mutex must be held by caller.
+    @details Sequences older than ENETBUS_WINDOW are considered as duplicates.
+    @param p_origin Node publishing batch.
+    @param p_sequence Sequence of batch.
+    @return true if batch was already received.
+  */
+  bool                        ENetBus::isDuplicate(uint32 p_origin, uint64 p_sequence)
+  {
+    bool                      l_isDuplicate = false;
+    std::unordered_map<uint32, ENetBusWindow>::iterator l_window = m_windows.find(p_origin);
+
+    if (m_windows.end() == l_window)
+    {
+      ENetBusWindow           l_new = { p_sequence, 1 };
+
+      m_windows[p_origin] = l_new;
+    }
+    else if (l_window->second.m_last < p_sequence)
+    {
+      uint64                  l_shift = p_sequence - l_window->second.m_last;
+
+      l_window->second.m_mask = (ENETBUS_WINDOW <= l_shift) ? 0 : (l_window->second.m_mask << l_shift);
+      l_window->second.m_mask |= 1;
+      l_window->second.m_last = p_sequence;
+    }
+    else
+    {
+      uint64                  l_offset = l_window->second.m_last - p_sequence;
+
+      if ((ENETBUS_WINDOW <= l_offset)
+        || (0 != (l_window->second.m_mask & (static_cast<uint64>(1) << l_offset))))
+      {
+        l_isDuplicate = true;
+      }
+      else
+      {
+        l_window->second.m_mask |= static_cast<uint64>(1) << l_offset;
+      }
+    }
+    if (true == l_isDuplicate)
+    {
+      ++m_duplicates;
+    }
+
+    return (l_isDuplicate);
+  }
+
+}
@@ -0,0 +1,288 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetCapture Class.
+*/
+
+#include "ENetwork/ENetCapture.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Functor for ENetCapture::write(). /!\ EError.
+    @param p_capture ENetCapture caller.
+    @return Unused.
+  */
+  DWORD WINAPI                CaptureWriteFunctor(LPVOID p_capture)
+  {
+    mEERROR_R();
+    if (nullptr != p_capture)
+    {
+      static_cast<ENetCapture*>(p_capture)->write();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Constructor for ENetCapture.
+  */
+  ENetCapture::ENetCapture() :
+    m_path(),
+    m_file(),
+    m_pending(),
+    m_start(0),
+    m_frequency(),
+    m_recorded(0),
+    m_dropped(0),
+    m_mutex(nullptr),
+    m_threadWrite(nullptr),
+    m_isRunning(false)
+  {
+    QueryPerformanceFrequency(&m_frequency);
+  }
+
+  /**
+    @brief Destructor for ENetCapture.
+    @details Stop capture, release its mutex.
+  */
+  ENetCapture::~ENetCapture()
+  {
+    if ((true == m_isRunning)
+      || (nullptr != m_threadWrite))
+    {
+      stop();
+    }
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Singleton for ENetCapture. /!\ EError.
+    @details Initialize its mutex.
+    @return ENetCapture unique instance on success.
+    @return nullptr on failure.
+  */
+  ENetCapture                 *ENetCapture::getInstance()
+  {
+    static ENetCapture        *l_instance = nullptr;
+
+    mEERROR_R();
+    if (nullptr == l_instance)
+    {
+      HANDLE                  l_mutex = nullptr;
+
+      l_mutex = CreateMutex(nullptr, false, nullptr);
+      if (nullptr != l_mutex)
+      {
+        l_instance = new ENetCapture();
+        if (nullptr != l_instance)
+        {
+          l_instance->m_mutex = l_mutex;
+        }
+        else
+        {
+          mEERROR_S(EERROR_MEMORY);
+          CloseHandle(l_mutex);
+        }
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+      }
+    }
+
+    return (l_instance);
+  }
+
+  /**
+    @brief Start capture into a file. /!\ EError.
+    @details Capture stopped by a write failure is closed first.
+    @details File is overwritten with ENetCaptureHeader, then write() thread is created.
+    @param p_path Path of capture file.
+  */
+  void                        ENetCapture::start(const std::string &p_path)
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_CAPTURE_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      ENetCaptureHeader       l_header = { ENETCAPTURE_MAGIC, ENETCAPTURE_VERSION };
+      LARGE_INTEGER           l_now = { 0 };
+
+      close();
+      m_path = p_path;
+      m_file.open(m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+      m_file.write(reinterpret_cast<const char*>(&l_header), sizeof(ENetCaptureHeader));
+      if (true == m_file.good())
+      {
+        QueryPerformanceCounter(&l_now);
+        m_start = l_now.QuadPart;
+        m_recorded = 0;
+        m_dropped = 0;
+        m_isRunning = true;
+        m_threadWrite = CreateThread(nullptr, 0, CaptureWriteFunctor, this, 0, nullptr);
+        if (nullptr == m_threadWrite)
+        {
+          m_isRunning = false;
+          m_file.close();
+          mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+        }
+      }
+      else
+      {
+        m_file.close();
+        mEERROR_SA(EERROR_FILE_ERR, m_path);
+      }
+    }
+  }
+
+  /**
+    @brief Stop capture. /!\ Blocking. /!\ EError.
+    @details Wait for write() thread, write remaining frames and close file.
+    @details Also closes a capture stopped by a write failure.
+  */
+  void                        ENetCapture::stop()
+  {
+    mEERROR_R();
+    if ((false == m_isRunning)
+      && (nullptr == m_threadWrite))
+    {
+      mEERROR_S(EERROR_NET_CAPTURE_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = false;
+      close();
+    }
+  }
+
+  /**
+    @brief Loop of ENetCapture. /!\ Blocking. /!\ Mutex. /!\ EError.
+    @details Write waiting frames every ENETCAPTURE_IDLE milliseconds.
+    @details Stop capture on write failure. Thread and file are closed by stop() or next start().
+  */
+  void                        ENetCapture::write()
+  {
+    while (true == m_isRunning)
+    {
+      Sleep(ENETCAPTURE_IDLE);
+      flush();
+      if (false == m_file.good())
+      {
+        m_isRunning = false;
+        mEERROR_SA(EERROR_FILE_ERR, m_path);
+      }
+    }
+  }
+
+  /**
+    @brief Record a received frame. /!\ Mutex.
+    @details Ignored when capture is not running. Dropped when ENETCAPTURE_PENDING_MAX bytes are waiting.
+    @param p_src ENetSocket source, nullptr if none.
+    @param p_received Performance counter at reception.
+    @param p_frame Frame, ENetPacketType then datas.
+    @param p_len Frame length.
+  */
+  void                        ENetCapture::record(const ENetSocket *p_src, LONGLONG p_received, const char *p_frame, int32 p_len)
+  {
+    if ((true == m_isRunning)
+      && (nullptr != p_frame)
+      && (0 < p_len))
+    {
+      ENetCaptureRecord       l_record = { 0 };
+
+      l_record.m_time = (p_received > m_start) ? static_cast<uint64>((p_received - m_start) * 1000000000.0 / m_frequency.QuadPart) : 0;
+      l_record.m_connection = (nullptr != p_src) ? static_cast<uint64>(*p_src) : 0;
+      l_record.m_protocol = (nullptr != p_src) ? (p_src->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS) : 0;
+      l_record.m_len = p_len;
+      WaitForSingleObject(m_mutex, INFINITE);
+      if (ENETCAPTURE_PENDING_MAX >= m_pending.size() + sizeof(ENetCaptureRecord) + p_len)
+      {
+        m_pending.append(reinterpret_cast<const char*>(&l_record), sizeof(ENetCaptureRecord));
+        m_pending.append(p_frame, p_len);
+        ++m_recorded;
+      }
+      else
+      {
+        ++m_dropped;
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Get frames recorded since start().
+    @return Frames recorded.
+  */
+  uint64                      ENetCapture::getRecorded() const
+  {
+    return (m_recorded);
+  }
+
+  /**
+    @brief Get frames dropped since start(), while too many bytes were waiting.
+    @return Frames dropped.
+  */
+  uint64                      ENetCapture::getDropped() const
+  {
+    return (m_dropped);
+  }
+
+  /**
+    @brief Get state of ENetCapture.
+    @return true if capture is running.
+  */
+  bool                        ENetCapture::isRunning() const
+  {
+    return (m_isRunning);
+  }
+
+  /**
+    @brief Write waiting frames into file. /!\ Mutex.
+    @details Waiting frames are swapped under mutex, then written without it.
+  */
+  void                        ENetCapture::flush()
+  {
+    std::string               l_datas;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_datas.swap(m_pending);
+    ReleaseMutex(m_mutex);
+    if (false == l_datas.empty())
+    {
+      m_file.write(l_datas.data(), l_datas.size());
+      m_file.flush();
+    }
+  }
+
+  /**
+    @brief Close write() thread and file once capture is not running. /!\ Blocking.
+    @details Wait for write() thread, write remaining frames. Nothing is done if there is no write() thread.
+  */
+  void                        ENetCapture::close()
+  {
+    if (nullptr != m_threadWrite)
+    {
+      WaitForSingleObject(m_threadWrite, INFINITE);
+      CloseHandle(m_threadWrite);
+      m_threadWrite = nullptr;
+      flush();
+      m_file.close();
+    }
+  }
+
+}
@@ -5,6 +5,7 @@
 */
 
 #include "ENetwork/ENetClient.h"
+#include "ENetwork/ENetRpc.h"
 
 /**
   @brief General scope for ELib components.
@@ -14,15 +15,15 @@ namespace               ELib
 
   /**
     @brief Functor for ENetClient::recvfrom thread.
-    @param p_unused Unused.
+    @param p_client ENetClient caller.
     @return Unused.
   */
-  DWORD WINAPI          ClientRecvfromFunctor(LPVOID p_unused)
+  DWORD WINAPI          ClientRecvfromFunctor(LPVOID p_client)
   {
     mEERROR_R();
-    if (nullptr != ENetClient::getInstance())
+    if (nullptr != p_client)
     {
-      ENetClient::getInstance()->recvfrom();
+      static_cast<ENetClient*>(p_client)->recvfrom();
     }
     else
     {
@@ -34,15 +35,15 @@ namespace               ELib
 
   /**
     @brief Functor for ENetClient::recv thread.
-    @param p_unused Unused.
+    @param p_client ENetClient caller.
     @return Unused.
   */
-  DWORD WINAPI          ClientRecvFunctor(LPVOID p_unused)
+  DWORD WINAPI          ClientRecvFunctor(LPVOID p_client)
   {
     mEERROR_R();
-    if (nullptr != ENetClient::getInstance())
+    if (nullptr != p_client)
     {
-      ENetClient::getInstance()->recv();
+      static_cast<ENetClient*>(p_client)->recv();
     }
     else
     {
@@ -54,14 +55,24 @@ namespace               ELib
 
   /**
     @brief Constructor for ENetClient.
+    @details Call WSAStartup().
+    @param p_handler ENetPacketHandler storing ENetPacket of this context, nullptr for ENetPacketHandler Singleton.
   */
-  ENetClient::ENetClient() :
+  ENetClient::ENetClient(ENetPacketHandler *p_handler) :
     m_socketRecvfrom(),
     m_threadRecvfrom(nullptr),
     m_socketRecv(),
     m_threadRecv(nullptr),
+    m_handler(p_handler),
+    m_fec(),
+    m_isJoined(false),
+    m_isMulticast(false),
+    m_isStartup(false),
     m_isRunning(false)
   {
+    WSADATA             WSAData = { 0 };
+
+    m_isStartup = (0 == WSAStartup(MAKEWORD(2, 2), &WSAData));
   }
 
   /**
@@ -76,12 +87,15 @@ namespace               ELib
     m_socketRecv.close();
     TerminateThread(m_threadRecv, 0);
     CloseHandle(m_threadRecv);
-    WSACleanup();
+    if (true == m_isStartup)
+    {
+      WSACleanup();
+    }
   }
 
   /**
-    @brief Singleton for ENetClient. /!\ EError.
-    @details Call WSAStartup().
+    @brief Singleton for ENetClient, default context. /!\ EError.
+    @details Use ENetPacketHandler Singleton.
     @return ENetClient unique instance on success.
     @return nullptr on failure.
   */
@@ -92,19 +106,19 @@ namespace               ELib
     mEERROR_R();
     if (nullptr == l_instance)
     {
-      WSADATA           WSAData = { 0 };
-
-      if (0 == WSAStartup(MAKEWORD(2, 2), &WSAData))
+      l_instance = new ENetClient();
+      if (nullptr != l_instance)
       {
-        l_instance = new ENetClient();
-        if (nullptr == l_instance)
+        if (false == l_instance->m_isStartup)
         {
-          mEERROR_S(EERROR_MEMORY);
+          mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+          delete (l_instance);
+          l_instance = nullptr;
         }
       }
       else
       {
-        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+        mEERROR_S(EERROR_MEMORY);
       }
     }
 
@@ -171,7 +185,7 @@ namespace               ELib
   /**
     @brief Start ENetClient automation. /!\ EError.
     @details Create threads for ENetClient::recvfrom() and ENetClient:recv().
-    @details ENetPacketHandler Singleton need to be valid.
+    @details ENetPacketHandler of ENetClient need to be valid.
   */
   void                  ENetClient::start()
   {
@@ -180,17 +194,17 @@ namespace               ELib
     {
       mEERROR_S(EERROR_NET_CLIENT_STATE);
     }
-    if (nullptr == ENetPacketHandler::getInstance())
+    if (nullptr == getHandler())
     {
       mEERROR_SH(EERROR_NULL_PTR);
     }
 
     if (EERROR_NONE == mEERROR)
     {
-      m_threadRecvfrom = CreateThread(nullptr, 0, ClientRecvfromFunctor, nullptr, 0, nullptr);
+      m_threadRecvfrom = CreateThread(nullptr, 0, ClientRecvfromFunctor, this, 0, nullptr);
       if (nullptr != m_threadRecvfrom)
       {
-        m_threadRecv = CreateThread(nullptr, 0, ClientRecvFunctor, nullptr, 0, nullptr);
+        m_threadRecv = CreateThread(nullptr, 0, ClientRecvFunctor, this, 0, nullptr);
         if (nullptr != m_threadRecv)
         {
           m_isRunning = true;
@@ -218,7 +232,7 @@ namespace               ELib
     mEERROR_R();
     if (false == isRunning())
     {
-      mEERROR_S(EERROR_NET_SERVER_STATE);
+      mEERROR_S(EERROR_NET_CLIENT_STATE);
     }
 
     if (EERROR_NONE == mEERROR)
@@ -233,14 +247,16 @@ namespace               ELib
   /**
     @brief Receive connectionless datas to ENetClient. /!\ Blocking. /!\ Mutex. /!\ EError.
     @details Receive datas on connectionless ENetSocket and send them to ENetPacketHandler::read().
-    @details ENetPacketHandler Singleton need to be valid.
+    @details ENETPACKET_TYPE_FEC datagrams are given to ENetFec::read().
+    @details ENETCOOKIE_KIND_CHALLENGE is echoed to ENetServer, followed by ENETPACKET_TYPE_DGRAM_JOIN if datagrams were joined.
+    @details ENetPacketHandler of ENetClient need to be valid.
   */
   void                  ENetClient::recvfrom()
   {
     while (true == isRunning())
     {
       mEERROR_R();
-      if (nullptr != ENetPacketHandler::getInstance())
+      if (nullptr == getHandler())
       {
         mEERROR_SH(EERROR_NULL_PTR);
         stop();
@@ -262,9 +278,36 @@ namespace               ELib
 
           l_len = m_socketRecvfrom.recvfrom(l_datas, ENETSOCKET_UDP_MAX, l_client);
           /* TODO: Check that source correspond to ENetServer. */
-          if (0 < l_len)
+          if ((ENETCOOKIE_SIZE == l_len)
+            && (ENETPACKET_TYPE_COOKIE == *reinterpret_cast<ENetPacketType*>(l_datas))
+            && (ENETCOOKIE_KIND_CHALLENGE == *reinterpret_cast<uint32*>(l_datas + sizeof(ENetPacketType))))
+          {
+            *reinterpret_cast<uint32*>(l_datas + sizeof(ENetPacketType)) = ENETCOOKIE_KIND_ECHO;
+            sendServer(l_datas, ENETCOOKIE_SIZE);
+            if ((EERROR_NONE == mEERROR)
+              && (true == m_isJoined))
+            {
+              sendJoin();
+            }
+            if (EERROR_NONE != mEERROR)
+            {
+              mEERROR_SH(EERROR_NET_SOCKET_ERR);
+            }
+            delete (l_client);
+          }
+          else if ((ENETFEC_HEADER <= l_len)
+            && (ENETPACKET_TYPE_FEC == *reinterpret_cast<ENetPacketType*>(l_datas)))
           {
-            ENetPacketHandler::getInstance()->read(l_datas, l_len, l_client);
+            m_fec.read(l_datas, l_len, l_client, getHandler());
+            if (EERROR_NONE != mEERROR)
+            {
+              mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
+            }
+            delete (l_client);
+          }
+          else if (0 < l_len)
+          {
+            getHandler()->read(l_datas, l_len, l_client);
             if (EERROR_NONE != mEERROR)
             {
               mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
@@ -287,15 +330,15 @@ namespace               ELib
   /**
     @brief Receive connected datas to ENetClient. /!\ Blocking. /!\ Mutex. /!\ EError.
     @details Call ENetPacketHandler::recvPacket().
-    @details ENetPacketHandler Singleton need to be valid.
-    @details On error, m_socketRecv is closed and ENetClient::stop() is called.
+    @details ENetPacketHandler of ENetClient need to be valid.
+    @details On error, m_socketRecv is closed, its pending ENetRpc calls are cancelled and ENetClient::stop() is called.
   */
   void                  ENetClient::recv()
   {
     while (true == m_isRunning)
     {
       mEERROR_R();
-      if (nullptr != ENetPacketHandler::getInstance())
+      if (nullptr == getHandler())
       {
         mEERROR_SH(EERROR_NULL_PTR);
         stop();
@@ -307,13 +350,17 @@ namespace               ELib
 
       if (EERROR_NONE == mEERROR)
       {
-        ENetPacketHandler::getInstance()->recvPacket(&m_socketRecv);
+        getHandler()->recvPacket(&m_socketRecv);
         if (EERROR_NONE != mEERROR)
         {
           mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
           m_socketRecv.close();
           if (EERROR_NONE == mEERROR)
           {
+            if (nullptr != ENetRpc::getInstance())
+            {
+              ENetRpc::getInstance()->cancel(&m_socketRecv);
+            }
             stop();
             if (EERROR_NONE != mEERROR)
             {
@@ -353,6 +400,137 @@ namespace               ELib
     }
   }
 
+  /**
+    @brief Register to datagrams of ENetServer. /!\ EError.
+    @details ENetClient must be initialized and not running.
+    @details With a group, connectionless ENetSocket is bound again on the port of the group and joins it.
+      If the group cannot be joined (no multicast route...), ENetClient falls back to unicast datagrams.
+    @details Send ENETCOOKIE_KIND_HELLO, for ENetServer requiring cookies, then ENETPACKET_TYPE_DGRAM_JOIN telling if multicast is received.
+    @param p_group Multicast address of ENetServer::setMulticast(), empty for unicast.
+    @param p_port Port of group.
+  */
+  void                  ENetClient::joinDatagrams(const std::string &p_group, uint16 p_port)
+  {
+    bool                l_isMulticast = false;
+
+    mEERROR_R();
+    if (true == isRunning())
+    {
+      mEERROR_S(EERROR_NET_CLIENT_STATE);
+    }
+
+    if ((EERROR_NONE == mEERROR)
+      && (false == p_group.empty()))
+    {
+      m_socketRecvfrom.close();
+      m_socketRecvfrom.socket(ENETSOCKET_FLAGS_PROTOCOL_UDP);
+      if (EERROR_NONE == mEERROR)
+      {
+        m_socketRecvfrom.setReuseAddress(true);
+      }
+      if (EERROR_NONE == mEERROR)
+      {
+        m_socketRecvfrom.bind("0.0.0.0", p_port);
+      }
+      if (EERROR_NONE == mEERROR)
+      {
+        m_socketRecvfrom.joinGroup(p_group);
+        if (EERROR_NONE == mEERROR)
+        {
+          l_isMulticast = true;
+          mEPRINT_STD("ENetClient: Joined multicast group " + p_group + ":" + std::to_string(p_port) + ".");
+        }
+        else
+        {
+          mEPRINT_ERR("ENetClient: Multicast group " + p_group + " unreachable, unicast fallback.");
+          mEERROR_R();
+        }
+      }
+      else
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+    }
+    if (EERROR_NONE == mEERROR)
+    {
+      char              l_hello[ENETCOOKIE_SIZE] = { 0 };
+      ENetPacketType    l_type = ENETPACKET_TYPE_COOKIE;
+
+      m_isJoined = true;
+      m_isMulticast = l_isMulticast;
+      memcpy(l_hello, &l_type, sizeof(ENetPacketType));
+      sendServer(l_hello, ENETCOOKIE_SIZE);
+      if (EERROR_NONE == mEERROR)
+      {
+        sendJoin();
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Set forward error correction of connectionless datas sent by ENetClient.
+    @details Received ENETPACKET_TYPE_FEC datagrams are always unwrapped.
+    @param p_count Datagrams protected by one parity datagram, 0 to disable.
+  */
+  void                  ENetClient::setFec(uint8 p_count)
+  {
+    if (0 == p_count)
+    {
+      m_socketRecvfrom.setFec(nullptr);
+    }
+    else
+    {
+      m_fec.setBlockSize(p_count);
+      m_socketRecvfrom.setFec(&m_fec);
+    }
+  }
+
+  /**
+    @brief Get ENetFec of connectionless datas.
+    @return ENetFec of ENetClient.
+  */
+  ENetFec               *ENetClient::getFec()
+  {
+    return (&m_fec);
+  }
+
+  /**
+    @brief Send parity of blocks not yet full, see ENetFec::flush(). /!\ Mutex. /!\ EError.
+    @details Call it after a burst of connectionless datas, so its last datagrams are protected.
+    @param p_delay Milliseconds since last datagram of a block before its parity is sent, 0 for every block.
+  */
+  void                  ENetClient::flushFec(uint32 p_delay)
+  {
+    mEERROR_R();
+    m_fec.flush(&m_socketRecvfrom, p_delay);
+    if (EERROR_NONE != mEERROR)
+    {
+      mEERROR_SH(EERROR_NET_SOCKET_ERR);
+    }
+  }
+
+  /**
+    @brief Get ENetPacketHandler of ENetClient.
+    @return ENetPacketHandler given to constructor, ENetPacketHandler Singleton by default.
+  */
+  ENetPacketHandler     *ENetClient::getHandler() const
+  {
+    return ((nullptr != m_handler) ? m_handler : ENetPacketHandler::getInstance());
+  }
+
+  /**
+    @brief Get connected ENetSocket of ENetClient.
+    @return Source of ENetPacket received by ENetClient::recv().
+  */
+  ENetSocket            *ENetClient::getSocket()
+  {
+    return (&m_socketRecv);
+  }
+
   /**
     @brief Get state of ENetClient.
     @return State.
@@ -362,4 +540,32 @@ namespace               ELib
     return (m_isRunning);
   }
 
+  /**
+    @brief Send datas to connectionless address of ENetServer. /!\ EError.
+    @details Raw address is used: a temporary ENetSocket would reset EError when destroyed.
+    @param p_datas Datagram.
+    @param p_len Datagram length.
+  */
+  void                  ENetClient::sendServer(const char *p_datas, uint16 p_len)
+  {
+    m_socketRecvfrom.sendto(p_datas, p_len, inet_addr(m_socketRecv.getHostname().c_str()), m_socketRecv.getPort());
+    if (EERROR_NONE != mEERROR)
+    {
+      mEERROR_SH(EERROR_NET_SOCKET_ERR);
+    }
+  }
+
+  /**
+    @brief Send ENETPACKET_TYPE_DGRAM_JOIN to ENetServer. /!\ EError.
+  */
+  void                  ENetClient::sendJoin()
+  {
+    char                l_datas[sizeof(ENetPacketType) + sizeof(uint8)] = { 0 };
+    ENetPacketType      l_type = ENETPACKET_TYPE_DGRAM_JOIN;
+
+    memcpy(l_datas, &l_type, sizeof(ENetPacketType));
+    l_datas[sizeof(ENetPacketType)] = (true == m_isMulticast) ? 1 : 0;
+    sendServer(l_datas, sizeof(l_datas));
+  }
+
 }
\ No newline at end of file
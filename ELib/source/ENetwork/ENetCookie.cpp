@@ -0,0 +1,194 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetCookie Class.
+*/
+
+#include "ENetwork/ENetCookie.h"
+#include "ENetwork/ENetHashRing.h"
+
+#define mENETCOOKIE_ROTL(p_value, p_bits) (((p_value) << (p_bits)) | ((p_value) >> (64 - (p_bits))))
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief One SipRound of SipHash.
+    @param p_v0 First state word.
+    @param p_v1 Second state word.
+    @param p_v2 Third state word.
+    @param p_v3 Fourth state word.
+  */
+  static void                 SipRound(uint64 &p_v0, uint64 &p_v1, uint64 &p_v2, uint64 &p_v3)
+  {
+    p_v0 += p_v1;
+    p_v1 = mENETCOOKIE_ROTL(p_v1, 13);
+    p_v1 ^= p_v0;
+    p_v0 = mENETCOOKIE_ROTL(p_v0, 32);
+    p_v2 += p_v3;
+    p_v3 = mENETCOOKIE_ROTL(p_v3, 16);
+    p_v3 ^= p_v2;
+    p_v0 += p_v3;
+    p_v3 = mENETCOOKIE_ROTL(p_v3, 21);
+    p_v3 ^= p_v0;
+    p_v2 += p_v1;
+    p_v1 = mENETCOOKIE_ROTL(p_v1, 17);
+    p_v1 ^= p_v2;
+    p_v2 = mENETCOOKIE_ROTL(p_v2, 32);
+  }
+
+  /**
+    @brief Constructor for ENetCookie.
+    @details Draw secret key from performance counter, tick count, process and object addresses.
+      Call setKey() to share a key between several ENetServers of a cluster.
+  */
+  ENetCookie::ENetCookie() :
+    m_key0(0),
+    m_key1(0),
+    m_verified(),
+    m_rejected(0)
+  {
+    LARGE_INTEGER             l_counter = { 0 };
+
+    QueryPerformanceCounter(&l_counter);
+    m_key0 = ENetHashRing::hash(static_cast<uint64>(l_counter.QuadPart) ^ (static_cast<uint64>(GetCurrentProcessId()) << 32));
+    m_key1 = ENetHashRing::hash(GetTickCount64() ^ reinterpret_cast<uint64>(this) ^ m_key0);
+  }
+
+  /**
+    @brief Destructor for ENetCookie.
+  */
+  ENetCookie::~ENetCookie()
+  {
+  }
+
+  /**
+    @brief Generate cookie of a source for current epoch.
+    @param p_address IPv4 address of source, in network byte order.
+    @param p_port Port of source.
+    @return Cookie of source.
+  */
+  uint64                      ENetCookie::generate(uint32 p_address, uint16 p_port) const
+  {
+    return (hash((static_cast<uint64>(p_address) << 16) | p_port, GetTickCount64() / ENETCOOKIE_PERIOD));
+  }
+
+  /**
+    @brief Check cookie echoed by a source, against current and previous epochs.
+    @param p_address IPv4 address of source, in network byte order.
+    @param p_port Port of source.
+    @param p_cookie Cookie echoed.
+    @return true if cookie was generated for this source.
+  */
+  bool                        ENetCookie::check(uint32 p_address, uint16 p_port, uint64 p_cookie) const
+  {
+    uint64                    l_source = (static_cast<uint64>(p_address) << 16) | p_port;
+    uint64                    l_epoch = GetTickCount64() / ENETCOOKIE_PERIOD;
+
+    return ((hash(l_source, l_epoch) == p_cookie)
+      || ((0 != l_epoch) && (hash(l_source, l_epoch - 1) == p_cookie)));
+  }
+
+  /**
+    @brief Mark a source as verified.
+    @param p_address IPv4 address of source, in network byte order.
+    @param p_port Port of source.
+  */
+  void                        ENetCookie::verify(uint32 p_address, uint16 p_port)
+  {
+    m_verified.insert((static_cast<uint64>(p_address) << 16) | p_port);
+  }
+
+  /**
+    @brief Forget a verified source. It will need a new cookie.
+    @param p_address IPv4 address of source, in network byte order.
+    @param p_port Port of source.
+  */
+  void                        ENetCookie::forget(uint32 p_address, uint16 p_port)
+  {
+    m_verified.erase((static_cast<uint64>(p_address) << 16) | p_port);
+  }
+
+  /**
+    @brief Check if a source is verified.
+    @param p_address IPv4 address of source, in network byte order.
+    @param p_port Port of source.
+    @return true if source echoed a valid cookie.
+  */
+  bool                        ENetCookie::isVerified(uint32 p_address, uint16 p_port) const
+  {
+    return (m_verified.end() != m_verified.find((static_cast<uint64>(p_address) << 16) | p_port));
+  }
+
+  /**
+    @brief Set secret key of cookies.
+    @details Cookies given with previous key are no longer valid.
+    @param p_key0 First half of secret key.
+    @param p_key1 Second half of secret key.
+  */
+  void                        ENetCookie::setKey(uint64 p_key0, uint64 p_key1)
+  {
+    m_key0 = p_key0;
+    m_key1 = p_key1;
+  }
+
+  /**
+    @brief Get number of verified sources.
+    @return Number of verified sources.
+  */
+  uint32                      ENetCookie::getVerifiedCount() const
+  {
+    return (static_cast<uint32>(m_verified.size()));
+  }
+
+  /**
+    @brief Get number of rejected datagrams.
+    @return Number of datagrams rejected from unverified sources.
+  */
+  uint64                      ENetCookie::getRejected() const
+  {
+    return (m_rejected);
+  }
+
+  /**
+    @brief Count a datagram rejected from an unverified source.
+  */
+  void                        ENetCookie::addRejected()
+  {
+    ++m_rejected;
+  }
+
+  /**
+    @brief SipHash-2-4 of two words with secret key.
+    @param p_word0 First word.
+    @param p_word1 Second word.
+    @return Keyed hash.
+  */
+  uint64                      ENetCookie::hash(uint64 p_word0, uint64 p_word1) const
+  {
+    uint64                    l_v0 = m_key0 ^ 0x736F6D6570736575ULL;
+    uint64                    l_v1 = m_key1 ^ 0x646F72616E646F6DULL;
+    uint64                    l_v2 = m_key0 ^ 0x6C7967656E657261ULL;
+    uint64                    l_v3 = m_key1 ^ 0x7465646279746573ULL;
+    uint64                    l_words[3] = { p_word0, p_word1, 16ULL << 56 };
+
+    for (uint32 l_i = 0; l_i < 3; ++l_i)
+    {
+      l_v3 ^= l_words[l_i];
+      SipRound(l_v0, l_v1, l_v2, l_v3);
+      SipRound(l_v0, l_v1, l_v2, l_v3);
+      l_v0 ^= l_words[l_i];
+    }
+    l_v2 ^= 0xFF;
+    for (uint32 l_i = 0; l_i < 4; ++l_i)
+    {
+      SipRound(l_v0, l_v1, l_v2, l_v3);
+    }
+
+    return (l_v0 ^ l_v1 ^ l_v2 ^ l_v3);
+  }
+
+}
@@ -0,0 +1,637 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetFec Class.
+*/
+
+#include "ENetwork/ENetFec.h"
+#include "ENetwork/ENetPacer.h"
+#include "ENetwork/ENetPacketHandler.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Constructor for ENetFec.
+    @details Initialize its mutex.
+  */
+  ENetFec::ENetFec() :
+    m_count(ENETFEC_BLOCK),
+    m_encoders(),
+    m_decoders(),
+    m_bytes(0),
+    m_sweep(0),
+    m_loss(0.0),
+    m_seed(1),
+    m_recovered(0),
+    m_dropped(0),
+    m_mutex(nullptr)
+  {
+    m_mutex = CreateMutex(nullptr, false, nullptr);
+  }
+
+  /**
+    @brief Destructor for ENetFec.
+    @details Release its mutex.
+  */
+  ENetFec::~ENetFec()
+  {
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Protect a datagram for its destination. /!\ Mutex. /!\ EError.
+    @details Give the wrapped datagram, followed by the parity datagram if it completes its block.
+    @details Block identifiers of a new destination start from the tick count, so a restarted sender is not taken for a late one.
+    @details Datagram is given unprotected to a new destination while ENETFEC_PEERS_MAX destinations are known.
+    @param p_datas Serialized ENetPacket.
+    @param p_len Length of serialized ENetPacket.
+    @param p_dst ENetSocket destination.
+    @param p_datagrams Datagrams to be sent, in order.
+  */
+  void                        ENetFec::encode(const char *p_datas, int32 p_len, const ENetSocket *p_dst,
+                                std::vector<std::string> &p_datagrams)
+  {
+    mEERROR_R();
+    if ((nullptr == p_datas)
+      || (nullptr == p_dst))
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if (0 > p_len)
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      if (ENETSOCKET_UDP_MAX < p_len + ENETFEC_HEADER)
+      {
+        p_datagrams.push_back(std::string(p_datas, p_len));
+      }
+      else
+      {
+        std::string           l_address = p_dst->getHostname() + ":" + std::to_string(p_dst->getPort());
+        std::map<std::string, ENetFecEncoder>::iterator l_it;
+        uint64                l_now = GetTickCount64();
+
+        WaitForSingleObject(m_mutex, INFINITE);
+        expire(l_now);
+        l_it = m_encoders.find(l_address);
+        if ((m_encoders.end() == l_it)
+          && (ENETFEC_PEERS_MAX > m_encoders.size()))
+        {
+          ENetFecEncoder      l_encoder = { static_cast<uint32>(l_now), 0, m_count, 0, "", l_now, p_dst->getHostname(), p_dst->getPort() };
+
+          l_it = m_encoders.insert(std::make_pair(l_address, l_encoder)).first;
+        }
+        if (m_encoders.end() == l_it)
+        {
+          p_datagrams.push_back(std::string(p_datas, p_len));
+        }
+        else
+        {
+          ENetFecEncoder      &l_encoder = l_it->second;
+
+          l_encoder.m_last = l_now;
+          if (0 == l_encoder.m_index)
+          {
+            l_encoder.m_count = m_count;
+            l_encoder.m_length = 0;
+            l_encoder.m_parity.clear();
+          }
+          p_datagrams.push_back(wrap(l_encoder.m_block, l_encoder.m_index, l_encoder.m_count, static_cast<uint16>(p_len),
+            p_datas, p_len));
+          if (static_cast<int32>(l_encoder.m_parity.size()) < p_len)
+          {
+            l_encoder.m_parity.resize(p_len, '\0');
+          }
+          for (int32 l_i = 0; l_i < p_len; ++l_i)
+          {
+            l_encoder.m_parity[l_i] ^= p_datas[l_i];
+          }
+          l_encoder.m_length ^= static_cast<uint16>(p_len);
+          ++l_encoder.m_index;
+          if (l_encoder.m_count == l_encoder.m_index)
+          {
+            p_datagrams.push_back(wrap(l_encoder.m_block, l_encoder.m_count, l_encoder.m_count, l_encoder.m_length,
+              l_encoder.m_parity.data(), static_cast<int32>(l_encoder.m_parity.size())));
+            ++l_encoder.m_block;
+            l_encoder.m_index = 0;
+          }
+        }
+        ReleaseMutex(m_mutex);
+      }
+    }
+  }
+
+  /**
+    @brief Unwrap a FEC datagram from a source. /!\ Mutex. /!\ EError.
+    @details Give the datagram if it is new, followed by the datagram of its block recovered thanks to it, if any.
+    @details A parity protecting less datagrams than announced (flush()) shrinks its block, unless a later datagram
+      of the block is already known.
+    @details Blocks older than the ENETFEC_WINDOW last ones of source are ignored. A block far behind them means the
+      sender restarted: blocks of source are forgotten.
+    @details Datagram is given without being kept for recovery if its source is new while ENETFEC_PEERS_MAX sources
+      are known, or if ENETFEC_BYTES_MAX bytes are kept.
+    @param p_datas Datas received, starting with ENETPACKET_TYPE_FEC.
+    @param p_len Length of datas.
+    @param p_src ENetSocket source.
+    @param p_datagrams Datagrams to be read, in order.
+  */
+  void                        ENetFec::decode(const char *p_datas, int32 p_len, const ENetSocket *p_src,
+                                std::vector<std::string> &p_datagrams)
+  {
+    ENetPacketType            l_type = ENETPACKET_TYPE_DISCONNECT;
+    uint32                    l_block = 0;
+    uint8                     l_index = 0;
+    uint8                     l_count = 0;
+    uint16                    l_length = 0;
+
+    mEERROR_R();
+    if ((nullptr == p_datas)
+      || (nullptr == p_src))
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((EERROR_NONE == mEERROR)
+      && (ENETFEC_HEADER > p_len))
+    {
+      mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      memcpy(&l_type, p_datas, sizeof(ENetPacketType));
+      memcpy(&l_block, p_datas + 4, sizeof(uint32));
+      memcpy(&l_index, p_datas + 8, sizeof(uint8));
+      memcpy(&l_count, p_datas + 9, sizeof(uint8));
+      memcpy(&l_length, p_datas + 10, sizeof(uint16));
+      if (ENETPACKET_TYPE_FEC != l_type)
+      {
+        mEERROR_S(EERROR_NET_PACKET_TYPE);
+      }
+      else if ((0 == l_count)
+        || (ENETFEC_BLOCK_MAX < l_count)
+        || (l_count < l_index)
+        || ((l_count > l_index) && (p_len - ENETFEC_HEADER != l_length)))
+      {
+        mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+      }
+    }
+    if (EERROR_NONE == mEERROR)
+    {
+      std::string             l_address = p_src->getHostname() + ":" + std::to_string(p_src->getPort());
+      std::map<std::string, ENetFecSource>::iterator l_source;
+      uint64                  l_now = GetTickCount64();
+      bool                    l_isDropped = false;
+
+      WaitForSingleObject(m_mutex, INFINITE);
+      expire(l_now);
+      if (0.0 < m_loss)
+      {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 7;
+        m_seed ^= m_seed << 17;
+        if (static_cast<double>(m_seed >> 11) / 9007199254740992.0 < m_loss)
+        {
+          l_isDropped = true;
+          ++m_dropped;
+        }
+      }
+      if (false == l_isDropped)
+      {
+        l_source = m_decoders.find(l_address);
+        if ((m_decoders.end() == l_source)
+          && (ENETFEC_PEERS_MAX > m_decoders.size()))
+        {
+          ENetFecSource       l_new = { std::map<uint32, ENetFecBlock>(), l_now };
+
+          l_source = m_decoders.insert(std::make_pair(l_address, l_new)).first;
+        }
+        if (m_decoders.end() == l_source)
+        {
+          if (l_count > l_index)
+          {
+            p_datagrams.push_back(std::string(p_datas + ENETFEC_HEADER, l_length));
+          }
+          l_isDropped = true;
+        }
+      }
+      if (false == l_isDropped)
+      {
+        std::map<uint32, ENetFecBlock> &l_blocks = l_source->second.m_blocks;
+        std::map<uint32, ENetFecBlock>::iterator l_it = l_blocks.find(l_block);
+
+        l_source->second.m_last = l_now;
+
+        if ((l_blocks.end() == l_it)
+          && (ENETFEC_WINDOW <= l_blocks.size())
+          && (l_block < l_blocks.begin()->first))
+        {
+          if (ENETFEC_WINDOW * 4 < l_blocks.begin()->first - l_block)
+          {
+            while (false == l_blocks.empty())
+            {
+              m_bytes -= getSize(l_blocks.begin()->second);
+              l_blocks.erase(l_blocks.begin());
+            }
+          }
+          else
+          {
+            l_isDropped = true;
+          }
+        }
+        if ((false == l_isDropped)
+          && (l_blocks.end() == l_it))
+        {
+          ENetFecBlock        l_new = { std::vector<std::string>(l_count), 0, 0, l_count, 0, "", false };
+
+          l_it = l_blocks.insert(std::make_pair(l_block, l_new)).first;
+          if (ENETFEC_WINDOW < l_blocks.size())
+          {
+            m_bytes -= getSize(l_blocks.begin()->second);
+            l_blocks.erase(l_blocks.begin());
+          }
+        }
+        if ((false == l_isDropped)
+          && (l_count == l_index)
+          && (l_count < l_it->second.m_count)
+          && (false == l_it->second.m_isParity)
+          && (0 == (l_it->second.m_mask >> l_count)))
+        {
+          uint64              l_size = getSize(l_it->second);
+
+          l_it->second.m_count = l_count;
+          l_it->second.m_datagrams.resize(l_count);
+          recover(l_it->second, p_datagrams);
+          m_bytes = m_bytes - l_size + getSize(l_it->second);
+        }
+        if ((false == l_isDropped)
+          && (((l_count == l_index) && (l_count == l_it->second.m_count))
+            || ((l_count > l_index) && (l_it->second.m_count > l_index)))
+          && (l_it->second.m_count > l_it->second.m_received))
+        {
+          ENetFecBlock        &l_current = l_it->second;
+          uint64              l_size = getSize(l_current);
+          bool                l_isKept = (ENETFEC_BYTES_MAX >= m_bytes + p_len - ENETFEC_HEADER);
+
+          if (l_count == l_index)
+          {
+            if ((false == l_current.m_isParity)
+              && (true == l_isKept))
+            {
+              l_current.m_parity.assign(p_datas + ENETFEC_HEADER, p_len - ENETFEC_HEADER);
+              l_current.m_length = l_length;
+              l_current.m_isParity = true;
+            }
+          }
+          else if (0 == (l_current.m_mask & (1ULL << l_index)))
+          {
+            if (true == l_isKept)
+            {
+              l_current.m_datagrams[l_index].assign(p_datas + ENETFEC_HEADER, l_length);
+              l_current.m_mask |= (1ULL << l_index);
+              ++l_current.m_received;
+              p_datagrams.push_back(l_current.m_datagrams[l_index]);
+            }
+            else
+            {
+              p_datagrams.push_back(std::string(p_datas + ENETFEC_HEADER, l_length));
+            }
+          }
+          recover(l_current, p_datagrams);
+          m_bytes = m_bytes - l_size + getSize(l_current);
+        }
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Unwrap a FEC datagram and give resulting datagrams to ENetPacketHandler::read(). /!\ Mutex. /!\ EError.
+    @details Each datagram is read with its own copy of source address, owned by its ENetPacket.
+    @param p_datas Datas received, starting with ENETPACKET_TYPE_FEC.
+    @param p_len Length of datas.
+    @param p_src ENetSocket source.
+    @param p_handler ENetPacketHandler storing ENetPacket.
+  */
+  void                        ENetFec::read(const char *p_datas, int32 p_len, const ENetSocket *p_src,
+                                ENetPacketHandler *p_handler)
+  {
+    std::vector<std::string>  l_datagrams;
+
+    mEERROR_R();
+    if (nullptr == p_handler)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      decode(p_datas, p_len, p_src, l_datagrams);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+    for (std::vector<std::string>::iterator l_it = l_datagrams.begin(); (EERROR_NONE == mEERROR) && (l_it != l_datagrams.end()); ++l_it)
+    {
+      ENetSocket              *l_src = nullptr;
+
+      l_src = new ENetSocket();
+      if (nullptr != l_src)
+      {
+        l_src->setAddress(p_src->getHostname(), p_src->getPort());
+        p_handler->read(&(*l_it)[0], static_cast<int32>(l_it->size()), l_src);
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
+          delete (l_src);
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_MEMORY);
+      }
+    }
+  }
+
+  /**
+    @brief Send parity of blocks not yet full, from a connectionless ENetSocket. /!\ Mutex. /!\ EError.
+    @details Parity records the number of datagrams already sent, next datagrams start a new block.
+    @details Call it after a burst (end of a tick), so its last datagrams are protected without waiting for the next ones.
+    @details Parities are queued into ENetPacer of source when it is running.
+    @param p_src ENetSocket source, whose ENetFec is this one.
+    @param p_delay Milliseconds since last datagram of a block before its parity is sent, 0 for every block.
+  */
+  void                        ENetFec::flush(ENetSocket *p_src, uint32 p_delay)
+  {
+    std::vector<std::pair<ENetSocket*, std::string> > l_parities;
+    uint64                    l_now = GetTickCount64();
+
+    mEERROR_R();
+    if (nullptr == p_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      WaitForSingleObject(m_mutex, INFINITE);
+      for (std::map<std::string, ENetFecEncoder>::iterator l_it = m_encoders.begin(); (EERROR_NONE == mEERROR) && (l_it != m_encoders.end()); ++l_it)
+      {
+        ENetFecEncoder        &l_encoder = l_it->second;
+
+        if ((0 != l_encoder.m_index)
+          && (p_delay <= l_now - l_encoder.m_last))
+        {
+          ENetSocket          *l_dst = nullptr;
+
+          l_dst = new ENetSocket();
+          if (nullptr != l_dst)
+          {
+            l_dst->setAddress(l_encoder.m_host, l_encoder.m_port);
+            l_parities.push_back(std::make_pair(l_dst, wrap(l_encoder.m_block, l_encoder.m_index, l_encoder.m_index, l_encoder.m_length,
+              l_encoder.m_parity.data(), static_cast<int32>(l_encoder.m_parity.size()))));
+            ++l_encoder.m_block;
+            l_encoder.m_index = 0;
+          }
+          else
+          {
+            mEERROR_S(EERROR_MEMORY);
+          }
+        }
+      }
+      ReleaseMutex(m_mutex);
+    }
+    for (std::vector<std::pair<ENetSocket*, std::string> >::iterator l_it = l_parities.begin(); l_it != l_parities.end(); ++l_it)
+    {
+      if (EERROR_NONE == mEERROR)
+      {
+        if ((nullptr != p_src->getPacer())
+          && (true == p_src->getPacer()->isRunning()))
+        {
+          p_src->getPacer()->push(l_it->second.data(), static_cast<int32>(l_it->second.size()), l_it->first);
+        }
+        else
+        {
+          p_src->sendto(l_it->second.data(), static_cast<uint16>(l_it->second.size()), l_it->first);
+        }
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_SOCKET_ERR);
+        }
+      }
+      delete (l_it->first);
+    }
+  }
+
+  /**
+    @brief Set number of datagrams protected by one parity datagram. /!\ Mutex.
+    @details Applied from next block of each destination.
+    @param p_count Datagrams per block, between 1 and ENETFEC_BLOCK_MAX.
+  */
+  void                        ENetFec::setBlockSize(uint8 p_count)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    if (0 == p_count)
+    {
+      m_count = 1;
+    }
+    else if (ENETFEC_BLOCK_MAX < p_count)
+    {
+      m_count = ENETFEC_BLOCK_MAX;
+    }
+    else
+    {
+      m_count = p_count;
+    }
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Set loss injection on received FEC datagrams. /!\ Mutex.
+    @details For tests only: datagrams are dropped before decoding, as if lost on the link.
+    @param p_rate Rate of datagrams dropped, 0 to disable.
+    @param p_seed Seed of the pseudo-random generator, must not be 0.
+  */
+  void                        ENetFec::setLoss(double p_rate, uint64 p_seed)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_loss = p_rate;
+    m_seed = (0 != p_seed) ? p_seed : 1;
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Get number of datagrams protected by one parity datagram.
+    @return Datagrams per block.
+  */
+  uint8                       ENetFec::getBlockSize() const
+  {
+    return (m_count);
+  }
+
+  /**
+    @brief Get number of recovered datagrams.
+    @return Number of datagrams rebuilt from parity.
+  */
+  uint64                      ENetFec::getRecovered() const
+  {
+    return (m_recovered);
+  }
+
+  /**
+    @brief Get number of datagrams dropped by loss injection.
+    @return Number of dropped datagrams.
+  */
+  uint64                      ENetFec::getDropped() const
+  {
+    return (m_dropped);
+  }
+
+  /**
+    @brief Get bytes of received datagrams kept for recovery.
+    @return Bytes kept, at most ENETFEC_BYTES_MAX.
+  */
+  uint64                      ENetFec::getBytes() const
+  {
+    return (m_bytes);
+  }
+
+  /**
+    @brief Rebuild the missing datagram of a block, if it is the only one and parity is known.
+    @details Storage of a block is released once all its datagrams are known, its mask is kept to ignore duplicates.
+    @param p_block Block of source.
+    @param p_datagrams Datagrams to be read, receiving the rebuilt one.
+  */
+  void                        ENetFec::recover(ENetFecBlock &p_block, std::vector<std::string> &p_datagrams)
+  {
+    if ((true == p_block.m_isParity)
+      && (p_block.m_count == p_block.m_received + 1))
+    {
+      uint8                   l_missing = 0;
+      uint16                  l_length = p_block.m_length;
+      std::string             l_datas = p_block.m_parity;
+
+      for (uint8 l_index = 0; l_index < p_block.m_count; ++l_index)
+      {
+        if (0 == (p_block.m_mask & (1ULL << l_index)))
+        {
+          l_missing = l_index;
+        }
+        else
+        {
+          const std::string   &l_datagram = p_block.m_datagrams[l_index];
+
+          l_length ^= static_cast<uint16>(l_datagram.size());
+          for (size_t l_i = 0; (l_i < l_datagram.size()) && (l_i < l_datas.size()); ++l_i)
+          {
+            l_datas[l_i] ^= l_datagram[l_i];
+          }
+        }
+      }
+      if (l_datas.size() >= l_length)
+      {
+        l_datas.resize(l_length);
+        p_datagrams.push_back(l_datas);
+        p_block.m_mask |= (1ULL << l_missing);
+        ++p_block.m_received;
+        ++m_recovered;
+      }
+    }
+    if (p_block.m_count == p_block.m_received)
+    {
+      std::vector<std::string>().swap(p_block.m_datagrams);
+      std::string().swap(p_block.m_parity);
+    }
+  }
+
+  /**
+    @brief Forget sources and destinations idle for ENETFEC_IDLE. m_mutex must be held by caller.
+    @details Done at most once every ENETFEC_SWEEP.
+    @param p_now GetTickCount64() of caller.
+  */
+  void                        ENetFec::expire(uint64 p_now)
+  {
+    if (ENETFEC_SWEEP <= p_now - m_sweep)
+    {
+      m_sweep = p_now;
+      for (std::map<std::string, ENetFecSource>::iterator l_it = m_decoders.begin(); l_it != m_decoders.end();)
+      {
+        if (ENETFEC_IDLE < p_now - l_it->second.m_last)
+        {
+          for (std::map<uint32, ENetFecBlock>::iterator l_block = l_it->second.m_blocks.begin(); l_block != l_it->second.m_blocks.end(); ++l_block)
+          {
+            m_bytes -= getSize(l_block->second);
+          }
+          l_it = m_decoders.erase(l_it);
+        }
+        else
+        {
+          ++l_it;
+        }
+      }
+      for (std::map<std::string, ENetFecEncoder>::iterator l_it = m_encoders.begin(); l_it != m_encoders.end();)
+      {
+        if (ENETFEC_IDLE < p_now - l_it->second.m_last)
+        {
+          l_it = m_encoders.erase(l_it);
+        }
+        else
+        {
+          ++l_it;
+        }
+      }
+    }
+  }
+
+  /**
+    @brief Get bytes kept by a received block.
+    @param p_block Block of source.
+    @return Bytes of its datagrams and parity.
+  */
+  uint64                      ENetFec::getSize(const ENetFecBlock &p_block) const
+  {
+    uint64                    l_size = p_block.m_parity.size();
+
+    for (std::vector<std::string>::const_iterator l_it = p_block.m_datagrams.begin(); l_it != p_block.m_datagrams.end(); ++l_it)
+    {
+      l_size += l_it->size();
+    }
+
+    return (l_size);
+  }
+
+  /**
+    @brief Build a FEC datagram.
+    @param p_block Identifier of block.
+    @param p_index Index in block, block size for parity.
+    @param p_count Datagrams of block.
+    @param p_length Length of datagram, XOR of lengths for parity.
+    @param p_datas Datagram or parity.
+    @param p_len Length of p_datas.
+    @return FEC datagram.
+  */
+  std::string                 ENetFec::wrap(uint32 p_block, uint8 p_index, uint8 p_count, uint16 p_length,
+                                const char *p_datas, int32 p_len) const
+  {
+    std::string               l_datagram(ENETFEC_HEADER, '\0');
+    ENetPacketType            l_type = ENETPACKET_TYPE_FEC;
+
+    memcpy(&l_datagram[0], &l_type, sizeof(ENetPacketType));
+    memcpy(&l_datagram[4], &p_block, sizeof(uint32));
+    memcpy(&l_datagram[8], &p_index, sizeof(uint8));
+    memcpy(&l_datagram[9], &p_count, sizeof(uint8));
+    memcpy(&l_datagram[10], &p_length, sizeof(uint16));
+    l_datagram.append(p_datas, p_len);
+
+    return (l_datagram);
+  }
+
+}
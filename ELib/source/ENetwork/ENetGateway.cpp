@@ -0,0 +1,615 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetGateway Class.
+*/
+
+#include "ENetwork/ENetGateway.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Functor for ENetGateway::runFront(). /!\ EError.
+    @param p_gateway ENetGateway caller.
+    @return Unused.
+  */
+  DWORD WINAPI                GatewayFrontFunctor(LPVOID p_gateway)
+  {
+    mEERROR_R();
+    if (nullptr != p_gateway)
+    {
+      static_cast<ENetGateway*>(p_gateway)->runFront();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Functor for ENetGateway::runBack(). /!\ EError.
+    @param p_gateway ENetGateway caller.
+    @return Unused.
+  */
+  DWORD WINAPI                GatewayBackFunctor(LPVOID p_gateway)
+  {
+    mEERROR_R();
+    if (nullptr != p_gateway)
+    {
+      static_cast<ENetGateway*>(p_gateway)->runBack();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Constructor for ENetGateway.
+    @details Initialize its mutex, copy settings of ENetPacketHandler Singleton in its ENetPacketHandlers.
+  */
+  ENetGateway::ENetGateway() :
+    m_frontHandler(),
+    m_front(&m_frontHandler),
+    m_backHandler(),
+    m_backends(),
+    m_ring(),
+    m_streams(),
+    m_ids(),
+    m_nextStream(0),
+    m_route(nullptr),
+    m_context(nullptr),
+    m_mutex(nullptr),
+    m_threadFront(nullptr),
+    m_threadBack(nullptr),
+    m_isRunning(false)
+  {
+    m_mutex = CreateMutex(nullptr, false, nullptr);
+    if (nullptr != ENetPacketHandler::getInstance())
+    {
+      m_frontHandler.copySettings(*ENetPacketHandler::getInstance());
+      m_backHandler.copySettings(*ENetPacketHandler::getInstance());
+    }
+  }
+
+  /**
+    @brief Destructor for ENetGateway.
+    @details Stop its threads, release its mutex, delete its ENetClients.
+  */
+  ENetGateway::~ENetGateway()
+  {
+    if (true == m_isRunning)
+    {
+      stop();
+    }
+    while (false == m_backends.empty())
+    {
+      delete (m_backends.begin()->second);
+      m_backends.erase(m_backends.begin());
+    }
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Initialize ENetGateway. /!\ EError.
+    @details Prepare ENetServer of clients.
+    @param p_hostname Internet host address in number-and-dots notation.
+    @param p_port Port of the host.
+  */
+  void                        ENetGateway::init(const std::string &p_hostname, uint16 p_port)
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_GATEWAY_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_front.init(p_hostname, p_port);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SERVER_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Connect a backend to ENetGateway. /!\ Mutex. /!\ EError.
+    @details Streams whose routing key now belongs to backend are moved to it.
+    @param p_backend Backend identifier.
+    @param p_hostname Internet host address of backend in number-and-dots notation.
+    @param p_port Port of backend.
+    @param p_weight Relative capacity of backend.
+  */
+  void                        ENetGateway::addBackend(uint32 p_backend, const std::string &p_hostname, uint16 p_port, uint32 p_weight)
+  {
+    ENetClient                *l_client = nullptr;
+
+    mEERROR_R();
+    if (nullptr == m_mutex)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      l_client = new ENetClient(&m_backHandler);
+      if (nullptr != l_client)
+      {
+        l_client->init(p_hostname, p_port);
+        if (EERROR_NONE == mEERROR)
+        {
+          l_client->start();
+        }
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_CLIENT_ERR);
+          delete (l_client);
+          l_client = nullptr;
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_MEMORY);
+      }
+    }
+    if (EERROR_NONE == mEERROR)
+    {
+      WaitForSingleObject(m_mutex, INFINITE);
+      m_ring.addNode(p_backend, p_weight);
+      if (EERROR_NONE == mEERROR)
+      {
+        m_backends[p_backend] = l_client;
+        rebalance();
+        mEPRINT_STD("ENetGateway: Backend " + std::to_string(p_backend) + " connected to " + p_hostname + ":" + std::to_string(p_port) + ".");
+      }
+      else
+      {
+        delete (l_client);
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Disconnect a backend from ENetGateway. /!\ Mutex. /!\ EError.
+    @details Streams of backend are moved to the following backends of ENetHashRing.
+    @param p_backend Backend identifier.
+  */
+  void                        ENetGateway::removeBackend(uint32 p_backend)
+  {
+    mEERROR_R();
+    if (nullptr == m_mutex)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      WaitForSingleObject(m_mutex, INFINITE);
+      if (m_backends.end() != m_backends.find(p_backend))
+      {
+        dropBackend(p_backend);
+      }
+      else
+      {
+        mEERROR_S(EERROR_OUT_OF_RANGE);
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Start ENetGateway automation. /!\ EError.
+    @details Start ENetServer of clients, create threads for runFront() and runBack().
+  */
+  void                        ENetGateway::start()
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_GATEWAY_STATE);
+    }
+    if (nullptr == m_mutex)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_front.start();
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SERVER_ERR);
+      }
+    }
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = true;
+      m_threadFront = CreateThread(nullptr, 0, GatewayFrontFunctor, this, 0, nullptr);
+      m_threadBack = CreateThread(nullptr, 0, GatewayBackFunctor, this, 0, nullptr);
+      if ((nullptr != m_threadFront)
+        && (nullptr != m_threadBack))
+      {
+        mEPRINT_STD("ENetGateway: Started successfully.");
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+        stop();
+        mEERROR_R();
+        mEERROR_S(EERROR_NET_GATEWAY_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Stop ENetGateway automation. /!\ Blocking. /!\ EError.
+    @details Wake and wait for its threads, stop ENetServer of clients. Backends stay connected.
+  */
+  void                        ENetGateway::stop()
+  {
+    mEERROR_R();
+    if (false == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_GATEWAY_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = false;
+      SetEvent(m_frontHandler.getEvent());
+      SetEvent(m_backHandler.getEvent());
+      if (nullptr != m_threadFront)
+      {
+        WaitForSingleObject(m_threadFront, INFINITE);
+        CloseHandle(m_threadFront);
+        m_threadFront = nullptr;
+      }
+      if (nullptr != m_threadBack)
+      {
+        WaitForSingleObject(m_threadBack, INFINITE);
+        CloseHandle(m_threadBack);
+        m_threadBack = nullptr;
+      }
+      if (true == m_front.isRunning())
+      {
+        m_front.stop();
+      }
+      mEERROR_R();
+      mEPRINT_STD("ENetGateway: Stopped successfully.");
+    }
+  }
+
+  /**
+    @brief Loop forwarding ENetPacket of clients to backends. /!\ Blocking. /!\ Mutex.
+    @details Wait for the event of ENetPacketHandler of clients when its queues are empty.
+  */
+  void                        ENetGateway::runFront()
+  {
+    while (true == m_isRunning)
+    {
+      ENetPacket              *l_packet = nullptr;
+
+      ResetEvent(m_frontHandler.getEvent());
+      l_packet = m_frontHandler.popPacket();
+      if (nullptr != l_packet)
+      {
+        WaitForSingleObject(m_mutex, INFINITE);
+        forward(l_packet);
+        ReleaseMutex(m_mutex);
+        delete (l_packet);
+      }
+      else if (true == m_isRunning)
+      {
+        WaitForSingleObject(m_frontHandler.getEvent(), INFINITE);
+      }
+    }
+  }
+
+  /**
+    @brief Loop delivering ENetPacketGateway of backends to clients. /!\ Blocking. /!\ Mutex.
+    @details A disconnected backend is removed, its streams are moved.
+    @details Wait for the event of ENetPacketHandler of backends when its queues are empty.
+  */
+  void                        ENetGateway::runBack()
+  {
+    while (true == m_isRunning)
+    {
+      ENetPacket              *l_packet = nullptr;
+
+      ResetEvent(m_backHandler.getEvent());
+      l_packet = m_backHandler.popPacket();
+      if (nullptr != l_packet)
+      {
+        WaitForSingleObject(m_mutex, INFINITE);
+        if (ENETPACKET_TYPE_GATEWAY == l_packet->getType())
+        {
+          deliver(static_cast<ENetPacketGateway*>(l_packet));
+        }
+        else if (ENETPACKET_TYPE_DISCONNECT == l_packet->getType())
+        {
+          for (std::map<uint32, ENetClient*>::iterator l_it = m_backends.begin(); l_it != m_backends.end(); ++l_it)
+          {
+            if (l_packet->getSource() == l_it->second->getSocket())
+            {
+              mEPRINT_ERR("ENetGateway: Backend " + std::to_string(l_it->first) + " disconnected.");
+              dropBackend(l_it->first);
+              break;
+            }
+          }
+        }
+        ReleaseMutex(m_mutex);
+        delete (l_packet);
+      }
+      else if (true == m_isRunning)
+      {
+        WaitForSingleObject(m_backHandler.getEvent(), INFINITE);
+      }
+    }
+  }
+
+  /**
+    @brief Set function giving the routing key of client datas.
+    @details Without function, streams are routed by their identifier (one session per connection).
+    @param p_route ENetGatewayRoute.
+    @param p_context Context of function.
+  */
+  void                        ENetGateway::setRoute(ENetGatewayRoute p_route, void *p_context)
+  {
+    m_route = p_route;
+    m_context = p_context;
+  }
+
+  /**
+    @brief Get number of client streams. /!\ Mutex.
+    @return Number of client streams.
+  */
+  uint32                      ENetGateway::getStreamCount() const
+  {
+    uint32                    l_count = 0;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_count = static_cast<uint32>(m_streams.size());
+    ReleaseMutex(m_mutex);
+
+    return (l_count);
+  }
+
+  /**
+    @brief Get number of backends. /!\ Mutex.
+    @return Number of connected backends.
+  */
+  uint32                      ENetGateway::getBackendCount() const
+  {
+    uint32                    l_count = 0;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_count = static_cast<uint32>(m_backends.size());
+    ReleaseMutex(m_mutex);
+
+    return (l_count);
+  }
+
+  /**
+    @brief Get state of ENetGateway.
+    @return State.
+  */
+  bool                        ENetGateway::isRunning() const
+  {
+    return (m_isRunning);
+  }
+
+  /**
+    @brief Forward a ENetPacket of client. m_mutex must be held by caller.
+    @details First ENetPacket of a client opens its stream. ENetPacketDisconnect closes it.
+    @details ENetPacketRawDatas are routed to backend of stream, other ENetPacket are dropped.
+    @param p_packet ENetPacket of client.
+  */
+  void                        ENetGateway::forward(ENetPacket *p_packet)
+  {
+    std::unordered_map<const ENetSocket*, uint64>::iterator l_id = m_ids.find(p_packet->getSource());
+
+    if (ENETPACKET_TYPE_DISCONNECT == p_packet->getType())
+    {
+      if (m_ids.end() != l_id)
+      {
+        std::unordered_map<uint64, ENetGatewayStream>::iterator l_stream = m_streams.find(l_id->second);
+
+        if (m_streams.end() != l_stream)
+        {
+          close(l_stream->first, l_stream->second);
+          m_streams.erase(l_stream);
+        }
+        m_ids.erase(l_id);
+      }
+    }
+    else if (ENETPACKET_TYPE_RAW_DATAS == p_packet->getType())
+    {
+      const ENetPacketRawDatas *l_datas = static_cast<const ENetPacketRawDatas*>(p_packet);
+      uint64                  l_stream = 0;
+      uint64                  l_key = 0;
+
+      if (m_ids.end() != l_id)
+      {
+        l_stream = l_id->second;
+      }
+      else
+      {
+        ENetGatewayStream     l_infos = { const_cast<ENetSocket*>(p_packet->getSource()), 0, 0, false };
+
+        l_stream = ++m_nextStream;
+        l_infos.m_key = l_stream;
+        m_streams[l_stream] = l_infos;
+        m_ids[p_packet->getSource()] = l_stream;
+      }
+      l_key = m_streams[l_stream].m_key;
+      if ((nullptr != m_route)
+        && (true == m_route(l_datas, l_stream, l_key, m_context))
+        && (l_key != m_streams[l_stream].m_key))
+      {
+        close(l_stream, m_streams[l_stream]);
+        m_streams[l_stream].m_key = l_key;
+      }
+      route(l_stream, m_streams[l_stream], l_datas->getDatas(), l_datas->getLength());
+    }
+  }
+
+  /**
+    @brief Deliver a ENetPacketGateway of backend to its client. m_mutex must be held by caller.
+    @details Datas are posted to client as ENetPacketRawDatas. Unknown streams are dropped.
+    @param p_packet ENetPacketGateway of backend.
+  */
+  void                        ENetGateway::deliver(ENetPacketGateway *p_packet)
+  {
+    std::unordered_map<uint64, ENetGatewayStream>::iterator l_stream = m_streams.find(p_packet->getStream());
+
+    mEERROR_R();
+    if ((m_streams.end() != l_stream)
+      && (0 == (ENETPACKETGATEWAY_FLAG_CLOSED & p_packet->getFlags())))
+    {
+      ENetPacketRawDatas      l_packet(l_stream->second.m_client);
+      int32                   l_len = static_cast<int32>(p_packet->getDatas().size());
+      char                    *l_datas = nullptr;
+
+      l_datas = new char[(0 < l_len) ? l_len : 1];
+      if (nullptr != l_datas)
+      {
+        memcpy(l_datas, p_packet->getDatas().c_str(), l_len);
+        l_packet.setDatas(l_datas, l_len);
+        l_packet.post();
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_PACKET_ERR);
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_MEMORY);
+      }
+    }
+  }
+
+  /**
+    @brief Send datas of a stream to its backend. m_mutex must be held by caller.
+    @details Stream is routed on the backend owning its key, if not already routed.
+    @details Datas over ENETPACKETGATEWAY_MAX are split into consecutive ENetPacketGateway of the stream.
+    @param p_id Stream identifier.
+    @param p_stream Stream.
+    @param p_datas Datas of client.
+    @param p_len Datas length.
+  */
+  void                        ENetGateway::route(uint64 p_id, ENetGatewayStream &p_stream, const char *p_datas, int32 p_len)
+  {
+    mEERROR_R();
+    if (false == p_stream.m_isRouted)
+    {
+      p_stream.m_isRouted = m_ring.getNode(p_stream.m_key, p_stream.m_backend);
+    }
+    if (true == p_stream.m_isRouted)
+    {
+      ENetPacketGateway       l_packet;
+      int32                   l_offset = 0;
+
+      l_packet.setStream(p_id);
+      l_packet.setKey(p_stream.m_key);
+      do
+      {
+        int32                 l_len = min(p_len - l_offset, ENETPACKETGATEWAY_MAX);
+
+        l_packet.setDatas(p_datas + l_offset, l_len);
+        m_backends[p_stream.m_backend]->send(&l_packet);
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_CLIENT_ERR);
+        }
+        l_offset += l_len;
+      } while ((EERROR_NONE == mEERROR)
+        && (l_offset < p_len));
+    }
+  }
+
+  /**
+    @brief Close a stream on its backend. m_mutex must be held by caller.
+    @details Backend receive an ENetPacketGateway with ENETPACKETGATEWAY_FLAG_CLOSED. Stream is no more routed.
+    @param p_id Stream identifier.
+    @param p_stream Stream.
+  */
+  void                        ENetGateway::close(uint64 p_id, ENetGatewayStream &p_stream)
+  {
+    std::map<uint32, ENetClient*>::iterator l_backend = m_backends.find(p_stream.m_backend);
+
+    mEERROR_R();
+    if ((true == p_stream.m_isRouted)
+      && (m_backends.end() != l_backend))
+    {
+      ENetPacketGateway       l_packet;
+
+      l_packet.setStream(p_id);
+      l_packet.setKey(p_stream.m_key);
+      l_packet.setFlags(ENETPACKETGATEWAY_FLAG_CLOSED);
+      l_backend->second->send(&l_packet);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_CLIENT_ERR);
+      }
+    }
+    p_stream.m_isRouted = false;
+  }
+
+  /**
+    @brief Move streams whose key changed of backend. m_mutex must be held by caller.
+    @details Only streams owned by added or removed points move, others stay on their backend.
+  */
+  void                        ENetGateway::rebalance()
+  {
+    for (std::unordered_map<uint64, ENetGatewayStream>::iterator l_it = m_streams.begin(); l_it != m_streams.end(); ++l_it)
+    {
+      uint32                  l_backend = 0;
+
+      if ((true == l_it->second.m_isRouted)
+        && ((false == m_ring.getNode(l_it->second.m_key, l_backend))
+          || (l_backend != l_it->second.m_backend)))
+      {
+        close(l_it->first, l_it->second);
+      }
+    }
+  }
+
+  /**
+    @brief Remove a backend. m_mutex must be held by caller.
+    @details Its streams are no more routed, next datas route them on the following backends.
+    @param p_backend Backend identifier.
+  */
+  void                        ENetGateway::dropBackend(uint32 p_backend)
+  {
+    std::map<uint32, ENetClient*>::iterator l_it = m_backends.find(p_backend);
+
+    if (m_backends.end() != l_it)
+    {
+      ENetClient              *l_client = l_it->second;
+
+      m_ring.removeNode(p_backend);
+      m_backends.erase(l_it);
+      rebalance();
+      if (true == l_client->isRunning())
+      {
+        l_client->stop();
+      }
+      m_backHandler.cleanSocket(l_client->getSocket());
+      delete (l_client);
+      mEERROR_R();
+    }
+  }
+
+}
@@ -0,0 +1,152 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetHashRing Class.
+*/
+
+#include "ENetwork/ENetHashRing.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Constructor for ENetHashRing.
+    @param p_replicas Points of a node of weight 1. More points give a better balance but a bigger ring.
+  */
+  ENetHashRing::ENetHashRing(uint32 p_replicas) :
+    m_replicas((0 != p_replicas) ? p_replicas : 1),
+    m_ring(),
+    m_nodes()
+  {
+  }
+
+  /**
+    @brief Destructor for ENetHashRing.
+  */
+  ENetHashRing::~ENetHashRing()
+  {
+  }
+
+  /**
+    @brief Add a node to ENetHashRing. /!\ EError.
+    @details Keys now owned by the points of node move to it, other keys stay in place.
+    @param p_node Node identifier.
+    @param p_weight Relative capacity of node.
+  */
+  void                        ENetHashRing::addNode(uint32 p_node, uint32 p_weight)
+  {
+    mEERROR_R();
+    if (true == hasNode(p_node))
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+    if (0 == p_weight)
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      uint64                  l_points = static_cast<uint64>(p_weight) * m_replicas;
+
+      m_nodes[p_node] = p_weight;
+      for (uint64 l_point = 0; l_point < l_points; ++l_point)
+      {
+        m_ring.insert(std::make_pair(hash((static_cast<uint64>(p_node) << 32) ^ l_point), p_node));
+      }
+    }
+  }
+
+  /**
+    @brief Remove a node from ENetHashRing. /!\ EError.
+    @details Keys of node move to the following points, other keys stay in place.
+    @param p_node Node identifier.
+  */
+  void                        ENetHashRing::removeNode(uint32 p_node)
+  {
+    mEERROR_R();
+    if (false == hasNode(p_node))
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      for (std::map<uint64, uint32>::iterator l_it = m_ring.begin(); l_it != m_ring.end(); )
+      {
+        if (p_node == l_it->second)
+        {
+          l_it = m_ring.erase(l_it);
+        }
+        else
+        {
+          ++l_it;
+        }
+      }
+      m_nodes.erase(p_node);
+    }
+  }
+
+  /**
+    @brief Get node owning a key.
+    @param p_key Key (session, room...).
+    @param p_node Node owning key.
+    @return false if ENetHashRing is empty.
+  */
+  bool                        ENetHashRing::getNode(uint64 p_key, uint32 &p_node) const
+  {
+    bool                      l_isFound = false;
+
+    if (false == m_ring.empty())
+    {
+      std::map<uint64, uint32>::const_iterator l_it = m_ring.lower_bound(hash(p_key));
+
+      if (m_ring.end() == l_it)
+      {
+        l_it = m_ring.begin();
+      }
+      p_node = l_it->second;
+      l_isFound = true;
+    }
+
+    return (l_isFound);
+  }
+
+  /**
+    @brief Check if a node is in ENetHashRing.
+    @param p_node Node identifier.
+    @return true if node is in ENetHashRing.
+  */
+  bool                        ENetHashRing::hasNode(uint32 p_node) const
+  {
+    return (m_nodes.end() != m_nodes.find(p_node));
+  }
+
+  /**
+    @brief Get number of nodes of ENetHashRing.
+    @return Number of nodes.
+  */
+  uint32                      ENetHashRing::getSize() const
+  {
+    return (static_cast<uint32>(m_nodes.size()));
+  }
+
+  /**
+    @brief Mix a value over 64 bits (SplitMix64 finalizer).
+    @details Close values (consecutive identifiers) give unrelated positions on the ring.
+    @param p_value Value.
+    @return Hash of value.
+  */
+  uint64                      ENetHashRing::hash(uint64 p_value)
+  {
+    p_value += 0x9E3779B97F4A7C15ULL;
+    p_value = (p_value ^ (p_value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    p_value = (p_value ^ (p_value >> 27)) * 0x94D049BB133111EBULL;
+
+    return (p_value ^ (p_value >> 31));
+  }
+
+}
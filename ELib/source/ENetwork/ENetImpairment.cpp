@@ -0,0 +1,467 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetImpairment Class.
+*/
+
+#include "ENetwork/ENetImpairment.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Functor for ENetImpairment::run(). /!\ EError.
+    @param p_impairment ENetImpairment caller.
+    @return Unused.
+  */
+  DWORD WINAPI                ImpairmentRunFunctor(LPVOID p_impairment)
+  {
+    mEERROR_R();
+    if (nullptr != p_impairment)
+    {
+      static_cast<ENetImpairment*>(p_impairment)->run();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Constructor for ENetImpairment.
+    @details Initialize its mutex. Settings do not impair datas.
+  */
+  ENetImpairment::ENetImpairment() :
+    m_settings({ 0, 0, 0.0, 0.0, 0.0, 0 }),
+    m_frames(),
+    m_links(),
+    m_forgotten(),
+    m_sweep(0),
+    m_random(0),
+    m_order(0),
+    m_drops(0),
+    m_duplicates(0),
+    m_frequency(),
+    m_mutex(nullptr),
+    m_threadRun(nullptr),
+    m_isRunning(false)
+  {
+    m_mutex = CreateMutex(nullptr, false, nullptr);
+    QueryPerformanceFrequency(&m_frequency);
+  }
+
+  /**
+    @brief Destructor for ENetImpairment.
+    @details Stop its thread, release its mutex. Waiting frames are dropped.
+  */
+  ENetImpairment::~ENetImpairment()
+  {
+    if (true == m_isRunning)
+    {
+      stop();
+    }
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Start ENetImpairment automation. /!\ EError.
+    @details Create thread for run(). Sent datas of attached ENetSockets are impaired from now on.
+  */
+  void                        ENetImpairment::start()
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_IMPAIRMENT_STATE);
+    }
+    if (nullptr == m_mutex)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = true;
+      m_threadRun = CreateThread(nullptr, 0, ImpairmentRunFunctor, this, 0, nullptr);
+      if (nullptr == m_threadRun)
+      {
+        m_isRunning = false;
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+      }
+    }
+  }
+
+  /**
+    @brief Stop ENetImpairment automation. /!\ Blocking. /!\ EError.
+    @details Wait for run() thread. Waiting frames are kept for next start().
+  */
+  void                        ENetImpairment::stop()
+  {
+    mEERROR_R();
+    if (false == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_IMPAIRMENT_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = false;
+      WaitForSingleObject(m_threadRun, INFINITE);
+      CloseHandle(m_threadRun);
+      m_threadRun = nullptr;
+    }
+  }
+
+  /**
+    @brief Loop of ENetImpairment. /!\ Blocking. /!\ Mutex.
+    @details Send the earliest frame once it is due. Frames of forgotten ENetSockets are skipped.
+    @details Remove links free since last sweep every ENETIMPAIRMENT_SWEEP milliseconds.
+    @details Sleep ENETIMPAIRMENT_IDLE milliseconds while no frame is due within it, yield otherwise.
+    @details Connected frames are sent until complete, as the stream would be corrupted otherwise.
+    @details Sending errors are ignored, as a lossy network would.
+  */
+  void                        ENetImpairment::run()
+  {
+    while (true == m_isRunning)
+    {
+      ENetImpairmentFrame     l_frame = { 0, 0, 0, 0, 0, "" };
+      bool                    l_isDue = false;
+      bool                    l_isIdle = true;
+      LARGE_INTEGER           l_time = { 0 };
+
+      QueryPerformanceCounter(&l_time);
+      WaitForSingleObject(m_mutex, INFINITE);
+      while ((false == m_frames.empty())
+        && (false == m_forgotten.empty()))
+      {
+        std::map<uint64, uint64>::const_iterator l_forgotten = m_forgotten.find(m_frames.top().m_socket);
+
+        if ((m_forgotten.end() == l_forgotten)
+          || (l_forgotten->second <= m_frames.top().m_order))
+        {
+          break;
+        }
+        m_frames.pop();
+      }
+      if (true == m_frames.empty())
+      {
+        m_forgotten.clear();
+      }
+      if (l_time.QuadPart >= m_sweep)
+      {
+        for (std::map<std::string, LONGLONG>::iterator l_it = m_links.begin(); l_it != m_links.end();)
+        {
+          if (l_time.QuadPart >= l_it->second)
+          {
+            l_it = m_links.erase(l_it);
+          }
+          else
+          {
+            ++l_it;
+          }
+        }
+        m_sweep = l_time.QuadPart + m_frequency.QuadPart * ENETIMPAIRMENT_SWEEP / 1000;
+      }
+      if (false == m_frames.empty())
+      {
+        if (l_time.QuadPart >= m_frames.top().m_due)
+        {
+          l_frame = m_frames.top();
+          m_frames.pop();
+          l_isDue = true;
+        }
+        else
+        {
+          l_isIdle = (m_frames.top().m_due - l_time.QuadPart > m_frequency.QuadPart * ENETIMPAIRMENT_IDLE / 1000);
+        }
+      }
+      ReleaseMutex(m_mutex);
+      if (true == l_isDue)
+      {
+        if (0 == l_frame.m_port)
+        {
+          int                 l_offset = 0;
+          int                 l_sent = 0;
+
+          while ((static_cast<int>(l_frame.m_datas.size()) > l_offset)
+            && (0 < (l_sent = ::send(static_cast<SOCKET>(l_frame.m_socket), l_frame.m_datas.data() + l_offset,
+              static_cast<int>(l_frame.m_datas.size()) - l_offset, 0))))
+          {
+            l_offset += l_sent;
+          }
+        }
+        else
+        {
+          SOCKADDR_IN         l_infos = { 0 };
+
+          l_infos.sin_addr.s_addr = l_frame.m_address;
+          l_infos.sin_port = htons(l_frame.m_port);
+          l_infos.sin_family = ENETSOCKET_FAMILY;
+          ::sendto(static_cast<SOCKET>(l_frame.m_socket), l_frame.m_datas.data(), static_cast<int>(l_frame.m_datas.size()), 0,
+            reinterpret_cast<SOCKADDR*>(&l_infos), sizeof(SOCKADDR_IN));
+        }
+      }
+      else if (true == l_isIdle)
+      {
+        Sleep(ENETIMPAIRMENT_IDLE);
+      }
+      else
+      {
+        SwitchToThread();
+      }
+    }
+  }
+
+  /**
+    @brief Queue a frame sent by an ENetSocket. /!\ Blocking. /!\ Mutex.
+    @details Connected datas are delayed on their link, never lost, duplicated nor reordered.
+      While ENETIMPAIRMENT_QUEUE_MAX frames are waiting, sender is held until run() sends some, as a full send buffer would.
+    @details A datagram may be lost, duplicated, or sent without latency before older ones.
+      It is dropped when ENETIMPAIRMENT_QUEUE_MAX frames are waiting.
+    @param p_socket ENetSocket sending frame.
+    @param p_datas Frame.
+    @param p_len Frame length.
+    @param p_address IPv4 address of destination of datagram, in network byte order.
+    @param p_port Port of destination of datagram, 0 for connected datas.
+    @return p_len, as lost datas are sent for the sender.
+    @return -1 on invalid parameters.
+  */
+  int32                       ENetImpairment::push(const ENetSocket *p_socket, const char *p_datas, uint16 p_len, uint32 p_address, uint16 p_port)
+  {
+    int32                     l_len = -1;
+
+    if ((nullptr != p_socket)
+      && (nullptr != p_datas))
+    {
+      ENetImpairmentFrame     l_frame = { 0, 0, static_cast<uint64>(*p_socket), p_address, p_port, std::string(p_datas, p_len) };
+      std::uniform_real_distribution<double> l_draw(0.0, 1.0);
+      LARGE_INTEGER           l_time = { 0 };
+
+      WaitForSingleObject(m_mutex, INFINITE);
+      while ((0 == p_port)
+        && (ENETIMPAIRMENT_QUEUE_MAX <= m_frames.size())
+        && (true == m_isRunning))
+      {
+        ReleaseMutex(m_mutex);
+        Sleep(ENETIMPAIRMENT_IDLE);
+        WaitForSingleObject(m_mutex, INFINITE);
+      }
+      QueryPerformanceCounter(&l_time);
+      if (0 == p_port)
+      {
+        l_frame.m_due = schedule(std::to_string(l_frame.m_socket), l_time.QuadPart, p_len, true);
+        l_frame.m_order = m_order++;
+        m_frames.push(l_frame);
+      }
+      else if ((l_draw(m_random) < m_settings.m_loss)
+        || (ENETIMPAIRMENT_QUEUE_MAX <= m_frames.size()))
+      {
+        ++m_drops;
+      }
+      else
+      {
+        std::string           l_link = std::to_string(l_frame.m_socket) + ":" + std::to_string(p_address) + ":" + std::to_string(p_port);
+
+        if (l_draw(m_random) < m_settings.m_reorder)
+        {
+          l_frame.m_due = l_time.QuadPart;
+        }
+        else
+        {
+          l_frame.m_due = schedule(l_link, l_time.QuadPart, p_len, false);
+        }
+        l_frame.m_order = m_order++;
+        m_frames.push(l_frame);
+        if (l_draw(m_random) < m_settings.m_duplicate)
+        {
+          l_frame.m_due = schedule(l_link, l_time.QuadPart, p_len, false);
+          l_frame.m_order = m_order++;
+          m_frames.push(l_frame);
+          ++m_duplicates;
+        }
+      }
+      ReleaseMutex(m_mutex);
+      l_len = p_len;
+    }
+
+    return (l_len);
+  }
+
+  /**
+    @brief Drop waiting frames and links of an ENetSocket. /!\ Mutex.
+    @details Called when ENetSocket is closed, so its frames are never sent on a reused SOCKET.
+    @details Frames are not removed from queue: SOCKET is marked with current push order, run() skips its older frames.
+    @param p_socket ENetSocket closed.
+  */
+  void                        ENetImpairment::forget(const ENetSocket *p_socket)
+  {
+    if (nullptr != p_socket)
+    {
+      uint64                  l_socket = static_cast<uint64>(*p_socket);
+      std::string             l_prefix = std::to_string(l_socket);
+
+      WaitForSingleObject(m_mutex, INFINITE);
+      if (false == m_frames.empty())
+      {
+        m_forgotten[l_socket] = m_order;
+      }
+      for (std::map<std::string, LONGLONG>::iterator l_it = m_links.lower_bound(l_prefix); l_it != m_links.end();)
+      {
+        if ((l_prefix == l_it->first)
+          || (0 == l_it->first.compare(0, l_prefix.size() + 1, l_prefix + ":")))
+        {
+          l_it = m_links.erase(l_it);
+        }
+        else if (0 == l_it->first.compare(0, l_prefix.size(), l_prefix))
+        {
+          ++l_it;
+        }
+        else
+        {
+          break;
+        }
+      }
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Set impairments applied to next frames. /!\ Mutex.
+    @param p_settings Impairments. Probabilities are in [0, 1].
+  */
+  void                        ENetImpairment::setSettings(const ENetImpairmentSettings &p_settings)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_settings = p_settings;
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Get impairments applied to next frames. /!\ Mutex.
+    @return Impairments.
+  */
+  const ENetImpairmentSettings ENetImpairment::getSettings() const
+  {
+    ENetImpairmentSettings    l_settings;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_settings = m_settings;
+    ReleaseMutex(m_mutex);
+
+    return (l_settings);
+  }
+
+  /**
+    @brief Seed random draws, to reproduce a run. /!\ Mutex.
+    @param p_seed Seed of generator.
+  */
+  void                        ENetImpairment::setSeed(uint32 p_seed)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_random.seed(p_seed);
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Get number of waiting frames. /!\ Mutex.
+    @details Frames of forgotten ENetSockets are counted until run() skips them.
+    @return Waiting frames.
+  */
+  uint32                      ENetImpairment::getSize() const
+  {
+    uint32                    l_size = 0;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_size = static_cast<uint32>(m_frames.size());
+    ReleaseMutex(m_mutex);
+
+    return (l_size);
+  }
+
+  /**
+    @brief Get datagrams lost, or dropped on full queue.
+    @return Dropped datagrams.
+  */
+  uint64                      ENetImpairment::getDrops() const
+  {
+    return (m_drops);
+  }
+
+  /**
+    @brief Get datagrams duplicated.
+    @return Duplicated datagrams.
+  */
+  uint64                      ENetImpairment::getDuplicates() const
+  {
+    return (m_duplicates);
+  }
+
+  /**
+    @brief Get state of ENetImpairment.
+    @return true if run() thread is running.
+  */
+  bool                        ENetImpairment::isRunning() const
+  {
+    return (m_isRunning);
+  }
+
+  /**
+    @brief Compare due time of two frames, then push order.
+    @param p_frame Other frame.
+    @return true if frame is sent after p_frame.
+  */
+  bool                        ENetImpairment::ENetImpairmentFrame::operator>(const ENetImpairmentFrame &p_frame) const
+  {
+    return ((m_due > p_frame.m_due)
+      || ((m_due == p_frame.m_due) && (m_order > p_frame.m_order)));
+  }
+
+  /**
+    @brief Compute due time of a frame on its link.
+    @details Delay is latency plus a uniform jitter, never negative. Ordered frames and limited links
+      never leave before the link is free, then a limited link is busy for the transmission of the frame.
+    @param p_link Link of frame.
+    @param p_now Performance counter at push.
+    @param p_len Frame length.
+    @param p_isOrdered true if frame must not leave before older frames of its link.
+    @return Performance counter when frame is sent.
+  */
+  LONGLONG                    ENetImpairment::schedule(const std::string &p_link, LONGLONG p_now, uint16 p_len, bool p_isOrdered)
+  {
+    std::uniform_int_distribution<int64> l_jitter(-static_cast<int64>(m_settings.m_jitter), m_settings.m_jitter);
+    int64                     l_delay = static_cast<int64>(m_settings.m_latency) + l_jitter(m_random);
+    LONGLONG                  l_due = p_now;
+
+    if (0 < l_delay)
+    {
+      l_due += l_delay * m_frequency.QuadPart / 1000000;
+    }
+    if ((true == p_isOrdered)
+      || (0 != m_settings.m_rate))
+    {
+      LONGLONG                &l_free = m_links[p_link];
+
+      if (l_free > l_due)
+      {
+        l_due = l_free;
+      }
+      if (0 != m_settings.m_rate)
+      {
+        l_free = l_due + static_cast<LONGLONG>(p_len * m_frequency.QuadPart / m_settings.m_rate);
+      }
+      else
+      {
+        l_free = l_due;
+      }
+    }
+
+    return (l_due);
+  }
+
+}
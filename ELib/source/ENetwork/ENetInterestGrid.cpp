@@ -0,0 +1,455 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetInterestGrid Class.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "ENetwork/ENetInterestGrid.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                   ELib
+{
+
+  /**
+    @brief Registered ENetInterestGrid instances.
+  */
+  struct                    ENetInterestGrids
+  {
+    std::vector<ENetInterestGrid*> m_grids; /**< Living instances. */
+    HANDLE                  m_mutex;        /**< m_grids semaphore. */
+  };
+
+  /**
+    @brief Get registered ENetInterestGrid instances.
+    @return Instances, created on first call.
+  */
+  static ENetInterestGrids  &GetInterestGrids()
+  {
+    static ENetInterestGrids  l_grids = { std::vector<ENetInterestGrid*>(), CreateMutex(nullptr, false, nullptr) };
+
+    return (l_grids);
+  }
+
+  /**
+    @brief Constructor for ENetInterestGrid.
+    @details Initialize its mutex, register instance for removeAll().
+    @param p_cellSize Side length of a cell. Should be close to the usual radius of interest.
+  */
+  ENetInterestGrid::ENetInterestGrid(float p_cellSize) :
+    m_cellSize(0.0f < p_cellSize ? p_cellSize : 64.0f),
+    m_entities(),
+    m_indexes(),
+    m_cells(),
+    m_mutexGrid(nullptr)
+  {
+    ENetInterestGrids       &l_grids = GetInterestGrids();
+
+    m_mutexGrid = CreateMutex(nullptr, false, nullptr);
+    WaitForSingleObject(l_grids.m_mutex, INFINITE);
+    l_grids.m_grids.push_back(this);
+    ReleaseMutex(l_grids.m_mutex);
+  }
+
+  /**
+    @brief Destructor for ENetInterestGrid.
+    @details Unregister instance, release its mutex.
+  */
+  ENetInterestGrid::~ENetInterestGrid()
+  {
+    ENetInterestGrids       &l_grids = GetInterestGrids();
+
+    WaitForSingleObject(l_grids.m_mutex, INFINITE);
+    l_grids.m_grids.erase(std::remove(l_grids.m_grids.begin(), l_grids.m_grids.end(), this), l_grids.m_grids.end());
+    ReleaseMutex(l_grids.m_mutex);
+    ReleaseMutex(m_mutexGrid);
+    CloseHandle(m_mutexGrid);
+  }
+
+  /**
+    @brief Insert or move an entity. /!\ Mutex. /!\ EError.
+    @details Entity is only moved to another cell when its new position is outside of its current cell.
+    @param p_entity Entity identifier.
+    @param p_client ENetSocket of the entity owner.
+    @param p_x Position on X axis.
+    @param p_y Position on Y axis.
+  */
+  void                      ENetInterestGrid::setEntity(ENetEntityId p_entity, ENetSocket *p_client, float p_x, float p_y)
+  {
+    mEERROR_R();
+    if (nullptr == p_client)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::unordered_map<ENetEntityId, uint32>::iterator  l_index;
+      uint64                l_cell = 0;
+
+      l_cell = getCell(p_x, p_y);
+      WaitForSingleObject(m_mutexGrid, INFINITE);
+      l_index = m_indexes.find(p_entity);
+      if (m_indexes.end() != l_index)
+      {
+        ENetEntity          &l_entity = m_entities[l_index->second];
+
+        l_entity.m_client = p_client;
+        l_entity.m_x = p_x;
+        l_entity.m_y = p_y;
+        if (l_cell != l_entity.m_cell)
+        {
+          removeCell(l_index->second);
+          l_entity.m_cell = l_cell;
+          insertCell(l_index->second);
+        }
+      }
+      else
+      {
+        ENetEntity          l_entity = { p_entity, p_client, p_x, p_y, l_cell, 0 };
+
+        m_indexes[p_entity] = static_cast<uint32>(m_entities.size());
+        m_entities.push_back(l_entity);
+        insertCell(static_cast<uint32>(m_entities.size() - 1));
+      }
+      ReleaseMutex(m_mutexGrid);
+    }
+  }
+
+  /**
+    @brief Remove an entity from the grid. /!\ Mutex.
+    @param p_entity Entity identifier.
+  */
+  void                      ENetInterestGrid::removeEntity(ENetEntityId p_entity)
+  {
+    std::unordered_map<ENetEntityId, uint32>::iterator  l_index;
+
+    WaitForSingleObject(m_mutexGrid, INFINITE);
+    l_index = m_indexes.find(p_entity);
+    if (m_indexes.end() != l_index)
+    {
+      removeIndex(l_index->second);
+    }
+    ReleaseMutex(m_mutexGrid);
+  }
+
+  /**
+    @brief Remove every entities owned by a ENetSocket. /!\ Mutex.
+    @details Done by ENetSelector on disconnection of the owner, see removeAll().
+    @param p_client ENetSocket of the entities owner.
+  */
+  void                      ENetInterestGrid::removeClient(const ENetSocket *p_client)
+  {
+    WaitForSingleObject(m_mutexGrid, INFINITE);
+    for (uint32 l_index = 0; l_index < m_entities.size(); )
+    {
+      if (p_client == m_entities[l_index].m_client)
+      {
+        removeIndex(l_index);
+      }
+      else
+      {
+        ++l_index;
+      }
+    }
+    ReleaseMutex(m_mutexGrid);
+  }
+
+  /**
+    @brief Remove every entities owned by a ENetSocket from every ENetInterestGrid. /!\ Mutex.
+    @details Called by ENetSelector when a client is closed.
+    @param p_client ENetSocket of the entities owner.
+  */
+  void                      ENetInterestGrid::removeAll(const ENetSocket *p_client)
+  {
+    ENetInterestGrids       &l_grids = GetInterestGrids();
+
+    WaitForSingleObject(l_grids.m_mutex, INFINITE);
+    for (std::vector<ENetInterestGrid*>::iterator l_it = l_grids.m_grids.begin(); l_it != l_grids.m_grids.end(); ++l_it)
+    {
+      (*l_it)->removeClient(p_client);
+    }
+    ReleaseMutex(l_grids.m_mutex);
+  }
+
+  /**
+    @brief Send ENetPacket to owners of entities within an area of interest. /!\ Mutex. /!\ EError.
+    @details Only cells overlapping the area are walked. Each ENetSocket receive the ENetPacket once.
+    @details Receivers are collected under grid semaphore, ENetPacket is posted after releasing it.
+    @param p_x Center of the area on X axis.
+    @param p_y Center of the area on Y axis.
+    @param p_radius Radius of the area.
+    @param p_packet ENetPacket to be send.
+    @param p_exclude ENetSocket that will not receive the ENetPacket (usually the source).
+  */
+  void                      ENetInterestGrid::publish(float p_x, float p_y, float p_radius, ENetPacket *p_packet,
+                              const ENetSocket *p_exclude)
+  {
+    mEERROR_R();
+    if (nullptr == p_packet)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::vector<ENetSocket*>  l_targets;
+
+      WaitForSingleObject(m_mutexGrid, INFINITE);
+      collect(p_x, p_y, p_radius, p_exclude, l_targets);
+      ReleaseMutex(m_mutexGrid);
+      send(p_packet, l_targets);
+    }
+  }
+
+  /**
+    @brief Send ENetPacket to owners of entities around an entity. /!\ Mutex. /!\ EError.
+    @details The owner of the entity does not receive the ENetPacket.
+    @details Receivers are collected under grid semaphore, ENetPacket is posted after releasing it.
+    @param p_entity Entity at the center of the area.
+    @param p_radius Radius of the area.
+    @param p_packet ENetPacket to be send.
+  */
+  void                      ENetInterestGrid::publish(ENetEntityId p_entity, float p_radius, ENetPacket *p_packet)
+  {
+    mEERROR_R();
+    if (nullptr == p_packet)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::unordered_map<ENetEntityId, uint32>::iterator  l_index;
+      std::vector<ENetSocket*>  l_targets;
+
+      WaitForSingleObject(m_mutexGrid, INFINITE);
+      l_index = m_indexes.find(p_entity);
+      if (m_indexes.end() != l_index)
+      {
+        const ENetEntity    &l_entity = m_entities[l_index->second];
+
+        collect(l_entity.m_x, l_entity.m_y, p_radius, l_entity.m_client, l_targets);
+      }
+      else
+      {
+        mEERROR_S(EERROR_OUT_OF_RANGE);
+      }
+      ReleaseMutex(m_mutexGrid);
+      if (EERROR_NONE == mEERROR)
+      {
+        send(p_packet, l_targets);
+      }
+    }
+  }
+
+  /**
+    @brief Get number of entities. /!\ Mutex.
+    @return Number of entities.
+  */
+  uint32                    ENetInterestGrid::getSize() const
+  {
+    uint32                  l_size = 0;
+
+    WaitForSingleObject(m_mutexGrid, INFINITE);
+    l_size = static_cast<uint32>(m_entities.size());
+    ReleaseMutex(m_mutexGrid);
+
+    return (l_size);
+  }
+
+  /**
+    @brief Get index of the cell containing a coordinate on one axis.
+    @details Index is clamped to int32 range, so far or infinite coordinates fall into border cells. NaN falls into lowest cell.
+    @param p_value Coordinate.
+    @return Cell index.
+  */
+  int32                     ENetInterestGrid::getIndex(float p_value) const
+  {
+    double                  l_index = std::floor(static_cast<double>(p_value) / m_cellSize);
+
+    l_index = max(l_index, static_cast<double>(INT32_MIN));
+    l_index = min(l_index, static_cast<double>(INT32_MAX));
+
+    return (static_cast<int32>(l_index));
+  }
+
+  /**
+    @brief Get key of the cell containing a position.
+    @param p_x Position on X axis.
+    @param p_y Position on Y axis.
+    @return Cell key (X index on high bits, Y index on low bits).
+  */
+  uint64                    ENetInterestGrid::getCell(float p_x, float p_y) const
+  {
+    int32                   l_x = getIndex(p_x);
+    int32                   l_y = getIndex(p_y);
+
+    return ((static_cast<uint64>(static_cast<uint32>(l_x)) << 32) | static_cast<uint32>(l_y));
+  }
+
+  /**
+    @brief Add entity to its cell. m_mutexGrid must be held by caller.
+    @param p_index Index of entity in m_entities.
+  */
+  void                      ENetInterestGrid::insertCell(uint32 p_index)
+  {
+    std::vector<uint32>     &l_cell = m_cells[m_entities[p_index].m_cell];
+
+    m_entities[p_index].m_cellIndex = static_cast<uint32>(l_cell.size());
+    l_cell.push_back(p_index);
+  }
+
+  /**
+    @brief Remove entity from its cell. m_mutexGrid must be held by caller.
+    @details Last entity of the cell is moved at the position of the removed one.
+    @param p_index Index of entity in m_entities.
+  */
+  void                      ENetInterestGrid::removeCell(uint32 p_index)
+  {
+    std::unordered_map<uint64, std::vector<uint32> >::iterator  l_cell;
+
+    l_cell = m_cells.find(m_entities[p_index].m_cell);
+    if (m_cells.end() != l_cell)
+    {
+      uint32                l_cellIndex = m_entities[p_index].m_cellIndex;
+
+      l_cell->second[l_cellIndex] = l_cell->second.back();
+      m_entities[l_cell->second[l_cellIndex]].m_cellIndex = l_cellIndex;
+      l_cell->second.pop_back();
+      if (true == l_cell->second.empty())
+      {
+        m_cells.erase(l_cell);
+      }
+    }
+  }
+
+  /**
+    @brief Remove entity from grid. m_mutexGrid must be held by caller.
+    @details Last entity is moved at the position of the removed one.
+    @param p_index Index of entity in m_entities.
+  */
+  void                      ENetInterestGrid::removeIndex(uint32 p_index)
+  {
+    uint32                  l_last = static_cast<uint32>(m_entities.size() - 1);
+
+    removeCell(p_index);
+    m_indexes.erase(m_entities[p_index].m_id);
+    if (p_index != l_last)
+    {
+      m_entities[p_index] = m_entities[l_last];
+      m_indexes[m_entities[p_index].m_id] = p_index;
+      m_cells[m_entities[p_index].m_cell][m_entities[p_index].m_cellIndex] = p_index;
+    }
+    m_entities.pop_back();
+  }
+
+  /**
+    @brief Fill targets with owners of entities within an area. m_mutexGrid must be held by caller.
+    @details Cells overlapping the area are walked, unless they outnumber occupied cells: occupied cells are walked instead.
+    @details Negative or NaN radius gives no target.
+    @param p_x Center of the area on X axis.
+    @param p_y Center of the area on Y axis.
+    @param p_radius Radius of the area.
+    @param p_exclude ENetSocket to be excluded.
+    @param p_targets Sorted ENetSocket targets, each once.
+  */
+  void                      ENetInterestGrid::collect(float p_x, float p_y, float p_radius, const ENetSocket *p_exclude,
+                              std::vector<ENetSocket*> &p_targets) const
+  {
+    p_targets.clear();
+    if (0.0f <= p_radius)
+    {
+      int64                 l_minX = getIndex(p_x - p_radius);
+      int64                 l_maxX = getIndex(p_x + p_radius);
+      int64                 l_minY = getIndex(p_y - p_radius);
+      int64                 l_maxY = getIndex(p_y + p_radius);
+      uint64                l_width = static_cast<uint64>(l_maxX - l_minX + 1);
+      uint64                l_height = static_cast<uint64>(l_maxY - l_minY + 1);
+
+      if ((l_width > m_cells.size())
+        || (l_height > m_cells.size() / l_width))
+      {
+        for (std::unordered_map<uint64, std::vector<uint32> >::const_iterator l_cell = m_cells.begin(); l_cell != m_cells.end(); ++l_cell)
+        {
+          int64             l_x = static_cast<int32>(static_cast<uint32>(l_cell->first >> 32));
+          int64             l_y = static_cast<int32>(static_cast<uint32>(l_cell->first));
+
+          if ((l_minX <= l_x) && (l_maxX >= l_x)
+            && (l_minY <= l_y) && (l_maxY >= l_y))
+          {
+            collect(l_cell->second, p_x, p_y, p_radius, p_exclude, p_targets);
+          }
+        }
+      }
+      else
+      {
+        for (int64 l_x = l_minX; l_x <= l_maxX; ++l_x)
+        {
+          for (int64 l_y = l_minY; l_y <= l_maxY; ++l_y)
+          {
+            std::unordered_map<uint64, std::vector<uint32> >::const_iterator  l_cell;
+
+            l_cell = m_cells.find((static_cast<uint64>(static_cast<uint32>(l_x)) << 32) | static_cast<uint32>(l_y));
+            if (m_cells.end() != l_cell)
+            {
+              collect(l_cell->second, p_x, p_y, p_radius, p_exclude, p_targets);
+            }
+          }
+        }
+      }
+      std::sort(p_targets.begin(), p_targets.end());
+      p_targets.erase(std::unique(p_targets.begin(), p_targets.end()), p_targets.end());
+    }
+  }
+
+  /**
+    @brief Add owners of entities of a cell within an area to targets. m_mutexGrid must be held by caller.
+    @param p_cell Indexes of entities of the cell.
+    @param p_x Center of the area on X axis.
+    @param p_y Center of the area on Y axis.
+    @param p_radius Radius of the area.
+    @param p_exclude ENetSocket to be excluded.
+    @param p_targets ENetSocket targets.
+  */
+  void                      ENetInterestGrid::collect(const std::vector<uint32> &p_cell, float p_x, float p_y, float p_radius,
+                              const ENetSocket *p_exclude, std::vector<ENetSocket*> &p_targets) const
+  {
+    float                   l_radius2 = p_radius * p_radius;
+
+    for (std::vector<uint32>::const_iterator l_it = p_cell.begin(); l_it != p_cell.end(); ++l_it)
+    {
+      const ENetEntity      &l_entity = m_entities[*l_it];
+      float                 l_dx = l_entity.m_x - p_x;
+      float                 l_dy = l_entity.m_y - p_y;
+
+      if ((p_exclude != l_entity.m_client)
+        && (l_radius2 >= (l_dx * l_dx) + (l_dy * l_dy)))
+      {
+        p_targets.push_back(l_entity.m_client);
+      }
+    }
+  }
+
+  /**
+    @brief Post ENetPacket to every targets. m_mutexGrid must not be held. /!\ EError.
+    @details ENetPacket is queued into ENetSendQueue of each target, a slow receiver does not stall the others.
+    @param p_packet ENetPacket to be send.
+    @param p_targets ENetSocket targets.
+  */
+  void                      ENetInterestGrid::send(ENetPacket *p_packet, const std::vector<ENetSocket*> &p_targets)
+  {
+    for (std::vector<ENetSocket*>::const_iterator l_it = p_targets.begin(); l_it != p_targets.end(); ++l_it)
+    {
+      p_packet->post(*l_it);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+  }
+
+}
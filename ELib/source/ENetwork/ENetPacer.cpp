@@ -0,0 +1,398 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetPacer Class.
+*/
+
+#include "ENetwork/ENetPacer.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Functor for ENetPacer::run(). /!\ EError.
+    @param p_pacer ENetPacer caller.
+    @return Unused.
+  */
+  DWORD WINAPI                PacerRunFunctor(LPVOID p_pacer)
+  {
+    mEERROR_R();
+    if (nullptr != p_pacer)
+    {
+      static_cast<ENetPacer*>(p_pacer)->run();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Constructor for ENetPacer.
+    @details Initialize its mutex. Buckets are not limited.
+    @param p_socket Connectionless ENetSocket sending datagrams.
+  */
+  ENetPacer::ENetPacer(ENetSocket *p_socket) :
+    m_socket(p_socket),
+    m_bucket({ ENETPACER_BURST, 0, ENETPACER_BURST, 0 }),
+    m_peerBucket({ ENETPACER_BURST, 0, ENETPACER_BURST, 0 }),
+    m_peers(),
+    m_last(),
+    m_size(0),
+    m_drops(0),
+    m_sweep(0),
+    m_frequency(),
+    m_mutex(nullptr),
+    m_threadRun(nullptr),
+    m_isRunning(false)
+  {
+    m_mutex = CreateMutex(nullptr, false, nullptr);
+    QueryPerformanceFrequency(&m_frequency);
+  }
+
+  /**
+    @brief Destructor for ENetPacer.
+    @details Stop its thread, release its mutex, delete waiting datagrams.
+  */
+  ENetPacer::~ENetPacer()
+  {
+    if (true == m_isRunning)
+    {
+      stop();
+    }
+    while (false == m_peers.empty())
+    {
+      delete (m_peers.begin()->second.m_dst);
+      m_peers.erase(m_peers.begin());
+    }
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Start ENetPacer automation. /!\ EError.
+    @details Create thread for run().
+  */
+  void                        ENetPacer::start()
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_PACER_STATE);
+    }
+    if ((nullptr == m_socket)
+      || (nullptr == m_mutex))
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = true;
+      m_threadRun = CreateThread(nullptr, 0, PacerRunFunctor, this, 0, nullptr);
+      if (nullptr == m_threadRun)
+      {
+        m_isRunning = false;
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+      }
+    }
+  }
+
+  /**
+    @brief Stop ENetPacer automation. /!\ Blocking. /!\ EError.
+    @details Wait for run() thread. Waiting datagrams are kept for next start().
+  */
+  void                        ENetPacer::stop()
+  {
+    mEERROR_R();
+    if (false == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_PACER_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = false;
+      WaitForSingleObject(m_threadRun, INFINITE);
+      CloseHandle(m_threadRun);
+      m_threadRun = nullptr;
+    }
+  }
+
+  /**
+    @brief Loop of ENetPacer. /!\ Blocking. /!\ Mutex.
+    @details Send the next datagram of the first destination, after last one served,
+      whose bucket and ENetSocket bucket have tokens. Buckets are refilled when they are checked.
+    @details Sleep ENETPACER_IDLE milliseconds without datagram. While waiting for tokens, sleep until the first
+      bucket is refilled (at most ENETPACER_WAIT_MAX milliseconds), yield if it is less than a millisecond away.
+    @details Sending errors are ignored: connectionless datas are not reliable.
+  */
+  void                        ENetPacer::run()
+  {
+    while (true == m_isRunning)
+    {
+      std::string             l_datas;
+      const ENetSocket        *l_dst = nullptr;
+      LARGE_INTEGER           l_time = { 0 };
+      double                  l_wait = 0.0;
+
+      QueryPerformanceCounter(&l_time);
+      WaitForSingleObject(m_mutex, INFINITE);
+      expire(l_time.QuadPart);
+      refill(m_bucket, l_time.QuadPart);
+      if ((0 != m_size)
+        && ((0 == m_bucket.m_rate) || (0.0 <= m_bucket.m_tokens)))
+      {
+        std::map<std::string, ENetPacerPeer>::iterator l_it = m_peers.upper_bound(m_last);
+
+        l_wait = ENETPACER_WAIT_MAX / 1000.0;
+        for (size_t l_count = 0; (nullptr == l_dst) && (l_count < m_peers.size()); ++l_count, ++l_it)
+        {
+          if (m_peers.end() == l_it)
+          {
+            l_it = m_peers.begin();
+          }
+          refill(l_it->second.m_bucket, l_time.QuadPart);
+          if ((false == l_it->second.m_datagrams.empty())
+            && (getWait(l_it->second.m_bucket) < l_wait))
+          {
+            l_wait = getWait(l_it->second.m_bucket);
+          }
+          if ((false == l_it->second.m_datagrams.empty())
+            && ((0 == l_it->second.m_bucket.m_rate) || (0.0 <= l_it->second.m_bucket.m_tokens)))
+          {
+            l_datas.swap(l_it->second.m_datagrams.front());
+            l_it->second.m_datagrams.pop_front();
+            l_it->second.m_bucket.m_tokens -= l_datas.size();
+            m_bucket.m_tokens -= l_datas.size();
+            l_dst = l_it->second.m_dst;
+            m_last = l_it->first;
+            --m_size;
+          }
+        }
+      }
+      else if (0 != m_size)
+      {
+        l_wait = getWait(m_bucket);
+      }
+      ReleaseMutex(m_mutex);
+      if (nullptr != l_dst)
+      {
+        m_socket->sendto(l_datas.data(), static_cast<uint16>(l_datas.size()), l_dst);
+      }
+      else if (0 == m_size)
+      {
+        Sleep(ENETPACER_IDLE);
+      }
+      else if (0.001 <= l_wait)
+      {
+        Sleep(static_cast<DWORD>(min(l_wait * 1000.0, static_cast<double>(ENETPACER_WAIT_MAX))));
+      }
+      else
+      {
+        SwitchToThread();
+      }
+    }
+  }
+
+  /**
+    @brief Queue a datagram for its destination. /!\ Mutex. /!\ EError.
+    @details Oldest datagram of destination is dropped when ENETPACER_QUEUE_MAX datagrams are waiting.
+    @param p_datas Serialized ENetPacket.
+    @param p_len Length of serialized ENetPacket.
+    @param p_dst ENetSocket destination.
+  */
+  void                        ENetPacer::push(const char *p_datas, int32 p_len, const ENetSocket *p_dst)
+  {
+    mEERROR_R();
+    if ((nullptr == p_datas)
+      || (nullptr == p_dst))
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((0 > p_len)
+      || (ENETSOCKET_UDP_MAX < p_len))
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::string             l_address = p_dst->getHostname() + ":" + std::to_string(p_dst->getPort());
+      std::map<std::string, ENetPacerPeer>::iterator l_it;
+      LARGE_INTEGER           l_time = { 0 };
+
+      WaitForSingleObject(m_mutex, INFINITE);
+      l_it = m_peers.find(l_address);
+      if (m_peers.end() == l_it)
+      {
+        ENetPacerPeer         l_peer = { new ENetSocket(), {}, m_peerBucket, 0 };
+
+        l_peer.m_dst->setAddress(p_dst->getHostname(), p_dst->getPort());
+        l_it = m_peers.insert(std::make_pair(l_address, l_peer)).first;
+      }
+      QueryPerformanceCounter(&l_time);
+      l_it->second.m_time = l_time.QuadPart;
+      if (ENETPACER_QUEUE_MAX <= l_it->second.m_datagrams.size())
+      {
+        l_it->second.m_datagrams.pop_front();
+        --m_size;
+        ++m_drops;
+      }
+      l_it->second.m_datagrams.push_back(std::string(p_datas, p_len));
+      ++m_size;
+      ReleaseMutex(m_mutex);
+    }
+  }
+
+  /**
+    @brief Set connectionless ENetSocket sending datagrams.
+    @details ENetPacer must not be running.
+    @param p_socket Connectionless ENetSocket.
+  */
+  void                        ENetPacer::setSocket(ENetSocket *p_socket)
+  {
+    if (false == m_isRunning)
+    {
+      m_socket = p_socket;
+    }
+  }
+
+  /**
+    @brief Set rate of ENetSocket bucket. /!\ Mutex.
+    @param p_rate Bytes per second for all destinations, 0 for no limit.
+    @param p_burst Bytes that can be sent at once.
+  */
+  void                        ENetPacer::setRate(uint64 p_rate, uint32 p_burst)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_bucket.m_rate = p_rate;
+    m_bucket.m_burst = p_burst;
+    m_bucket.m_tokens = p_burst;
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Set rate of each destination bucket. /!\ Mutex.
+    @details Applied to known destinations and new ones.
+    @param p_rate Bytes per second for one destination, 0 for no limit.
+    @param p_burst Bytes that can be sent at once to one destination.
+  */
+  void                        ENetPacer::setPeerRate(uint64 p_rate, uint32 p_burst)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_peerBucket.m_rate = p_rate;
+    m_peerBucket.m_burst = p_burst;
+    m_peerBucket.m_tokens = p_burst;
+    for (std::map<std::string, ENetPacerPeer>::iterator l_it = m_peers.begin(); l_it != m_peers.end(); ++l_it)
+    {
+      l_it->second.m_bucket = m_peerBucket;
+    }
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Get number of waiting datagrams. /!\ Mutex.
+    @return Number of datagrams waiting in queues.
+  */
+  uint32                      ENetPacer::getSize() const
+  {
+    uint32                    l_size = 0;
+
+    WaitForSingleObject(m_mutex, INFINITE);
+    l_size = m_size;
+    ReleaseMutex(m_mutex);
+
+    return (l_size);
+  }
+
+  /**
+    @brief Get number of dropped datagrams.
+    @return Number of datagrams dropped on full queues.
+  */
+  uint64                      ENetPacer::getDrops() const
+  {
+    return (m_drops);
+  }
+
+  /**
+    @brief Get state of ENetPacer.
+    @return State.
+  */
+  bool                        ENetPacer::isRunning() const
+  {
+    return (m_isRunning);
+  }
+
+  /**
+    @brief Credit a bucket with the tokens of time elapsed since its last refill, up to its burst.
+    @param p_bucket Bucket to refill.
+    @param p_time Current performance counter.
+  */
+  void                        ENetPacer::refill(ENetPacerBucket &p_bucket, LONGLONG p_time) const
+  {
+    if ((0 != p_bucket.m_rate)
+      && (0 != m_frequency.QuadPart))
+    {
+      p_bucket.m_tokens += static_cast<double>(p_time - p_bucket.m_time) * static_cast<double>(p_bucket.m_rate)
+        / static_cast<double>(m_frequency.QuadPart);
+      if (p_bucket.m_tokens > p_bucket.m_burst)
+      {
+        p_bucket.m_tokens = p_bucket.m_burst;
+      }
+    }
+    p_bucket.m_time = p_time;
+  }
+
+  /**
+    @brief Get time until a bucket can send again.
+    @param p_bucket Refilled bucket.
+    @return Seconds until its tokens are back to zero, 0 if it can send.
+  */
+  double                      ENetPacer::getWait(const ENetPacerBucket &p_bucket) const
+  {
+    double                    l_wait = 0.0;
+
+    if ((0 != p_bucket.m_rate)
+      && (0.0 > p_bucket.m_tokens))
+    {
+      l_wait = -p_bucket.m_tokens / static_cast<double>(p_bucket.m_rate);
+    }
+
+    return (l_wait);
+  }
+
+  /**
+    @brief Forget destinations without datagram for ENETPACER_PEER_IDLE. m_mutex must be held by caller.
+    @details Done at most once every ENETPACER_PEER_IDLE.
+    @param p_time Current performance counter.
+  */
+  void                        ENetPacer::expire(LONGLONG p_time)
+  {
+    LONGLONG                  l_idle = m_frequency.QuadPart * ENETPACER_PEER_IDLE / 1000;
+
+    if (l_idle <= p_time - m_sweep)
+    {
+      m_sweep = p_time;
+      for (std::map<std::string, ENetPacerPeer>::iterator l_it = m_peers.begin(); l_it != m_peers.end();)
+      {
+        if ((true == l_it->second.m_datagrams.empty())
+          && (l_idle <= p_time - l_it->second.m_time))
+        {
+          delete (l_it->second.m_dst);
+          l_it = m_peers.erase(l_it);
+        }
+        else
+        {
+          ++l_it;
+        }
+      }
+    }
+  }
+
+}
@@ -4,7 +4,12 @@
   @brief Source for ENetPacket Class.
 */
 
+#include "ENetwork/ENetBudget.h"
+#include "ENetwork/ENetFec.h"
+#include "ENetwork/ENetPacer.h"
 #include "ENetwork/ENetPacket.h"
+#include "ENetwork/ENetPacketHandler.h"
+#include "ENetwork/ENetSelector.h"
 
 /**
   @brief General scope for ELib components.
@@ -12,6 +17,34 @@
 namespace           ELib
 {
 
+  /**
+    @brief Send a datagram from connectionless ENetSocket. /!\ EError.
+    @details Datagram is queued into ENetPacer of source when it is running.
+    @param p_src Connectionless ENetSocket.
+    @param p_datas Datagram.
+    @param p_len Datagram length.
+    @param p_dst ENetSocket destination.
+    @return Number of bytes sent or queued.
+  */
+  static int32      SendDatagram(ENetSocket *p_src, const char *p_datas, int32 p_len, const ENetSocket *p_dst)
+  {
+    ENetPacer       *l_pacer = p_src->getPacer();
+    int32           l_ret = -1;
+
+    if ((nullptr != l_pacer)
+      && (true == l_pacer->isRunning()))
+    {
+      l_pacer->push(p_datas, p_len, p_dst);
+      l_ret = p_len;
+    }
+    else
+    {
+      l_ret = p_src->sendto(p_datas, static_cast<uint16>(p_len), p_dst);
+    }
+
+    return (l_ret);
+  }
+
   /**
     @brief Constructor for ENetPacket.
     @param p_type Type of ENetPacket.
@@ -19,15 +52,36 @@ namespace           ELib
   */
   ENetPacket::ENetPacket(ENetPacketType p_type, ENetSocket *p_src) :
     m_type(p_type),
-    m_src(p_src)
+    m_src(p_src),
+    m_isPosted(false),
+    m_budget(nullptr),
+    m_reserved(0),
+    m_trace(0),
+    m_received(0),
+    m_popped(0)
   {
   }
 
   /**
     @brief Destructor for ENetPacket.
+    @details Give back bytes reserved in ENetBudget.
+    @details End ETRACE_EVENT_HANDLER if sampled ENetPacket was popped from ENetPacketHandler.
+    @details Record EMETRICS_LATENCY_HANDLER if ENetPacket was popped from ENetPacketHandler.
   */
   ENetPacket::~ENetPacket()
   {
+    if (nullptr != m_budget)
+    {
+      m_budget->release(m_src, m_reserved);
+    }
+    mETRACE_G.end(ETRACE_EVENT_HANDLER, m_trace, m_type);
+    if (0 != m_popped)
+    {
+      LARGE_INTEGER   l_now = { 0 };
+
+      QueryPerformanceCounter(&l_now);
+      mEMETRICS_G.latency(EMETRICS_LATENCY_HANDLER, m_type, m_popped, l_now.QuadPart);
+    }
   }
 
   /**
@@ -35,6 +89,10 @@ namespace           ELib
     @details Handle the transmission of datas from source.
     @details Target is destination if valid or source for connected protocols.
     @details ENetSocket destination must be valid for connectionless protocols.
+    @details When called from post(), connected datas are queued into target ENetSendQueue, on the ENetChannel of type.
+      ENetChannel is read from ENetPacketHandler of target ENetSelector, or from ENetPacketHandler Singleton without ENetSelector.
+      They are dropped with EERROR_NET_BUDGET when ENetBudget of target is exhausted.
+    @details Connectionless datas are wrapped by ENetFec of source, if any, and queued into ENetPacer of source when it is running.
     @param p_datas Datas of ENetPacket.
     @param p_len Datas length.
     @param p_dst ENetSocket destination.
@@ -72,19 +130,61 @@ namespace           ELib
         {
           case ENETSOCKET_FLAGS_PROTOCOL_TCP:
           {
-            if (nullptr != p_dst)
+            ENetSocket  *l_target = (nullptr != p_dst) ? p_dst : m_src;
+
+            if ((true == m_isPosted)
+              && (nullptr != l_target->getSendQueue()))
             {
-              l_ret = p_dst->send(l_datas, l_len);
+              uint64      l_key = 0;
+              bool        l_isConflated = false;
+              ENetChannel l_channel = { ENETCHANNEL_DEFAULT, 1, ENETSENDQUEUE_FLUSH_MAX / 4 };
+              ENetPacketHandler *l_handler = ENetPacketHandler::getInstance();
+
+              if (nullptr != l_target->getSendQueue()->getSelector())
+              {
+                l_handler = l_target->getSendQueue()->getSelector()->getHandler();
+              }
+              if (nullptr != l_handler)
+              {
+                l_channel = l_handler->getChannel(m_type);
+              }
+              l_isConflated = getConflationKey(l_key);
+              if (true == l_target->getSendQueue()->push(l_target, l_datas, l_len, m_type, l_channel, l_isConflated, l_key))
+              {
+                l_ret = l_len;
+                if (nullptr == l_target->getSendQueue()->getSelector())
+                {
+                  l_target->getSendQueue()->flush(l_target);
+                }
+              }
+              else
+              {
+                mEERROR_S(EERROR_NET_BUDGET);
+              }
             }
             else
             {
-              l_ret = m_src->send(l_datas, l_len);
+              l_ret = l_target->send(l_datas, l_len);
             }
           }
             break;
           case ENETSOCKET_FLAGS_PROTOCOL_UDP:
           {
-            l_ret = m_src->sendto(l_datas, l_len, p_dst);
+            if (nullptr != m_src->getFec())
+            {
+              std::vector<std::string> l_datagrams;
+
+              m_src->getFec()->encode(l_datas, l_len, p_dst, l_datagrams);
+              for (std::vector<std::string>::iterator l_it = l_datagrams.begin(); (EERROR_NONE == mEERROR) && (l_it != l_datagrams.end()); ++l_it)
+              {
+                SendDatagram(m_src, l_it->data(), static_cast<int32>(l_it->size()), p_dst);
+              }
+              l_ret = l_len;
+            }
+            else
+            {
+              l_ret = SendDatagram(m_src, l_datas, l_len, p_dst);
+            }
           }
             break;
           default:
@@ -96,6 +196,10 @@ namespace           ELib
           {
             mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
           }
+          else
+          {
+            mEMETRICS_G.packetOut(m_type);
+          }
         }
         else
         {
@@ -110,6 +214,70 @@ namespace           ELib
     }
   }
 
+  /**
+    @brief Conflation key of ENetPacket.
+    @details Default ENetPacket are never conflated. Override for types carrying latest-value states.
+    @param p_key Key of the state carried (entity identifier...).
+    @return true if ENetPacket can replace an unsent ENetPacket of same type and key.
+  */
+  bool              ENetPacket::getConflationKey(uint64 &p_key) const
+  {
+    p_key = 0;
+
+    return (false);
+  }
+
+  /**
+    @brief Queue ENetPacket for sending. Target depends on protocol. /!\ EError.
+    @details Call send() in posting mode: connected datas are pushed into target ENetSendQueue.
+    @details ENetSendQueue is flushed by ENetSelector of target, or immediately if target has no ENetSelector.
+    @details Connectionless datas are sent immediately.
+    @param p_dst ENetSocket destination.
+  */
+  void              ENetPacket::post(ENetSocket *p_dst)
+  {
+    mEERROR_R();
+    m_isPosted = true;
+    send(p_dst);
+    m_isPosted = false;
+    if (EERROR_NONE != mEERROR)
+    {
+      mEERROR_SH(EERROR_NET_PACKET_ERR);
+    }
+  }
+
+  /**
+    @brief Reserve bytes of a received payload in ENetBudget of source, before allocating it. /!\ EError.
+    @details Reserved bytes are given back when ENetPacket is deleted.
+    @param p_bytes Length of payload.
+    @return true if payload fits budgets of source, or if there is no ENetBudget.
+    @return false on EERROR_NET_BUDGET.
+  */
+  bool              ENetPacket::reserve(int32 p_bytes)
+  {
+    bool            l_ret = true;
+
+    m_budget = ENetBudget::getInstance();
+    if (nullptr != m_budget)
+    {
+      if (true == m_budget->reserve(m_src, p_bytes))
+      {
+        m_reserved += p_bytes;
+      }
+      else
+      {
+        mEERROR_S(EERROR_NET_BUDGET);
+        l_ret = false;
+      }
+    }
+    else
+    {
+      mEERROR_R();
+    }
+
+    return (l_ret);
+  }
+
   /**
     @brief Get type of ENetPacket.
     @return Type.
@@ -137,6 +305,33 @@ namespace           ELib
     m_src = p_src;
   }
 
+  /**
+    @brief Get start of current ETrace stage.
+    @return Performance counter at start of stage, 0 if not sampled.
+  */
+  LONGLONG          ENetPacket::getTrace() const
+  {
+    return (m_trace);
+  }
+
+  /**
+    @brief Get reception time.
+    @return Performance counter at reception, 0 if ENetPacket was not received.
+  */
+  LONGLONG          ENetPacket::getReceived() const
+  {
+    return (m_received);
+  }
+
+  /**
+    @brief Set start of current ETrace stage.
+    @param p_trace Performance counter at start of stage, 0 to stop tracing ENetPacket.
+  */
+  void              ENetPacket::setTrace(LONGLONG p_trace)
+  {
+    m_trace = p_trace;
+  }
+
   /**
     @brief Constructor for ENetPacketDisconnect.
     @param p_src ENetPacket source.
@@ -263,6 +458,7 @@ namespace           ELib
     @brief Receive ENetPacketRawDatas from ENetSocket source. Used for connected protocols. /!\ Blocking. /!\ EError.
     @details Handle the reception of ENetPacketRawDatas from ENetSocket source.
     @details Can be blocking on bad behavior, waiting for datas that were not properly sent.
+    @details Length over ENETPACKETRAWDATAS_MAX or over ENetBudget of source is refused before any allocation.
   */
   void              ENetPacketRawDatas::recv()
   {
@@ -271,14 +467,11 @@ namespace           ELib
     {
       mEERROR_S(EERROR_NULL_PTR);
     }
-    if (ENETSOCKET_FLAGS_PROTOCOL_UDP == (m_src->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS))
+    if ((nullptr != m_src)
+      && (ENETSOCKET_FLAGS_PROTOCOL_UDP == (m_src->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS)))
     {
       mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
     }
-    if (nullptr == m_datas)
-    {
-      mEERROR_S(EERROR_NULL_PTR);
-    }
 
     if (EERROR_NONE == mEERROR)
     {
@@ -287,22 +480,32 @@ namespace           ELib
       l_len = m_src->recv(reinterpret_cast<char*>(&m_len), sizeof(int32));
       if (EERROR_NONE == mEERROR)
       {
-        if (sizeof(int32) == l_len)
+        if ((sizeof(int32) == l_len)
+          && ((0 > m_len) || (ENETPACKETRAWDATAS_MAX < m_len)))
+        {
+          m_len = 0;
+          mEERROR_S(EERROR_OUT_OF_RANGE);
+        }
+        else if ((sizeof(int32) == l_len)
+          && (true == reserve(m_len)))
         {
-          m_datas = new char[m_len];
+          m_datas = new char[(0 < m_len) ? m_len : 1];
           if (nullptr != m_datas)
           {
-            l_len = m_src->recv(m_datas, m_len);
-            if (EERROR_NONE == mEERROR)
+            if (0 < m_len)
             {
-              if (l_len < m_len)
+              l_len = m_src->recv(m_datas, m_len);
+              if (EERROR_NONE == mEERROR)
               {
-                mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+                if (l_len < m_len)
+                {
+                  mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+                }
+              }
+              else
+              {
+                mEERROR_SH(EERROR_NET_SOCKET_ERR);
               }
-            }
-            else
-            {
-              mEERROR_SH(EERROR_NET_SOCKET_ERR);
             }
             if (EERROR_NONE != mEERROR)
             {
@@ -318,7 +521,11 @@ namespace           ELib
         }
         else
         {
-          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+          m_len = 0;
+          if (EERROR_NONE == mEERROR)
+          {
+            mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+          }
         }
       }
       else
@@ -387,10 +594,16 @@ namespace           ELib
     {
       mEERROR_S(EERROR_NULL_PTR);
     }
-    if (nullptr == m_datas)
+    if ((nullptr == m_datas)
+      && (0 != m_len))
     {
       mEERROR_S(EERROR_NULL_PTR);
     }
+    if ((0 > m_len)
+      || (ENETPACKETRAWDATAS_MAX < m_len))
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
 
     if (EERROR_NONE == mEERROR)
     {
@@ -401,8 +614,11 @@ namespace           ELib
       l_datas = new char[l_len];
       if (nullptr != l_datas)
       {
-        memcpy(l_datas, &l_len, sizeof(int32));
-        memcpy(l_datas + sizeof(int32), m_datas, l_len);
+        memcpy(l_datas, &m_len, sizeof(int32));
+        if (0 != m_len)
+        {
+          memcpy(l_datas + sizeof(int32), m_datas, m_len);
+        }
         ENetPacket::send(l_datas, l_len, p_dst);
         if (EERROR_NONE != mEERROR)
         {
@@ -446,4 +662,933 @@ namespace           ELib
     m_datas = p_datas;
   }
 
+  /**
+    @brief Constructor for ENetPacketRpc.
+    @param p_type ENETPACKET_TYPE_RPC_REQUEST or ENETPACKET_TYPE_RPC_RESPONSE.
+    @param p_src ENetPacket source.
+  */
+  ENetPacketRpc::ENetPacketRpc(ENetPacketType p_type, ENetSocket *p_src) :
+    ENetPacket(p_type, p_src),
+    m_method(0),
+    m_id(0),
+    m_status(0),
+    m_datas()
+  {
+  }
+
+  /**
+    @brief Destructor for ENetPacketRpc.
+  */
+  ENetPacketRpc::~ENetPacketRpc()
+  {
+  }
+
+  /**
+    @brief Receive ENetPacketRpc from ENetSocket source. Used for connected protocols. /!\ Blocking. /!\ EError.
+    @details Handle the reception of ENetPacketRpc from ENetSocket source.
+    @details Can be blocking on bad behavior, waiting for datas that were not properly sent.
+  */
+  void              ENetPacketRpc::recv()
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((nullptr != m_src)
+      && (ENETSOCKET_FLAGS_PROTOCOL_UDP == (m_src->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS)))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      char          l_header[sizeof(uint32) + sizeof(uint64) + sizeof(uint32) + sizeof(int32)] = { 0 };
+      int32         l_len = -1;
+
+      l_len = m_src->recv(l_header, sizeof(l_header));
+      if (EERROR_NONE == mEERROR)
+      {
+        if (sizeof(l_header) == l_len)
+        {
+          int32     l_size = 0;
+
+          memcpy(&m_method, l_header, sizeof(uint32));
+          memcpy(&m_id, l_header + sizeof(uint32), sizeof(uint64));
+          memcpy(&m_status, l_header + sizeof(uint32) + sizeof(uint64), sizeof(uint32));
+          memcpy(&l_size, l_header + sizeof(uint32) + sizeof(uint64) + sizeof(uint32), sizeof(int32));
+          if ((0 <= l_size)
+            && (ENETPACKETRPC_MAX >= l_size)
+            && (true == reserve(l_size)))
+          {
+            m_datas.resize(l_size);
+            if (0 < l_size)
+            {
+              l_len = m_src->recv(&m_datas[0], l_size);
+              if (EERROR_NONE == mEERROR)
+              {
+                if (l_len < l_size)
+                {
+                  mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+                }
+              }
+              else
+              {
+                mEERROR_SH(EERROR_NET_SOCKET_ERR);
+              }
+            }
+          }
+          else if (EERROR_NONE == mEERROR)
+          {
+            mEERROR_S(EERROR_OUT_OF_RANGE);
+          }
+        }
+        else
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+      }
+      else
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        m_datas.clear();
+      }
+    }
+  }
+
+  /**
+    @brief Read ENetPacketRpc from datas in parameters. Used for connectionless protocols. /!\ EError.
+    @details Handle the reading of ENetPacketRpc from datas in parameters.
+    @param p_datas Datas of ENetPacketRpc.
+    @param p_len Datas length.
+  */
+  void              ENetPacketRpc::read(const char *p_datas, int32 p_len)
+  {
+    int32           l_header = sizeof(uint32) + sizeof(uint64) + sizeof(uint32) + sizeof(int32);
+
+    mEERROR_R();
+    if (nullptr == p_datas)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      if (l_header <= p_len)
+      {
+        int32       l_size = 0;
+
+        memcpy(&m_method, p_datas, sizeof(uint32));
+        memcpy(&m_id, p_datas + sizeof(uint32), sizeof(uint64));
+        memcpy(&m_status, p_datas + sizeof(uint32) + sizeof(uint64), sizeof(uint32));
+        memcpy(&l_size, p_datas + sizeof(uint32) + sizeof(uint64) + sizeof(uint32), sizeof(int32));
+        if ((l_size == (p_len - l_header))
+          && (ENETPACKETBUS_MAX >= l_size))
+        {
+          m_datas.assign(p_datas + l_header, l_size);
+        }
+        else
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+      }
+    }
+  }
+
+  /**
+    @brief Send ENetPacketRpc. Destination depends on protocol. /!\ EError.
+    @details Handle the transmission of ENetPacketRpc from source.
+    @details Use default send() with copy of members.
+    @details Datas over ENETPACKETRPC_MAX are refused.
+    @param p_dst ENetSocket destination.
+  */
+  void              ENetPacketRpc::send(ENetSocket *p_dst)
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if (ENETPACKETRPC_MAX < m_datas.size())
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::string   l_datas;
+      int32         l_size = static_cast<int32>(m_datas.size());
+
+      l_datas.reserve(sizeof(uint32) + sizeof(uint64) + sizeof(uint32) + sizeof(int32) + m_datas.size());
+      l_datas.append(reinterpret_cast<const char*>(&m_method), sizeof(uint32));
+      l_datas.append(reinterpret_cast<const char*>(&m_id), sizeof(uint64));
+      l_datas.append(reinterpret_cast<const char*>(&m_status), sizeof(uint32));
+      l_datas.append(reinterpret_cast<const char*>(&l_size), sizeof(int32));
+      l_datas.append(m_datas);
+      ENetPacket::send(l_datas.c_str(), static_cast<int32>(l_datas.size()), p_dst);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Get method called by ENetPacketRpc.
+    @return Method.
+  */
+  uint32            ENetPacketRpc::getMethod() const
+  {
+    return (m_method);
+  }
+
+  /**
+    @brief Get correlation identifier of ENetPacketRpc.
+    @return Correlation identifier.
+  */
+  uint64            ENetPacketRpc::getId() const
+  {
+    return (m_id);
+  }
+
+  /**
+    @brief Get status of ENetPacketRpc.
+    @return ENetRpcStatus of response.
+  */
+  uint32            ENetPacketRpc::getStatus() const
+  {
+    return (m_status);
+  }
+
+  /**
+    @brief Get datas of ENetPacketRpc.
+    @return Arguments of request or result of response.
+  */
+  const std::string &ENetPacketRpc::getDatas() const
+  {
+    return (m_datas);
+  }
+
+  /**
+    @brief Set method called by ENetPacketRpc.
+    @param p_method Method.
+  */
+  void              ENetPacketRpc::setMethod(uint32 p_method)
+  {
+    m_method = p_method;
+  }
+
+  /**
+    @brief Set correlation identifier of ENetPacketRpc.
+    @param p_id Correlation identifier.
+  */
+  void              ENetPacketRpc::setId(uint64 p_id)
+  {
+    m_id = p_id;
+  }
+
+  /**
+    @brief Set status of ENetPacketRpc.
+    @param p_status ENetRpcStatus of response.
+  */
+  void              ENetPacketRpc::setStatus(uint32 p_status)
+  {
+    m_status = p_status;
+  }
+
+  /**
+    @brief Set datas of ENetPacketRpc. Datas are copied.
+    @param p_datas Arguments of request or result of response.
+    @param p_len Datas length.
+  */
+  void              ENetPacketRpc::setDatas(const char *p_datas, int32 p_len)
+  {
+    if ((nullptr != p_datas)
+      && (0 < p_len))
+    {
+      m_datas.assign(p_datas, p_len);
+    }
+    else
+    {
+      m_datas.clear();
+    }
+  }
+
+  /**
+    @brief Constructor for ENetPacketGateway.
+    @param p_src ENetPacket source.
+  */
+  ENetPacketGateway::ENetPacketGateway(ENetSocket *p_src) :
+    ENetPacket(ENETPACKET_TYPE_GATEWAY, p_src),
+    m_stream(0),
+    m_key(0),
+    m_flags(0),
+    m_datas()
+  {
+  }
+
+  /**
+    @brief Destructor for ENetPacketGateway.
+  */
+  ENetPacketGateway::~ENetPacketGateway()
+  {
+  }
+
+  /**
+    @brief Receive ENetPacketGateway from ENetSocket source. Used for connected protocols. /!\ Blocking. /!\ EError.
+    @details Handle the reception of ENetPacketGateway from ENetSocket source.
+    @details Can be blocking on bad behavior, waiting for datas that were not properly sent.
+  */
+  void              ENetPacketGateway::recv()
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((nullptr != m_src)
+      && (ENETSOCKET_FLAGS_PROTOCOL_UDP == (m_src->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS)))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      char          l_header[sizeof(uint64) + sizeof(uint64) + sizeof(uint32) + sizeof(int32)] = { 0 };
+      int32         l_len = -1;
+
+      l_len = m_src->recv(l_header, sizeof(l_header));
+      if (EERROR_NONE == mEERROR)
+      {
+        if (sizeof(l_header) == l_len)
+        {
+          int32     l_size = 0;
+
+          memcpy(&m_stream, l_header, sizeof(uint64));
+          memcpy(&m_key, l_header + sizeof(uint64), sizeof(uint64));
+          memcpy(&m_flags, l_header + sizeof(uint64) + sizeof(uint64), sizeof(uint32));
+          memcpy(&l_size, l_header + sizeof(uint64) + sizeof(uint64) + sizeof(uint32), sizeof(int32));
+          if ((0 <= l_size)
+            && (ENETPACKETGATEWAY_MAX >= l_size)
+            && (true == reserve(l_size)))
+          {
+            m_datas.resize(l_size);
+            if (0 < l_size)
+            {
+              l_len = m_src->recv(&m_datas[0], l_size);
+              if (EERROR_NONE == mEERROR)
+              {
+                if (l_len < l_size)
+                {
+                  mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+                }
+              }
+              else
+              {
+                mEERROR_SH(EERROR_NET_SOCKET_ERR);
+              }
+            }
+          }
+          else if (EERROR_NONE == mEERROR)
+          {
+            mEERROR_S(EERROR_OUT_OF_RANGE);
+          }
+        }
+        else
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+      }
+      else
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        m_datas.clear();
+      }
+    }
+  }
+
+  /**
+    @brief Read ENetPacketGateway from datas in parameters. Used for connectionless protocols. /!\ EError.
+    @details Handle the reading of ENetPacketGateway from datas in parameters.
+    @param p_datas Datas of ENetPacketGateway.
+    @param p_len Datas length.
+  */
+  void              ENetPacketGateway::read(const char *p_datas, int32 p_len)
+  {
+    int32           l_header = sizeof(uint64) + sizeof(uint64) + sizeof(uint32) + sizeof(int32);
+
+    mEERROR_R();
+    if (nullptr == p_datas)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      if (l_header <= p_len)
+      {
+        int32       l_size = 0;
+
+        memcpy(&m_stream, p_datas, sizeof(uint64));
+        memcpy(&m_key, p_datas + sizeof(uint64), sizeof(uint64));
+        memcpy(&m_flags, p_datas + sizeof(uint64) + sizeof(uint64), sizeof(uint32));
+        memcpy(&l_size, p_datas + sizeof(uint64) + sizeof(uint64) + sizeof(uint32), sizeof(int32));
+        if ((l_size == (p_len - l_header))
+          && (ENETPACKETBUS_MAX >= l_size))
+        {
+          m_datas.assign(p_datas + l_header, l_size);
+        }
+        else
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+      }
+    }
+  }
+
+  /**
+    @brief Send ENetPacketGateway. Destination depends on protocol. /!\ EError.
+    @details Handle the transmission of ENetPacketGateway from source.
+    @details Use default send() with copy of members.
+    @details Datas over ENETPACKETGATEWAY_MAX are refused.
+    @param p_dst ENetSocket destination.
+  */
+  void              ENetPacketGateway::send(ENetSocket *p_dst)
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if (ENETPACKETGATEWAY_MAX < m_datas.size())
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::string   l_datas;
+      int32         l_size = static_cast<int32>(m_datas.size());
+
+      l_datas.reserve(sizeof(uint64) + sizeof(uint64) + sizeof(uint32) + sizeof(int32) + m_datas.size());
+      l_datas.append(reinterpret_cast<const char*>(&m_stream), sizeof(uint64));
+      l_datas.append(reinterpret_cast<const char*>(&m_key), sizeof(uint64));
+      l_datas.append(reinterpret_cast<const char*>(&m_flags), sizeof(uint32));
+      l_datas.append(reinterpret_cast<const char*>(&l_size), sizeof(int32));
+      l_datas.append(m_datas);
+      ENetPacket::send(l_datas.c_str(), static_cast<int32>(l_datas.size()), p_dst);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Get client stream of ENetPacketGateway.
+    @return Stream identifier.
+  */
+  uint64            ENetPacketGateway::getStream() const
+  {
+    return (m_stream);
+  }
+
+  /**
+    @brief Get routing key of ENetPacketGateway.
+    @return Routing key.
+  */
+  uint64            ENetPacketGateway::getKey() const
+  {
+    return (m_key);
+  }
+
+  /**
+    @brief Get flags of ENetPacketGateway.
+    @return ENETPACKETGATEWAY_FLAG_* of stream.
+  */
+  uint32            ENetPacketGateway::getFlags() const
+  {
+    return (m_flags);
+  }
+
+  /**
+    @brief Get datas of ENetPacketGateway.
+    @return Datas of client.
+  */
+  const std::string &ENetPacketGateway::getDatas() const
+  {
+    return (m_datas);
+  }
+
+  /**
+    @brief Set client stream of ENetPacketGateway.
+    @param p_stream Stream identifier.
+  */
+  void              ENetPacketGateway::setStream(uint64 p_stream)
+  {
+    m_stream = p_stream;
+  }
+
+  /**
+    @brief Set routing key of ENetPacketGateway.
+    @param p_key Routing key.
+  */
+  void              ENetPacketGateway::setKey(uint64 p_key)
+  {
+    m_key = p_key;
+  }
+
+  /**
+    @brief Set flags of ENetPacketGateway.
+    @param p_flags ENETPACKETGATEWAY_FLAG_* of stream.
+  */
+  void              ENetPacketGateway::setFlags(uint32 p_flags)
+  {
+    m_flags = p_flags;
+  }
+
+  /**
+    @brief Set datas of ENetPacketGateway. Datas are copied.
+    @param p_datas Datas of client.
+    @param p_len Datas length.
+  */
+  void              ENetPacketGateway::setDatas(const char *p_datas, int32 p_len)
+  {
+    if ((nullptr != p_datas)
+      && (0 < p_len))
+    {
+      m_datas.assign(p_datas, p_len);
+    }
+    else
+    {
+      m_datas.clear();
+    }
+  }
+
+  /**
+    @brief Constructor for ENetPacketBus.
+    @param p_src ENetPacket source.
+  */
+  ENetPacketBus::ENetPacketBus(ENetSocket *p_src) :
+    ENetPacket(ENETPACKET_TYPE_BUS, p_src),
+    m_origin(0),
+    m_sequence(0),
+    m_count(0),
+    m_datas()
+  {
+  }
+
+  /**
+    @brief Destructor for ENetPacketBus.
+  */
+  ENetPacketBus::~ENetPacketBus()
+  {
+  }
+
+  /**
+    @brief Receive ENetPacketBus from ENetSocket source. Used for connected protocols. /!\ Blocking. /!\ EError.
+    @details Handle the reception of ENetPacketBus from ENetSocket source.
+    @details Can be blocking on bad behavior, waiting for datas that were not properly sent.
+  */
+  void              ENetPacketBus::recv()
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((nullptr != m_src)
+      && (ENETSOCKET_FLAGS_PROTOCOL_UDP == (m_src->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS)))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      char          l_header[sizeof(uint32) + sizeof(uint64) + sizeof(uint32) + sizeof(int32)] = { 0 };
+      int32         l_len = -1;
+
+      l_len = m_src->recv(l_header, sizeof(l_header));
+      if (EERROR_NONE == mEERROR)
+      {
+        if (sizeof(l_header) == l_len)
+        {
+          int32     l_size = 0;
+
+          memcpy(&m_origin, l_header, sizeof(uint32));
+          memcpy(&m_sequence, l_header + sizeof(uint32), sizeof(uint64));
+          memcpy(&m_count, l_header + sizeof(uint32) + sizeof(uint64), sizeof(uint32));
+          memcpy(&l_size, l_header + sizeof(uint32) + sizeof(uint64) + sizeof(uint32), sizeof(int32));
+          if ((0 <= l_size)
+            && (ENETPACKETBUS_MAX >= l_size)
+            && (true == reserve(l_size)))
+          {
+            m_datas.resize(l_size);
+            if (0 < l_size)
+            {
+              l_len = m_src->recv(&m_datas[0], l_size);
+              if (EERROR_NONE == mEERROR)
+              {
+                if (l_len < l_size)
+                {
+                  mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+                }
+              }
+              else
+              {
+                mEERROR_SH(EERROR_NET_SOCKET_ERR);
+              }
+            }
+          }
+          else if (EERROR_NONE == mEERROR)
+          {
+            mEERROR_S(EERROR_OUT_OF_RANGE);
+          }
+        }
+        else
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+      }
+      else
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        m_datas.clear();
+      }
+    }
+  }
+
+  /**
+    @brief Read ENetPacketBus from datas in parameters. Used for connectionless protocols. /!\ EError.
+    @details Handle the reading of ENetPacketBus from datas in parameters.
+    @param p_datas Datas of ENetPacketBus.
+    @param p_len Datas length.
+  */
+  void              ENetPacketBus::read(const char *p_datas, int32 p_len)
+  {
+    int32           l_header = sizeof(uint32) + sizeof(uint64) + sizeof(uint32) + sizeof(int32);
+
+    mEERROR_R();
+    if (nullptr == p_datas)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      if (l_header <= p_len)
+      {
+        int32       l_size = 0;
+
+        memcpy(&m_origin, p_datas, sizeof(uint32));
+        memcpy(&m_sequence, p_datas + sizeof(uint32), sizeof(uint64));
+        memcpy(&m_count, p_datas + sizeof(uint32) + sizeof(uint64), sizeof(uint32));
+        memcpy(&l_size, p_datas + sizeof(uint32) + sizeof(uint64) + sizeof(uint32), sizeof(int32));
+        if ((l_size == (p_len - l_header))
+          && (ENETPACKETBUS_MAX >= l_size))
+        {
+          m_datas.assign(p_datas + l_header, l_size);
+        }
+        else
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+      }
+      else
+      {
+        mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+      }
+    }
+  }
+
+  /**
+    @brief Send ENetPacketBus. Destination depends on protocol. /!\ EError.
+    @details Handle the transmission of ENetPacketBus from source.
+    @details Use default send() with copy of members.
+    @param p_dst ENetSocket destination.
+  */
+  void              ENetPacketBus::send(ENetSocket *p_dst)
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if (ENETPACKETBUS_MAX < m_datas.size())
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::string   l_datas;
+      int32         l_size = static_cast<int32>(m_datas.size());
+
+      l_datas.reserve(sizeof(uint32) + sizeof(uint64) + sizeof(uint32) + sizeof(int32) + m_datas.size());
+      l_datas.append(reinterpret_cast<const char*>(&m_origin), sizeof(uint32));
+      l_datas.append(reinterpret_cast<const char*>(&m_sequence), sizeof(uint64));
+      l_datas.append(reinterpret_cast<const char*>(&m_count), sizeof(uint32));
+      l_datas.append(reinterpret_cast<const char*>(&l_size), sizeof(int32));
+      l_datas.append(m_datas);
+      ENetPacket::send(l_datas.c_str(), static_cast<int32>(l_datas.size()), p_dst);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Get origin node of ENetPacketBus.
+    @return Node identifier.
+  */
+  uint32            ENetPacketBus::getOrigin() const
+  {
+    return (m_origin);
+  }
+
+  /**
+    @brief Get sequence of ENetPacketBus.
+    @return Sequence of batch on its origin node.
+  */
+  uint64            ENetPacketBus::getSequence() const
+  {
+    return (m_sequence);
+  }
+
+  /**
+    @brief Get number of messages of ENetPacketBus.
+    @return Number of messages in batch.
+  */
+  uint32            ENetPacketBus::getCount() const
+  {
+    return (m_count);
+  }
+
+  /**
+    @brief Get datas of ENetPacketBus.
+    @return Batch of messages.
+  */
+  const std::string &ENetPacketBus::getDatas() const
+  {
+    return (m_datas);
+  }
+
+  /**
+    @brief Set origin node of ENetPacketBus.
+    @param p_origin Node identifier.
+  */
+  void              ENetPacketBus::setOrigin(uint32 p_origin)
+  {
+    m_origin = p_origin;
+  }
+
+  /**
+    @brief Set sequence of ENetPacketBus.
+    @param p_sequence Sequence of batch on its origin node.
+  */
+  void              ENetPacketBus::setSequence(uint64 p_sequence)
+  {
+    m_sequence = p_sequence;
+  }
+
+  /**
+    @brief Set batch of ENetPacketBus. Datas are copied.
+    @param p_datas Batch of messages.
+    @param p_count Number of messages in batch.
+  */
+  void              ENetPacketBus::setDatas(const std::string &p_datas, uint32 p_count)
+  {
+    m_datas = p_datas;
+    m_count = p_count;
+  }
+
+  /**
+    @brief Constructor for ENetPacketStats.
+    @param p_src ENetPacket source.
+  */
+  ENetPacketStats::ENetPacketStats(ENetSocket *p_src) :
+    ENetPacket(ENETPACKET_TYPE_STATS, p_src),
+    m_datas()
+  {
+  }
+
+  /**
+    @brief Destructor for ENetPacketStats.
+  */
+  ENetPacketStats::~ENetPacketStats()
+  {
+  }
+
+  /**
+    @brief Receive ENetPacketStats from ENetSocket source. Used for connected protocols. /!\ Blocking. /!\ EError.
+    @details Handle the reception of ENetPacketStats from ENetSocket source.
+    @details Can be blocking on bad behavior, waiting for datas that were not properly sent.
+  */
+  void              ENetPacketStats::recv()
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((nullptr != m_src)
+      && (ENETSOCKET_FLAGS_PROTOCOL_UDP == (m_src->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS)))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      int32         l_size = 0;
+      int32         l_len = -1;
+
+      l_len = m_src->recv(reinterpret_cast<char*>(&l_size), sizeof(int32));
+      if (EERROR_NONE == mEERROR)
+      {
+        if ((sizeof(int32) == l_len)
+          && (0 <= l_size)
+          && (ENETPACKETSTATS_MAX >= l_size)
+          && (true == reserve(l_size)))
+        {
+          m_datas.resize(l_size);
+          if (0 < l_size)
+          {
+            l_len = m_src->recv(&m_datas[0], l_size);
+            if (EERROR_NONE == mEERROR)
+            {
+              if (l_len < l_size)
+              {
+                mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+              }
+            }
+            else
+            {
+              mEERROR_SH(EERROR_NET_SOCKET_ERR);
+            }
+          }
+        }
+        else if (sizeof(int32) != l_len)
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+        else
+        {
+          mEERROR_S(EERROR_OUT_OF_RANGE);
+        }
+      }
+      else
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        m_datas.clear();
+      }
+    }
+  }
+
+  /**
+    @brief Read ENetPacketStats from datas in parameters. Used for connectionless protocols. /!\ EError.
+    @details Handle the reading of ENetPacketStats from datas in parameters.
+    @param p_datas Datas of ENetPacketStats.
+    @param p_len Datas length.
+  */
+  void              ENetPacketStats::read(const char *p_datas, int32 p_len)
+  {
+    mEERROR_R();
+    if (nullptr == p_datas)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      int32         l_size = 0;
+
+      if (sizeof(int32) <= p_len)
+      {
+        memcpy(&l_size, p_datas, sizeof(int32));
+      }
+      if ((sizeof(int32) <= p_len)
+        && (l_size == (p_len - static_cast<int32>(sizeof(int32)))))
+      {
+        m_datas.assign(p_datas + sizeof(int32), l_size);
+      }
+      else
+      {
+        mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+      }
+    }
+  }
+
+  /**
+    @brief Send ENetPacketStats. Destination depends on protocol. /!\ EError.
+    @details Handle the transmission of ENetPacketStats from source.
+    @details Use default send() with copy of members.
+    @param p_dst ENetSocket destination.
+  */
+  void              ENetPacketStats::send(ENetSocket *p_dst)
+  {
+    mEERROR_R();
+    if (nullptr == m_src)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if (ENETPACKETSTATS_MAX < m_datas.size())
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::string   l_datas;
+      int32         l_size = static_cast<int32>(m_datas.size());
+
+      l_datas.reserve(sizeof(int32) + m_datas.size());
+      l_datas.append(reinterpret_cast<const char*>(&l_size), sizeof(int32));
+      l_datas.append(m_datas);
+      ENetPacket::send(l_datas.c_str(), static_cast<int32>(l_datas.size()), p_dst);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Get datas of ENetPacketStats.
+    @return Admin token of request or snapshot of response.
+  */
+  const std::string &ENetPacketStats::getDatas() const
+  {
+    return (m_datas);
+  }
+
+  /**
+    @brief Set datas of ENetPacketStats.
+    @param p_datas Admin token of request or snapshot of response.
+  */
+  void              ENetPacketStats::setDatas(const std::string &p_datas)
+  {
+    m_datas = p_datas;
+  }
+
 }
@@ -72,33 +72,169 @@ namespace                     ELib
     return (l_packet);
   }
 
+  /**
+    @brief Generator for ENetPacketRpc requests. /!\ EError.
+    @param p_src ENetSocket source of ENetPacket.
+    @return Generated ENetPacketRpc on success.
+    @return nullptr on failure.
+  */
+  ENetPacket                  *generateENetPacketRpcRequest(ENetSocket *p_src)
+  {
+    ENetPacket                *l_packet = nullptr;
+
+    mEERROR_R();
+    l_packet = new ENetPacketRpc(ENETPACKET_TYPE_RPC_REQUEST, p_src);
+    if (nullptr == l_packet)
+    {
+      mEERROR_S(EERROR_MEMORY);
+    }
+
+    return (l_packet);
+  }
+
+  /**
+    @brief Generator for ENetPacketRpc responses. /!\ EError.
+    @param p_src ENetSocket source of ENetPacket.
+    @return Generated ENetPacketRpc on success.
+    @return nullptr on failure.
+  */
+  ENetPacket                  *generateENetPacketRpcResponse(ENetSocket *p_src)
+  {
+    ENetPacket                *l_packet = nullptr;
+
+    mEERROR_R();
+    l_packet = new ENetPacketRpc(ENETPACKET_TYPE_RPC_RESPONSE, p_src);
+    if (nullptr == l_packet)
+    {
+      mEERROR_S(EERROR_MEMORY);
+    }
+
+    return (l_packet);
+  }
+
+  /**
+    @brief Generator for ENetPacketGateway. /!\ EError.
+    @param p_src ENetSocket source of ENetPacket.
+    @return Generated ENetPacketGateway on success.
+    @return nullptr on failure.
+  */
+  ENetPacket                  *generateENetPacketGateway(ENetSocket *p_src)
+  {
+    ENetPacket                *l_packet = nullptr;
+
+    mEERROR_R();
+    l_packet = new ENetPacketGateway(p_src);
+    if (nullptr == l_packet)
+    {
+      mEERROR_S(EERROR_MEMORY);
+    }
+
+    return (l_packet);
+  }
+
+  /**
+    @brief Generator for ENetPacketBus. /!\ EError.
+    @param p_src ENetSocket source of ENetPacket.
+    @return Generated ENetPacketBus on success.
+    @return nullptr on failure.
+  */
+  ENetPacket                  *generateENetPacketBus(ENetSocket *p_src)
+  {
+    ENetPacket                *l_packet = nullptr;
+
+    mEERROR_R();
+    l_packet = new ENetPacketBus(p_src);
+    if (nullptr == l_packet)
+    {
+      mEERROR_S(EERROR_MEMORY);
+    }
+
+    return (l_packet);
+  }
+
+  /**
+    @brief Generator for ENetPacketStats. /!\ EError.
+    @param p_src ENetSocket source.
+    @return Generated ENetPacketStats on success.
+    @return nullptr on failure.
+  */
+  ENetPacket                  *generateENetPacketStats(ENetSocket *p_src)
+  {
+    ENetPacket                *l_packet = nullptr;
+
+    mEERROR_R();
+    l_packet = new ENetPacketStats(p_src);
+    if (nullptr == l_packet)
+    {
+      mEERROR_S(EERROR_MEMORY);
+    }
+
+    return (l_packet);
+  }
+
   /**
     @brief Constructor for ENetPacketHandler.
     @details Add Basics ENetPacketGenerators.
+    @details Default ENetChannels: ENETCHANNEL_CONTROL is the most urgent, others share priority 1.
+    @details ENETCHANNEL_BULK get a quarter of the weight of other channels.
+    @details Initialize its mutex and events.
   */
   ENetPacketHandler::ENetPacketHandler() :
     m_generators(),
+    m_types(),
+    m_channels(),
     m_packets(),
-    m_mutexPackets(nullptr)
+    m_admin(),
+    m_isAdmin(false),
+    m_rateLimit(),
+    m_mutexPackets(nullptr),
+    m_eventPackets(nullptr),
+    m_eventAdmin(nullptr)
   {
     m_generators[ENETPACKET_TYPE_DISCONNECT] = generateENetPacketDisconnect;
     m_generators[ENETPACKET_TYPE_CONNECT] = generateENetPacketConnect;
     m_generators[ENETPACKET_TYPE_RAW_DATAS] = generateENetPacketRawDatas;
+    m_generators[ENETPACKET_TYPE_RPC_REQUEST] = generateENetPacketRpcRequest;
+    m_generators[ENETPACKET_TYPE_RPC_RESPONSE] = generateENetPacketRpcResponse;
+    m_generators[ENETPACKET_TYPE_GATEWAY] = generateENetPacketGateway;
+    m_generators[ENETPACKET_TYPE_BUS] = generateENetPacketBus;
+    m_generators[ENETPACKET_TYPE_STATS] = generateENetPacketStats;
+    for (ENetChannelId l_id = 0; l_id < ENETCHANNEL_MAX; ++l_id)
+    {
+      m_channels[l_id].m_id = l_id;
+      m_channels[l_id].m_priority = 1;
+      m_channels[l_id].m_weight = ENETSENDQUEUE_FLUSH_MAX / 4;
+    }
+    m_channels[ENETCHANNEL_CONTROL].m_priority = 0;
+    m_channels[ENETCHANNEL_BULK].m_weight = ENETSENDQUEUE_FLUSH_MAX / 16;
+    m_types[ENETPACKET_TYPE_DISCONNECT] = ENETCHANNEL_CONTROL;
+    m_types[ENETPACKET_TYPE_CONNECT] = ENETCHANNEL_CONTROL;
+    m_mutexPackets = CreateMutex(nullptr, false, nullptr);
+    m_eventPackets = CreateEvent(nullptr, true, false, nullptr);
+    m_eventAdmin = CreateEvent(nullptr, true, false, nullptr);
   }
 
   /**
     @brief Destructor for ENetPacketHandler.
-    @details Release its mutex.
+    @details Release its mutex and events.
   */
   ENetPacketHandler::~ENetPacketHandler()
   {
     ReleaseMutex(m_mutexPackets);
     CloseHandle(m_mutexPackets);
+    if (nullptr != m_eventPackets)
+    {
+      CloseHandle(m_eventPackets);
+    }
+    if (nullptr != m_eventAdmin)
+    {
+      CloseHandle(m_eventAdmin);
+    }
   }
 
   /**
     @brief Singleton for ENetPacketHandler. /!\ EError.
-    @details Initialize its mutex.
+    @details Check its mutex and events.
     @return ENetPacketHandler unique instance on success.
     @return nullptr on failure.
   */
@@ -109,25 +245,18 @@ namespace                     ELib
     mEERROR_R();
     if (nullptr == l_instance)
     {
-      HANDLE                  l_mutex = nullptr;
-
-      l_mutex = CreateMutex(nullptr, false, nullptr);
-      if (nullptr != l_mutex)
+      l_instance = new ENetPacketHandler();
+      if (nullptr == l_instance)
       {
-        l_instance = new ENetPacketHandler();
-        if (nullptr == l_instance)
-        {
-          l_instance->m_mutexPackets = l_mutex;
-        }
-        else
-        {
-          mEERROR_S(EERROR_MEMORY);
-          CloseHandle(l_mutex);
-        }
+        mEERROR_S(EERROR_MEMORY);
       }
-      else
+      else if ((nullptr == l_instance->m_mutexPackets)
+        || (nullptr == l_instance->m_eventPackets)
+        || (nullptr == l_instance->m_eventAdmin))
       {
         mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+        delete (l_instance);
+        l_instance = nullptr;
       }
     }
 
@@ -135,21 +264,37 @@ namespace                     ELib
   }
 
   /**
-    @brief Pop a ENetPacket from the queue. /!\ Mutex.
-    @return First ENetPacket from the queue.
-    @return nullptr if queue is empty.
+    @brief Pop a ENetPacket from the queues. /!\ Mutex.
+    @details Queues are walked from the most urgent priority.
+    @details Sampled ENetPacket ends ETRACE_EVENT_QUEUE and starts ETRACE_EVENT_HANDLER.
+    @details Wait since reception is recorded into EMETRICS_LATENCY_QUEUE of its ENetPacketType.
+    @return First ENetPacket from the most urgent non-empty queue.
+    @return nullptr if queues are empty.
   */
   ENetPacket                  *ENetPacketHandler::popPacket()
   {
     ENetPacket                *l_packet = nullptr;
 
     WaitForSingleObject(m_mutexPackets, INFINITE);
-    if (false == m_packets.empty())
+    for (uint8 l_priority = 0; (nullptr == l_packet) && (l_priority < ENETCHANNEL_PRIORITIES); ++l_priority)
     {
-      l_packet = m_packets.front();
-      m_packets.pop();
+      if (false == m_packets[l_priority].empty())
+      {
+        l_packet = m_packets[l_priority].front();
+        m_packets[l_priority].pop();
+      }
     }
     ReleaseMutex(m_mutexPackets);
+    if (nullptr != l_packet)
+    {
+      LARGE_INTEGER           l_now = { 0 };
+
+      QueryPerformanceCounter(&l_now);
+      l_packet->m_popped = l_now.QuadPart;
+      mEMETRICS_G.move(EMETRICS_GAUGE_QUEUED, -1);
+      mEMETRICS_G.latency(EMETRICS_LATENCY_QUEUE, l_packet->getType(), l_packet->m_received, l_packet->m_popped);
+      l_packet->setTrace(mETRACE_G.end(ETRACE_EVENT_QUEUE, l_packet->getTrace(), l_packet->getType()));
+    }
 
     return (l_packet);
   }
@@ -158,12 +303,22 @@ namespace                     ELib
     @brief Receive a ENetPacket from connected ENetSocket source. /!\ Blocking. /!\ Mutex. /!\ EError.
     @details Receive ENetPacketType, then call its ENetPacket...::recv().
     @details Can be blocking on bad behavior, waiting for datas that were not properly sent.
-    @details On success, received ENetPacket is added to queue.
+    @details On success, received ENetPacket is added to the queue of its ENetChannel priority,
+      or dropped if its ENetPacketType is over its limit in ENetRateLimit.
+    @details Duration of each stored ENetPacket is recorded into EMETRICS_HISTOGRAM_RECV, and traced as ETRACE_EVENT_RECV.
+    @details Reception time of ENetPacket is the start of recvPacket(), when ENetSelector found the source readable.
+    @details While ENetCapture is running, the frame of each received ENetPacket is recorded, even over its rate limit.
     @details Source must be valid.
     @param p_src ENetSocket source.
   */
   void                        ENetPacketHandler::recvPacket(ENetSocket *p_src)
   {
+    LARGE_INTEGER             l_start = { 0 };
+    LONGLONG                  l_trace = mETRACE_G.begin();
+    ENetCapture               *l_capture = ENetCapture::getInstance();
+    std::string               l_frame;
+
+    QueryPerformanceCounter(&l_start);
     mEERROR_R();
     if (nullptr == p_src)
     {
@@ -180,6 +335,11 @@ namespace                     ELib
       int32                   l_len = 0;
       ENetPacketType          l_type = ENETPACKET_TYPE_DISCONNECT;
 
+      if ((nullptr != l_capture)
+        && (true == l_capture->isRunning()))
+      {
+        p_src->setTap(&l_frame);
+      }
       l_len = p_src->recv(reinterpret_cast<char*>(&l_type), sizeof(ENetPacketType));
       if (EERROR_NONE == mEERROR)
       {
@@ -196,9 +356,25 @@ namespace                     ELib
               l_packet->recv();
               if (EERROR_NONE == mEERROR)
               {
-                WaitForSingleObject(m_mutexPackets, INFINITE);
-                m_packets.push(l_packet);
-                ReleaseMutex(m_mutexPackets);
+                if ((nullptr != l_capture)
+                  && (true == l_capture->isRunning()))
+                {
+                  if (true == l_frame.empty())
+                  {
+                    l_frame.assign(reinterpret_cast<const char*>(&l_type), sizeof(ENetPacketType));
+                  }
+                  l_capture->record(p_src, l_start.QuadPart, l_frame.data(), static_cast<int32>(l_frame.size()));
+                }
+                if (true == m_rateLimit.consume(p_src, l_type))
+                {
+                  mETRACE_G.end(ETRACE_EVENT_RECV, l_trace, *p_src);
+                  store(l_packet, l_start.QuadPart);
+                  mEMETRICS_G.time(EMETRICS_HISTOGRAM_RECV, l_start.QuadPart);
+                }
+                else
+                {
+                  delete (l_packet);
+                }
               }
               else
               {
@@ -224,19 +400,26 @@ namespace                     ELib
       {
         mEERROR_SH(EERROR_NET_SOCKET_ERR);
       }
+      p_src->setTap(nullptr);
     }
   }
 
   /**
     @brief Read a ENetPacket from buffer. /!\ Mutex. /!\ EError.
     @details Read ENetPacketType, then call its ENetPacket...::read().
-    @details On success, read ENetPacket is added to queue.
+    @details On success, read ENetPacket is added to the queue of its ENetChannel priority.
+    @details Reception time of ENetPacket is the start of read().
+    @details While ENetCapture is running, the buffer of each read ENetPacket is recorded.
     @param p_datas Buffer of datas to be read.
     @param p_len Length of buffer.
     @param p_src ENetSocket source.
   */
   void                        ENetPacketHandler::read(char *p_datas, int32 p_len, ENetSocket *p_src)
   {
+    LARGE_INTEGER             l_received = { 0 };
+    ENetCapture               *l_capture = ENetCapture::getInstance();
+
+    QueryPerformanceCounter(&l_received);
     mEERROR_R();
     if (nullptr == p_datas)
     {
@@ -265,9 +448,13 @@ namespace                     ELib
             if (EERROR_NONE == mEERROR)
             {
               l_packet->setSource(p_src);
-              WaitForSingleObject(m_mutexPackets, INFINITE);
-              m_packets.push(l_packet);
-              ReleaseMutex(m_mutexPackets);
+              if ((nullptr != l_capture)
+                && (true == l_capture->isRunning()))
+              {
+                l_capture->record(p_src, l_received.QuadPart, (0 != p_len) ? p_datas : reinterpret_cast<const char*>(&l_type),
+                  (0 != p_len) ? p_len : static_cast<int32>(sizeof(ENetPacketType)));
+              }
+              store(l_packet, l_received.QuadPart);
             }
             else
             {
@@ -320,16 +507,199 @@ namespace                     ELib
     size_t                    l_size = 0;
 
     WaitForSingleObject(m_mutexPackets, INFINITE);
-    l_size = m_packets.size();
-    for (size_t l_pos = 0; l_pos < l_size; ++l_pos)
+    for (uint8 l_priority = 0; l_priority < ENETCHANNEL_PRIORITIES; ++l_priority)
     {
-      if (*m_packets.front()->getSource() != *p_socket)
+      std::queue<ENetPacket*> &l_packets = m_packets[l_priority];
+
+      l_size = l_packets.size();
+      for (size_t l_pos = 0; l_pos < l_size; ++l_pos)
       {
-        m_packets.push(m_packets.front());
+        if (*l_packets.front()->getSource() != *p_socket)
+        {
+          l_packets.push(l_packets.front());
+        }
+        else
+        {
+          mEMETRICS_G.move(EMETRICS_GAUGE_QUEUED, -1);
+        }
+        l_packets.pop();
       }
-      m_packets.pop();
     }
     ReleaseMutex(m_mutexPackets);
   }
 
+  /**
+    @brief Set ENetChannel carrying a ENetPacketType. /!\ EError.
+    @param p_type ENetPacketType.
+    @param p_channel ENetChannel identifier.
+  */
+  void                        ENetPacketHandler::setChannel(ENetPacketType p_type, ENetChannelId p_channel)
+  {
+    mEERROR_R();
+    if (ENETCHANNEL_MAX <= p_channel)
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_types[p_type] = p_channel;
+    }
+  }
+
+  /**
+    @brief Set priority and weight of a ENetChannel. /!\ EError.
+    @param p_channel ENetChannel identifier.
+    @param p_priority Priority level, under ENETCHANNEL_PRIORITIES. 0 is the most urgent.
+    @param p_weight Bytes credited to the ENetChannel per round of scheduler. Must not be 0.
+  */
+  void                        ENetPacketHandler::setChannelPriority(ENetChannelId p_channel, uint8 p_priority, uint32 p_weight)
+  {
+    mEERROR_R();
+    if ((ENETCHANNEL_MAX <= p_channel)
+      || (ENETCHANNEL_PRIORITIES <= p_priority)
+      || (0 == p_weight))
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_channels[p_channel].m_priority = p_priority;
+      m_channels[p_channel].m_weight = p_weight;
+    }
+  }
+
+  /**
+    @brief Get ENetChannel carrying a ENetPacketType.
+    @param p_type ENetPacketType.
+    @return ENetChannel of type, ENETCHANNEL_DEFAULT if not set.
+  */
+  ENetChannel                 ENetPacketHandler::getChannel(ENetPacketType p_type) const
+  {
+    std::map<ENetPacketType, ENetChannelId>::const_iterator l_it;
+    ENetChannelId             l_channel = ENETCHANNEL_DEFAULT;
+
+    l_it = m_types.find(p_type);
+    if (m_types.end() != l_it)
+    {
+      l_channel = l_it->second;
+    }
+
+    return (m_channels[l_channel]);
+  }
+
+  /**
+    @brief Copy generators, ENetChannel settings, rate limits and admin setting of another ENetPacketHandler.
+    @details Must be called before starting automation.
+    @param p_model ENetPacketHandler to be copied, usually the Singleton.
+  */
+  void                        ENetPacketHandler::copySettings(const ENetPacketHandler &p_model)
+  {
+    m_generators = p_model.m_generators;
+    m_types = p_model.m_types;
+    for (ENetChannelId l_id = 0; l_id < ENETCHANNEL_MAX; ++l_id)
+    {
+      m_channels[l_id] = p_model.m_channels[l_id];
+    }
+    m_rateLimit.copySettings(p_model.m_rateLimit);
+    m_isAdmin = p_model.m_isAdmin;
+  }
+
+  /**
+    @brief Get rate limits of connected sources.
+    @details Limits must be set before starting automation.
+    @return ENetRateLimit of ENetPacketHandler.
+  */
+  ENetRateLimit               *ENetPacketHandler::getRateLimit()
+  {
+    return (&m_rateLimit);
+  }
+
+  /**
+    @brief Pop an ENetPacketStats from the admin queue. /!\ Mutex.
+    @return First ENetPacketStats received.
+    @return nullptr if admin queue is empty.
+  */
+  ENetPacket                  *ENetPacketHandler::popAdmin()
+  {
+    ENetPacket                *l_packet = nullptr;
+
+    WaitForSingleObject(m_mutexPackets, INFINITE);
+    if (false == m_admin.empty())
+    {
+      l_packet = m_admin.front();
+      m_admin.pop();
+    }
+    ReleaseMutex(m_mutexPackets);
+
+    return (l_packet);
+  }
+
+  /**
+    @brief Keep ENetPacketStats in the admin queue, or drop them.
+    @details Admin queue is emptied by ENetServer::admin(), never by popPacket(). Without admin, ENetPacketStats are dropped.
+    @param p_isAdmin ENetPacketStats are kept.
+  */
+  void                        ENetPacketHandler::setAdmin(bool p_isAdmin)
+  {
+    m_isAdmin = p_isAdmin;
+  }
+
+  /**
+    @brief Get event signalled when a ENetPacket is stored.
+    @details Manual reset: its consumer resets it before emptying the queues, so no ENetPacket stored meanwhile is missed.
+    @return Event handle.
+  */
+  HANDLE                      ENetPacketHandler::getEvent() const
+  {
+    return (m_eventPackets);
+  }
+
+  /**
+    @brief Get event signalled when a ENetPacketStats is kept into the admin queue.
+    @details Manual reset, like getEvent(). Consumed by ENetServer::admin().
+    @return Event handle.
+  */
+  HANDLE                      ENetPacketHandler::getAdminEvent() const
+  {
+    return (m_eventAdmin);
+  }
+
+  /**
+    @brief Store a received ENetPacket. /!\ Mutex.
+    @details ENetPacketStats go to the admin queue, others to the queue of their ENetChannel priority.
+    @details Queued ENetPacket starts ETRACE_EVENT_QUEUE if sampled. Event of its queue is signalled.
+    @param p_packet Received ENetPacket.
+    @param p_received Performance counter at reception.
+  */
+  void                        ENetPacketHandler::store(ENetPacket *p_packet, LONGLONG p_received)
+  {
+    p_packet->m_received = p_received;
+    mEMETRICS_G.packetIn(p_packet->getType());
+    if (ENETPACKET_TYPE_STATS == p_packet->getType())
+    {
+      if (true == m_isAdmin)
+      {
+        WaitForSingleObject(m_mutexPackets, INFINITE);
+        m_admin.push(p_packet);
+        ReleaseMutex(m_mutexPackets);
+        SetEvent(m_eventAdmin);
+      }
+      else
+      {
+        delete (p_packet);
+      }
+    }
+    else
+    {
+      p_packet->setTrace(mETRACE_G.begin());
+      WaitForSingleObject(m_mutexPackets, INFINITE);
+      m_packets[getChannel(p_packet->getType()).m_priority].push(p_packet);
+      ReleaseMutex(m_mutexPackets);
+      SetEvent(m_eventPackets);
+      mEMETRICS_G.move(EMETRICS_GAUGE_QUEUED, 1);
+    }
+  }
+
 }
@@ -0,0 +1,263 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetRateLimit Class.
+*/
+
+#include "ENetwork/ENetRateLimit.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Constructor for ENetRateLimit.
+    @details Initialize its mutex. Nothing is limited.
+  */
+  ENetRateLimit::ENetRateLimit() :
+    m_connection({ 0.0, 0, 0, 0 }),
+    m_types(),
+    m_states(),
+    m_frequency(),
+    m_dropped(0),
+    m_deferred(0),
+    m_isEnabled(0),
+    m_mutex(nullptr)
+  {
+    m_mutex = CreateMutex(nullptr, false, nullptr);
+    QueryPerformanceFrequency(&m_frequency);
+  }
+
+  /**
+    @brief Destructor for ENetRateLimit.
+    @details Release its mutex.
+  */
+  ENetRateLimit::~ENetRateLimit()
+  {
+    ReleaseMutex(m_mutex);
+    CloseHandle(m_mutex);
+  }
+
+  /**
+    @brief Set limit of all ENetPacket of a connection. /!\ Mutex.
+    @details Applied to new connections.
+    @param p_rate ENetPacket per second, 0 for no limit.
+    @param p_burst ENetPacket that can be received at once.
+  */
+  void                        ENetRateLimit::setConnectionLimit(uint32 p_rate, uint32 p_burst)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_connection.m_rate = p_rate;
+    m_connection.m_burst = (0 != p_burst) ? p_burst : 1;
+    m_connection.m_tokens = m_connection.m_burst;
+    InterlockedExchange(&m_isEnabled, ((0 != m_connection.m_rate) || (false == m_types.empty())) ? 1 : 0);
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Set limit of an ENetPacketType on each connection. /!\ Mutex.
+    @details Applied to new connections and to connections without bucket for this type yet.
+    @param p_type ENetPacketType to be limited.
+    @param p_rate ENetPacket per second, 0 to remove limit.
+    @param p_burst ENetPacket that can be received at once.
+  */
+  void                        ENetRateLimit::setTypeLimit(ENetPacketType p_type, uint32 p_rate, uint32 p_burst)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    if (0 == p_rate)
+    {
+      m_types.erase(p_type);
+    }
+    else
+    {
+      ENetTokenBucket         l_bucket = { 0.0, p_rate, (0 != p_burst) ? p_burst : 1, 0 };
+
+      l_bucket.m_tokens = l_bucket.m_burst;
+      m_types[p_type] = l_bucket;
+    }
+    InterlockedExchange(&m_isEnabled, ((0 != m_connection.m_rate) || (false == m_types.empty())) ? 1 : 0);
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Copy limits of another ENetRateLimit. Buckets of connections are not copied. /!\ Mutex.
+    @param p_model ENetRateLimit giving its limits.
+  */
+  void                        ENetRateLimit::copySettings(const ENetRateLimit &p_model)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_connection = p_model.m_connection;
+    m_types = p_model.m_types;
+    InterlockedExchange(&m_isEnabled, ((0 != m_connection.m_rate) || (false == m_types.empty())) ? 1 : 0);
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Check if a connection can be read. /!\ Mutex.
+    @details A connection without token of connection bucket is deferred.
+    @param p_client Connected ENetSocket.
+    @return true if connection has a token or is not limited.
+  */
+  bool                        ENetRateLimit::isAllowed(const ENetSocket *p_client)
+  {
+    bool                      l_isAllowed = true;
+
+    if (0 != m_connection.m_rate)
+    {
+      LARGE_INTEGER           l_time = { 0 };
+
+      QueryPerformanceCounter(&l_time);
+      WaitForSingleObject(m_mutex, INFINITE);
+
+      ENetRateState           &l_state = getState(p_client);
+
+      refill(l_state.m_bucket, l_time.QuadPart);
+      if (1.0 > l_state.m_bucket.m_tokens)
+      {
+        l_isAllowed = false;
+        ++m_deferred;
+      }
+      ReleaseMutex(m_mutex);
+    }
+
+    return (l_isAllowed);
+  }
+
+  /**
+    @brief Take the tokens of an ENetPacket received from a connection. /!\ Mutex.
+    @details Connection bucket is always charged. Type bucket is charged if the type is limited.
+    @param p_client Connected ENetSocket.
+    @param p_type ENetPacketType received.
+    @return true if ENetPacket can be stored.
+    @return false if ENetPacket must be dropped, its type being over its limit.
+  */
+  bool                        ENetRateLimit::consume(const ENetSocket *p_client, ENetPacketType p_type)
+  {
+    bool                      l_isAllowed = true;
+
+    if ((ENETPACKET_TYPE_DISCONNECT != p_type)
+      && (true == isEnabled()))
+    {
+      LARGE_INTEGER           l_time = { 0 };
+
+      QueryPerformanceCounter(&l_time);
+      WaitForSingleObject(m_mutex, INFINITE);
+
+      ENetRateState           &l_state = getState(p_client);
+      std::map<ENetPacketType, ENetTokenBucket>::const_iterator l_limit = m_types.find(p_type);
+
+      if (0 != l_state.m_bucket.m_rate)
+      {
+        refill(l_state.m_bucket, l_time.QuadPart);
+        l_state.m_bucket.m_tokens -= 1.0;
+      }
+      if (m_types.end() != l_limit)
+      {
+        std::map<ENetPacketType, ENetTokenBucket>::iterator l_it = l_state.m_types.find(p_type);
+
+        if (l_state.m_types.end() == l_it)
+        {
+          l_it = l_state.m_types.insert(std::make_pair(p_type, l_limit->second)).first;
+          l_it->second.m_time = l_time.QuadPart;
+        }
+        refill(l_it->second, l_time.QuadPart);
+        if (1.0 <= l_it->second.m_tokens)
+        {
+          l_it->second.m_tokens -= 1.0;
+        }
+        else
+        {
+          l_isAllowed = false;
+          ++m_dropped;
+        }
+      }
+      ReleaseMutex(m_mutex);
+    }
+
+    return (l_isAllowed);
+  }
+
+  /**
+    @brief Forget buckets of a closed connection. /!\ Mutex.
+    @param p_client Connected ENetSocket.
+  */
+  void                        ENetRateLimit::forget(const ENetSocket *p_client)
+  {
+    WaitForSingleObject(m_mutex, INFINITE);
+    m_states.erase(p_client);
+    ReleaseMutex(m_mutex);
+  }
+
+  /**
+    @brief Check if a limit is set.
+    @details Flag is kept by setters under mutex, so it is read without locking on each received ENetPacket.
+    @return true if connections or types are limited.
+  */
+  bool                        ENetRateLimit::isEnabled() const
+  {
+    return (0 != m_isEnabled);
+  }
+
+  /**
+    @brief Get number of dropped ENetPacket.
+    @return Number of ENetPacket dropped by type limits.
+  */
+  uint64                      ENetRateLimit::getDropped() const
+  {
+    return (m_dropped);
+  }
+
+  /**
+    @brief Get number of deferred reads.
+    @return Number of times a connection was not read, being over its limit.
+  */
+  uint64                      ENetRateLimit::getDeferred() const
+  {
+    return (m_deferred);
+  }
+
+  /**
+    @brief Get buckets of a connection, created full on first call.
+    @param p_client Connected ENetSocket.
+    @return Buckets of connection.
+  */
+  ENetRateLimit::ENetRateState &ENetRateLimit::getState(const ENetSocket *p_client)
+  {
+    std::unordered_map<const ENetSocket*, ENetRateState>::iterator l_it = m_states.find(p_client);
+
+    if (m_states.end() == l_it)
+    {
+      LARGE_INTEGER           l_time = { 0 };
+      ENetRateState           l_state = { m_connection, {} };
+
+      QueryPerformanceCounter(&l_time);
+      l_state.m_bucket.m_time = l_time.QuadPart;
+      l_it = m_states.insert(std::make_pair(p_client, l_state)).first;
+    }
+
+    return (l_it->second);
+  }
+
+  /**
+    @brief Credit a bucket with the tokens of time elapsed since its last refill, up to its burst.
+    @param p_bucket Bucket to refill.
+    @param p_time Current performance counter.
+  */
+  void                        ENetRateLimit::refill(ENetTokenBucket &p_bucket, LONGLONG p_time) const
+  {
+    if ((0 != p_bucket.m_rate)
+      && (0 != m_frequency.QuadPart))
+    {
+      p_bucket.m_tokens += static_cast<double>(p_time - p_bucket.m_time) * static_cast<double>(p_bucket.m_rate)
+        / static_cast<double>(m_frequency.QuadPart);
+      if (p_bucket.m_tokens > p_bucket.m_burst)
+      {
+        p_bucket.m_tokens = p_bucket.m_burst;
+      }
+    }
+    p_bucket.m_time = p_time;
+  }
+
+}
@@ -0,0 +1,315 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetRpc Class.
+*/
+
+#include "ENetwork/ENetRpc.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Constructor for ENetRpc.
+  */
+  ENetRpc::ENetRpc() :
+    m_calls(),
+    m_deadlines(),
+    m_methods(),
+    m_nextId(1),
+    m_mutexCalls(nullptr)
+  {
+  }
+
+  /**
+    @brief Destructor for ENetRpc.
+    @details Release its mutex.
+  */
+  ENetRpc::~ENetRpc()
+  {
+    ReleaseMutex(m_mutexCalls);
+    CloseHandle(m_mutexCalls);
+  }
+
+  /**
+    @brief Singleton for ENetRpc. /!\ EError.
+    @details Initialize its mutex.
+    @return ENetRpc unique instance on success.
+    @return nullptr on failure.
+  */
+  ENetRpc                     *ENetRpc::getInstance()
+  {
+    static ENetRpc            *l_instance = nullptr;
+
+    mEERROR_R();
+    if (nullptr == l_instance)
+    {
+      HANDLE                  l_mutex = nullptr;
+
+      l_mutex = CreateMutex(nullptr, false, nullptr);
+      if (nullptr != l_mutex)
+      {
+        l_instance = new ENetRpc();
+        if (nullptr != l_instance)
+        {
+          l_instance->m_mutexCalls = l_mutex;
+        }
+        else
+        {
+          mEERROR_S(EERROR_MEMORY);
+          CloseHandle(l_mutex);
+        }
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+      }
+    }
+
+    return (l_instance);
+  }
+
+  /**
+    @brief Send a request to a connected ENetSocket. /!\ Mutex. /!\ EError.
+    @details Does not wait for the response: callback is invoked by process() or expire().
+    @details Request is posted into ENetSendQueue of destination, so calls are pipelined on the connection.
+    @details Arguments over ENETPACKETRPC_MAX fail the call before anything is sent.
+    @param p_dst Connected ENetSocket destination.
+    @param p_method Method to be called.
+    @param p_datas Arguments of method.
+    @param p_len Arguments length.
+    @param p_callback Completion function.
+    @param p_context Context of completion function.
+    @param p_timeout Deadline of call in milliseconds.
+    @return Correlation identifier on success.
+    @return 0 on failure.
+  */
+  uint64                      ENetRpc::call(ENetSocket *p_dst, uint32 p_method, const char *p_datas, int32 p_len,
+                                ENetRpcCallback p_callback, void *p_context, uint32 p_timeout)
+  {
+    uint64                    l_id = 0;
+
+    mEERROR_R();
+    if ((nullptr == p_dst)
+      || (nullptr == p_callback))
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+    if ((nullptr != p_dst)
+      && (ENETSOCKET_FLAGS_PROTOCOL_TCP != (p_dst->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS)))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+    if ((0 > p_len)
+      || (ENETPACKETRPC_MAX < p_len))
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      ENetPacketRpc           l_request(ENETPACKET_TYPE_RPC_REQUEST, p_dst);
+      ENetRpcCall             l_call = { p_dst, p_callback, p_context, GetTickCount64() + p_timeout, false };
+
+      WaitForSingleObject(m_mutexCalls, INFINITE);
+      l_id = m_nextId++;
+      m_calls[ENetRpcKey(p_dst, l_id)] = l_call;
+      m_deadlines.insert(std::make_pair(l_call.m_deadline, ENetRpcKey(p_dst, l_id)));
+      ReleaseMutex(m_mutexCalls);
+      l_request.setMethod(p_method);
+      l_request.setId(l_id);
+      l_request.setDatas(p_datas, p_len);
+      l_request.post();
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+        WaitForSingleObject(m_mutexCalls, INFINITE);
+        m_deadlines.erase(std::make_pair(l_call.m_deadline, ENetRpcKey(p_dst, l_id)));
+        m_calls.erase(ENetRpcKey(p_dst, l_id));
+        ReleaseMutex(m_mutexCalls);
+        l_id = 0;
+      }
+    }
+
+    return (l_id);
+  }
+
+  /**
+    @brief Process a ENetPacket popped from ENetPacketHandler. /!\ Mutex. /!\ EError.
+    @details Request: call ENetRpcHandler of method and post the response to source.
+      A result over ENETPACKETRPC_MAX is replaced by an empty ENETRPC_STATUS_ERROR response.
+    @details Response: complete the pending call with the same correlation identifier to its source.
+      A response from another ENetSocket is ignored, so a peer cannot complete calls of other connections.
+    @details ENetPacket is not deleted, caller keeps ownership.
+    @param p_packet ENetPacket popped from ENetPacketHandler.
+    @return true if ENetPacket was a ENetPacketRpc.
+  */
+  bool                        ENetRpc::process(ENetPacket *p_packet)
+  {
+    bool                      l_ret = false;
+
+    mEERROR_R();
+    if (nullptr == p_packet)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if ((EERROR_NONE == mEERROR)
+      && (ENETPACKET_TYPE_RPC_REQUEST == p_packet->getType()))
+    {
+      ENetPacketRpc           *l_request = static_cast<ENetPacketRpc*>(p_packet);
+      ENetPacketRpc           l_response(ENETPACKET_TYPE_RPC_RESPONSE, const_cast<ENetSocket*>(l_request->getSource()));
+      ENetRpcMethod           l_method = { nullptr, nullptr };
+      std::map<uint32, ENetRpcMethod>::iterator l_it;
+
+      WaitForSingleObject(m_mutexCalls, INFINITE);
+      l_it = m_methods.find(l_request->getMethod());
+      if (m_methods.end() != l_it)
+      {
+        l_method = l_it->second;
+      }
+      ReleaseMutex(m_mutexCalls);
+      l_response.setMethod(l_request->getMethod());
+      l_response.setId(l_request->getId());
+      if (nullptr != l_method.m_handler)
+      {
+        l_method.m_handler(l_request, &l_response, l_method.m_context);
+      }
+      else
+      {
+        l_response.setStatus(ENETRPC_STATUS_UNKNOWN_METHOD);
+      }
+      if (ENETPACKETRPC_MAX < l_response.getDatas().size())
+      {
+        l_response.setStatus(ENETRPC_STATUS_ERROR);
+        l_response.setDatas(nullptr, 0);
+      }
+      l_response.post();
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+      l_ret = true;
+    }
+    else if ((EERROR_NONE == mEERROR)
+      && (ENETPACKET_TYPE_RPC_RESPONSE == p_packet->getType()))
+    {
+      ENetPacketRpc           *l_response = static_cast<ENetPacketRpc*>(p_packet);
+      ENetRpcCall             l_call = { nullptr, nullptr, nullptr, 0, false };
+      std::map<ENetRpcKey, ENetRpcCall>::iterator l_it;
+
+      WaitForSingleObject(m_mutexCalls, INFINITE);
+      l_it = m_calls.find(ENetRpcKey(l_response->getSource(), l_response->getId()));
+      if ((m_calls.end() != l_it)
+        && (l_response->getSource() == l_it->second.m_dst)
+        && (false == l_it->second.m_isCancelled))
+      {
+        l_call = l_it->second;
+        m_deadlines.erase(std::make_pair(l_call.m_deadline, l_it->first));
+        m_calls.erase(l_it);
+      }
+      ReleaseMutex(m_mutexCalls);
+      if (nullptr != l_call.m_callback)
+      {
+        l_call.m_callback(static_cast<ENetRpcStatus>(l_response->getStatus()), l_response, l_call.m_context);
+      }
+      l_ret = true;
+    }
+
+    return (l_ret);
+  }
+
+  /**
+    @brief Complete calls that reached their deadline or whose destination disconnected. /!\ Mutex.
+    @details Callbacks receive ENETRPC_STATUS_TIMEOUT or ENETRPC_STATUS_CANCELLED. A late response is ignored.
+  */
+  void                        ENetRpc::expire()
+  {
+    std::vector<std::pair<ENetRpcStatus, ENetRpcCall> > l_expired;
+    uint64                    l_now = GetTickCount64();
+
+    WaitForSingleObject(m_mutexCalls, INFINITE);
+    while ((false == m_deadlines.empty())
+      && (l_now >= m_deadlines.begin()->first))
+    {
+      std::map<ENetRpcKey, ENetRpcCall>::iterator l_it;
+
+      l_it = m_calls.find(m_deadlines.begin()->second);
+      if (m_calls.end() != l_it)
+      {
+        l_expired.push_back(std::make_pair(true == l_it->second.m_isCancelled ? ENETRPC_STATUS_CANCELLED : ENETRPC_STATUS_TIMEOUT,
+          l_it->second));
+        m_calls.erase(l_it);
+      }
+      m_deadlines.erase(m_deadlines.begin());
+    }
+    ReleaseMutex(m_mutexCalls);
+    for (std::vector<std::pair<ENetRpcStatus, ENetRpcCall> >::iterator l_it = l_expired.begin(); l_it != l_expired.end(); ++l_it)
+    {
+      l_it->second.m_callback(l_it->first, nullptr, l_it->second.m_context);
+    }
+  }
+
+  /**
+    @brief Cancel pending calls to a ENetSocket. /!\ Mutex.
+    @details Called by ENetSelector on disconnection. Calls are completed by next expire().
+    @param p_socket ENetSocket destination.
+  */
+  void                        ENetRpc::cancel(const ENetSocket *p_socket)
+  {
+    WaitForSingleObject(m_mutexCalls, INFINITE);
+    for (std::map<ENetRpcKey, ENetRpcCall>::iterator l_it = m_calls.lower_bound(ENetRpcKey(p_socket, 0));
+      (m_calls.end() != l_it) && (p_socket == l_it->first.first); ++l_it)
+    {
+      if (false == l_it->second.m_isCancelled)
+      {
+        m_deadlines.erase(std::make_pair(l_it->second.m_deadline, l_it->first));
+        l_it->second.m_isCancelled = true;
+        l_it->second.m_deadline = 0;
+        m_deadlines.insert(std::make_pair(l_it->second.m_deadline, l_it->first));
+      }
+    }
+    ReleaseMutex(m_mutexCalls);
+  }
+
+  /**
+    @brief Set ENetRpcHandler of a method. /!\ Mutex.
+    @param p_method Method.
+    @param p_handler Serving function. nullptr to remove method.
+    @param p_context Context of serving function.
+  */
+  void                        ENetRpc::setHandler(uint32 p_method, ENetRpcHandler p_handler, void *p_context)
+  {
+    WaitForSingleObject(m_mutexCalls, INFINITE);
+    if (nullptr != p_handler)
+    {
+      ENetRpcMethod           l_method = { p_handler, p_context };
+
+      m_methods[p_method] = l_method;
+    }
+    else
+    {
+      m_methods.erase(p_method);
+    }
+    ReleaseMutex(m_mutexCalls);
+  }
+
+  /**
+    @brief Get number of calls waiting for their response. /!\ Mutex.
+    @return Number of pending calls.
+  */
+  uint32                      ENetRpc::getPending() const
+  {
+    uint32                    l_size = 0;
+
+    WaitForSingleObject(m_mutexCalls, INFINITE);
+    l_size = static_cast<uint32>(m_calls.size());
+    ReleaseMutex(m_mutexCalls);
+
+    return (l_size);
+  }
+
+}
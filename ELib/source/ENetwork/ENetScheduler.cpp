@@ -0,0 +1,922 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetScheduler Class.
+*/
+
+#include <exception>
+#include "ENetwork/ENetScheduler.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Functor for ENetScheduler::run().
+    @param p_scheduler ENetScheduler caller.
+    @return Unused.
+  */
+  DWORD WINAPI                RunFunctor(LPVOID p_scheduler)
+  {
+    mEERROR_R();
+    if (nullptr != p_scheduler)
+    {
+      static_cast<ENetScheduler*>(p_scheduler)->run();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Constructor for promise of ENetTask.
+  */
+  ENetTask::promise_type::promise_type() :
+    m_socket(nullptr)
+  {
+  }
+
+  /**
+    @brief Create ENetTask of a coroutine.
+    @return ENetTask.
+  */
+  ENetTask                    ENetTask::promise_type::get_return_object()
+  {
+    return (ENetTask(std::coroutine_handle<promise_type>::from_promise(*this)));
+  }
+
+  /**
+    @brief Coroutine is created suspended, until ENetScheduler::spawn().
+    @return Suspend.
+  */
+  std::suspend_always         ENetTask::promise_type::initial_suspend() noexcept
+  {
+    return (std::suspend_always());
+  }
+
+  /**
+    @brief Coroutine frame is freed when it returns. /!\ Mutex.
+    @details A session coroutine removes the mailbox of its ENetSocket, so next ENetPacket spawns a new session.
+    @return Do not suspend.
+  */
+  std::suspend_never          ENetTask::promise_type::final_suspend() noexcept
+  {
+    ENetScheduler             *l_scheduler = nullptr;
+
+    if (nullptr != m_socket)
+    {
+      l_scheduler = ENetScheduler::getInstance();
+      if (nullptr != l_scheduler)
+      {
+        l_scheduler->closeMailbox(m_socket, std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+    }
+
+    return (std::suspend_never());
+  }
+
+  /**
+    @brief End of coroutine.
+  */
+  void                        ENetTask::promise_type::return_void()
+  {
+  }
+
+  /**
+    @brief Exception escaping a coroutine. ELib does not use exceptions.
+  */
+  void                        ENetTask::promise_type::unhandled_exception()
+  {
+    std::terminate();
+  }
+
+  /**
+    @brief Constructor for ENetTask.
+    @param p_handle Coroutine.
+  */
+  ENetTask::ENetTask(std::coroutine_handle<promise_type> p_handle) :
+    m_handle(p_handle)
+  {
+  }
+
+  /**
+    @brief Get coroutine of ENetTask.
+    @return Coroutine.
+  */
+  std::coroutine_handle<>     ENetTask::getHandle() const
+  {
+    return (m_handle);
+  }
+
+  /**
+    @brief Set ENetSocket of a session coroutine, whose mailbox is removed when it returns.
+    @param p_socket ENetSocket of session.
+  */
+  void                        ENetTask::setSocket(const ENetSocket *p_socket)
+  {
+    m_handle.promise().m_socket = p_socket;
+  }
+
+  /**
+    @brief Constructor for ENetRecvAwaiter.
+    @param p_socket ENetSocket awaited.
+  */
+  ENetRecvAwaiter::ENetRecvAwaiter(ENetSocket *p_socket) :
+    m_socket(p_socket),
+    m_packet(nullptr)
+  {
+  }
+
+  /**
+    @brief Mailbox is checked by await_suspend(), under ENetScheduler mutex.
+    @return false.
+  */
+  bool                        ENetRecvAwaiter::await_ready() const
+  {
+    return (false);
+  }
+
+  /**
+    @brief Take next ENetPacket of mailbox, or register coroutine as waiter. /!\ Mutex.
+    @param p_handle Coroutine awaiting.
+    @return true if coroutine must stay suspended.
+  */
+  bool                        ENetRecvAwaiter::await_suspend(std::coroutine_handle<> p_handle)
+  {
+    return (ENetScheduler::getInstance()->takePacket(m_socket, p_handle, &m_packet));
+  }
+
+  /**
+    @brief Get ENetPacket received.
+    @return ENetPacket, to be deleted by coroutine.
+  */
+  ENetPacket                  *ENetRecvAwaiter::await_resume() const
+  {
+    return (m_packet);
+  }
+
+  /**
+    @brief Constructor for ENetSendAwaiter.
+    @param p_socket ENetSocket destination.
+    @param p_packet ENetPacket to be posted.
+  */
+  ENetSendAwaiter::ENetSendAwaiter(ENetSocket *p_socket, ENetPacket *p_packet) :
+    m_socket(p_socket),
+    m_packet(p_packet)
+  {
+  }
+
+  /**
+    @brief ENetPacket::post() never blocks, coroutine is never suspended.
+    @return true.
+  */
+  bool                        ENetSendAwaiter::await_ready() const
+  {
+    return (true);
+  }
+
+  /**
+    @brief Unused.
+    @param p_handle Coroutine awaiting.
+  */
+  void                        ENetSendAwaiter::await_suspend(std::coroutine_handle<> p_handle)
+  {
+  }
+
+  /**
+    @brief Post ENetPacket into ENetSendQueue of destination. /!\ EError.
+    @return true on success.
+  */
+  bool                        ENetSendAwaiter::await_resume() const
+  {
+    mEERROR_R();
+    if (nullptr == m_packet)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_packet->post(m_socket);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+
+    return (EERROR_NONE == mEERROR);
+  }
+
+  /**
+    @brief Constructor for ENetSleepAwaiter.
+    @param p_delay Delay in milliseconds.
+  */
+  ENetSleepAwaiter::ENetSleepAwaiter(uint32 p_delay) :
+    m_delay(p_delay)
+  {
+  }
+
+  /**
+    @brief Coroutine is not suspended without delay.
+    @return true if delay is 0.
+  */
+  bool                        ENetSleepAwaiter::await_ready() const
+  {
+    return (0 == m_delay);
+  }
+
+  /**
+    @brief Register coroutine into ENetScheduler timers. /!\ Mutex.
+    @param p_handle Coroutine awaiting.
+  */
+  void                        ENetSleepAwaiter::await_suspend(std::coroutine_handle<> p_handle)
+  {
+    ENetScheduler::getInstance()->addTimer(GetTickCount64() + m_delay, p_handle);
+  }
+
+  /**
+    @brief End of delay.
+  */
+  void                        ENetSleepAwaiter::await_resume() const
+  {
+  }
+
+  /**
+    @brief Constructor for ENetRpcAwaiter.
+    @details Arguments are not copied, they must be valid until the coroutine is suspended.
+    @param p_socket ENetSocket destination.
+    @param p_method Method to be called.
+    @param p_datas Arguments of method.
+    @param p_len Arguments length.
+    @param p_timeout Deadline of call in milliseconds.
+  */
+  ENetRpcAwaiter::ENetRpcAwaiter(ENetSocket *p_socket, uint32 p_method, const char *p_datas, int32 p_len, uint32 p_timeout) :
+    m_socket(p_socket),
+    m_method(p_method),
+    m_datas(p_datas),
+    m_len(p_len),
+    m_timeout(p_timeout),
+    m_handle(),
+    m_result()
+  {
+    m_result.m_status = ENETRPC_STATUS_ERROR;
+  }
+
+  /**
+    @brief Call is sent by await_suspend().
+    @return false.
+  */
+  bool                        ENetRpcAwaiter::await_ready() const
+  {
+    return (false);
+  }
+
+  /**
+    @brief Send request with ENetRpc::call(). /!\ Mutex. /!\ EError.
+    @details Coroutine is resumed by complete(), possibly on another thread: members are not used after ENetRpc::call().
+    @param p_handle Coroutine awaiting.
+    @return true if coroutine must stay suspended, false if call could not be sent.
+  */
+  bool                        ENetRpcAwaiter::await_suspend(std::coroutine_handle<> p_handle)
+  {
+    ENetRpc                   *l_rpc = nullptr;
+    uint64                    l_id = 0;
+
+    mEERROR_R();
+    l_rpc = ENetRpc::getInstance();
+    if (nullptr == l_rpc)
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_handle = p_handle;
+      l_id = l_rpc->call(m_socket, m_method, m_datas, m_len, ENetRpcAwaiter::complete, this, m_timeout);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_PACKET_ERR);
+      }
+    }
+
+    return (0 != l_id);
+  }
+
+  /**
+    @brief Get result of call.
+    @return ENetRpcResult.
+  */
+  ENetRpcResult               ENetRpcAwaiter::await_resume() const
+  {
+    return (m_result);
+  }
+
+  /**
+    @brief ENetRpcCallback of ENetRpcAwaiter. Store result and schedule coroutine. /!\ Mutex.
+    @param p_status ENetRpcStatus of call.
+    @param p_response Response.
+    @param p_context ENetRpcAwaiter.
+  */
+  void                        ENetRpcAwaiter::complete(ENetRpcStatus p_status, const ENetPacketRpc *p_response, void *p_context)
+  {
+    ENetRpcAwaiter            *l_awaiter = static_cast<ENetRpcAwaiter*>(p_context);
+
+    l_awaiter->m_result.m_status = p_status;
+    if (nullptr != p_response)
+    {
+      l_awaiter->m_result.m_datas = p_response->getDatas();
+    }
+    ENetScheduler::getInstance()->schedule(l_awaiter->m_handle);
+  }
+
+  /**
+    @brief Constructor for ENetConnection.
+    @param p_socket Connected ENetSocket.
+  */
+  ENetConnection::ENetConnection(ENetSocket *p_socket) :
+    m_socket(p_socket)
+  {
+  }
+
+  /**
+    @brief Await next ENetPacket of ENetSocket.
+    @return ENetRecvAwaiter.
+  */
+  ENetRecvAwaiter             ENetConnection::recvPacket()
+  {
+    return (ENetRecvAwaiter(m_socket));
+  }
+
+  /**
+    @brief Await posting of a ENetPacket to ENetSocket.
+    @param p_packet ENetPacket to be posted.
+    @return ENetSendAwaiter.
+  */
+  ENetSendAwaiter             ENetConnection::send(ENetPacket *p_packet)
+  {
+    return (ENetSendAwaiter(m_socket, p_packet));
+  }
+
+  /**
+    @brief Await a delay.
+    @param p_delay Delay in milliseconds.
+    @return ENetSleepAwaiter.
+  */
+  ENetSleepAwaiter            ENetConnection::sleep(uint32 p_delay)
+  {
+    return (ENetSleepAwaiter(p_delay));
+  }
+
+  /**
+    @brief Await a ENetRpc call on ENetSocket.
+    @param p_method Method to be called.
+    @param p_datas Arguments of method.
+    @param p_len Arguments length.
+    @param p_timeout Deadline of call in milliseconds.
+    @return ENetRpcAwaiter.
+  */
+  ENetRpcAwaiter              ENetConnection::rpc(uint32 p_method, const char *p_datas, int32 p_len, uint32 p_timeout)
+  {
+    return (ENetRpcAwaiter(m_socket, p_method, p_datas, p_len, p_timeout));
+  }
+
+  /**
+    @brief Get ENetSocket of connection.
+    @return Connected ENetSocket.
+  */
+  ENetSocket                  *ENetConnection::getSocket() const
+  {
+    return (m_socket);
+  }
+
+  /**
+    @brief Constructor for ENetScheduler.
+  */
+  ENetScheduler::ENetScheduler() :
+    m_ready(),
+    m_timers(),
+    m_mailboxes(),
+    m_session(nullptr),
+    m_handler(nullptr),
+    m_dropped(0),
+    m_threads(),
+    m_mutexTasks(nullptr),
+    m_mutexPoll(nullptr),
+    m_eventTasks(nullptr),
+    m_isRunning(false)
+  {
+  }
+
+  /**
+    @brief Destructor for ENetScheduler.
+    @details Stop its threads, release its mutexes and event.
+  */
+  ENetScheduler::~ENetScheduler()
+  {
+    if (true == m_isRunning)
+    {
+      stop();
+    }
+    ReleaseMutex(m_mutexTasks);
+    CloseHandle(m_mutexTasks);
+    ReleaseMutex(m_mutexPoll);
+    CloseHandle(m_mutexPoll);
+    CloseHandle(m_eventTasks);
+  }
+
+  /**
+    @brief Singleton for ENetScheduler. /!\ EError.
+    @details Initialize its mutexes and event.
+    @return ENetScheduler unique instance on success.
+    @return nullptr on failure.
+  */
+  ENetScheduler               *ENetScheduler::getInstance()
+  {
+    static ENetScheduler      *l_instance = nullptr;
+
+    mEERROR_R();
+    if (nullptr == l_instance)
+    {
+      HANDLE                  l_mutexTasks = nullptr;
+      HANDLE                  l_mutexPoll = nullptr;
+      HANDLE                  l_eventTasks = nullptr;
+
+      l_mutexTasks = CreateMutex(nullptr, false, nullptr);
+      l_mutexPoll = CreateMutex(nullptr, false, nullptr);
+      l_eventTasks = CreateEvent(nullptr, true, false, nullptr);
+      if ((nullptr != l_mutexTasks)
+        && (nullptr != l_mutexPoll)
+        && (nullptr != l_eventTasks))
+      {
+        l_instance = new ENetScheduler();
+        if (nullptr != l_instance)
+        {
+          l_instance->m_mutexTasks = l_mutexTasks;
+          l_instance->m_mutexPoll = l_mutexPoll;
+          l_instance->m_eventTasks = l_eventTasks;
+        }
+        else
+        {
+          mEERROR_S(EERROR_MEMORY);
+          CloseHandle(l_mutexTasks);
+          CloseHandle(l_mutexPoll);
+          CloseHandle(l_eventTasks);
+        }
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+        if (nullptr != l_mutexTasks)
+        {
+          CloseHandle(l_mutexTasks);
+        }
+        if (nullptr != l_mutexPoll)
+        {
+          CloseHandle(l_mutexPoll);
+        }
+        if (nullptr != l_eventTasks)
+        {
+          CloseHandle(l_eventTasks);
+        }
+      }
+    }
+
+    return (l_instance);
+  }
+
+  /**
+    @brief Start ENetScheduler automation. /!\ Mutex. /!\ EError.
+    @details Create threads for run(). A few threads are enough for thousands of coroutines.
+    @param p_threads Number of threads.
+  */
+  void                        ENetScheduler::start(uint32 p_threads)
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_SCHEDULER_STATE);
+    }
+    if (0 == p_threads)
+    {
+      mEERROR_S(EERROR_OUT_OF_RANGE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = true;
+      for (uint32 l_index = 0; (EERROR_NONE == mEERROR) && (l_index < p_threads); ++l_index)
+      {
+        HANDLE                l_thread = nullptr;
+
+        l_thread = CreateThread(nullptr, 0, RunFunctor, this, 0, nullptr);
+        if (nullptr != l_thread)
+        {
+          m_threads.push_back(l_thread);
+        }
+        else
+        {
+          mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+        }
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        stop();
+        mEERROR_SH(EERROR_NET_SCHEDULER_STATE);
+      }
+    }
+  }
+
+  /**
+    @brief Stop ENetScheduler automation. /!\ Blocking. /!\ EError.
+    @details Wake its threads and wait for them to end their current iteration. Suspended coroutines are not resumed anymore.
+  */
+  void                        ENetScheduler::stop()
+  {
+    mEERROR_R();
+    if (false == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_SCHEDULER_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = false;
+      SetEvent(m_eventTasks);
+      for (std::vector<HANDLE>::iterator l_it = m_threads.begin(); l_it != m_threads.end(); ++l_it)
+      {
+        WaitForSingleObject(*l_it, INFINITE);
+        CloseHandle(*l_it);
+      }
+      m_threads.clear();
+    }
+  }
+
+  /**
+    @brief Loop of ENetScheduler threads. /!\ Blocking. /!\ Mutex.
+    @details Poll ENetPacketHandler, timers and ENetRpc deadlines, then resume ready coroutines.
+    @details When there is nothing to do, wait for the event of ENetPacketHandler, a scheduled coroutine
+      or the next timer, at most ENETSCHEDULER_WAIT milliseconds.
+  */
+  void                        ENetScheduler::run()
+  {
+    while (true == m_isRunning)
+    {
+      bool                    l_isBusy = false;
+
+      ResetEvent(m_eventTasks);
+      l_isBusy = poll();
+      for (uint32 l_count = 0; l_count < ENETSCHEDULER_POLL_MAX; ++l_count)
+      {
+        std::coroutine_handle<> l_handle = nullptr;
+
+        WaitForSingleObject(m_mutexTasks, INFINITE);
+        if (false == m_ready.empty())
+        {
+          l_handle = m_ready.front();
+          m_ready.pop_front();
+        }
+        ReleaseMutex(m_mutexTasks);
+        if (nullptr == l_handle)
+        {
+          break;
+        }
+        l_handle.resume();
+        l_isBusy = true;
+      }
+      if (false == l_isBusy)
+      {
+        HANDLE                l_events[2] = { m_eventTasks, nullptr };
+        DWORD                 l_count = 1;
+        DWORD                 l_wait = ENETSCHEDULER_WAIT;
+        ENetPacketHandler     *l_handler = getHandler();
+
+        if (nullptr != l_handler)
+        {
+          l_events[l_count++] = l_handler->getEvent();
+        }
+        WaitForSingleObject(m_mutexTasks, INFINITE);
+        if (false == m_timers.empty())
+        {
+          uint64              l_now = GetTickCount64();
+
+          if (l_now >= m_timers.begin()->first)
+          {
+            l_wait = 0;
+          }
+          else if (l_wait > m_timers.begin()->first - l_now)
+          {
+            l_wait = static_cast<DWORD>(m_timers.begin()->first - l_now);
+          }
+        }
+        ReleaseMutex(m_mutexTasks);
+        WaitForMultipleObjects(l_count, l_events, false, l_wait);
+      }
+    }
+  }
+
+  /**
+    @brief Start a coroutine. /!\ Mutex.
+    @param p_task ENetTask to be started.
+  */
+  void                        ENetScheduler::spawn(ENetTask p_task)
+  {
+    schedule(p_task.getHandle());
+  }
+
+  /**
+    @brief Add a coroutine to the ready queue and wake a waiting thread. /!\ Mutex.
+    @param p_handle Coroutine to be resumed.
+  */
+  void                        ENetScheduler::schedule(std::coroutine_handle<> p_handle)
+  {
+    if (nullptr != p_handle)
+    {
+      WaitForSingleObject(m_mutexTasks, INFINITE);
+      m_ready.push_back(p_handle);
+      ReleaseMutex(m_mutexTasks);
+      SetEvent(m_eventTasks);
+    }
+  }
+
+  /**
+    @brief Set session coroutine of new connections.
+    @details Must be set before start().
+    @param p_session ENetSession. nullptr to disable.
+  */
+  void                        ENetScheduler::setSession(ENetSession p_session)
+  {
+    m_session = p_session;
+  }
+
+  /**
+    @brief Set ENetPacketHandler polled by ENetScheduler.
+    @details Must be set before start().
+    @param p_handler ENetPacketHandler. nullptr for ENetPacketHandler Singleton.
+  */
+  void                        ENetScheduler::setHandler(ENetPacketHandler *p_handler)
+  {
+    m_handler = p_handler;
+  }
+
+  /**
+    @brief Get ENetPacketHandler polled by ENetScheduler.
+    @return ENetPacketHandler set by setHandler(), or ENetPacketHandler Singleton.
+  */
+  ENetPacketHandler           *ENetScheduler::getHandler() const
+  {
+    return ((nullptr != m_handler) ? m_handler : ENetPacketHandler::getInstance());
+  }
+
+  /**
+    @brief Get number of ENetPacket dropped by full mailboxes.
+    @return Dropped ENetPacket.
+  */
+  uint64                      ENetScheduler::getDropped() const
+  {
+    return (m_dropped);
+  }
+
+  /**
+    @brief Indicate if ENetScheduler is running.
+    @return true if running.
+  */
+  bool                        ENetScheduler::isRunning() const
+  {
+    return (m_isRunning);
+  }
+
+  /**
+    @brief Poll ENetPacketHandler, ENetRpc deadlines and timers. /!\ Mutex.
+    @details Only one thread poll at a time, so ENetPacket of a ENetSocket keep their order.
+    @details Event of ENetPacketHandler is reset before its queues are read, an ENetPacket stored meanwhile signals it again.
+    @return true if work was found.
+  */
+  bool                        ENetScheduler::poll()
+  {
+    bool                      l_isBusy = false;
+
+    if (WAIT_OBJECT_0 == WaitForSingleObject(m_mutexPoll, 0))
+    {
+      ENetPacketHandler       *l_handler = getHandler();
+      ENetRpc                 *l_rpc = ENetRpc::getInstance();
+      uint64                  l_now = GetTickCount64();
+
+      if (nullptr != l_handler)
+      {
+        ResetEvent(l_handler->getEvent());
+      }
+      if (nullptr != l_rpc)
+      {
+        l_rpc->expire();
+      }
+      for (uint32 l_count = 0; (nullptr != l_handler) && (l_count < ENETSCHEDULER_POLL_MAX); ++l_count)
+      {
+        ENetPacket            *l_packet = nullptr;
+
+        l_packet = l_handler->popPacket();
+        if (nullptr == l_packet)
+        {
+          break;
+        }
+        if ((nullptr != l_rpc)
+          && (true == l_rpc->process(l_packet)))
+        {
+          delete (l_packet);
+        }
+        else
+        {
+          dispatch(l_packet);
+        }
+        l_isBusy = true;
+      }
+      WaitForSingleObject(m_mutexTasks, INFINITE);
+      while ((false == m_timers.empty())
+        && (l_now >= m_timers.begin()->first))
+      {
+        m_ready.push_back(m_timers.begin()->second);
+        m_timers.erase(m_timers.begin());
+      }
+      l_isBusy = l_isBusy || (false == m_ready.empty());
+      ReleaseMutex(m_mutexTasks);
+      ReleaseMutex(m_mutexPoll);
+    }
+
+    return (l_isBusy);
+  }
+
+  /**
+    @brief Give ENetPacket to the coroutine of its source. /!\ Mutex.
+    @details Resume the coroutine awaiting it, or store it into the mailbox.
+    @details First ENetPacket of an unknown source spawns the ENetSession coroutine, owner of the new mailbox.
+    @details Mailbox is removed once its ENetPacketDisconnect is given to the coroutine, or when its session returns.
+    @details A mailbox holding ENETSCHEDULER_MAILBOX_MAX ENetPacket drops the following ones, except ENetPacketDisconnect.
+    @param p_packet ENetPacket popped from ENetPacketHandler.
+  */
+  void                        ENetScheduler::dispatch(ENetPacket *p_packet)
+  {
+    std::unordered_map<const ENetSocket*, ENetMailbox>::iterator  l_mailbox;
+    const ENetSocket          *l_src = p_packet->getSource();
+    std::coroutine_handle<>   l_session = nullptr;
+    bool                      l_isNew = false;
+
+    WaitForSingleObject(m_mutexTasks, INFINITE);
+    l_mailbox = m_mailboxes.find(l_src);
+    if (m_mailboxes.end() == l_mailbox)
+    {
+      ENetMailbox             l_empty = { std::deque<ENetPacket*>(), nullptr, nullptr, nullptr };
+
+      l_isNew = (nullptr != m_session);
+      if ((true == l_isNew)
+        && (ENETPACKET_TYPE_DISCONNECT == p_packet->getType()))
+      {
+        delete (p_packet);
+        p_packet = nullptr;
+        l_isNew = false;
+      }
+      else
+      {
+        if (true == l_isNew)
+        {
+          ENetTask            l_task = m_session(ENetConnection(const_cast<ENetSocket*>(l_src)));
+
+          l_task.setSocket(l_src);
+          l_session = l_task.getHandle();
+          l_empty.m_session = l_session;
+        }
+        l_mailbox = m_mailboxes.insert(std::make_pair(l_src, l_empty)).first;
+      }
+    }
+    if (nullptr != p_packet)
+    {
+      if (nullptr != l_mailbox->second.m_waiter)
+      {
+        *l_mailbox->second.m_slot = p_packet;
+        m_ready.push_back(l_mailbox->second.m_waiter);
+        if (ENETPACKET_TYPE_DISCONNECT == p_packet->getType())
+        {
+          m_mailboxes.erase(l_mailbox);
+        }
+        else
+        {
+          l_mailbox->second.m_waiter = nullptr;
+          l_mailbox->second.m_slot = nullptr;
+        }
+      }
+      else if ((static_cast<size_t>(ENETSCHEDULER_MAILBOX_MAX) > l_mailbox->second.m_packets.size())
+        || (ENETPACKET_TYPE_DISCONNECT == p_packet->getType()))
+      {
+        l_mailbox->second.m_packets.push_back(p_packet);
+      }
+      else
+      {
+        delete (p_packet);
+        ++m_dropped;
+      }
+    }
+    ReleaseMutex(m_mutexTasks);
+    if (true == l_isNew)
+    {
+      schedule(l_session);
+    }
+  }
+
+  /**
+    @brief Add a sleeping coroutine and wake a waiting thread, so its wait covers the new deadline. /!\ Mutex.
+    @param p_deadline GetTickCount64() at which coroutine is resumed.
+    @param p_handle Coroutine sleeping.
+  */
+  void                        ENetScheduler::addTimer(uint64 p_deadline, std::coroutine_handle<> p_handle)
+  {
+    WaitForSingleObject(m_mutexTasks, INFINITE);
+    m_timers.insert(std::make_pair(p_deadline, p_handle));
+    ReleaseMutex(m_mutexTasks);
+    SetEvent(m_eventTasks);
+  }
+
+  /**
+    @brief Take next ENetPacket of a ENetSocket mailbox, or register coroutine as its waiter. /!\ Mutex.
+    @param p_socket ENetSocket awaited.
+    @param p_handle Coroutine awaiting.
+    @param p_slot Result of coroutine.
+    @return true if coroutine must stay suspended.
+  */
+  bool                        ENetScheduler::takePacket(ENetSocket *p_socket, std::coroutine_handle<> p_handle, ENetPacket **p_slot)
+  {
+    bool                      l_isSuspended = true;
+
+    WaitForSingleObject(m_mutexTasks, INFINITE);
+    ENetMailbox               &l_mailbox = m_mailboxes[p_socket];
+
+    if (false == l_mailbox.m_packets.empty())
+    {
+      *p_slot = l_mailbox.m_packets.front();
+      l_mailbox.m_packets.pop_front();
+      if (ENETPACKET_TYPE_DISCONNECT == (*p_slot)->getType())
+      {
+        m_mailboxes.erase(p_socket);
+      }
+      l_isSuspended = false;
+    }
+    else
+    {
+      l_mailbox.m_waiter = p_handle;
+      l_mailbox.m_slot = p_slot;
+    }
+    ReleaseMutex(m_mutexTasks);
+
+    return (l_isSuspended);
+  }
+
+  /**
+    @brief Remove mailbox of a returning session coroutine. /!\ Mutex.
+    @details ENetPacket not yet awaited are deleted. A mailbox owned by another session
+      (ENetSocket reused by a new connection) is kept.
+    @details Another coroutine still awaiting the mailbox is resumed with a ENetPacketDisconnect.
+      If it cannot be allocated, the mailbox is kept without owner until the ENetPacketDisconnect of its ENetSocket.
+    @param p_socket ENetSocket of session.
+    @param p_session Session coroutine returning.
+  */
+  void                        ENetScheduler::closeMailbox(const ENetSocket *p_socket, std::coroutine_handle<> p_session)
+  {
+    std::unordered_map<const ENetSocket*, ENetMailbox>::iterator  l_mailbox;
+
+    WaitForSingleObject(m_mutexTasks, INFINITE);
+    l_mailbox = m_mailboxes.find(p_socket);
+    if ((m_mailboxes.end() != l_mailbox)
+      && (p_session == l_mailbox->second.m_session))
+    {
+      ENetPacket              *l_disconnect = nullptr;
+
+      while (false == l_mailbox->second.m_packets.empty())
+      {
+        delete (l_mailbox->second.m_packets.front());
+        l_mailbox->second.m_packets.pop_front();
+      }
+      if (nullptr != l_mailbox->second.m_waiter)
+      {
+        l_disconnect = new ENetPacketDisconnect(const_cast<ENetSocket*>(p_socket));
+      }
+      if (nullptr != l_disconnect)
+      {
+        *l_mailbox->second.m_slot = l_disconnect;
+        m_ready.push_back(l_mailbox->second.m_waiter);
+        m_mailboxes.erase(l_mailbox);
+      }
+      else if (nullptr != l_mailbox->second.m_waiter)
+      {
+        l_mailbox->second.m_session = nullptr;
+      }
+      else
+      {
+        m_mailboxes.erase(l_mailbox);
+      }
+    }
+    ReleaseMutex(m_mutexTasks);
+  }
+
+}
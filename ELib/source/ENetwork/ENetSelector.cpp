@@ -4,7 +4,11 @@
   @brief Source for ENetSelector Class.
 */
 
+#include "ENetwork/ENetBudget.h"
 #include "ENetwork/ENetSelector.h"
+#include "ENetwork/ENetRpc.h"
+#include "ENetwork/ENetInterestGrid.h"
+#include "ENetwork/ENetTopics.h"
 
 /**
   @brief General scope for ELib components.
@@ -34,11 +38,16 @@ namespace                     ELib
 
   /**
     @brief Constructor for ENetSelector.
+    @param p_handler ENetPacketHandler storing received ENetPacket. nullptr for ENetPacketHandler Singleton.
   */
-  ENetSelector::ENetSelector() :
+  ENetSelector::ENetSelector(ENetPacketHandler *p_handler) :
     m_clients(),
+    m_next(0),
     m_threadSelect(nullptr),
     m_mutexClients(nullptr),
+    m_socketWake(),
+    m_handler(p_handler),
+    m_affinity(0),
     m_isRunning(false)
   {
   }
@@ -53,6 +62,7 @@ namespace                     ELib
     CloseHandle(m_mutexClients);
     TerminateThread(m_threadSelect, 0);
     CloseHandle(m_threadSelect);
+    mEMETRICS_G.move(EMETRICS_GAUGE_CONNECTIONS, -static_cast<int64>(m_clients.size()));
     while (m_clients.empty() != true)
     {
       delete (m_clients.front());
@@ -62,7 +72,7 @@ namespace                     ELib
 
   /**
     @brief Start ENetSelector automation. /!\ EError.
-    @details Initialize its mutex, create thread for select().
+    @details Initialize its mutex and its loopback wake up ENetSocket, create thread for select() with its affinity.
     @details Need at least one client.
   */
   void                      ENetSelector::start()
@@ -77,6 +87,19 @@ namespace                     ELib
       mEERROR_S(EERROR_NET_SELECTOR_EMPTY);
     }
 
+    if ((EERROR_NONE == mEERROR)
+      && (ENETSOCKET_FLAGS_STATE_UNINITIALIZED == (m_socketWake.getFlags() & ENETSOCKET_FLAGS_STATES)))
+    {
+      m_socketWake.socket(ENETSOCKET_FLAGS_PROTOCOL_UDP);
+      if (EERROR_NONE == mEERROR)
+      {
+        m_socketWake.bind("127.0.0.1", 0);
+      }
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+    }
     if (EERROR_NONE == mEERROR)
     {
       m_mutexClients = CreateMutex(nullptr, false, nullptr);
@@ -85,7 +108,12 @@ namespace                     ELib
         m_threadSelect = CreateThread(nullptr, 0, SelectFunctor, this, 0, nullptr);
         if (nullptr != m_threadSelect)
         {
+          if (0 != m_affinity)
+          {
+            SetThreadAffinityMask(m_threadSelect, m_affinity);
+          }
           m_isRunning = true;
+          mEMETRICS_G.move(EMETRICS_GAUGE_SELECTORS, 1);
         }
         else
         {
@@ -113,6 +141,7 @@ namespace                     ELib
     if (EERROR_NONE == mEERROR)
     {
       m_isRunning = false;
+      mEMETRICS_G.move(EMETRICS_GAUGE_SELECTORS, -1);
       ReleaseMutex(m_mutexClients);
       TerminateThread(m_threadSelect, 0);
     }
@@ -121,20 +150,32 @@ namespace                     ELib
   /**
     @brief Loop for connected ENetSocket automation. /!\ Blocking. /!\ Mutex. /!\ EError.
     @details Receive ENetPacket from ENetSocket clients and store them into ENetPacketHandler.
-    @details Close ENetPacket client receive failure.
+    @details Close ENetPacket client receive failure, removing it from ENetTopics and ENetInterestGrids and cancelling its ENetRpc calls.
+    @details Read clients round robin from where previous iteration stopped, up to ENETSELECTOR_READ_BUDGET ENetPacket.
+    @details Clients over their connection limit are left in system buffers until their bucket is refilled.
+    @details Clients are not read either while their ENetBudget or the global one is exhausted.
+    @details Wait into select() and flush of each ENetSendQueue are traced by ETrace.
     @details Stop when clients list is empty.
-    @details ENetPacketHandler Singleton need to be valid.
+    @details ENetPacketHandler need to be valid.
   */
   void                        ENetSelector::select()
   {
     while (true == m_isRunning)
     {
       fd_set                  l_set = { 0 };
+      fd_set                  l_writeSet = { 0 };
       uint64                  l_maxFd = 0;
       timeval                 l_timeout = { 0, 100000 };
+      ENetBudget              *l_budget = ENetBudget::getInstance();
+      bool                    l_isDeferred = false;
+      uint32                  l_reads = 0;
+      size_t                  l_count = 0;
+      size_t                  l_index = 0;
+      LONGLONG                l_trace = 0;
+      int                     l_result = 0;
 
       mEERROR_R();
-      if (nullptr != ENetPacketHandler::getInstance())
+      if (nullptr == getHandler())
       {
         mEERROR_SH(EERROR_NULL_PTR);
         stop();
@@ -148,33 +189,95 @@ namespace                     ELib
       {
         WaitForSingleObject(m_mutexClients, INFINITE);
         FD_ZERO(&l_set);
+        FD_ZERO(&l_writeSet);
+        l_maxFd = m_socketWake;
+        FD_SET(m_socketWake, &l_set);
         for (std::vector<ENetSocket*>::iterator l_client = m_clients.begin(); l_client != m_clients.end(); ++l_client)
         {
           l_maxFd = max(l_maxFd, **l_client);
-          FD_SET(**l_client, &l_set);
+          if ((true == getHandler()->getRateLimit()->isAllowed(*l_client))
+            && ((nullptr == l_budget) || (true == l_budget->isAvailable(*l_client))))
+          {
+            FD_SET(**l_client, &l_set);
+          }
+          else
+          {
+            l_isDeferred = true;
+          }
+          if (false == (*l_client)->getSendQueue()->isEmpty())
+          {
+            FD_SET(**l_client, &l_writeSet);
+          }
         }
-        if (SOCKET_ERROR != ::select(static_cast<int>(l_maxFd), &l_set, nullptr, nullptr, &l_timeout))
+        if (true == l_isDeferred)
         {
-          for (std::vector<ENetSocket*>::iterator l_client = m_clients.begin(); l_client != m_clients.end(); )
+          l_timeout.tv_usec = ENETSELECTOR_DEFER_TIMEOUT;
+        }
+        l_trace = mETRACE_G.begin();
+        l_result = ::select(static_cast<int>(l_maxFd), &l_set, &l_writeSet, nullptr, &l_timeout);
+        mETRACE_G.end(ETRACE_EVENT_SELECT, l_trace);
+        if (SOCKET_ERROR != l_result)
+        {
+          if (0 != FD_ISSET(m_socketWake, &l_set))
+          {
+            char              l_byte = 0;
+
+            ::recvfrom(static_cast<SOCKET>(m_socketWake), &l_byte, sizeof(char), 0, nullptr, nullptr);
+          }
+          for (std::vector<ENetSocket*>::iterator l_client = m_clients.begin(); l_client != m_clients.end(); ++l_client)
+          {
+            if (0 != FD_ISSET(**l_client, &l_writeSet))
+            {
+              l_trace = mETRACE_G.begin();
+              (*l_client)->getSendQueue()->flush(*l_client);
+              mETRACE_G.end(ETRACE_EVENT_FLUSH, l_trace, **l_client);
+              if (EERROR_NONE != mEERROR)
+              {
+                mEERROR_SH(EERROR_NET_SELECTOR_ERR);
+              }
+            }
+          }
+          l_count = m_clients.size();
+          l_index = (m_next < l_count) ? m_next : 0;
+          for (size_t l_visited = 0; (l_visited < l_count) && (false == m_clients.empty()) && (ENETSELECTOR_READ_BUDGET > l_reads); ++l_visited)
           {
+            ENetSocket          *l_client = m_clients[l_index];
             bool                l_closed = false;
 
-            if (0 != FD_ISSET(**l_client, &l_set))
+            if (0 != FD_ISSET(*l_client, &l_set))
             {
-              ENetPacketHandler::getInstance()->recvPacket(*l_client);
+              ++l_reads;
+              getHandler()->recvPacket(l_client);
               if (EERROR_NONE != mEERROR)
               {
                 ENetPacketType  l_type = ENETPACKET_TYPE_DISCONNECT;
 
                 mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
-                ENetPacketHandler::getInstance()->read(reinterpret_cast<char*>(&l_type), sizeof(ENetPacketType), *l_client);
+                getHandler()->read(reinterpret_cast<char*>(&l_type), sizeof(ENetPacketType), l_client);
                 if (EERROR_NONE == mEERROR)
                 {
-                  (*l_client)->close();
+                  l_client->close();
                   if (EERROR_NONE == mEERROR)
                   {
-                    // delete (*l_client); -> TODO: high risk of segfault when reading packets.
-                    l_client = m_clients.erase(l_client);
+                    if (nullptr != ENetTopics::getInstance())
+                    {
+                      ENetTopics::getInstance()->leaveAll(l_client);
+                    }
+                    ENetInterestGrid::removeAll(l_client);
+                    if (nullptr != ENetRpc::getInstance())
+                    {
+                      ENetRpc::getInstance()->cancel(l_client);
+                    }
+                    getHandler()->getRateLimit()->forget(l_client);
+                    if (nullptr != l_budget)
+                    {
+                      l_budget->forget(l_client);
+                    }
+                    l_client->getSendQueue()->setSelector(nullptr);
+                    // delete (l_client); -> TODO: high risk of segfault when reading packets.
+                    m_clients.erase(m_clients.begin() + l_index);
+                    mEMETRICS_G.move(EMETRICS_GAUGE_CONNECTIONS, -1);
+                    mEMETRICS_G.add(EMETRICS_COUNTER_CLOSED);
                     l_closed = true;
                     if (0 == getSize())
                     {
@@ -198,9 +301,14 @@ namespace                     ELib
             }
             if (false == l_closed)
             {
-              l_client++;
+              ++l_index;
+            }
+            if (m_clients.size() <= l_index)
+            {
+              l_index = 0;
             }
           }
+          m_next = l_index;
         }
         else
         {
@@ -213,9 +321,9 @@ namespace                     ELib
 
   /**
     @brief Add a connected ENetSocket client to automation. /!\ Mutex. /!\ EError.
-    @details Can contains up to ENETSOCKET_MAX_CLIENTS clients.
+    @details Can contains up to ENETSELECTOR_CLIENTS_MAX clients, so every client and the wake ENetSocket fit the FD_SETSIZE read set.
     @details An EError indicate that ENetSocket client should be discarded.
-    @details ENetPacketHandler Singleton need to be valid.
+    @details ENetPacketHandler need to be valid.
     @param p_client ENetPacket client.
     @return true on success.
     @return false on failure.
@@ -239,22 +347,24 @@ namespace                     ELib
     {
       mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
     }
-    if (nullptr != ENetPacketHandler::getInstance())
+    if (nullptr == getHandler())
     {
       mEERROR_SH(EERROR_NULL_PTR);
     }
 
     if (EERROR_NONE == mEERROR)
     {
-      if (ENETSOCKET_MAX_CLIENTS > m_clients.size())
+      if (static_cast<size_t>(ENETSELECTOR_CLIENTS_MAX) > m_clients.size())
       {
         ENetPacketType        l_type = ENETPACKET_TYPE_CONNECT;
 
         WaitForSingleObject(m_mutexClients, INFINITE);
-        ENetPacketHandler::getInstance()->read(reinterpret_cast<char*>(&l_type), sizeof(ENetPacketType), p_client);
+        getHandler()->read(reinterpret_cast<char*>(&l_type), sizeof(ENetPacketType), p_client);
         if (EERROR_NONE == mEERROR)
         {
+          p_client->getSendQueue()->setSelector(this);
           m_clients.push_back(p_client);
+          mEMETRICS_G.move(EMETRICS_GAUGE_CONNECTIONS, 1);
           l_ret = true;
         }
         else
@@ -297,6 +407,51 @@ namespace                     ELib
     }
   }
 
+  /**
+    @brief Wake up select() loop. /!\ EError.
+    @details Send one byte to the loopback wake up ENetSocket, so newly queued frames are flushed without waiting select() timeout.
+    @details Byte is sent and received with raw sockets calls, so it is not counted by EMetrics as a datagram.
+  */
+  void                        ENetSelector::wake()
+  {
+    char                      l_byte = 0;
+
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      SOCKADDR_IN             l_infos = { 0 };
+
+      l_infos.sin_addr.s_addr = inet_addr(m_socketWake.getHostname().c_str());
+      l_infos.sin_port = htons(m_socketWake.getPort());
+      l_infos.sin_family = ENETSOCKET_FAMILY;
+      if (SOCKET_ERROR == ::sendto(static_cast<SOCKET>(m_socketWake), &l_byte, sizeof(char), 0,
+        reinterpret_cast<SOCKADDR*>(&l_infos), sizeof(SOCKADDR_IN)))
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+    }
+  }
+
+  /**
+    @brief Set processor affinity of select() thread.
+    @details Applied at next start(). Used by ENetShard to keep a ENetSelector on its core.
+    @param p_affinity Processor affinity mask, 0 for any.
+  */
+  void                        ENetSelector::setAffinity(DWORD_PTR p_affinity)
+  {
+    m_affinity = p_affinity;
+  }
+
+  /**
+    @brief Get ENetPacketHandler storing received ENetPacket.
+    @return ENetPacketHandler given at construction, or ENetPacketHandler Singleton.
+  */
+  ENetPacketHandler           *ENetSelector::getHandler() const
+  {
+    return ((nullptr != m_handler) ? m_handler : ENetPacketHandler::getInstance());
+  }
+
   /**
     @brief Get number of clients.
     @return Number of clients.
@@ -0,0 +1,334 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetSendQueue Class.
+*/
+
+#include "ENetwork/ENetBudget.h"
+#include "ENetwork/ENetSendQueue.h"
+#include "ENetwork/ENetSelector.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                 ELib
+{
+
+  /**
+    @brief Constructor for ENetSendQueue.
+    @details Initialize its mutex.
+  */
+  ENetSendQueue::ENetSendQueue() :
+    m_lanes(),
+    m_conflated(),
+    m_current(0),
+    m_isCredited(false),
+    m_size(0),
+    m_bytes(0),
+    m_selector(nullptr),
+    m_mutexFrames(nullptr)
+  {
+    m_mutexFrames = CreateMutex(nullptr, false, nullptr);
+  }
+
+  /**
+    @brief Destructor for ENetSendQueue.
+    @details Release its mutex.
+  */
+  ENetSendQueue::~ENetSendQueue()
+  {
+    ReleaseMutex(m_mutexFrames);
+    CloseHandle(m_mutexFrames);
+  }
+
+  /**
+    @brief Add a serialized ENetPacket to the lane of its ENetChannel. /!\ Mutex.
+    @details A conflated frame replace in place the unsent frame with the same type and key, keeping its position.
+    @details Growth of queue is reserved in ENetBudget for the connection. Frame is refused if it does not fit.
+    @details Wake up the ENetSelector flushing the queue when it was empty.
+    @param p_dst Connected ENetSocket owning the queue.
+    @param p_datas Serialized ENetPacket.
+    @param p_len Length of serialized ENetPacket.
+    @param p_type ENetPacketType of the frame.
+    @param p_channel ENetChannel of the frame.
+    @param p_isConflated Indicate if frame can replace an older one.
+    @param p_key Conflation key.
+    @return true if frame is queued.
+    @return false if frame is refused by ENetBudget.
+  */
+  bool                    ENetSendQueue::push(const ENetSocket *p_dst, const char *p_datas, int32 p_len, uint32 p_type,
+                            const ENetChannel &p_channel, bool p_isConflated, uint64 p_key)
+  {
+    ENetBudget            *l_budget = ENetBudget::getInstance();
+    bool                  l_ret = true;
+    bool                  l_wake = false;
+
+    WaitForSingleObject(m_mutexFrames, INFINITE);
+    if (true == p_isConflated)
+    {
+      std::map<std::pair<uint32, uint64>, std::pair<ENetChannelId, uint64> >::iterator l_it;
+
+      l_it = m_conflated.find(std::make_pair(p_type, p_key));
+      if (m_conflated.end() != l_it)
+      {
+        ENetLane          &l_lane = m_lanes[l_it->second.first];
+        ENetFrame         &l_frame = l_lane.m_frames[static_cast<size_t>(l_it->second.second - l_lane.m_head)];
+
+        if ((nullptr != l_budget)
+          && (static_cast<size_t>(p_len) > l_frame.m_datas.size()))
+        {
+          l_ret = l_budget->reserve(p_dst, p_len - l_frame.m_datas.size());
+        }
+        else if (nullptr != l_budget)
+        {
+          l_budget->release(p_dst, l_frame.m_datas.size() - p_len);
+        }
+        if (true == l_ret)
+        {
+          m_bytes -= l_frame.m_datas.size();
+          l_frame.m_datas.assign(p_datas, p_len);
+          m_bytes += l_frame.m_datas.size();
+        }
+        p_datas = nullptr;
+      }
+    }
+    if ((nullptr != p_datas)
+      && (nullptr != l_budget))
+    {
+      l_ret = l_budget->reserve(p_dst, p_len);
+    }
+    if ((nullptr != p_datas)
+      && (true == l_ret))
+    {
+      ENetLane            &l_lane = m_lanes[p_channel.m_id % ENETCHANNEL_MAX];
+      ENetFrame           l_frame = { std::string(p_datas, p_len), p_type, p_key, p_isConflated };
+
+      if (true == p_isConflated)
+      {
+        m_conflated[std::make_pair(p_type, p_key)] = std::make_pair(static_cast<ENetChannelId>(p_channel.m_id % ENETCHANNEL_MAX),
+          l_lane.m_head + l_lane.m_frames.size());
+      }
+      l_lane.m_priority = (ENETCHANNEL_PRIORITIES > p_channel.m_priority) ? p_channel.m_priority : ENETCHANNEL_PRIORITIES - 1;
+      l_lane.m_weight = (0 != p_channel.m_weight) ? p_channel.m_weight : 1;
+      l_lane.m_frames.push_back(l_frame);
+      l_wake = (0 == m_size);
+      ++m_size;
+      m_bytes += p_len;
+    }
+    ReleaseMutex(m_mutexFrames);
+    if ((true == l_wake)
+      && (nullptr != m_selector))
+    {
+      m_selector->wake();
+    }
+
+    return (l_ret);
+  }
+
+  /**
+    @brief Send queued frames to connected ENetSocket. /!\ Mutex. /!\ EError.
+    @details Next frame is taken from the lane chosen by selectLane().
+    @details Frames are coalesced into batches of up to ENETSENDQUEUE_BATCH_MAX bytes, one ENetSocket::send() each.
+      A batch is sent before adding a frame that would exceed it.
+    @details Stop after ENETSENDQUEUE_FLUSH_MAX bytes so one slow ENetSocket cannot hold its ENetSelector.
+    @details Frames are removed from queue before being sent, then they cannot be conflated anymore.
+    @details Bytes of removed frames are given back to ENetBudget.
+    @param p_dst ENetSocket destination.
+  */
+  void                    ENetSendQueue::flush(ENetSocket *p_dst)
+  {
+    ENetBudget            *l_budget = ENetBudget::getInstance();
+    uint64                l_sent = 0;
+    bool                  l_stop = false;
+
+    mEERROR_R();
+    if (nullptr == p_dst)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    while ((EERROR_NONE == mEERROR)
+      && (false == l_stop))
+    {
+      std::string         l_datas;
+      bool                l_isFull = false;
+
+      WaitForSingleObject(m_mutexFrames, INFINITE);
+      while ((0 != m_size)
+        && (ENETSENDQUEUE_FLUSH_MAX > l_sent + l_datas.size())
+        && (false == l_isFull))
+      {
+        ENetLane          &l_lane = m_lanes[selectLane()];
+        ENetFrame         &l_frame = l_lane.m_frames.front();
+
+        if ((true == l_datas.empty())
+          || (ENETSENDQUEUE_BATCH_MAX >= l_datas.size() + l_frame.m_datas.size()))
+        {
+          if (true == l_frame.m_isConflated)
+          {
+            m_conflated.erase(std::make_pair(l_frame.m_type, l_frame.m_key));
+          }
+          l_lane.m_deficit -= l_frame.m_datas.size();
+          m_bytes -= l_frame.m_datas.size();
+          if (true == l_datas.empty())
+          {
+            l_datas.swap(l_frame.m_datas);
+          }
+          else
+          {
+            l_datas.append(l_frame.m_datas);
+          }
+          l_lane.m_frames.pop_front();
+          ++l_lane.m_head;
+          --m_size;
+        }
+        else
+        {
+          l_isFull = true;
+        }
+      }
+      l_stop = l_datas.empty();
+      ReleaseMutex(m_mutexFrames);
+      if ((false == l_stop)
+        && (nullptr != l_budget))
+      {
+        l_budget->release(p_dst, l_datas.size());
+      }
+      if (false == l_stop)
+      {
+        int32             l_ret = -1;
+
+        l_ret = p_dst->send(l_datas.c_str(), static_cast<uint16>(l_datas.size()));
+        if (EERROR_NONE == mEERROR)
+        {
+          if (l_ret < static_cast<int32>(l_datas.size()))
+          {
+            mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+          }
+          l_sent += l_datas.size();
+        }
+        else
+        {
+          mEERROR_SH(EERROR_NET_SOCKET_ERR);
+        }
+      }
+    }
+  }
+
+  /**
+    @brief Set ENetSelector flushing the queue. /!\ Mutex.
+    @param p_selector ENetSelector. nullptr if frames are flushed by the caller of ENetPacket::post().
+  */
+  void                    ENetSendQueue::setSelector(ENetSelector *p_selector)
+  {
+    WaitForSingleObject(m_mutexFrames, INFINITE);
+    m_selector = p_selector;
+    ReleaseMutex(m_mutexFrames);
+  }
+
+  /**
+    @brief Get ENetSelector flushing the queue.
+    @return ENetSelector, nullptr if none.
+  */
+  ENetSelector            *ENetSendQueue::getSelector() const
+  {
+    return (m_selector);
+  }
+
+  /**
+    @brief Indicate if queue is empty. /!\ Mutex.
+    @return true if no frame is waiting.
+  */
+  bool                    ENetSendQueue::isEmpty() const
+  {
+    bool                  l_isEmpty = true;
+
+    WaitForSingleObject(m_mutexFrames, INFINITE);
+    l_isEmpty = (0 == m_size);
+    ReleaseMutex(m_mutexFrames);
+
+    return (l_isEmpty);
+  }
+
+  /**
+    @brief Get number of waiting frames. /!\ Mutex.
+    @return Number of frames.
+  */
+  uint32                  ENetSendQueue::getSize() const
+  {
+    uint32                l_size = 0;
+
+    WaitForSingleObject(m_mutexFrames, INFINITE);
+    l_size = m_size;
+    ReleaseMutex(m_mutexFrames);
+
+    return (l_size);
+  }
+
+  /**
+    @brief Get number of waiting bytes. /!\ Mutex.
+    @return Number of bytes.
+  */
+  uint64                  ENetSendQueue::getBytes() const
+  {
+    uint64                l_bytes = 0;
+
+    WaitForSingleObject(m_mutexFrames, INFINITE);
+    l_bytes = m_bytes;
+    ReleaseMutex(m_mutexFrames);
+
+    return (l_bytes);
+  }
+
+  /**
+    @brief Choose lane of next frame. m_mutexFrames must be held by caller, with at least one frame waiting.
+    @details Only lanes of the most urgent non-empty priority level are eligible.
+    @details Eligible lanes are served by deficit round robin: each turn credits the lane with its weight,
+      lane is served while its deficit cover its next frame.
+    @return Index of lane in m_lanes.
+  */
+  ENetChannelId           ENetSendQueue::selectLane()
+  {
+    uint8                 l_priority = ENETCHANNEL_PRIORITIES;
+    ENetChannelId         l_selected = ENETCHANNEL_MAX;
+
+    for (ENetChannelId l_id = 0; l_id < ENETCHANNEL_MAX; ++l_id)
+    {
+      if ((false == m_lanes[l_id].m_frames.empty())
+        && (l_priority > m_lanes[l_id].m_priority))
+      {
+        l_priority = m_lanes[l_id].m_priority;
+      }
+    }
+    while (ENETCHANNEL_MAX == l_selected)
+    {
+      ENetLane            &l_lane = m_lanes[m_current];
+
+      if ((false == l_lane.m_frames.empty())
+        && (l_priority == l_lane.m_priority)
+        && (l_lane.m_deficit >= l_lane.m_frames.front().m_datas.size()))
+      {
+        l_selected = m_current;
+      }
+      else if ((false == l_lane.m_frames.empty())
+        && (l_priority == l_lane.m_priority)
+        && (false == m_isCredited))
+      {
+        l_lane.m_deficit += l_lane.m_weight;
+        m_isCredited = true;
+      }
+      else
+      {
+        if (true == l_lane.m_frames.empty())
+        {
+          l_lane.m_deficit = 0;
+        }
+        m_current = (m_current + 1) % ENETCHANNEL_MAX;
+        m_isCredited = false;
+      }
+    }
+
+    return (l_selected);
+  }
+
+}
@@ -14,15 +14,15 @@ namespace               ELib
 
   /**
     @brief Functor for ENetServer::recvfrom(). /!\ EError.
-    @param p_unused Unused.
+    @param p_server ENetServer caller.
     @return Unused.
   */
-  DWORD WINAPI          ServerRecvfromFunctor(LPVOID p_unused)
+  DWORD WINAPI          ServerRecvfromFunctor(LPVOID p_server)
   {
     mEERROR_R();
-    if (nullptr != ENetServer::getInstance())
+    if (nullptr != p_server)
     {
-      ENetServer::getInstance()->recvfrom();
+      static_cast<ENetServer*>(p_server)->recvfrom();
     }
     else
     {
@@ -34,15 +34,35 @@ namespace               ELib
 
   /**
     @brief Functor for ENetServer::accept(). /!\ EError.
-    @param p_unused Unused.
+    @param p_server ENetServer caller.
     @return Unused.
   */
-  DWORD WINAPI          ServerAcceptFunctor(LPVOID p_unused)
+  DWORD WINAPI          ServerAcceptFunctor(LPVOID p_server)
   {
     mEERROR_R();
-    if (nullptr != ENetServer::getInstance())
+    if (nullptr != p_server)
     {
-      ENetServer::getInstance()->accept();
+      static_cast<ENetServer*>(p_server)->accept();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Functor for ENetServer::admin(). /!\ EError.
+    @param p_server ENetServer caller.
+    @return Unused.
+  */
+  DWORD WINAPI          ServerAdminFunctor(LPVOID p_server)
+  {
+    mEERROR_R();
+    if (nullptr != p_server)
+    {
+      static_cast<ENetServer*>(p_server)->admin();
     }
     else
     {
@@ -54,21 +74,45 @@ namespace               ELib
   
   /**
     @brief Constructor for ENetServer.
+    @details Call WSAStartup() and initialize its mutex. Its mutex stays nullptr on failure.
+    @param p_handler ENetPacketHandler storing ENetPacket of this context, nullptr for ENetPacketHandler Singleton.
   */
-  ENetServer::ENetServer() :
+  ENetServer::ENetServer(ENetPacketHandler *p_handler) :
     m_socketRecvfrom(),
     m_threadRecvfrom(nullptr),
     m_socketAccept(),
     m_threadAccept(nullptr),
     m_selectors({}),
     m_mutexSelectors(nullptr),
+    m_shards(),
+    m_nextShard(0),
+    m_handler(p_handler),
+    m_group(),
+    m_isMulticast(false),
+    m_peers(),
+    m_mutexPeers(nullptr),
+    m_pacer(&m_socketRecvfrom),
+    m_fec(),
+    m_cookie(),
+    m_impairment(),
+    m_isCookie(false),
+    m_adminToken(),
+    m_threadAdmin(nullptr),
+    m_startTime(0),
     m_isRunning(false)
   {
+    WSADATA             WSAData = { 0 };
+
+    if (0 == WSAStartup(MAKEWORD(2, 2), &WSAData))
+    {
+      m_mutexSelectors = CreateMutex(nullptr, false, nullptr);
+      m_mutexPeers = CreateMutex(nullptr, false, nullptr);
+    }
   }
   
   /**
     @brief Destructor for ENetServer.
-    @details Release its mutex, terminate its threads, close its ENetSockets, delete its ENetSelectors and call WSACleanup().
+    @details Release its mutex, terminate its threads, close its ENetSockets, delete its ENetSelectors and ENetShards and call WSACleanup().
   */
   ENetServer::~ENetServer()
   {
@@ -80,17 +124,31 @@ namespace               ELib
     m_socketAccept.close();
     TerminateThread(m_threadAccept, 0);
     CloseHandle(m_threadAccept);
+    TerminateThread(m_threadAdmin, 0);
+    CloseHandle(m_threadAdmin);
     while (m_selectors.empty() != true)
     {
       delete (m_selectors.front());
       m_selectors.erase(m_selectors.begin());
     }
+    while (m_shards.empty() != true)
+    {
+      delete (m_shards.back());
+      m_shards.pop_back();
+    }
+    while (m_peers.empty() != true)
+    {
+      delete (m_peers.begin()->second.m_socket);
+      m_peers.erase(m_peers.begin());
+    }
+    ReleaseMutex(m_mutexPeers);
+    CloseHandle(m_mutexPeers);
     WSACleanup();
   }
 
   /**
-    @brief Singleton for ENetServer. /!\ EError.
-    @details Call WSAStartup() and initialize its mutex.
+    @brief Singleton for ENetServer, default context. /!\ EError.
+    @details Use ENetPacketHandler Singleton.
     @return ENetServer unique instance on success.
     @return nullptr on failure.
   */
@@ -101,34 +159,20 @@ namespace               ELib
     mEERROR_R();
     if (nullptr == l_instance)
     {
-      WSADATA           WSAData = { 0 };
-
-      if (0 == WSAStartup(MAKEWORD(2, 2), &WSAData))
+      l_instance = new ENetServer();
+      if (nullptr != l_instance)
       {
-        HANDLE          l_mutex = nullptr;
-
-        l_mutex = CreateMutex(nullptr, false, nullptr);
-        if (nullptr != l_mutex)
-        {
-          l_instance = new ENetServer();
-          if (nullptr == l_instance)
-          {
-            l_instance->m_mutexSelectors = l_mutex;
-          }
-          else
-          {
-            CloseHandle(l_mutex);
-            mEERROR_S(EERROR_MEMORY);
-          }
-        }
-        else
+        if ((nullptr == l_instance->m_mutexSelectors)
+          || (nullptr == l_instance->m_mutexPeers))
         {
           mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+          delete (l_instance);
+          l_instance = nullptr;
         }
       }
       else
       {
-        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+        mEERROR_S(EERROR_MEMORY);
       }
     }
 
@@ -203,8 +247,11 @@ namespace               ELib
   /**
     @brief Start ENetServer automation. /!\ Mutex. /!\ EError.
     @details Create threads for ENetServer::recvfrom() and ENetServer:accept().
-    @details Call ENetSelector::start() on each ENetSelector (failures ignored).
-    @details ENetPacketHandler Singleton need to be valid.
+    @details Call ENetSelector::start() on each ENetSelector and ENetShard::start() on each ENetShard (failures ignored).
+    @details Call ENetPacer::start() if connectionless datas are paced (failure ignored).
+    @details Call ENetImpairment::start() if sent datas are impaired (failure ignored).
+    @details Create thread for ENetServer::admin() if an admin token is set (failure ignored).
+    @details ENetPacketHandler of ENetServer need to be valid.
   */
   void                  ENetServer::start()
   {
@@ -213,18 +260,19 @@ namespace               ELib
     {
       mEERROR_S(EERROR_NET_SERVER_STATE);
     }
-    if (nullptr == ENetPacketHandler::getInstance())
+    if ((nullptr == getHandler())
+      || (nullptr == m_mutexSelectors)
+      || (nullptr == m_mutexPeers))
     {
       mEERROR_SH(EERROR_NULL_PTR);
     }
 
-
     if (EERROR_NONE == mEERROR)
     {
-      m_threadRecvfrom = CreateThread(nullptr, 0, ServerRecvfromFunctor, nullptr, 0, nullptr);
+      m_threadRecvfrom = CreateThread(nullptr, 0, ServerRecvfromFunctor, this, 0, nullptr);
       if (nullptr != m_threadRecvfrom)
       {
-        m_threadAccept = CreateThread(nullptr, 0, ServerAcceptFunctor, nullptr, 0, nullptr);
+        m_threadAccept = CreateThread(nullptr, 0, ServerAcceptFunctor, this, 0, nullptr);
         if (nullptr != m_threadAccept)
         {
           WaitForSingleObject(m_mutexSelectors, INFINITE);
@@ -237,8 +285,42 @@ namespace               ELib
               mEERROR_SH(EERROR_NET_SELECTOR_ERR);
             }
           }
+          for (std::vector<ENetShard*>::iterator l_shard = m_shards.begin(); l_shard != m_shards.end(); ++l_shard)
+          {
+            (*l_shard)->start();
+            if (EERROR_NONE != mEERROR)
+            {
+              mEERROR_SH(EERROR_NET_SERVER_ERR);
+            }
+          }
           ReleaseMutex(m_mutexSelectors);
+          if (nullptr != m_socketRecvfrom.getPacer())
+          {
+            m_pacer.start();
+            if (EERROR_NONE != mEERROR)
+            {
+              mEERROR_SH(EERROR_NET_SERVER_ERR);
+            }
+          }
+          if (nullptr != m_socketRecvfrom.getImpairment())
+          {
+            m_impairment.start();
+            if (EERROR_NONE != mEERROR)
+            {
+              mEERROR_SH(EERROR_NET_SERVER_ERR);
+            }
+          }
+          m_startTime = GetTickCount64();
           m_isRunning = true;
+          if (false == m_adminToken.empty())
+          {
+            m_threadAdmin = CreateThread(nullptr, 0, ServerAdminFunctor, this, 0, nullptr);
+            if (nullptr == m_threadAdmin)
+            {
+              mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+              mEERROR_SH(EERROR_NET_SERVER_ERR);
+            }
+          }
           mEPRINT_STD("ENetServer: Started successfully.");
         }
         else
@@ -257,7 +339,8 @@ namespace               ELib
   /**
     @brief Stop ENetServer automation. /!\ Mutex. /!\ EError.
     @details Terminate its threads.
-    @details Call ENetSelector::stop() on each ENetSelectors (failures ignored).
+    @details Call ENetSelector::stop() on each ENetSelectors and ENetShard::stop() on each ENetShard (failures ignored).
+    @details Call ENetPacer::stop() and ENetImpairment::stop() if running (failures ignored).
   */
   void                  ENetServer::stop()
   {
@@ -272,6 +355,12 @@ namespace               ELib
       m_isRunning = false;
       TerminateThread(m_threadRecvfrom, 0);
       TerminateThread(m_threadAccept, 0);
+      if (nullptr != m_threadAdmin)
+      {
+        TerminateThread(m_threadAdmin, 0);
+        CloseHandle(m_threadAdmin);
+        m_threadAdmin = nullptr;
+      }
       WaitForSingleObject(m_mutexSelectors, INFINITE);
       for (std::vector<ENetSelector*>::iterator l_it = m_selectors.begin(); l_it != m_selectors.end(); ++l_it)
       {
@@ -281,7 +370,31 @@ namespace               ELib
           mEERROR_SH(EERROR_NET_SELECTOR_ERR);
         }
       }
+      for (std::vector<ENetShard*>::iterator l_it = m_shards.begin(); l_it != m_shards.end(); ++l_it)
+      {
+        (*l_it)->stop();
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_SERVER_ERR);
+        }
+      }
       ReleaseMutex(m_mutexSelectors);
+      if (true == m_pacer.isRunning())
+      {
+        m_pacer.stop();
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_SERVER_ERR);
+        }
+      }
+      if (true == m_impairment.isRunning())
+      {
+        m_impairment.stop();
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_SERVER_ERR);
+        }
+      }
       mEPRINT_STD("ENetServer: Stopped successfully.");
     }
   }
@@ -289,14 +402,19 @@ namespace               ELib
   /**
     @brief Receive connectionless datas to ENetServer. /!\ Blocking. /!\ Mutex. /!\ EError.
     @details Receive datas on connectionless ENetSocket and send them to ENetPacketHandler::read().
-    @details ENetPacketHandler Singleton need to be valid.
+    @details ENETPACKET_TYPE_DGRAM_JOIN registers its source as datagram peer, ENETPACKET_TYPE_DISCONNECT unregisters it.
+      Without cookies, ENETPACKET_TYPE_DGRAM_JOIN is rejected: its source could be spoofed. Other datagrams refresh their peer.
+    @details ENETPACKET_TYPE_FEC datagrams are given to ENetFec::read().
+    @details With cookies, ENETPACKET_TYPE_COOKIE datagrams are answered and other datagrams of unverified sources are dropped,
+      both before any allocation.
+    @details ENetPacketHandler of ENetServer need to be valid.
   */
   void                  ENetServer::recvfrom()
   {
     while (true == isRunning())
     {
       mEERROR_R();
-      if (nullptr != ENetPacketHandler::getInstance())
+      if (nullptr == getHandler())
       {
         mEERROR_SH(EERROR_NULL_PTR);
         stop();
@@ -308,33 +426,85 @@ namespace               ELib
 
       if (EERROR_NONE == mEERROR)
       {
-        ENetSocket      *l_client = nullptr;
+        char            l_datas[ENETSOCKET_UDP_MAX];
+        int32           l_len = -1;
+        uint32          l_address = 0;
+        uint16          l_port = 0;
 
-        l_client = new ENetSocket();
-        if (nullptr != l_client)
+        l_len = m_socketRecvfrom.recvfrom(l_datas, ENETSOCKET_UDP_MAX, l_address, l_port);
+        if (0 >= l_len)
+        {
+          mEERROR_SH(EERROR_NET_SOCKET_ERR);
+        }
+        else if ((ENETCOOKIE_SIZE == l_len)
+          && (ENETPACKET_TYPE_COOKIE == *reinterpret_cast<ENetPacketType*>(l_datas)))
+        {
+          if (true == m_isCookie)
+          {
+            answerCookie(l_datas, l_address, l_port);
+          }
+        }
+        else if ((true == m_isCookie)
+          && (false == m_cookie.isVerified(l_address, l_port)))
         {
-          char          l_datas[ENETSOCKET_UDP_MAX];
-          int32         l_len = -1;
+          m_cookie.addRejected();
+        }
+        else
+        {
+          ENetSocket    *l_client = nullptr;
 
-          l_len = m_socketRecvfrom.recvfrom(l_datas, ENETSOCKET_UDP_MAX, l_client);
-          if (0 < l_len)
+          l_client = new ENetSocket();
+          if (nullptr != l_client)
           {
-            ENetPacketHandler::getInstance()->read(l_datas, l_len, l_client);
-            if (EERROR_NONE != mEERROR)
+            l_client->setAddress(l_address, l_port);
+            if ((ENETFEC_HEADER <= l_len)
+              && (ENETPACKET_TYPE_FEC == *reinterpret_cast<ENetPacketType*>(l_datas)))
+            {
+              m_fec.read(l_datas, l_len, l_client, getHandler());
+              if (EERROR_NONE != mEERROR)
+              {
+                mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
+              }
+              delete (l_client);
+            }
+            else if ((static_cast<int32>(sizeof(ENetPacketType)) < l_len)
+              && (ENETPACKET_TYPE_DGRAM_JOIN == *reinterpret_cast<ENetPacketType*>(l_datas)))
             {
-              mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
+              if (true == m_isCookie)
+              {
+                joinDatagram(l_client, 0 != l_datas[sizeof(ENetPacketType)]);
+              }
+              else
+              {
+                m_cookie.addRejected();
+              }
               delete (l_client);
             }
+            else
+            {
+              if ((static_cast<int32>(sizeof(ENetPacketType)) <= l_len)
+                && (ENETPACKET_TYPE_DISCONNECT == *reinterpret_cast<ENetPacketType*>(l_datas)))
+              {
+                leaveDatagram(l_client);
+                m_cookie.forget(l_address, l_port);
+              }
+              else
+              {
+                touchDatagram(l_client);
+              }
+              getHandler()->read(l_datas, l_len, l_client);
+              if (EERROR_NONE != mEERROR)
+              {
+                mEERROR_SH(EERROR_NET_PACKETHANDLER_ERR);
+                delete (l_client);
+              }
+            }
           }
           else
           {
-            mEERROR_SH(EERROR_NET_SOCKET_ERR);
+            mEERROR_S(EERROR_MEMORY);
           }
         }
-        else
-        {
-          mEERROR_S(EERROR_MEMORY);
-        }
       }
     }
   }
@@ -342,6 +512,7 @@ namespace               ELib
   /**
     @brief Accept incoming connections to ENetServer. /!\ Blocking. /!\ Mutex. /!\ EError.
     @details Accept connect ENetServer and send them to ENetServer::addClient().
+    @details Accepted ENetSockets share ENetImpairment of connectionless ENetSocket.
   */
   void                  ENetServer::accept()
   {
@@ -353,6 +524,8 @@ namespace               ELib
       l_client = m_socketAccept.accept();
       if (nullptr != l_client)
       {
+        mEMETRICS_G.add(EMETRICS_COUNTER_ACCEPTED);
+        l_client->setImpairment(m_socketRecvfrom.getImpairment());
         addClient(l_client);
         if (EERROR_NONE != mEERROR)
         {
@@ -368,9 +541,54 @@ namespace               ELib
     }
   }
   
+  /**
+    @brief Answer ENetPacketStats requests to ENetServer. /!\ Blocking. /!\ Mutex. /!\ EError.
+    @details Pop admin queue of ENetPacketHandler of ENetServer and of each ENetShard, answer with answerStats().
+    @details Without request, wait for the admin events of these ENetPacketHandlers. Over MAXIMUM_WAIT_OBJECTS queues,
+      only the first ones are waited for, at most ENETSERVER_ADMIN_IDLE milliseconds.
+  */
+  void                  ENetServer::admin()
+  {
+    std::vector<HANDLE> l_events;
+
+    l_events.push_back(getHandler()->getAdminEvent());
+    for (std::vector<ENetShard*>::iterator l_it = m_shards.begin(); l_it != m_shards.end(); ++l_it)
+    {
+      l_events.push_back((*l_it)->getHandler()->getAdminEvent());
+    }
+    while (true == isRunning())
+    {
+      ENetPacket        *l_packet = nullptr;
+
+      for (std::vector<HANDLE>::iterator l_it = l_events.begin(); l_it != l_events.end(); ++l_it)
+      {
+        ResetEvent(*l_it);
+      }
+      l_packet = getHandler()->popAdmin();
+      for (std::vector<ENetShard*>::iterator l_it = m_shards.begin(); (nullptr == l_packet) && (l_it != m_shards.end()); ++l_it)
+      {
+        l_packet = (*l_it)->getHandler()->popAdmin();
+      }
+      if (nullptr != l_packet)
+      {
+        answerStats(static_cast<ENetPacketStats*>(l_packet));
+        delete (l_packet);
+      }
+      else if (static_cast<size_t>(MAXIMUM_WAIT_OBJECTS) >= l_events.size())
+      {
+        WaitForMultipleObjects(static_cast<DWORD>(l_events.size()), l_events.data(), false, INFINITE);
+      }
+      else
+      {
+        WaitForMultipleObjects(MAXIMUM_WAIT_OBJECTS, l_events.data(), false, ENETSERVER_ADMIN_IDLE);
+      }
+    }
+  }
+
   /**
     @brief Add ENetSocket client to ENetSelector automation. /!\ Mutex. /!\ EError.
-    @details Call ENetServer::clearSelectors() at start.
+    @details In thread-per-core mode, hand ENetSocket client over to next ENetShard.
+    @details Otherwise call ENetServer::clearSelectors() at start.
     @details Call ENetSelector::addClient() on each ENetSelector untill a success.
     @details Create a new ENetSelector if addition failed with no error.
     @details Discard ENetSocket client in case of EError.
@@ -384,7 +602,22 @@ namespace               ELib
       mEERROR_S(EERROR_NULL_PTR);
     }
 
-    if (EERROR_NONE == mEERROR)
+    if ((EERROR_NONE == mEERROR)
+      && (false == m_shards.empty()))
+    {
+      ENetShard         *l_shard = nullptr;
+
+      WaitForSingleObject(m_mutexSelectors, INFINITE);
+      l_shard = m_shards[m_nextShard];
+      m_nextShard = (m_nextShard + 1) % m_shards.size();
+      ReleaseMutex(m_mutexSelectors);
+      l_shard->addClient(p_client);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SERVER_ERR);
+      }
+    }
+    else if (EERROR_NONE == mEERROR)
     {
       bool              l_stop = false;
 
@@ -408,7 +641,7 @@ namespace               ELib
       {
         ENetSelector    *l_selector = nullptr;
 
-        l_selector = new ENetSelector();
+        l_selector = new ENetSelector(m_handler);
         if (nullptr != l_selector)
         {
           l_selector->addClient(p_client);
@@ -443,11 +676,12 @@ namespace               ELib
 
   /**
     @brief Send ENetPacket to every ENetServer clients. /!\ Mutex. /!\ EError.
-    @details Call ENetSelector::broadcast() on each ENetSelector.
+    @details Call ENetSelector::broadcast() on each ENetSelector and ENetShard::broadcast() on each ENetShard.
     @param p_packet ENetPacket to be send.
   */
   void                  ENetServer::broadcast(ENetPacket *p_packet)
   {
+    mEERROR_R();
     if (nullptr == p_packet)
     {
       mEERROR_S(EERROR_NULL_PTR);
@@ -459,15 +693,47 @@ namespace               ELib
       for (std::vector<ENetSelector*>::iterator l_it = m_selectors.begin(); l_it != m_selectors.end(); ++l_it)
       {
         (*l_it)->broadcast(p_packet);
-        if (EERROR_NONE == mEERROR)
+        if (EERROR_NONE != mEERROR)
         {
           mEERROR_SH(EERROR_NET_SELECTOR_ERR);
         }
       }
+      for (std::vector<ENetShard*>::iterator l_it = m_shards.begin(); l_it != m_shards.end(); ++l_it)
+      {
+        (*l_it)->broadcast(p_packet);
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_SERVER_ERR);
+        }
+      }
       ReleaseMutex(m_mutexSelectors);
     }
   }
 
+  /**
+    @brief Send ENetPacket to ENetServer clients that joined a topic. /!\ Mutex. /!\ EError.
+    @details Call ENetTopics::publish(). Only members of the topic are walked.
+    @param p_topic Topic to be published on.
+    @param p_packet ENetPacket to be send.
+  */
+  void                  ENetServer::publish(ENetTopicId p_topic, ENetPacket *p_packet)
+  {
+    mEERROR_R();
+    if (nullptr == ENetTopics::getInstance())
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      ENetTopics::getInstance()->publish(p_topic, p_packet);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SERVER_ERR);
+      }
+    }
+  }
+
   /**
     @brief Clear the ENetSelector list unused. /!\ Mutex.
     @details Delete every ENetSelectors that are empty.
@@ -490,6 +756,354 @@ namespace               ELib
     ReleaseMutex(m_mutexSelectors);
   }
 
+  /**
+    @brief Enable thread-per-core mode. /!\ Mutex. /!\ EError.
+    @details Create one ENetShard per core, each pinned on its own processor. Must be called before start().
+    @details Windows has no SO_REUSEPORT load balancing: one accept thread hands connections over to ENetShards.
+    @param p_count Number of ENetShards, usually the number of cores. 0 disables thread-per-core mode.
+  */
+  void                  ENetServer::setShards(uint32 p_count)
+  {
+    mEERROR_R();
+    if (true == isRunning())
+    {
+      mEERROR_S(EERROR_NET_SERVER_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      WaitForSingleObject(m_mutexSelectors, INFINITE);
+      while (false == m_shards.empty())
+      {
+        delete (m_shards.back());
+        m_shards.pop_back();
+      }
+      for (uint32 l_index = 0; (EERROR_NONE == mEERROR) && (l_index < p_count); ++l_index)
+      {
+        ENetShard       *l_shard = nullptr;
+
+        l_shard = new ENetShard(l_index, static_cast<DWORD_PTR>(1) << (l_index % (sizeof(DWORD_PTR) * 8)));
+        if (nullptr != l_shard)
+        {
+          if (nullptr != getHandler())
+          {
+            l_shard->getHandler()->copySettings(*getHandler());
+          }
+          m_shards.push_back(l_shard);
+        }
+        else
+        {
+          mEERROR_S(EERROR_MEMORY);
+        }
+      }
+      m_nextShard = 0;
+      ReleaseMutex(m_mutexSelectors);
+    }
+  }
+
+  /**
+    @brief Get a ENetShard.
+    @param p_index Index of ENetShard.
+    @return ENetShard, nullptr if out of range.
+  */
+  ENetShard             *ENetServer::getShard(uint32 p_index) const
+  {
+    return ((p_index < m_shards.size()) ? m_shards[p_index] : nullptr);
+  }
+
+  /**
+    @brief Get number of ENetShards.
+    @return Number of ENetShards, 0 out of thread-per-core mode.
+  */
+  uint32                ENetServer::getShardCount() const
+  {
+    return (static_cast<uint32>(m_shards.size()));
+  }
+
+  /**
+    @brief Get ENetPacketHandler of ENetServer.
+    @return ENetPacketHandler given to constructor, ENetPacketHandler Singleton by default.
+  */
+  ENetPacketHandler     *ENetServer::getHandler() const
+  {
+    return ((nullptr != m_handler) ? m_handler : ENetPacketHandler::getInstance());
+  }
+
+  /**
+    @brief Set multicast group of datagram peers. /!\ EError.
+    @details ENetServer must be initialized. Peers join the group on their side, see ENetClient::joinDatagrams().
+    @param p_group Multicast address in number-and-dots notation (239.0.0.0/8 for local use).
+    @param p_port Port of group, bound by peers.
+    @param p_ttl Number of routers crossed by datagrams, 1 for local network.
+  */
+  void                  ENetServer::setMulticast(const std::string &p_group, uint16 p_port, uint8 p_ttl)
+  {
+    mEERROR_R();
+    m_socketRecvfrom.setMulticastTtl(p_ttl);
+    if (EERROR_NONE == mEERROR)
+    {
+      m_group.setAddress(p_group, p_port);
+      m_isMulticast = true;
+      mEPRINT_STD("ENetServer: Multicast group " + p_group + ":" + std::to_string(p_port) + ".");
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NET_SOCKET_ERR);
+    }
+  }
+
+  /**
+    @brief Send ENetPacket to every datagram peer. /!\ Mutex. /!\ EError.
+    @details One datagram to the multicast group if a peer joined it, one unicast datagram per other peer.
+    @details Idle peers are forgotten first.
+    @details Source of ENetPacket is set to the connectionless ENetSocket of ENetServer.
+    @param p_packet ENetPacket to be send.
+  */
+  void                  ENetServer::sendDatagram(ENetPacket *p_packet)
+  {
+    mEERROR_R();
+    if (nullptr == p_packet)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      bool              l_isGroup = false;
+
+      p_packet->setSource(&m_socketRecvfrom);
+      WaitForSingleObject(m_mutexPeers, INFINITE);
+      expireDatagram(GetTickCount64());
+      for (std::map<std::string, ENetDatagramPeer>::iterator l_it = m_peers.begin(); l_it != m_peers.end(); ++l_it)
+      {
+        if ((true == m_isMulticast)
+          && (true == l_it->second.m_isMulticast))
+        {
+          l_isGroup = true;
+        }
+        else
+        {
+          p_packet->send(l_it->second.m_socket);
+          if (EERROR_NONE != mEERROR)
+          {
+            mEERROR_SH(EERROR_NET_PACKET_ERR);
+          }
+        }
+      }
+      if (true == l_isGroup)
+      {
+        p_packet->send(&m_group);
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_PACKET_ERR);
+        }
+      }
+      ReleaseMutex(m_mutexPeers);
+    }
+  }
+
+  /**
+    @brief Get number of datagram peers. /!\ Mutex.
+    @return Number of registered datagram peers.
+  */
+  uint32                ENetServer::getDatagramPeerCount() const
+  {
+    uint32              l_count = 0;
+
+    WaitForSingleObject(m_mutexPeers, INFINITE);
+    l_count = static_cast<uint32>(m_peers.size());
+    ReleaseMutex(m_mutexPeers);
+
+    return (l_count);
+  }
+
+  /**
+    @brief Set pacing of connectionless datas. /!\ Mutex.
+    @details Datagrams of connectionless ENetSocket are queued into ENetPacer, which spreads them with token buckets.
+      Winsock has no kernel pacing (SO_TXTIME, SO_MAX_PACING_RATE), pacing is done in user space.
+    @details Both rates to 0 disable pacing. Takes effect on next start().
+    @param p_rate Bytes per second for all peers, 0 for no limit.
+    @param p_peerRate Bytes per second for one peer, 0 for no limit.
+    @param p_burst Bytes that can be sent at once, overall and per peer.
+  */
+  void                  ENetServer::setPacing(uint64 p_rate, uint64 p_peerRate, uint32 p_burst)
+  {
+    m_pacer.setRate(p_rate, p_burst);
+    m_pacer.setPeerRate(p_peerRate, p_burst);
+    if ((0 == p_rate)
+      && (0 == p_peerRate))
+    {
+      m_socketRecvfrom.setPacer(nullptr);
+    }
+    else
+    {
+      m_socketRecvfrom.setPacer(&m_pacer);
+    }
+  }
+
+  /**
+    @brief Get ENetPacer of connectionless datas.
+    @return ENetPacer of ENetServer.
+  */
+  ENetPacer             *ENetServer::getPacer()
+  {
+    return (&m_pacer);
+  }
+
+  /**
+    @brief Set impairment of datas sent by ENetServer. /!\ Mutex.
+    @details Connectionless datas and datas of connections accepted from now on are queued into ENetImpairment,
+      sent once delayed, and datagrams may be lost, duplicated or reordered. Emulate a bad network without netem.
+    @details Settings without any impairment disable it. Takes effect on next start().
+    @param p_settings Impairments of each link.
+  */
+  void                  ENetServer::setImpairment(const ENetImpairmentSettings &p_settings)
+  {
+    m_impairment.setSettings(p_settings);
+    if ((0 == p_settings.m_latency)
+      && (0 == p_settings.m_jitter)
+      && (0.0 >= p_settings.m_loss)
+      && (0.0 >= p_settings.m_duplicate)
+      && (0.0 >= p_settings.m_reorder)
+      && (0 == p_settings.m_rate))
+    {
+      m_socketRecvfrom.setImpairment(nullptr);
+    }
+    else
+    {
+      m_socketRecvfrom.setImpairment(&m_impairment);
+    }
+  }
+
+  /**
+    @brief Get ENetImpairment of sent datas.
+    @return ENetImpairment of ENetServer.
+  */
+  ENetImpairment        *ENetServer::getImpairment()
+  {
+    return (&m_impairment);
+  }
+
+  /**
+    @brief Set forward error correction of connectionless datas sent by ENetServer.
+    @details Received ENETPACKET_TYPE_FEC datagrams are always unwrapped.
+    @param p_count Datagrams protected by one parity datagram, 0 to disable.
+  */
+  void                  ENetServer::setFec(uint8 p_count)
+  {
+    if (0 == p_count)
+    {
+      m_socketRecvfrom.setFec(nullptr);
+    }
+    else
+    {
+      m_fec.setBlockSize(p_count);
+      m_socketRecvfrom.setFec(&m_fec);
+    }
+  }
+
+  /**
+    @brief Get ENetFec of connectionless datas.
+    @return ENetFec of ENetServer.
+  */
+  ENetFec               *ENetServer::getFec()
+  {
+    return (&m_fec);
+  }
+
+  /**
+    @brief Send parity of blocks not yet full, see ENetFec::flush(). /!\ Mutex. /!\ EError.
+    @details Call it after a burst of connectionless datas, so its last datagrams are protected.
+    @param p_delay Milliseconds since last datagram of a block before its parity is sent, 0 for every block.
+  */
+  void                  ENetServer::flushFec(uint32 p_delay)
+  {
+    mEERROR_R();
+    m_fec.flush(&m_socketRecvfrom, p_delay);
+    if (EERROR_NONE != mEERROR)
+    {
+      mEERROR_SH(EERROR_NET_SOCKET_ERR);
+    }
+  }
+
+  /**
+    @brief Require verification of connectionless sources.
+    @details Set before start(): ENetCookie is used by recvfrom() thread only.
+    @details Required for datagram peers: ENETPACKET_TYPE_DGRAM_JOIN is rejected without cookies.
+    @param p_isCookie Datagrams of unverified sources are dropped.
+  */
+  void                  ENetServer::setCookies(bool p_isCookie)
+  {
+    m_isCookie = p_isCookie;
+  }
+
+  /**
+    @brief Get ENetCookie of connectionless sources.
+    @return ENetCookie of ENetServer.
+  */
+  ENetCookie            *ENetServer::getCookie()
+  {
+    return (&m_cookie);
+  }
+
+  /**
+    @brief Set token of admin connections. Must be called before start().
+    @details ENetPacketHandlers of ENetServer and of its ENetShards keep ENetPacketStats apart while a token is set.
+    @param p_token Token carried by ENetPacketStats requests, empty to disable admin.
+  */
+  void                  ENetServer::setAdmin(const std::string &p_token)
+  {
+    m_adminToken = p_token;
+    if (nullptr != getHandler())
+    {
+      getHandler()->setAdmin(false == m_adminToken.empty());
+    }
+    for (std::vector<ENetShard*>::iterator l_it = m_shards.begin(); l_it != m_shards.end(); ++l_it)
+    {
+      (*l_it)->getHandler()->setAdmin(false == m_adminToken.empty());
+    }
+  }
+
+  /**
+    @brief Build a snapshot of ENetServer statistics. /!\ Mutex.
+    @details ENetStatsHeader, an ENetStatsGroup per ENetSelector of ENetServer and per ENetShard, then the EMetricsSnapshot.
+    @return Snapshot.
+  */
+  const std::string     ENetServer::getStats() const
+  {
+    std::string         l_datas;
+    ENetStatsHeader     l_header = { ENETSTATS_VERSION, 0, static_cast<uint32>(m_shards.size()), getDatagramPeerCount(), 0 };
+    std::vector<ENetStatsGroup> l_groups;
+    EMetricsSnapshot    *l_snapshot = new EMetricsSnapshot();
+
+    if (true == isRunning())
+    {
+      l_header.m_uptime = GetTickCount64() - m_startTime;
+    }
+    WaitForSingleObject(m_mutexSelectors, INFINITE);
+    for (std::vector<ENetSelector*>::const_iterator l_it = m_selectors.begin(); l_it != m_selectors.end(); ++l_it)
+    {
+      l_groups.push_back({ ENETSTATS_NO_SHARD, (*l_it)->getSize() });
+    }
+    for (std::vector<ENetShard*>::const_iterator l_it = m_shards.begin(); l_it != m_shards.end(); ++l_it)
+    {
+      l_groups.push_back({ (*l_it)->getId(), (*l_it)->getSize() });
+    }
+    ReleaseMutex(m_mutexSelectors);
+    l_header.m_groups = static_cast<uint32>(l_groups.size());
+    mEMETRICS_G.snapshot(*l_snapshot);
+    l_datas.reserve(sizeof(ENetStatsHeader) + l_groups.size() * sizeof(ENetStatsGroup) + sizeof(EMetricsSnapshot));
+    l_datas.append(reinterpret_cast<const char*>(&l_header), sizeof(ENetStatsHeader));
+    if (false == l_groups.empty())
+    {
+      l_datas.append(reinterpret_cast<const char*>(l_groups.data()), l_groups.size() * sizeof(ENetStatsGroup));
+    }
+    l_datas.append(reinterpret_cast<const char*>(l_snapshot), sizeof(EMetricsSnapshot));
+    delete (l_snapshot);
+
+    return (l_datas);
+  }
+
   /**
     @brief Get state of ENetServer.
     @return State.
@@ -520,4 +1134,182 @@ namespace               ELib
     return (l_str);
   }
 
+  /**
+    @brief Answer an ENetPacketStats request with getStats(). /!\ EError.
+    @details Request must come from a connection and carry the admin token, otherwise it is refused.
+    @details Tokens are compared in constant time.
+    @param p_request ENetPacketStats request.
+  */
+  void                  ENetServer::answerStats(const ENetPacketStats *p_request)
+  {
+    const std::string   &l_token = p_request->getDatas();
+    uint8               l_diff = (l_token.size() == m_adminToken.size()) ? 0 : 1;
+
+    mEERROR_R();
+    for (size_t l_pos = 0; l_pos < m_adminToken.size(); ++l_pos)
+    {
+      l_diff |= static_cast<uint8>(m_adminToken[l_pos] ^ ((l_pos < l_token.size()) ? l_token[l_pos] : 0));
+    }
+    if ((0 == l_diff)
+      && (nullptr != p_request->getSource())
+      && (ENETSOCKET_FLAGS_PROTOCOL_TCP == (p_request->getSource()->getFlags() & ENETSOCKET_FLAGS_PROTOCOLS)))
+    {
+      ENetPacketStats   l_response(const_cast<ENetSocket*>(p_request->getSource()));
+
+      l_response.setDatas(getStats());
+      l_response.post();
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SERVER_ERR);
+      }
+    }
+    else
+    {
+      mEPRINT_ERR("ENetServer: Refused admin request.");
+    }
+  }
+
+  /**
+    @brief Register a datagram peer. /!\ Mutex.
+    @details Without multicast group, every peer is unicast.
+    @details Idle peers are forgotten when ENETSERVER_PEERS_MAX is reached. A new peer is refused if it is still reached.
+    @param p_peer Address of peer.
+    @param p_isMulticast Peer joined the multicast group.
+  */
+  void                  ENetServer::joinDatagram(const ENetSocket *p_peer, bool p_isMulticast)
+  {
+    std::string         l_key = p_peer->getHostname() + ":" + std::to_string(p_peer->getPort());
+    std::map<std::string, ENetDatagramPeer>::iterator l_it;
+    ULONGLONG           l_time = GetTickCount64();
+
+    WaitForSingleObject(m_mutexPeers, INFINITE);
+    l_it = m_peers.find(l_key);
+    if (m_peers.end() == l_it)
+    {
+      if (ENETSERVER_PEERS_MAX <= m_peers.size())
+      {
+        expireDatagram(l_time);
+      }
+      if (ENETSERVER_PEERS_MAX > m_peers.size())
+      {
+        ENetDatagramPeer  l_peer = { new ENetSocket(), p_isMulticast, l_time };
+
+        if (nullptr != l_peer.m_socket)
+        {
+          l_peer.m_socket->setAddress(p_peer->getHostname(), p_peer->getPort());
+          m_peers[l_key] = l_peer;
+        }
+      }
+      else
+      {
+        m_cookie.addRejected();
+      }
+    }
+    else
+    {
+      l_it->second.m_isMulticast = p_isMulticast;
+      l_it->second.m_time = l_time;
+    }
+    ReleaseMutex(m_mutexPeers);
+  }
+
+  /**
+    @brief Refresh a datagram peer on a datagram of its address. /!\ Mutex.
+    @details Nothing is done for an unregistered address.
+    @param p_peer Address of datagram source.
+  */
+  void                  ENetServer::touchDatagram(const ENetSocket *p_peer)
+  {
+    std::map<std::string, ENetDatagramPeer>::iterator l_it;
+
+    WaitForSingleObject(m_mutexPeers, INFINITE);
+    if (false == m_peers.empty())
+    {
+      l_it = m_peers.find(p_peer->getHostname() + ":" + std::to_string(p_peer->getPort()));
+      if (m_peers.end() != l_it)
+      {
+        l_it->second.m_time = GetTickCount64();
+      }
+    }
+    ReleaseMutex(m_mutexPeers);
+  }
+
+  /**
+    @brief Forget datagram peers idle for ENETSERVER_PEER_IDLE milliseconds.
+    @details m_mutexPeers must be held.
+    @param p_time Current tick count.
+  */
+  void                  ENetServer::expireDatagram(ULONGLONG p_time)
+  {
+    for (std::map<std::string, ENetDatagramPeer>::iterator l_it = m_peers.begin(); l_it != m_peers.end();)
+    {
+      if (ENETSERVER_PEER_IDLE < p_time - l_it->second.m_time)
+      {
+        delete (l_it->second.m_socket);
+        l_it = m_peers.erase(l_it);
+      }
+      else
+      {
+        ++l_it;
+      }
+    }
+  }
+
+  /**
+    @brief Unregister a datagram peer. /!\ Mutex.
+    @param p_peer Address of peer.
+  */
+  void                  ENetServer::leaveDatagram(const ENetSocket *p_peer)
+  {
+    std::map<std::string, ENetDatagramPeer>::iterator l_it;
+
+    WaitForSingleObject(m_mutexPeers, INFINITE);
+    l_it = m_peers.find(p_peer->getHostname() + ":" + std::to_string(p_peer->getPort()));
+    if (m_peers.end() != l_it)
+    {
+      delete (l_it->second.m_socket);
+      m_peers.erase(l_it);
+    }
+    ReleaseMutex(m_mutexPeers);
+  }
+
+  /**
+    @brief Answer a ENETPACKET_TYPE_COOKIE datagram. /!\ EError.
+    @details ENETCOOKIE_KIND_HELLO is answered with ENETCOOKIE_KIND_CHALLENGE, in place and of the same size.
+    @details ENETCOOKIE_KIND_ECHO with a valid cookie verifies its source. Nothing is stored otherwise.
+    @param p_datas Cookie datagram of ENETCOOKIE_SIZE.
+    @param p_address IPv4 address of source, in network byte order.
+    @param p_port Port of source.
+  */
+  void                  ENetServer::answerCookie(char *p_datas, uint32 p_address, uint16 p_port)
+  {
+    uint32              l_kind = ENETCOOKIE_KIND_HELLO;
+    uint64              l_cookie = 0;
+
+    mEERROR_R();
+    memcpy(&l_kind, p_datas + sizeof(ENetPacketType), sizeof(uint32));
+    memcpy(&l_cookie, p_datas + sizeof(ENetPacketType) + sizeof(uint32), sizeof(uint64));
+    if (ENETCOOKIE_KIND_HELLO == l_kind)
+    {
+      l_kind = ENETCOOKIE_KIND_CHALLENGE;
+      l_cookie = m_cookie.generate(p_address, p_port);
+      memcpy(p_datas + sizeof(ENetPacketType), &l_kind, sizeof(uint32));
+      memcpy(p_datas + sizeof(ENetPacketType) + sizeof(uint32), &l_cookie, sizeof(uint64));
+      m_socketRecvfrom.sendto(p_datas, ENETCOOKIE_SIZE, p_address, p_port);
+      if (EERROR_NONE != mEERROR)
+      {
+        mEERROR_SH(EERROR_NET_SOCKET_ERR);
+      }
+    }
+    else if ((ENETCOOKIE_KIND_ECHO == l_kind)
+      && (true == m_cookie.check(p_address, p_port, l_cookie)))
+    {
+      m_cookie.verify(p_address, p_port);
+    }
+    else
+    {
+      m_cookie.addRejected();
+    }
+  }
+
  }
@@ -0,0 +1,394 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetShard Class.
+*/
+
+#include "ENetwork/ENetShard.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Functor for ENetShard::run(). /!\ EError.
+    @param p_shard ENetShard caller.
+    @return Unused.
+  */
+  DWORD WINAPI                ShardRunFunctor(LPVOID p_shard)
+  {
+    mEERROR_R();
+    if (nullptr != p_shard)
+    {
+      static_cast<ENetShard*>(p_shard)->run();
+    }
+    else
+    {
+      mEERROR_SH(EERROR_NULL_PTR);
+    }
+
+    return (0);
+  }
+
+  /**
+    @brief Constructor for ENetShard.
+    @details Initialize its mutexes and event, copy settings of ENetPacketHandler Singleton.
+    @param p_id Index of ENetShard.
+    @param p_affinity Processor affinity mask of its threads, 0 for any.
+  */
+  ENetShard::ENetShard(uint32 p_id, DWORD_PTR p_affinity) :
+    m_id(p_id),
+    m_affinity(p_affinity),
+    m_handler(),
+    m_selectors(),
+    m_mutexSelectors(nullptr),
+    m_messages(),
+    m_mutexMessages(nullptr),
+    m_eventMessages(nullptr),
+    m_worker(nullptr),
+    m_context(nullptr),
+    m_threadRun(nullptr),
+    m_isRunning(false)
+  {
+    m_mutexSelectors = CreateMutex(nullptr, false, nullptr);
+    m_mutexMessages = CreateMutex(nullptr, false, nullptr);
+    m_eventMessages = CreateEvent(nullptr, true, false, nullptr);
+    if (nullptr != ENetPacketHandler::getInstance())
+    {
+      m_handler.copySettings(*ENetPacketHandler::getInstance());
+    }
+  }
+
+  /**
+    @brief Destructor for ENetShard.
+    @details Stop its thread, release its mutexes and event, delete its ENetSelectors.
+  */
+  ENetShard::~ENetShard()
+  {
+    if (true == m_isRunning)
+    {
+      stop();
+    }
+    while (false == m_selectors.empty())
+    {
+      delete (m_selectors.back());
+      m_selectors.pop_back();
+    }
+    ReleaseMutex(m_mutexSelectors);
+    CloseHandle(m_mutexSelectors);
+    ReleaseMutex(m_mutexMessages);
+    CloseHandle(m_mutexMessages);
+    if (nullptr != m_eventMessages)
+    {
+      CloseHandle(m_eventMessages);
+    }
+  }
+
+  /**
+    @brief Start ENetShard automation. /!\ EError.
+    @details Create thread for run(), pinned on the core of the ENetShard.
+  */
+  void                        ENetShard::start()
+  {
+    mEERROR_R();
+    if (true == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_SERVER_STATE);
+    }
+    if ((nullptr == m_mutexSelectors)
+      || (nullptr == m_mutexMessages)
+      || (nullptr == m_eventMessages))
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = true;
+      m_threadRun = CreateThread(nullptr, 0, ShardRunFunctor, this, 0, nullptr);
+      if (nullptr != m_threadRun)
+      {
+        if (0 != m_affinity)
+        {
+          SetThreadAffinityMask(m_threadRun, m_affinity);
+        }
+      }
+      else
+      {
+        m_isRunning = false;
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+      }
+    }
+  }
+
+  /**
+    @brief Stop ENetShard automation. /!\ Blocking. /!\ Mutex. /!\ EError.
+    @details Wake and wait for run() thread, call ENetSelector::stop() on each running ENetSelector (failures ignored).
+  */
+  void                        ENetShard::stop()
+  {
+    mEERROR_R();
+    if (false == m_isRunning)
+    {
+      mEERROR_S(EERROR_NET_SERVER_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      m_isRunning = false;
+      SetEvent(m_eventMessages);
+      WaitForSingleObject(m_threadRun, INFINITE);
+      CloseHandle(m_threadRun);
+      m_threadRun = nullptr;
+      WaitForSingleObject(m_mutexSelectors, INFINITE);
+      for (std::vector<ENetSelector*>::iterator l_it = m_selectors.begin(); l_it != m_selectors.end(); ++l_it)
+      {
+        if (true == (*l_it)->isRunning())
+        {
+          (*l_it)->stop();
+        }
+      }
+      ReleaseMutex(m_mutexSelectors);
+      mEERROR_R();
+    }
+  }
+
+  /**
+    @brief Loop of the core of ENetShard. /!\ Blocking. /!\ Mutex. /!\ EError.
+    @details Execute ENetShardTask posted by other cores, then give up to ENETSHARD_BATCH ENetPacket to ENetShardWorker.
+    @details Without ENetShardWorker, ENetPacket stay in its ENetPacketHandler for the application.
+    @details Without work, wait for post(), or for a ENetPacket stored by its ENetSelectors if there is an ENetShardWorker.
+      Events are reset before their queues are read, so nothing posted or stored meanwhile is missed.
+  */
+  void                        ENetShard::run()
+  {
+    while (true == m_isRunning)
+    {
+      std::deque<ENetShardMessage> l_messages;
+      bool                    l_isBusy = false;
+
+      ResetEvent(m_eventMessages);
+      if (nullptr != m_worker)
+      {
+        ResetEvent(m_handler.getEvent());
+      }
+      WaitForSingleObject(m_mutexMessages, INFINITE);
+      l_messages.swap(m_messages);
+      ReleaseMutex(m_mutexMessages);
+      for (std::deque<ENetShardMessage>::iterator l_it = l_messages.begin(); l_it != l_messages.end(); ++l_it)
+      {
+        l_it->m_task(this, l_it->m_context);
+        l_isBusy = true;
+      }
+      for (uint32 l_count = 0; (nullptr != m_worker) && (l_count < ENETSHARD_BATCH); ++l_count)
+      {
+        ENetPacket            *l_packet = nullptr;
+
+        l_packet = m_handler.popPacket();
+        if (nullptr == l_packet)
+        {
+          break;
+        }
+        m_worker(this, l_packet, m_context);
+        delete (l_packet);
+        l_isBusy = true;
+      }
+      if ((false == l_isBusy)
+        && (true == m_isRunning))
+      {
+        HANDLE                l_events[2] = { m_eventMessages, m_handler.getEvent() };
+
+        WaitForMultipleObjects((nullptr != m_worker) ? 2 : 1, l_events, false, INFINITE);
+      }
+    }
+  }
+
+  /**
+    @brief Add connected ENetSocket client to ENetShard. /!\ Mutex. /!\ EError.
+    @details Called by the accept thread of ENetServer, which hands the connection over to this core.
+    @details Call ENetSelector::addClient() on each ENetSelector untill a success.
+    @details Create a new ENetSelector, pinned on the core of the ENetShard, if addition failed with no error.
+    @param p_client ENetSocket client.
+  */
+  void                        ENetShard::addClient(ENetSocket *p_client)
+  {
+    mEERROR_R();
+    if (nullptr == p_client)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      bool                    l_stop = false;
+
+      WaitForSingleObject(m_mutexSelectors, INFINITE);
+      clearSelectors();
+      for (std::vector<ENetSelector*>::iterator l_selector = m_selectors.begin(); (false == l_stop) && (l_selector != m_selectors.end()); ++l_selector)
+      {
+        l_stop = (*l_selector)->addClient(p_client);
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_SELECTOR_ERR);
+          l_stop = true;
+        }
+      }
+      if ((EERROR_NONE == mEERROR)
+        && (false == l_stop))
+      {
+        ENetSelector          *l_selector = nullptr;
+
+        l_selector = new ENetSelector(&m_handler);
+        if (nullptr != l_selector)
+        {
+          l_selector->setAffinity(m_affinity);
+          l_selector->addClient(p_client);
+          if (EERROR_NONE == mEERROR)
+          {
+            l_selector->start();
+          }
+          if (EERROR_NONE == mEERROR)
+          {
+            m_selectors.push_back(l_selector);
+          }
+          else
+          {
+            mEERROR_SH(EERROR_NET_SELECTOR_ERR);
+            delete (l_selector);
+          }
+        }
+        else
+        {
+          mEERROR_S(EERROR_MEMORY);
+        }
+      }
+      ReleaseMutex(m_mutexSelectors);
+    }
+  }
+
+  /**
+    @brief Send a message to ENetShard. /!\ Mutex.
+    @details Only way for other cores to act on ENetShard: ENetShardTask is executed by run(), on the core of the ENetShard.
+    @details Wake run() if it waits.
+    @param p_task Function to be executed.
+    @param p_context Context of function.
+  */
+  void                        ENetShard::post(ENetShardTask p_task, void *p_context)
+  {
+    if (nullptr != p_task)
+    {
+      ENetShardMessage        l_message = { p_task, p_context };
+
+      WaitForSingleObject(m_mutexMessages, INFINITE);
+      m_messages.push_back(l_message);
+      ReleaseMutex(m_mutexMessages);
+      SetEvent(m_eventMessages);
+    }
+  }
+
+  /**
+    @brief Send ENetPacket to every clients of ENetShard. /!\ Mutex. /!\ EError.
+    @param p_packet ENetPacket to be send.
+  */
+  void                        ENetShard::broadcast(ENetPacket *p_packet)
+  {
+    mEERROR_R();
+    if (nullptr == p_packet)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      WaitForSingleObject(m_mutexSelectors, INFINITE);
+      for (std::vector<ENetSelector*>::iterator l_it = m_selectors.begin(); l_it != m_selectors.end(); ++l_it)
+      {
+        (*l_it)->broadcast(p_packet);
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_SELECTOR_ERR);
+        }
+      }
+      ReleaseMutex(m_mutexSelectors);
+    }
+  }
+
+  /**
+    @brief Set function handling received ENetPacket on the core of ENetShard.
+    @details Must be set before start().
+    @param p_worker ENetShardWorker. nullptr to let ENetPacket in ENetPacketHandler.
+    @param p_context Context of function.
+  */
+  void                        ENetShard::setWorker(ENetShardWorker p_worker, void *p_context)
+  {
+    m_worker = p_worker;
+    m_context = p_context;
+  }
+
+  /**
+    @brief Get ENetPacketHandler of ENetShard.
+    @return ENetPacketHandler storing ENetPacket of ENetShard connections.
+  */
+  ENetPacketHandler           *ENetShard::getHandler()
+  {
+    return (&m_handler);
+  }
+
+  /**
+    @brief Get index of ENetShard.
+    @return Index.
+  */
+  uint32                      ENetShard::getId() const
+  {
+    return (m_id);
+  }
+
+  /**
+    @brief Get number of clients of ENetShard. /!\ Mutex.
+    @return Number of clients.
+  */
+  uint32                      ENetShard::getSize() const
+  {
+    uint32                    l_size = 0;
+
+    WaitForSingleObject(m_mutexSelectors, INFINITE);
+    for (std::vector<ENetSelector*>::const_iterator l_it = m_selectors.begin(); l_it != m_selectors.end(); ++l_it)
+    {
+      l_size += (*l_it)->getSize();
+    }
+    ReleaseMutex(m_mutexSelectors);
+
+    return (l_size);
+  }
+
+  /**
+    @brief Get state of ENetShard.
+    @return State.
+  */
+  bool                        ENetShard::isRunning() const
+  {
+    return (m_isRunning);
+  }
+
+  /**
+    @brief Delete every ENetSelectors that are empty. m_mutexSelectors must be held by caller.
+  */
+  void                        ENetShard::clearSelectors()
+  {
+    for (std::vector<ENetSelector*>::iterator l_it = m_selectors.begin(); l_it != m_selectors.end(); )
+    {
+      if (0 == (*l_it)->getSize())
+      {
+        delete (*l_it);
+        l_it = m_selectors.erase(l_it);
+      }
+      else
+      {
+        ++l_it;
+      }
+    }
+  }
+
+}
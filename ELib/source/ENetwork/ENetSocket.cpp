@@ -4,6 +4,7 @@
   @brief Source for ENetSocket Class.
 */
 
+#include "ENetwork/ENetImpairment.h"
 #include "ENetwork/ENetSocket.h"
 
 /**
@@ -20,13 +21,19 @@ namespace               ELib
     m_socket(INVALID_SOCKET),
     m_hostname("0.0.0.0"),
     m_port(0),
-    m_flags(ENETSOCKET_FLAGS_STATE_UNINITIALIZED)
+    m_flags(ENETSOCKET_FLAGS_STATE_UNINITIALIZED),
+    m_sendQueue(nullptr),
+    m_pacer(nullptr),
+    m_fec(nullptr),
+    m_tap(nullptr),
+    m_memory(nullptr),
+    m_impairment(nullptr)
   {
   }
   
   /**
     @brief Destructor for ENetSocket. /!\ EError.
-    @details Call ENetSocket::close().
+    @details Call ENetSocket::close() and delete its ENetSendQueue.
   */
   ENetSocket::~ENetSocket()
   {
@@ -40,6 +47,10 @@ namespace               ELib
         mEERROR_SH(EERROR_NET_SOCKET_ERR);
       }
     }
+    if (nullptr != m_sendQueue)
+    {
+      delete (m_sendQueue);
+    }
   }
 
   /**
@@ -109,7 +120,7 @@ namespace               ELib
     {
       SOCKADDR_IN       l_infos = { 0 };
 
-      l_infos.sin_addr.s_addr = inet_addr(m_hostname.c_str());
+      l_infos.sin_addr.s_addr = inet_addr(p_hostname.c_str());
       if (INADDR_NONE != l_infos.sin_addr.s_addr)
       {
         m_hostname = p_hostname;
@@ -118,16 +129,22 @@ namespace               ELib
         l_infos.sin_family = ENETSOCKET_FAMILY;
         if (SOCKET_ERROR != ::bind(m_socket, reinterpret_cast<SOCKADDR*>(&l_infos), sizeof(SOCKADDR)))
         {
+          int32         l_infosLen = sizeof(SOCKADDR_IN);
+
+          if (SOCKET_ERROR != getsockname(m_socket, reinterpret_cast<SOCKADDR*>(&l_infos), &l_infosLen))
+          {
+            m_port = ntohs(l_infos.sin_port);
+          }
           m_flags = static_cast<ENetSocketFlags>(ENETSOCKET_FLAGS_STATE_BOUND | (m_flags & ENETSOCKET_FLAGS_PROTOCOLS));
         }
         else
         {
-          mEERROR_SA(EERROR_WINDOWS_ERR, "Not a legitimate Internet address");
+          mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
         }
       }
       else
       {
-        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+        mEERROR_SA(EERROR_WINDOWS_ERR, "Not a legitimate Internet address");
       }
     }
   }
@@ -196,8 +213,9 @@ namespace               ELib
         if (INVALID_SOCKET != l_client->m_socket)
         {
           l_client->m_hostname = inet_ntoa(l_infos.sin_addr);
-          l_client->m_port = l_infos.sin_port;
+          l_client->m_port = ntohs(l_infos.sin_port);
           l_client->m_flags = static_cast<ENetSocketFlags>(ENETSOCKET_FLAGS_STATE_CONNECTED | ENETSOCKET_FLAGS_PROTOCOL_TCP);
+          l_client->m_sendQueue = new ENetSendQueue();
         }
         else
         {
@@ -217,7 +235,7 @@ namespace               ELib
 
   /**
     @brief Connect ENetSocket to a host internet address. /!\ EError.
-    @details State must be ENETSOCKET_FLAGS_STATE_BOUND.
+    @details State must be ENETSOCKET_FLAGS_STATE_INITIALIZED or ENETSOCKET_FLAGS_STATE_BOUND.
     @details Protocol must be ENETSOCKET_FLAGS_PROTOCOL_TCP.
     @details On success, state is set to ENETSOCKET_FLAGS_STATE_CONNECTED.
     @param p_hostname Internet host address in number-and-dots notation.
@@ -226,7 +244,8 @@ namespace               ELib
   void                  ENetSocket::connect(const std::string &p_hostname, uint16 p_port)
   {
     mEERROR_R();
-    if (ENETSOCKET_FLAGS_STATE_BOUND != (m_flags & ENETSOCKET_FLAGS_STATES))
+    if ((ENETSOCKET_FLAGS_STATE_INITIALIZED != (m_flags & ENETSOCKET_FLAGS_STATES))
+      && (ENETSOCKET_FLAGS_STATE_BOUND != (m_flags & ENETSOCKET_FLAGS_STATES)))
     {
       mEERROR_S(EERROR_NET_SOCKET_STATE);
     }
@@ -239,7 +258,7 @@ namespace               ELib
     {
       SOCKADDR_IN       l_infos = { 0 };
 
-      l_infos.sin_addr.s_addr = inet_addr(m_hostname.c_str());
+      l_infos.sin_addr.s_addr = inet_addr(p_hostname.c_str());
       if (INADDR_NONE != l_infos.sin_addr.s_addr)
       {
         m_hostname = p_hostname;
@@ -249,6 +268,10 @@ namespace               ELib
         if (SOCKET_ERROR != ::connect(m_socket, reinterpret_cast<SOCKADDR*>(&l_infos), sizeof(SOCKADDR)))
         {
           m_flags = static_cast<ENetSocketFlags>(ENETSOCKET_FLAGS_STATE_CONNECTED | ENETSOCKET_FLAGS_PROTOCOL_TCP);
+          if (nullptr == m_sendQueue)
+          {
+            m_sendQueue = new ENetSendQueue();
+          }
         }
         else
         {
@@ -266,6 +289,8 @@ namespace               ELib
     @brief Receive datas from connected ENetSocket. /!\ Blocking. /!\ EError.
     @details State must be ENETSOCKET_FLAGS_STATUS_CONNECTED.
     @details Protocol must be ENETSOCKET_FLAGS_PROTOCOL_TCP.
+    @details Received datas are appended to the tap, if any.
+    @details Datas are taken from the in-memory stream instead of the kernel while it is set. It fails when the stream is empty.
     @param p_datas Buffer to receive the incoming datas.
     @param p_len Length of buffer.
     @return Length of received datas on success.
@@ -295,14 +320,35 @@ namespace               ELib
     {
       if (0 != p_len)
       {
-        l_len = ::recv(m_socket, p_datas, p_len, 0);
+        if (nullptr != m_memory)
+        {
+          if (false == m_memory->empty())
+          {
+            l_len = static_cast<int32>(min(static_cast<size_t>(p_len), m_memory->size()));
+            memcpy(p_datas, m_memory->data(), l_len);
+            m_memory->erase(0, l_len);
+          }
+        }
+        else
+        {
+          l_len = ::recv(m_socket, p_datas, p_len, 0);
+        }
         if (SOCKET_ERROR != l_len)
         {
+          mEMETRICS_G.add(EMETRICS_COUNTER_BYTES_IN, l_len);
+          if (nullptr != m_tap)
+          {
+            m_tap->append(p_datas, l_len);
+          }
           if (0 == l_len)
           {
             close();
           }
         }
+        else if (nullptr != m_memory)
+        {
+          mEERROR_S(EERROR_NET_SOCKET_ERR);
+        }
         else
         {
           mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
@@ -361,8 +407,10 @@ namespace               ELib
         l_len = ::recvfrom(m_socket, p_datas, p_len, 0, reinterpret_cast<SOCKADDR*>(&l_infos), &l_infosLen);
         if (SOCKET_ERROR != l_len)
         {
+          mEMETRICS_G.add(EMETRICS_COUNTER_DATAGRAMS_IN);
+          mEMETRICS_G.add(EMETRICS_COUNTER_BYTES_IN, l_len);
           p_src->m_hostname = inet_ntoa(l_infos.sin_addr);
-          p_src->m_port = l_infos.sin_port;
+          p_src->m_port = ntohs(l_infos.sin_port);
         }
         else
         {
@@ -378,10 +426,63 @@ namespace               ELib
     return (l_len);
   }
 
+  /**
+    @brief Receive datas from connectionless ENetSocket, with raw address of source. /!\ Blocking. /!\ EError.
+    @details State must be ENETSOCKET_FLAGS_STATUS_BOUND.
+    @details Protocol must be ENETSOCKET_FLAGS_PROTOCOL_UDP.
+    @details Nothing is allocated: source can be checked before any ENetSocket is created for it.
+    @param p_datas Buffer to receive the incoming datas.
+    @param p_len Length of buffer.
+    @param p_address IPv4 address of source, in network byte order.
+    @param p_port Port of source.
+    @return Length of received datas on success.
+    @return -1 on failure.
+  */
+  int32                 ENetSocket::recvfrom(char *p_datas, uint16 p_len, uint32 &p_address, uint16 &p_port)
+  {
+    int32               l_len = SOCKET_ERROR;
+
+    mEERROR_R();
+    if (ENETSOCKET_FLAGS_STATE_BOUND != (m_flags & ENETSOCKET_FLAGS_STATES))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_STATE);
+    }
+    if (ENETSOCKET_FLAGS_PROTOCOL_UDP != (m_flags & ENETSOCKET_FLAGS_PROTOCOLS))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+    if (nullptr == p_datas)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      SOCKADDR_IN       l_infos = { 0 };
+      int32             l_infosLen = sizeof(SOCKADDR_IN);
+
+      l_len = ::recvfrom(m_socket, p_datas, p_len, 0, reinterpret_cast<SOCKADDR*>(&l_infos), &l_infosLen);
+      if (SOCKET_ERROR != l_len)
+      {
+        mEMETRICS_G.add(EMETRICS_COUNTER_DATAGRAMS_IN);
+        mEMETRICS_G.add(EMETRICS_COUNTER_BYTES_IN, l_len);
+        p_address = l_infos.sin_addr.s_addr;
+        p_port = ntohs(l_infos.sin_port);
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+      }
+    }
+
+    return (l_len);
+  }
+
   /**
     @brief Send datas to connected ENetSocket. /!\ EError.
     @details State must be ENETSOCKET_FLAGS_STATUS_CONNECTED.
     @details Protocol must be ENETSOCKET_FLAGS_PROTOCOL_TCP.
+    @details Datas are appended to the in-memory stream while it is set, else queued into ENetImpairment while it is running.
     @param p_datas Buffer of datas to be send.
     @param p_len Length of buffer.
     @return Length of sent datas on success.
@@ -410,8 +511,25 @@ namespace               ELib
     {
       if (0 != p_len)
       {
-        l_len = ::send(m_socket, p_datas, p_len, 0);
-        if (SOCKET_ERROR == l_len)
+        if (nullptr != m_memory)
+        {
+          m_memory->append(p_datas, p_len);
+          l_len = p_len;
+        }
+        else if ((nullptr != m_impairment)
+          && (true == m_impairment->isRunning()))
+        {
+          l_len = m_impairment->push(this, p_datas, p_len);
+        }
+        else
+        {
+          l_len = ::send(m_socket, p_datas, p_len, 0);
+        }
+        if (SOCKET_ERROR != l_len)
+        {
+          mEMETRICS_G.add(EMETRICS_COUNTER_BYTES_OUT, l_len);
+        }
+        else
         {
           mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
         }
@@ -430,6 +548,7 @@ namespace               ELib
     @details State must be ENETSOCKET_FLAGS_STATUS_BOUND.
     @details Protocol must be ENETSOCKET_FLAGS_PROTOCOL_UDP.
     @details ENetSocket destination must be valid.
+    @details Datas are queued into ENetImpairment while it is running.
     @param p_datas Buffer of datas to be send.
     @param p_len Length of buffer.
     @param p_dst ENetSocket that hold informations of the destination.
@@ -465,13 +584,26 @@ namespace               ELib
       {
         SOCKADDR_IN     l_infos = { 0 };
 
-        l_infos.sin_addr.s_addr = inet_addr(m_hostname.c_str());
+        l_infos.sin_addr.s_addr = inet_addr(p_dst->m_hostname.c_str());
         if (INADDR_NONE != l_infos.sin_addr.s_addr)
         {
           l_infos.sin_port = htons(p_dst->m_port);
           l_infos.sin_family = ENETSOCKET_FAMILY;
-          l_len = ::sendto(m_socket, p_datas, p_len, 0, reinterpret_cast<SOCKADDR*>(&l_infos), sizeof(SOCKADDR_IN));
-          if (SOCKET_ERROR == l_len)
+          if ((nullptr != m_impairment)
+            && (true == m_impairment->isRunning()))
+          {
+            l_len = m_impairment->push(this, p_datas, p_len, l_infos.sin_addr.s_addr, p_dst->m_port);
+          }
+          else
+          {
+            l_len = ::sendto(m_socket, p_datas, p_len, 0, reinterpret_cast<SOCKADDR*>(&l_infos), sizeof(SOCKADDR_IN));
+          }
+          if (SOCKET_ERROR != l_len)
+          {
+            mEMETRICS_G.add(EMETRICS_COUNTER_DATAGRAMS_OUT);
+            mEMETRICS_G.add(EMETRICS_COUNTER_BYTES_OUT, l_len);
+          }
+          else
           {
             mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
           }
@@ -490,6 +622,66 @@ namespace               ELib
     return (l_len);
   }
 
+  /**
+    @brief Send datas to raw address from connectionless ENetSocket. /!\ EError.
+    @details State must be ENETSOCKET_FLAGS_STATUS_BOUND.
+    @details Protocol must be ENETSOCKET_FLAGS_PROTOCOL_UDP.
+    @details Datas are queued into ENetImpairment while it is running.
+    @param p_datas Buffer of datas to be send.
+    @param p_len Length of buffer.
+    @param p_address IPv4 address of destination, in network byte order.
+    @param p_port Port of destination.
+    @return Length of sent datas on success.
+    @return -1 on failure.
+  */
+  int32                 ENetSocket::sendto(const char *p_datas, uint16 p_len, uint32 p_address, uint16 p_port)
+  {
+    int32               l_len = SOCKET_ERROR;
+
+    mEERROR_R();
+    if (ENETSOCKET_FLAGS_STATE_BOUND != (m_flags & ENETSOCKET_FLAGS_STATES))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_STATE);
+    }
+    if (ENETSOCKET_FLAGS_PROTOCOL_UDP != (m_flags & ENETSOCKET_FLAGS_PROTOCOLS))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+    if (nullptr == p_datas)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      SOCKADDR_IN       l_infos = { 0 };
+
+      l_infos.sin_addr.s_addr = p_address;
+      l_infos.sin_port = htons(p_port);
+      l_infos.sin_family = ENETSOCKET_FAMILY;
+      if ((nullptr != m_impairment)
+        && (true == m_impairment->isRunning()))
+      {
+        l_len = m_impairment->push(this, p_datas, p_len, p_address, p_port);
+      }
+      else
+      {
+        l_len = ::sendto(m_socket, p_datas, p_len, 0, reinterpret_cast<SOCKADDR*>(&l_infos), sizeof(SOCKADDR_IN));
+      }
+      if (SOCKET_ERROR != l_len)
+      {
+        mEMETRICS_G.add(EMETRICS_COUNTER_DATAGRAMS_OUT);
+        mEMETRICS_G.add(EMETRICS_COUNTER_BYTES_OUT, l_len);
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+      }
+    }
+
+    return (l_len);
+  }
+
   /**
     @brief Shutdown a service of ENetSocket. /!\ EError.
     @details State must not be ENETSOCKET_FLAGS_STATE_UNINITIALIZED.
@@ -515,6 +707,7 @@ namespace               ELib
   /**
     @brief Close ENetSocket. /!\ EError.
     @details State must not be ENETSOCKET_FLAGS_STATE_UNINITIALIZED.
+    @details An in-memory stream is detached, no kernel socket is closed.
     @details On success, state is set to ENETSOCKET_FLAGS_STATE_UNINITIALIZED.
   */
   void                  ENetSocket::close()
@@ -527,7 +720,16 @@ namespace               ELib
 
     if (EERROR_NONE == mEERROR)
     {
-      if (SOCKET_ERROR != ::closesocket(m_socket))
+      if (nullptr != m_impairment)
+      {
+        m_impairment->forget(this);
+      }
+      if (nullptr != m_memory)
+      {
+        m_memory = nullptr;
+        m_flags = ENETSOCKET_FLAGS_STATE_UNINITIALIZED;
+      }
+      else if (SOCKET_ERROR != ::closesocket(m_socket))
       {
         m_flags = ENETSOCKET_FLAGS_STATE_UNINITIALIZED;
       }
@@ -538,6 +740,150 @@ namespace               ELib
     }
   }
 
+  /**
+    @brief Allow several ENetSockets to bind the same address. /!\ EError.
+    @details State must be ENETSOCKET_FLAGS_STATE_INITIALIZED: call before bind().
+    @details Needed by several multicast receivers of one host, bound on the port of the group.
+    @param p_isReused Address can be reused.
+  */
+  void                  ENetSocket::setReuseAddress(bool p_isReused)
+  {
+    mEERROR_R();
+    if (ENETSOCKET_FLAGS_STATE_INITIALIZED != (m_flags & ENETSOCKET_FLAGS_STATES))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_STATE);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      BOOL              l_value = (true == p_isReused) ? TRUE : FALSE;
+
+      if (SOCKET_ERROR == setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&l_value), sizeof(BOOL)))
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+      }
+    }
+  }
+
+  /**
+    @brief Join an IP multicast group. /!\ EError.
+    @details State must be ENETSOCKET_FLAGS_STATE_BOUND and protocol ENETSOCKET_FLAGS_PROTOCOL_UDP.
+    @details ENetSocket receives datagrams sent to the group on its port, on the default interface.
+    @param p_group Multicast address in number-and-dots notation (224.0.0.0 to 239.255.255.255).
+  */
+  void                  ENetSocket::joinGroup(const std::string &p_group)
+  {
+    mEERROR_R();
+    if (ENETSOCKET_FLAGS_STATE_BOUND != (m_flags & ENETSOCKET_FLAGS_STATES))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_STATE);
+    }
+    if (ENETSOCKET_FLAGS_PROTOCOL_UDP != (m_flags & ENETSOCKET_FLAGS_PROTOCOLS))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      struct ip_mreq    l_request = { 0 };
+
+      l_request.imr_multiaddr.s_addr = inet_addr(p_group.c_str());
+      l_request.imr_interface.s_addr = htonl(INADDR_ANY);
+      if (INADDR_NONE != l_request.imr_multiaddr.s_addr)
+      {
+        if (SOCKET_ERROR == setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, reinterpret_cast<const char*>(&l_request), sizeof(l_request)))
+        {
+          mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+        }
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, "Not a legitimate Internet address");
+      }
+    }
+  }
+
+  /**
+    @brief Leave an IP multicast group. /!\ EError.
+    @details State must be ENETSOCKET_FLAGS_STATE_BOUND and protocol ENETSOCKET_FLAGS_PROTOCOL_UDP.
+    @param p_group Multicast address in number-and-dots notation.
+  */
+  void                  ENetSocket::leaveGroup(const std::string &p_group)
+  {
+    mEERROR_R();
+    if (ENETSOCKET_FLAGS_STATE_BOUND != (m_flags & ENETSOCKET_FLAGS_STATES))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_STATE);
+    }
+    if (ENETSOCKET_FLAGS_PROTOCOL_UDP != (m_flags & ENETSOCKET_FLAGS_PROTOCOLS))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      struct ip_mreq    l_request = { 0 };
+
+      l_request.imr_multiaddr.s_addr = inet_addr(p_group.c_str());
+      l_request.imr_interface.s_addr = htonl(INADDR_ANY);
+      if (SOCKET_ERROR == setsockopt(m_socket, IPPROTO_IP, IP_DROP_MEMBERSHIP, reinterpret_cast<const char*>(&l_request), sizeof(l_request)))
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+      }
+    }
+  }
+
+  /**
+    @brief Set number of routers crossed by multicast datagrams sent by ENetSocket. /!\ EError.
+    @details Protocol must be ENETSOCKET_FLAGS_PROTOCOL_UDP. 1 keeps datagrams on the local network.
+    @param p_ttl Time to live of multicast datagrams.
+  */
+  void                  ENetSocket::setMulticastTtl(uint8 p_ttl)
+  {
+    mEERROR_R();
+    if (ENETSOCKET_FLAGS_PROTOCOL_UDP != (m_flags & ENETSOCKET_FLAGS_PROTOCOLS))
+    {
+      mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      DWORD             l_ttl = p_ttl;
+
+      if (SOCKET_ERROR == setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<const char*>(&l_ttl), sizeof(DWORD)))
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(WSAGetLastError()));
+      }
+    }
+  }
+
+  /**
+    @brief Set address of ENetSocket, used as destination of connectionless datas.
+    @details Does not bind nor connect.
+    @param p_hostname Internet host address in number-and-dots notation.
+    @param p_port Internet host port.
+  */
+  void                  ENetSocket::setAddress(const std::string &p_hostname, uint16 p_port)
+  {
+    m_hostname = p_hostname;
+    m_port = p_port;
+  }
+
+  /**
+    @brief Set raw address of ENetSocket, used as destination of connectionless datas.
+    @details Does not bind nor connect.
+    @param p_address IPv4 address, in network byte order.
+    @param p_port Internet host port.
+  */
+  void                  ENetSocket::setAddress(uint32 p_address, uint16 p_port)
+  {
+    IN_ADDR             l_address = { 0 };
+
+    l_address.s_addr = p_address;
+    m_hostname = inet_ntoa(l_address);
+    m_port = p_port;
+  }
+
   /**
     @brief Get hostname of ENetSocket.
     @return Internet host address in number-and-dots notation.
@@ -565,6 +911,100 @@ namespace               ELib
     return (m_flags);
   }
 
+  /**
+    @brief Get ENetSendQueue of ENetSocket.
+    @details Only connected ENetSockets have an ENetSendQueue.
+    @return Outbound frames queue, nullptr if not connected.
+  */
+  ENetSendQueue         *ENetSocket::getSendQueue() const
+  {
+    return (m_sendQueue);
+  }
+
+  /**
+    @brief Set ENetPacer of connectionless ENetSocket.
+    @details ENetPacer is not owned by ENetSocket.
+    @param p_pacer Pacer of connectionless datas, nullptr to send immediately.
+  */
+  void                  ENetSocket::setPacer(ENetPacer *p_pacer)
+  {
+    m_pacer = p_pacer;
+  }
+
+  /**
+    @brief Get ENetPacer of ENetSocket.
+    @return Pacer of connectionless datas, nullptr if datas are sent immediately.
+  */
+  ENetPacer             *ENetSocket::getPacer() const
+  {
+    return (m_pacer);
+  }
+
+  /**
+    @brief Set ENetFec of connectionless ENetSocket.
+    @details ENetFec is not owned by ENetSocket.
+    @param p_fec Forward error correction of connectionless datas, nullptr for none.
+  */
+  void                  ENetSocket::setFec(ENetFec *p_fec)
+  {
+    m_fec = p_fec;
+  }
+
+  /**
+    @brief Get ENetFec of ENetSocket.
+    @return Forward error correction of connectionless datas, nullptr if none.
+  */
+  ENetFec               *ENetSocket::getFec() const
+  {
+    return (m_fec);
+  }
+
+  /**
+    @brief Set tap of ENetSocket, receiving a copy of datas read by recv().
+    @details Used by ENetPacketHandler to capture the frame of an ENetPacket for ENetCapture.
+    @param p_tap Buffer appended by recv(), nullptr to stop copying.
+  */
+  void                  ENetSocket::setTap(std::string *p_tap)
+  {
+    m_tap = p_tap;
+  }
+
+  /**
+    @brief Set in-memory stream of ENetSocket, replacing the kernel socket for send() and recv().
+    @details send() appends to the stream, recv() takes from its front: two ENetSockets on one stream are the two sides of a connection.
+    @details An uninitialized ENetSocket is set to ENETSOCKET_FLAGS_STATE_CONNECTED with ENETSOCKET_FLAGS_PROTOCOL_TCP.
+      close() detaches the stream. Used by ElemMicro to measure ELib without kernel round trip.
+    @param p_memory Stream, not owned by ENetSocket.
+  */
+  void                  ENetSocket::setMemory(std::string *p_memory)
+  {
+    m_memory = p_memory;
+    if ((nullptr != m_memory)
+      && (ENETSOCKET_FLAGS_STATE_UNINITIALIZED == (m_flags & ENETSOCKET_FLAGS_STATES)))
+    {
+      m_flags = static_cast<ENetSocketFlags>(ENETSOCKET_FLAGS_STATE_CONNECTED | ENETSOCKET_FLAGS_PROTOCOL_TCP);
+    }
+  }
+
+  /**
+    @brief Set ENetImpairment of ENetSocket.
+    @details ENetImpairment is not owned by ENetSocket, and can be shared by several ENetSockets.
+    @param p_impairment Impairment of sent datas, nullptr to send them unimpaired.
+  */
+  void                  ENetSocket::setImpairment(ENetImpairment *p_impairment)
+  {
+    m_impairment = p_impairment;
+  }
+
+  /**
+    @brief Get ENetImpairment of ENetSocket.
+    @return Impairment of sent datas, nullptr if none.
+  */
+  ENetImpairment        *ENetSocket::getImpairment() const
+  {
+    return (m_impairment);
+  }
+
   /**
     @brief Convert ENetSocket to unique identifier.
     @return Unique identifier.
@@ -0,0 +1,262 @@
+/**
+  @author Elandryl (Christophe.M).
+  @date 2019.
+  @brief Source for ENetTopics Class.
+*/
+
+#include "ENetwork/ENetTopics.h"
+
+/**
+  @brief General scope for ELib components.
+*/
+namespace                     ELib
+{
+
+  /**
+    @brief Constructor for ENetTopics.
+  */
+  ENetTopics::ENetTopics() :
+    m_topics(),
+    m_memberships(),
+    m_mutexTopics(nullptr)
+  {
+  }
+
+  /**
+    @brief Destructor for ENetTopics.
+    @details Release its mutex.
+  */
+  ENetTopics::~ENetTopics()
+  {
+    ReleaseMutex(m_mutexTopics);
+    CloseHandle(m_mutexTopics);
+  }
+
+  /**
+    @brief Singleton for ENetTopics. /!\ EError.
+    @details Initialize its mutex.
+    @return ENetTopics unique instance on success.
+    @return nullptr on failure.
+  */
+  ENetTopics                  *ENetTopics::getInstance()
+  {
+    static ENetTopics         *l_instance = nullptr;
+
+    mEERROR_R();
+    if (nullptr == l_instance)
+    {
+      HANDLE                  l_mutex = nullptr;
+
+      l_mutex = CreateMutex(nullptr, false, nullptr);
+      if (nullptr != l_mutex)
+      {
+        l_instance = new ENetTopics();
+        if (nullptr != l_instance)
+        {
+          l_instance->m_mutexTopics = l_mutex;
+        }
+        else
+        {
+          mEERROR_S(EERROR_MEMORY);
+          CloseHandle(l_mutex);
+        }
+      }
+      else
+      {
+        mEERROR_SA(EERROR_WINDOWS_ERR, WindowsErrString(GetLastError()));
+      }
+    }
+
+    return (l_instance);
+  }
+
+  /**
+    @brief Add a connected ENetSocket client to a topic. /!\ Mutex. /!\ EError.
+    @details Topic is created on first join. Joining twice is ignored.
+    @param p_topic Topic to be joined.
+    @param p_client ENetSocket client.
+  */
+  void                        ENetTopics::join(ENetTopicId p_topic, ENetSocket *p_client)
+  {
+    mEERROR_R();
+    if (nullptr == p_client)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      WaitForSingleObject(m_mutexTopics, INFINITE);
+      ENetTopic               &l_topic = m_topics[p_topic];
+
+      if (l_topic.m_positions.end() == l_topic.m_positions.find(p_client))
+      {
+        l_topic.m_positions[p_client] = static_cast<uint32>(l_topic.m_members.size());
+        l_topic.m_members.push_back(p_client);
+        m_memberships[p_client].push_back(p_topic);
+      }
+      ReleaseMutex(m_mutexTopics);
+    }
+  }
+
+  /**
+    @brief Remove a ENetSocket client from a topic. /!\ Mutex. /!\ EError.
+    @param p_topic Topic to be left.
+    @param p_client ENetSocket client.
+  */
+  void                        ENetTopics::leave(ENetTopicId p_topic, ENetSocket *p_client)
+  {
+    mEERROR_R();
+    if (nullptr == p_client)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::unordered_map<const ENetSocket*, std::vector<ENetTopicId> >::iterator  l_memberships;
+
+      WaitForSingleObject(m_mutexTopics, INFINITE);
+      l_memberships = m_memberships.find(p_client);
+      if (m_memberships.end() != l_memberships)
+      {
+        for (std::vector<ENetTopicId>::iterator l_it = l_memberships->second.begin(); l_it != l_memberships->second.end(); ++l_it)
+        {
+          if (p_topic == *l_it)
+          {
+            removeMember(p_topic, p_client);
+            *l_it = l_memberships->second.back();
+            l_memberships->second.pop_back();
+            break;
+          }
+        }
+        if (true == l_memberships->second.empty())
+        {
+          m_memberships.erase(l_memberships);
+        }
+      }
+      ReleaseMutex(m_mutexTopics);
+    }
+  }
+
+  /**
+    @brief Remove a ENetSocket client from every topics it joined. /!\ Mutex.
+    @details Called by ENetSelector on disconnection.
+    @param p_client ENetSocket client.
+  */
+  void                        ENetTopics::leaveAll(const ENetSocket *p_client)
+  {
+    std::unordered_map<const ENetSocket*, std::vector<ENetTopicId> >::iterator  l_memberships;
+
+    WaitForSingleObject(m_mutexTopics, INFINITE);
+    l_memberships = m_memberships.find(p_client);
+    if (m_memberships.end() != l_memberships)
+    {
+      for (std::vector<ENetTopicId>::iterator l_it = l_memberships->second.begin(); l_it != l_memberships->second.end(); ++l_it)
+      {
+        removeMember(*l_it, p_client);
+      }
+      m_memberships.erase(l_memberships);
+    }
+    ReleaseMutex(m_mutexTopics);
+  }
+
+  /**
+    @brief Post ENetPacket to every members of a topic. /!\ Mutex. /!\ EError.
+    @details Only members of the topic are walked, cost is independent of the number of connections.
+    @details Members are copied under mutex, then ENetPacket is posted to each one without it:
+      a slow member never stalls publish(), join() or leave(). Sending is done by ENetSelector threads.
+    @details ENetPacket source is used as in ENetSelector::broadcast().
+    @param p_topic Topic to be published on.
+    @param p_packet ENetPacket to be send.
+  */
+  void                        ENetTopics::publish(ENetTopicId p_topic, ENetPacket *p_packet)
+  {
+    mEERROR_R();
+    if (nullptr == p_packet)
+    {
+      mEERROR_S(EERROR_NULL_PTR);
+    }
+
+    if (EERROR_NONE == mEERROR)
+    {
+      std::unordered_map<ENetTopicId, ENetTopic>::iterator  l_topic;
+      std::vector<ENetSocket*>  l_members;
+
+      WaitForSingleObject(m_mutexTopics, INFINITE);
+      l_topic = m_topics.find(p_topic);
+      if (m_topics.end() != l_topic)
+      {
+        l_members = l_topic->second.m_members;
+      }
+      ReleaseMutex(m_mutexTopics);
+      for (std::vector<ENetSocket*>::iterator l_it = l_members.begin(); l_it != l_members.end(); ++l_it)
+      {
+        p_packet->post(*l_it);
+        if (EERROR_NONE != mEERROR)
+        {
+          mEERROR_SH(EERROR_NET_PACKET_ERR);
+        }
+      }
+    }
+  }
+
+  /**
+    @brief Get number of members of a topic. /!\ Mutex.
+    @param p_topic Topic.
+    @return Number of members.
+  */
+  uint32                      ENetTopics::getSize(ENetTopicId p_topic) const
+  {
+    uint32                    l_size = 0;
+    std::unordered_map<ENetTopicId, ENetTopic>::const_iterator  l_topic;
+
+    WaitForSingleObject(m_mutexTopics, INFINITE);
+    l_topic = m_topics.find(p_topic);
+    if (m_topics.end() != l_topic)
+    {
+      l_size = static_cast<uint32>(l_topic->second.m_members.size());
+    }
+    ReleaseMutex(m_mutexTopics);
+
+    return (l_size);
+  }
+
+  /**
+    @brief Remove a ENetSocket client from the members of a topic.
+    @details Last member is moved at the position of the leaving one.
+    @details Topic is deleted when its last member leaves.
+    @details m_mutexTopics must be held by caller.
+    @param p_topic Topic to be left.
+    @param p_client ENetSocket client.
+  */
+  void                        ENetTopics::removeMember(ENetTopicId p_topic, const ENetSocket *p_client)
+  {
+    std::unordered_map<ENetTopicId, ENetTopic>::iterator  l_topic;
+
+    l_topic = m_topics.find(p_topic);
+    if (m_topics.end() != l_topic)
+    {
+      std::unordered_map<const ENetSocket*, uint32>::iterator l_position;
+
+      l_position = l_topic->second.m_positions.find(p_client);
+      if (l_topic->second.m_positions.end() != l_position)
+      {
+        uint32                l_index = l_position->second;
+
+        l_topic->second.m_positions.erase(l_position);
+        if (l_index + 1 != l_topic->second.m_members.size())
+        {
+          l_topic->second.m_members[l_index] = l_topic->second.m_members.back();
+          l_topic->second.m_positions[l_topic->second.m_members[l_index]] = l_index;
+        }
+        l_topic->second.m_members.pop_back();
+        if (true == l_topic->second.m_members.empty())
+        {
+          m_topics.erase(l_topic);
+        }
+      }
+    }
+  }
+
+}
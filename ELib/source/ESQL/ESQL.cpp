@@ -111,8 +111,12 @@ namespace       ELib
     if (EERROR_NONE == mEERROR)
     {
       int32       l_ret = -1;
+      LARGE_INTEGER l_start = { 0 };
 
+      QueryPerformanceCounter(&l_start);
       l_ret = mysql_real_query(reinterpret_cast<MYSQL*>(m_mysql), p_query.c_str(), static_cast<unsigned long>(p_query.size()));
+      mEMETRICS_G.add(EMETRICS_COUNTER_SQL_QUERIES);
+      mEMETRICS_G.time(EMETRICS_HISTOGRAM_SQL, l_start.QuadPart);
       if (0 != l_ret)
       {
         mEERROR_SA(EERROR_SQL_MYSQL_ERR, mysql_error(reinterpret_cast<MYSQL*>(m_mysql)));
@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <ENetwork\ENetClient.h>
+#include <ENetwork\ENetRpc.h>
+#include <ENetwork\ENetServer.h>
+
+#define ELEMBENCH_HOSTNAME    ("127.0.0.1")
+#define ELEMBENCH_PORT        (2222)
+#define ELEMBENCH_METHOD_ECHO (1)
+#define ELEMBENCH_UDP_TIMEOUT (1000)  /**< Milliseconds before a datagram round trip is counted as lost. */
+#define ELEMBENCH_TCP_TIMEOUT (5000)  /**< Milliseconds before a connected round trip is counted as lost. */
+#define ELEMBENCH_TRACE_FILE  ("ElemBench.trace.json")
+
+/**
+  @brief Options of a benchmark run.
+*/
+struct                        BenchOptions
+{
+  uint32                      m_clients;  /**< Number of clients, one thread each. */
+  uint32                      m_count;    /**< Round trips per client. */
+  uint32                      m_size;     /**< Payload bytes of each ENetPacket. */
+  uint32                      m_udp;      /**< Percentage of round trips sent as datagrams. */
+  bool                        m_isRpc;    /**< Connected round trips are ENetRpc calls instead of ENetPacketRawDatas. */
+  uint32                      m_shards;   /**< ENetShard count of server, 0 for ENetSelectors. */
+  uint32                      m_trace;    /**< ETrace sampling, 0 for no trace. */
+  ELib::ENetImpairmentSettings m_impairment; /**< Impairment of datas sent by server, none by default. */
+};
+
+/**
+  @brief Results of one benchmark client.
+*/
+struct                        BenchClient
+{
+  const BenchOptions          *m_options;   /**< Options of the run. */
+  std::vector<double>         m_latencies;  /**< Round trip times in microseconds. */
+  uint64                      m_bytes;      /**< Payload bytes sent and received back. */
+  uint32                      m_lost;       /**< Round trips without answer. */
+  bool                        m_isFailed;   /**< Client could not connect. */
+};
+
+static LARGE_INTEGER          g_frequency = { 0 };
+static volatile bool          g_isRunning = true;
+
+/**
+  @brief Elapsed microseconds since a performance counter value.
+  @param p_start Performance counter at start.
+  @return Elapsed microseconds.
+*/
+static double                 elapsed(const LARGE_INTEGER &p_start)
+{
+  LARGE_INTEGER               l_now = { 0 };
+
+  QueryPerformanceCounter(&l_now);
+
+  return (static_cast<double>(l_now.QuadPart - p_start.QuadPart) * 1000000.0 / static_cast<double>(g_frequency.QuadPart));
+}
+
+/**
+  @brief ENetRpcHandler of ELEMBENCH_METHOD_ECHO. Response carries the datas of request.
+*/
+void                          echoMethod(const ELib::ENetPacketRpc *p_request, ELib::ENetPacketRpc *p_response, void *p_context)
+{
+  p_response->setDatas(p_request->getDatas().data(), static_cast<int32>(p_request->getDatas().size()));
+}
+
+/**
+  @brief Send back a received ENetPacket to its source.
+  @details Datagrams are answered from the connectionless ENetSocket in parameter, requests of ENetRpc are served.
+  @param p_packet Received ENetPacket.
+  @param p_echo Connectionless ENetSocket answering datagrams.
+*/
+void                          echo(ELib::ENetPacket *p_packet, ELib::ENetSocket *p_echo)
+{
+  ELib::ENetSocket            *l_src = const_cast<ELib::ENetSocket*>(p_packet->getSource());
+
+  if ((ELib::ENETPACKET_TYPE_RAW_DATAS == p_packet->getType())
+    && (nullptr != l_src))
+  {
+    if (ELib::ENETSOCKET_FLAGS_PROTOCOL_TCP == (l_src->getFlags() & ELib::ENETSOCKET_FLAGS_PROTOCOLS))
+    {
+      p_packet->send();
+    }
+    else if (nullptr != p_echo)
+    {
+      p_packet->setSource(p_echo);
+      p_packet->send(l_src);
+      p_packet->setSource(l_src);
+    }
+  }
+  else if (nullptr != ELib::ENetRpc::getInstance())
+  {
+    ELib::ENetRpc::getInstance()->process(p_packet);
+  }
+}
+
+/**
+  @brief ENetShardWorker echoing connected ENetPacket of an ENetShard.
+*/
+void                          echoWorker(ELib::ENetShard *p_shard, ELib::ENetPacket *p_packet, void *p_context)
+{
+  echo(p_packet, nullptr);
+}
+
+/**
+  @brief Echo thread of server ENetPacketHandler.
+  @param p_handler ENetPacketHandler of server.
+  @return Unused.
+*/
+DWORD WINAPI                  EchoFunctor(LPVOID p_handler)
+{
+  ELib::ENetPacketHandler     *l_handler = static_cast<ELib::ENetPacketHandler*>(p_handler);
+  ELib::ENetSocket            l_echo;
+
+  l_echo.socket(ELib::ENETSOCKET_FLAGS_PROTOCOL_UDP);
+  l_echo.bind(ELEMBENCH_HOSTNAME, 0);
+  while (true == g_isRunning)
+  {
+    ELib::ENetPacket          *l_packet = l_handler->popPacket();
+
+    if (nullptr != l_packet)
+    {
+      echo(l_packet, &l_echo);
+      delete (l_packet);
+    }
+    else
+    {
+      SwitchToThread();
+    }
+  }
+
+  return (0);
+}
+
+/**
+  @brief Completion of an ENetRpc round trip.
+*/
+void                          echoCallback(ELib::ENetRpcStatus p_status, const ELib::ENetPacketRpc *p_response, void *p_context)
+{
+  *static_cast<ELib::ENetRpcStatus*>(p_context) = p_status;
+}
+
+/**
+  @brief Wait for the answer of a connected round trip.
+  @details Popped ENetPacketRpc are given to ENetRpc, so the pending call is completed.
+  @param p_handler ENetPacketHandler of client.
+  @param p_isRpc Round trip is an ENetRpc call.
+  @param p_status Status written by echoCallback().
+  @param p_start Performance counter at sending.
+  @return Payload bytes received, -1 on timeout.
+*/
+static int64                  waitAnswer(ELib::ENetPacketHandler *p_handler, bool p_isRpc, volatile ELib::ENetRpcStatus *p_status,
+                                const LARGE_INTEGER &p_start)
+{
+  int64                       l_bytes = -1;
+
+  while ((0 > l_bytes)
+    && (ELEMBENCH_TCP_TIMEOUT * 1000.0 > elapsed(p_start)))
+  {
+    ELib::ENetPacket          *l_packet = p_handler->popPacket();
+
+    if (nullptr != l_packet)
+    {
+      if ((false == p_isRpc)
+        && (ELib::ENETPACKET_TYPE_RAW_DATAS == l_packet->getType()))
+      {
+        l_bytes = static_cast<ELib::ENetPacketRawDatas*>(l_packet)->getLength();
+      }
+      else if ((true == p_isRpc)
+        && (ELib::ENETPACKET_TYPE_RPC_RESPONSE == l_packet->getType()))
+      {
+        ELib::ENetRpc::getInstance()->process(l_packet);
+        if (ELib::ENETRPC_STATUS_OK == *p_status)
+        {
+          l_bytes = static_cast<ELib::ENetPacketRpc*>(l_packet)->getDatas().size();
+        }
+      }
+      delete (l_packet);
+    }
+    else
+    {
+      SwitchToThread();
+    }
+  }
+
+  return (l_bytes);
+}
+
+/**
+  @brief Benchmark client thread.
+  @details Closed loop: one round trip in flight, over its ENetClient connection or over its own connectionless ENetSocket.
+  @details Datagram payloads start with the round trip index, so a late echo of a lost round trip is discarded, not measured.
+  @param p_client BenchClient filled with results.
+  @return Unused.
+*/
+DWORD WINAPI                  ClientFunctor(LPVOID p_client)
+{
+  BenchClient                 *l_bench = static_cast<BenchClient*>(p_client);
+  const BenchOptions          *l_options = l_bench->m_options;
+  ELib::ENetPacketHandler     l_handler;
+  ELib::ENetClient            l_client(&l_handler);
+  ELib::ENetSocket            l_udp;
+  ELib::ENetSocket            l_server;
+  std::vector<char>           l_payload(l_options->m_size + 1, 'x');
+  std::vector<char>           l_datagram(ENETSOCKET_UDP_MAX);
+  DWORD                       l_timeout = ELEMBENCH_UDP_TIMEOUT;
+
+  l_handler.copySettings(*ELib::ENetPacketHandler::getInstance());
+  l_client.init(ELEMBENCH_HOSTNAME, ELEMBENCH_PORT);
+  if (EERROR_NONE == mEERROR)
+  {
+    l_client.start();
+  }
+  if (EERROR_NONE == mEERROR)
+  {
+    l_udp.socket(ELib::ENETSOCKET_FLAGS_PROTOCOL_UDP);
+    l_udp.bind(ELEMBENCH_HOSTNAME, 0);
+    setsockopt(l_udp, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&l_timeout), sizeof(DWORD));
+    l_server.setAddress(ELEMBENCH_HOSTNAME, ELEMBENCH_PORT);
+  }
+  l_bench->m_isFailed = (EERROR_NONE != mEERROR);
+  for (uint32 l_i = 0; (false == l_bench->m_isFailed) && (l_i < l_options->m_count); ++l_i)
+  {
+    LARGE_INTEGER             l_start = { 0 };
+    int64                     l_bytes = -1;
+
+    QueryPerformanceCounter(&l_start);
+    if ((l_i % 100) < l_options->m_udp)
+    {
+      ELib::ENetPacketRawDatas l_packet(&l_udp);
+      uint32                  l_address = 0;
+      uint16                  l_port = 0;
+      int32                   l_len = 0;
+
+      memcpy(l_payload.data(), &l_i, min(sizeof(uint32), static_cast<size_t>(l_options->m_size)));
+      l_packet.setDatas(l_payload.data(), l_options->m_size);
+      l_packet.send(&l_server);
+      l_packet.setDatas(nullptr, 0);
+      while ((0 > l_bytes)
+        && (ELEMBENCH_UDP_TIMEOUT * 1000.0 > elapsed(l_start))
+        && (0 < (l_len = l_udp.recvfrom(l_datagram.data(), static_cast<uint16>(l_datagram.size()), l_address, l_port))))
+      {
+        if ((static_cast<int32>(sizeof(int32) + l_options->m_size) == l_len)
+          && (0 == memcmp(l_datagram.data() + sizeof(int32), l_payload.data(), l_options->m_size)))
+        {
+          l_bytes = l_options->m_size;
+        }
+      }
+    }
+    else if (true == l_options->m_isRpc)
+    {
+      volatile ELib::ENetRpcStatus l_status = ELib::ENETRPC_STATUS_TIMEOUT;
+
+      ELib::ENetRpc::getInstance()->call(l_client.getSocket(), ELEMBENCH_METHOD_ECHO, l_payload.data(), l_options->m_size,
+        echoCallback, const_cast<ELib::ENetRpcStatus*>(&l_status), ELEMBENCH_TCP_TIMEOUT);
+      l_bytes = waitAnswer(&l_handler, true, &l_status, l_start);
+    }
+    else
+    {
+      ELib::ENetPacketRawDatas l_packet;
+
+      l_packet.setDatas(l_payload.data(), l_options->m_size);
+      l_client.send(&l_packet);
+      l_packet.setDatas(nullptr, 0);
+      l_bytes = waitAnswer(&l_handler, false, nullptr, l_start);
+    }
+    if (0 <= l_bytes)
+    {
+      l_bench->m_latencies.push_back(elapsed(l_start));
+      l_bench->m_bytes += l_options->m_size + l_bytes;
+    }
+    else
+    {
+      ++l_bench->m_lost;
+    }
+  }
+  l_client.stop();
+
+  return (0);
+}
+
+/**
+  @brief Percentile of sorted latencies.
+  @param p_latencies Sorted round trip times.
+  @param p_ratio Percentile, between 0 and 1.
+  @return Round trip time at percentile, 0 if empty.
+*/
+static double                 percentile(const std::vector<double> &p_latencies, double p_ratio)
+{
+  double                      l_value = 0.0;
+
+  if (false == p_latencies.empty())
+  {
+    l_value = p_latencies[static_cast<size_t>(p_ratio * (p_latencies.size() - 1))];
+  }
+
+  return (l_value);
+}
+
+/**
+  @brief Parse options. Usage: ElemBench [clients] [count] [size] [udp%] [raw|rpc] [shards] [trace sampling]
+    [latency ms] [jitter ms] [loss%].
+  @param p_argc Number of arguments.
+  @param p_argv Arguments.
+  @return Options, defaults for missing arguments.
+*/
+static BenchOptions           parseOptions(int p_argc, char **p_argv)
+{
+  BenchOptions                l_options = { 8, 10000, 64, 0, false, 0, 0, { 0, 0, 0.0, 0.0, 0.0, 0 } };
+
+  if (1 < p_argc)
+  {
+    l_options.m_clients = max(1ul, std::stoul(p_argv[1]));
+  }
+  if (2 < p_argc)
+  {
+    l_options.m_count = std::stoul(p_argv[2]);
+  }
+  if (3 < p_argc)
+  {
+    l_options.m_size = min(static_cast<unsigned long>(ENETPACKETRAWDATAS_MAX), std::stoul(p_argv[3]));
+  }
+  if (4 < p_argc)
+  {
+    l_options.m_udp = min(100ul, std::stoul(p_argv[4]));
+  }
+  if (5 < p_argc)
+  {
+    l_options.m_isRpc = (std::string("rpc") == p_argv[5]);
+  }
+  if (6 < p_argc)
+  {
+    l_options.m_shards = std::stoul(p_argv[6]);
+  }
+  if (7 < p_argc)
+  {
+    l_options.m_trace = std::stoul(p_argv[7]);
+  }
+  if (8 < p_argc)
+  {
+    l_options.m_impairment.m_latency = std::stoul(p_argv[8]) * 1000;
+  }
+  if (9 < p_argc)
+  {
+    l_options.m_impairment.m_jitter = std::stoul(p_argv[9]) * 1000;
+  }
+  if (10 < p_argc)
+  {
+    l_options.m_impairment.m_loss = min(100.0, std::stod(p_argv[10])) / 100.0;
+  }
+  if (ENETSOCKET_UDP_MAX < l_options.m_size + sizeof(ELib::ENetPacketType) + sizeof(int32))
+  {
+    l_options.m_udp = 0;
+  }
+
+  return (l_options);
+}
+
+int                           main(int argc, char **argv)
+{
+  try
+  {
+    BenchOptions              l_options = parseOptions(argc, argv);
+    ELib::ENetServer          l_server;
+    std::vector<BenchClient>  l_clients(l_options.m_clients, { &l_options, {}, 0, 0, false });
+    std::vector<HANDLE>       l_threads;
+    std::vector<double>       l_latencies;
+    HANDLE                    l_echo = nullptr;
+    LARGE_INTEGER             l_start = { 0 };
+    double                    l_duration = 0.0;
+    uint64                    l_bytes = 0;
+    uint32                    l_lost = 0;
+    uint32                    l_failed = 0;
+
+    QueryPerformanceFrequency(&g_frequency);
+    mETRACE_G.setSampling(l_options.m_trace);
+    l_server.init(ELEMBENCH_HOSTNAME, ELEMBENCH_PORT);
+    if (EERROR_NONE == mEERROR)
+    {
+      ELib::ENetRpc::getInstance()->setHandler(ELEMBENCH_METHOD_ECHO, echoMethod);
+      if (0 != l_options.m_shards)
+      {
+        l_server.setShards(l_options.m_shards);
+        for (uint32 l_i = 0; l_i < l_server.getShardCount(); ++l_i)
+        {
+          l_server.getShard(l_i)->setWorker(echoWorker);
+        }
+      }
+      l_server.setImpairment(l_options.m_impairment);
+      l_server.start();
+    }
+    if (EERROR_NONE != mEERROR)
+    {
+      throw (ELib::EException());
+    }
+    l_echo = CreateThread(nullptr, 0, EchoFunctor, l_server.getHandler(), 0, nullptr);
+    QueryPerformanceCounter(&l_start);
+    for (std::vector<BenchClient>::iterator l_it = l_clients.begin(); l_it != l_clients.end(); ++l_it)
+    {
+      l_threads.push_back(CreateThread(nullptr, 0, ClientFunctor, &(*l_it), 0, nullptr));
+    }
+    for (std::vector<HANDLE>::iterator l_it = l_threads.begin(); l_it != l_threads.end(); ++l_it)
+    {
+      WaitForSingleObject(*l_it, INFINITE);
+      CloseHandle(*l_it);
+    }
+    l_duration = elapsed(l_start) / 1000000.0;
+    g_isRunning = false;
+    WaitForSingleObject(l_echo, INFINITE);
+    CloseHandle(l_echo);
+    l_server.stop();
+    if (0 != l_options.m_trace)
+    {
+      mETRACE_G.setSampling(0);
+      mETRACE_G.dump(ELEMBENCH_TRACE_FILE);
+    }
+
+    for (std::vector<BenchClient>::iterator l_it = l_clients.begin(); l_it != l_clients.end(); ++l_it)
+    {
+      l_latencies.insert(l_latencies.end(), l_it->m_latencies.begin(), l_it->m_latencies.end());
+      l_bytes += l_it->m_bytes;
+      l_lost += l_it->m_lost;
+      l_failed += (true == l_it->m_isFailed) ? 1 : 0;
+    }
+    std::sort(l_latencies.begin(), l_latencies.end());
+    std::cout << "ElemBench clients=" << l_options.m_clients << " count=" << l_options.m_count
+      << " size=" << l_options.m_size << " udp=" << l_options.m_udp << "%"
+      << " type=" << ((true == l_options.m_isRpc) ? "rpc" : "raw") << " shards=" << l_options.m_shards << std::endl;
+    if ((0 != l_options.m_impairment.m_latency)
+      || (0 != l_options.m_impairment.m_jitter)
+      || (0.0 < l_options.m_impairment.m_loss))
+    {
+      std::cout << "  impairment latency=" << l_options.m_impairment.m_latency / 1000 << "ms jitter=" << l_options.m_impairment.m_jitter / 1000
+        << "ms loss=" << l_options.m_impairment.m_loss * 100.0 << "% dropped=" << l_server.getImpairment()->getDrops() << std::endl;
+    }
+    std::cout << "  duration  " << l_duration << " s" << std::endl;
+    std::cout << "  packets/s " << ((0.0 < l_duration) ? l_latencies.size() / l_duration : 0.0) << std::endl;
+    std::cout << "  bytes/s   " << ((0.0 < l_duration) ? l_bytes / l_duration : 0.0) << std::endl;
+    std::cout << "  rtt p50   " << percentile(l_latencies, 0.5) << " us" << std::endl;
+    std::cout << "  rtt p99   " << percentile(l_latencies, 0.99) << " us" << std::endl;
+    std::cout << "  rtt p999  " << percentile(l_latencies, 0.999) << " us" << std::endl;
+    std::cout << "  lost      " << l_lost << ", failed clients " << l_failed << std::endl;
+    if ((0 != l_options.m_trace)
+      && (EERROR_NONE == mEERROR))
+    {
+      std::cout << "  trace     " << ELEMBENCH_TRACE_FILE << std::endl;
+    }
+  }
+  catch (ELib::EException e)
+  {
+    e.printBox();
+  }
+  return (0);
+}
@@ -0,0 +1,549 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ENetwork\ENetSelector.h>
+
+#define ELEMLOAD_TICK       (10)    /**< Milliseconds between two iterations of the event loop. */
+#define ELEMLOAD_TEXT_MAX   (4096)  /**< Length max of login and message of LoadPacketChat. */
+
+/**
+  @brief ENetPacketType of chat messages, same value as CUSTOM_PACKET_TYPE_CHAT of ElemServer.
+*/
+enum                          LoadPacketType
+{
+  LOAD_PACKET_TYPE_CHAT       = ELib::ENETPACKET_TYPE_RESERVED + 1
+};
+
+/**
+  @brief Scripted behaviour of a simulated client.
+*/
+enum                          LoadKind
+{
+  LOAD_KIND_CHAT              = 0,  /**< Send messages at a rate, read everything. */
+  LOAD_KIND_IDLE              = 1,  /**< Stay connected, never send. */
+  LOAD_KIND_SLOW              = 2,  /**< Never send, read at a limited rate so the server sees a slow consumer. */
+  LOAD_KIND_COUNT             = 3
+};
+
+/**
+  @brief Chat message, wire compatible with CustomPacketChat of ElemServer and ElemClient.
+  @details Lengths of login and message, then login and message.
+*/
+class                         LoadPacketChat : public ELib::ENetPacket
+{
+public:
+  LoadPacketChat(ELib::ENetSocket *p_src = nullptr) :
+    ELib::ENetPacket(static_cast<ELib::ENetPacketType>(LOAD_PACKET_TYPE_CHAT), p_src),
+    m_login(),
+    m_message()
+  {
+  }
+
+  void                        recv()
+  {
+    int32                     l_lens[2] = { 0 };
+
+    if (sizeof(l_lens) == m_src->recv(reinterpret_cast<char*>(l_lens), sizeof(l_lens)))
+    {
+      if ((0 <= l_lens[0]) && (ELEMLOAD_TEXT_MAX >= l_lens[0])
+        && (0 <= l_lens[1]) && (ELEMLOAD_TEXT_MAX >= l_lens[1]))
+      {
+        m_login.resize(l_lens[0] + 1);
+        m_message.resize(l_lens[1] + 1);
+        if ((l_lens[0] != m_src->recv(&m_login[0], static_cast<uint16>(l_lens[0])))
+          || (l_lens[1] != m_src->recv(&m_message[0], static_cast<uint16>(l_lens[1]))))
+        {
+          mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+        }
+        m_login.resize(l_lens[0]);
+        m_message.resize(l_lens[1]);
+      }
+      else
+      {
+        mEERROR_S(EERROR_OUT_OF_RANGE);
+      }
+    }
+    else if (EERROR_NONE == mEERROR)
+    {
+      mEERROR_S(EERROR_NET_PACKET_TRUNCATED);
+    }
+  }
+
+  void                        read(const char *p_datas = nullptr, int32 p_len = 0)
+  {
+    mEERROR_S(EERROR_NET_SOCKET_PROTOCOL);
+  }
+
+  void                        send(ELib::ENetSocket *p_dst = nullptr)
+  {
+    std::string               l_datas;
+    int32                     l_lens[2] = { static_cast<int32>(m_login.size()), static_cast<int32>(m_message.size()) };
+
+    l_datas.append(reinterpret_cast<const char*>(l_lens), sizeof(l_lens));
+    l_datas.append(m_login);
+    l_datas.append(m_message);
+    ENetPacket::send(l_datas.data(), static_cast<int32>(l_datas.size()), p_dst);
+  }
+
+  const std::string           &getLogin() const
+  {
+    return (m_login);
+  }
+
+  void                        setLogin(const std::string &p_login)
+  {
+    m_login = p_login.substr(0, ELEMLOAD_TEXT_MAX);
+  }
+
+  const std::string           &getMessage() const
+  {
+    return (m_message);
+  }
+
+  void                        setMessage(const std::string &p_message)
+  {
+    m_message = p_message.substr(0, ELEMLOAD_TEXT_MAX);
+  }
+
+private:
+  std::string                 m_login;    /**< Login of sender. */
+  std::string                 m_message;  /**< Message. */
+};
+
+ELib::ENetPacket              *generatePacketChat(ELib::ENetSocket *p_src)
+{
+  return (new LoadPacketChat(p_src));
+}
+
+/**
+  @brief Group of clients sharing a behaviour.
+*/
+struct                        LoadGroup
+{
+  LoadKind                    m_kind;   /**< Behaviour. */
+  uint32                      m_count;  /**< Number of clients. */
+  double                      m_rate;   /**< Messages sent (chat) or ENetPacket read (slow) per second and per client. */
+};
+
+/**
+  @brief Load script.
+  @details One directive per line, '#' starts a comment:
+    server <hostname> <port>
+    duration <seconds>
+    ramp <connections per second, 0 for a connect storm>
+    seed <seed of jitter>
+    report <CSV file written every second>
+    chat <clients> <messages per second>
+    idle <clients>
+    slow <clients> <ENetPacket read per second>
+*/
+struct                        LoadScript
+{
+  std::string                 m_hostname;
+  uint16                      m_port;
+  uint32                      m_duration;
+  uint32                      m_ramp;
+  uint32                      m_seed;
+  std::string                 m_report;
+  std::vector<LoadGroup>      m_groups;
+};
+
+/**
+  @brief Simulated client.
+*/
+struct                        LoadClient
+{
+  uint32                      m_id;         /**< Index of client, its login is "load<id>". */
+  LoadKind                    m_kind;       /**< Behaviour. */
+  double                      m_rate;       /**< Rate of its LoadGroup. */
+  uint32                      m_group;      /**< Index of its LoadGroup and LoadPool. */
+  ELib::ENetSocket            *m_socket;    /**< Connected ENetSocket, nullptr until connected or after disconnection. */
+  LONGLONG                    m_next;       /**< Performance counter of next message. */
+};
+
+/**
+  @brief Counters of a report line.
+*/
+struct                        LoadCounters
+{
+  uint32                      m_connected;
+  uint64                      m_failed;
+  uint64                      m_disconnected;
+  uint64                      m_sent;
+  uint64                      m_received;
+  uint64                      m_sendErrors;
+};
+
+/**
+  @brief ENetSelectors of a LoadGroup, all storing into the same ENetPacketHandler.
+  @details One per LoadGroup, so each slow group keeps its own ENetRateLimit.
+*/
+struct                        LoadPool
+{
+  ELib::ENetPacketHandler     m_handler;
+  std::vector<ELib::ENetSelector*> m_selectors;
+};
+
+static LARGE_INTEGER          g_frequency = { 0 };
+
+/**
+  @brief Read load script. Missing directives keep their defaults.
+  @param p_path Path of script, empty for defaults only.
+  @param p_script Filled script.
+  @return false if file cannot be read or a line is invalid.
+*/
+static bool                   parseScript(const std::string &p_path, LoadScript &p_script)
+{
+  std::ifstream               l_file;
+  std::string                 l_line;
+  uint32                      l_number = 0;
+  bool                        l_ret = true;
+
+  p_script = { "127.0.0.1", 2222, 30, 100, 1, "", {} };
+  if (false == p_path.empty())
+  {
+    l_file.open(p_path);
+    l_ret = l_file.is_open();
+  }
+  while ((true == l_ret)
+    && (true == l_file.is_open())
+    && (std::getline(l_file, l_line)))
+  {
+    std::istringstream        l_stream(l_line.substr(0, l_line.find('#')));
+    std::string               l_directive;
+    LoadGroup                 l_group = { LOAD_KIND_CHAT, 0, 0.0 };
+
+    ++l_number;
+    if (l_stream >> l_directive)
+    {
+      if ("server" == l_directive)
+      {
+        l_ret = static_cast<bool>(l_stream >> p_script.m_hostname >> p_script.m_port);
+      }
+      else if ("duration" == l_directive)
+      {
+        l_ret = static_cast<bool>(l_stream >> p_script.m_duration);
+      }
+      else if ("ramp" == l_directive)
+      {
+        l_ret = static_cast<bool>(l_stream >> p_script.m_ramp);
+      }
+      else if ("seed" == l_directive)
+      {
+        l_ret = static_cast<bool>(l_stream >> p_script.m_seed);
+      }
+      else if ("report" == l_directive)
+      {
+        l_ret = static_cast<bool>(l_stream >> p_script.m_report);
+      }
+      else if ("chat" == l_directive)
+      {
+        l_group.m_kind = LOAD_KIND_CHAT;
+        l_ret = static_cast<bool>(l_stream >> l_group.m_count >> l_group.m_rate);
+        p_script.m_groups.push_back(l_group);
+      }
+      else if ("idle" == l_directive)
+      {
+        l_group.m_kind = LOAD_KIND_IDLE;
+        l_ret = static_cast<bool>(l_stream >> l_group.m_count);
+        p_script.m_groups.push_back(l_group);
+      }
+      else if ("slow" == l_directive)
+      {
+        l_group.m_kind = LOAD_KIND_SLOW;
+        l_ret = static_cast<bool>(l_stream >> l_group.m_count >> l_group.m_rate);
+        p_script.m_groups.push_back(l_group);
+      }
+      else
+      {
+        l_ret = false;
+      }
+      if (false == l_ret)
+      {
+        std::cerr << p_path << ":" << l_number << ": invalid directive \"" << l_line << "\"" << std::endl;
+      }
+    }
+  }
+  if (true == p_script.m_groups.empty())
+  {
+    p_script.m_groups.push_back({ LOAD_KIND_CHAT, 100, 1.0 });
+  }
+
+  return (l_ret);
+}
+
+/**
+  @brief Connect a client and hand it to an ENetSelector of its pool.
+  @details A new ENetSelector is started every ENETSOCKET_MAX_CLIENTS clients, as ENetServer does.
+  @param p_client Client to be connected.
+  @param p_script Load script.
+  @param p_pool Pool of behaviour of client.
+  @return true if client is connected.
+*/
+static bool                   connectClient(LoadClient &p_client, const LoadScript &p_script, LoadPool &p_pool)
+{
+  ELib::ENetSocket            *l_socket = new ELib::ENetSocket();
+  ELib::ENetSelector          *l_selector = nullptr;
+
+  l_socket->socket(ELib::ENETSOCKET_FLAGS_PROTOCOL_TCP);
+  if (EERROR_NONE == mEERROR)
+  {
+    l_socket->connect(p_script.m_hostname, p_script.m_port);
+  }
+  if (EERROR_NONE == mEERROR)
+  {
+    for (std::vector<ELib::ENetSelector*>::iterator l_it = p_pool.m_selectors.begin(); l_it != p_pool.m_selectors.end(); ++l_it)
+    {
+      if (((*l_it)->getSize() < ENETSOCKET_MAX_CLIENTS)
+        && (true == (*l_it)->isRunning()))
+      {
+        l_selector = *l_it;
+      }
+    }
+    if (nullptr == l_selector)
+    {
+      l_selector = new ELib::ENetSelector(&p_pool.m_handler);
+      p_pool.m_selectors.push_back(l_selector);
+    }
+    if (true == l_selector->addClient(l_socket))
+    {
+      p_client.m_socket = l_socket;
+      if (false == l_selector->isRunning())
+      {
+        l_selector->start();
+      }
+    }
+  }
+  if (nullptr == p_client.m_socket)
+  {
+    delete (l_socket);
+  }
+
+  return (nullptr != p_client.m_socket);
+}
+
+/**
+  @brief Pop received ENetPacket of a pool.
+  @details Own messages of a client give its round trip latency through the server broadcast,
+    measured at reception by ENetSelector, so time spent in the queue and the event loop is not counted.
+  @param p_pool Pool of a LoadGroup.
+  @param p_owners Client of each ENetSocket.
+  @param p_clients Clients.
+  @param p_max Maximum of ENetPacket popped.
+  @param p_counters Counters of report.
+  @param p_latencies Round trip latencies in milliseconds.
+*/
+static void                   drain(LoadPool &p_pool, std::unordered_map<const ELib::ENetSocket*, uint32> &p_owners,
+                                std::vector<LoadClient> &p_clients, uint64 p_max, LoadCounters &p_counters,
+                                std::vector<double> &p_latencies)
+{
+  ELib::ENetPacket            *l_packet = nullptr;
+
+  for (uint64 l_count = 0; (l_count < p_max) && (nullptr != (l_packet = p_pool.m_handler.popPacket())); ++l_count)
+  {
+    std::unordered_map<const ELib::ENetSocket*, uint32>::iterator l_owner = p_owners.find(l_packet->getSource());
+
+    if ((LOAD_PACKET_TYPE_CHAT == l_packet->getType())
+      && (p_owners.end() != l_owner))
+    {
+      LoadPacketChat          *l_chat = static_cast<LoadPacketChat*>(l_packet);
+
+      ++p_counters.m_received;
+      if ("load" + std::to_string(l_owner->second) == l_chat->getLogin())
+      {
+        p_latencies.push_back(static_cast<double>(l_chat->getReceived() - std::stoll(l_chat->getMessage()))
+          * 1000.0 / static_cast<double>(g_frequency.QuadPart));
+      }
+    }
+    else if ((ELib::ENETPACKET_TYPE_DISCONNECT == l_packet->getType())
+      && (p_owners.end() != l_owner))
+    {
+      p_clients[l_owner->second].m_socket = nullptr;
+      p_owners.erase(l_owner);
+      ++p_counters.m_disconnected;
+      --p_counters.m_connected;
+    }
+    delete (l_packet);
+  }
+}
+
+/**
+  @brief Percentile of sorted latencies.
+  @param p_latencies Sorted latencies.
+  @param p_ratio Percentile, between 0 and 1.
+  @return Latency at percentile, 0 if empty.
+*/
+static double                 percentile(const std::vector<double> &p_latencies, double p_ratio)
+{
+  double                      l_value = 0.0;
+
+  if (false == p_latencies.empty())
+  {
+    l_value = p_latencies[static_cast<size_t>(p_ratio * (p_latencies.size() - 1))];
+  }
+
+  return (l_value);
+}
+
+/**
+  @brief Headless load generator for ElemServer. Usage: ElemLoad [script].
+  @details Clients connect at the ramp-up rate, then follow the behaviour of their group on one event loop.
+    ENetSelectors receive for all clients, every ENETSOCKET_MAX_CLIENTS clients, messages are posted into ENetSendQueues.
+  @details Each group has its own LoadPool, slow clients are read through an ENetPacketHandler whose ENetRateLimit defers their ENetSelector.
+  @details Jitter of message times is drawn from the seed of script, so a run can be reproduced.
+*/
+int                           main(int argc, char **argv)
+{
+  LoadScript                  l_script;
+  std::vector<LoadPool*>      l_pools;
+  std::vector<LoadClient>     l_clients;
+  std::unordered_map<const ELib::ENetSocket*, uint32> l_owners;
+  std::vector<double>         l_latencies;
+  std::mt19937                l_random;
+  std::ofstream               l_report;
+  LoadCounters                l_counters = { 0 };
+  LARGE_INTEGER               l_start = { 0 };
+  LARGE_INTEGER               l_now = { 0 };
+  uint32                      l_nextClient = 0;
+  uint32                      l_second = 0;
+
+  if (false == parseScript((1 < argc) ? argv[1] : "", l_script))
+  {
+    return (1);
+  }
+  QueryPerformanceFrequency(&g_frequency);
+  l_random.seed(l_script.m_seed);
+  for (std::vector<LoadGroup>::const_iterator l_group = l_script.m_groups.begin(); l_group != l_script.m_groups.end(); ++l_group)
+  {
+    LoadPool                  *l_pool = new LoadPool();
+
+    l_pool->m_handler.setGenerator(static_cast<ELib::ENetPacketType>(LOAD_PACKET_TYPE_CHAT), generatePacketChat);
+    if (LOAD_KIND_SLOW == l_group->m_kind)
+    {
+      l_pool->m_handler.getRateLimit()->setConnectionLimit(static_cast<uint32>(max(1.0, l_group->m_rate)), 1);
+    }
+    for (uint32 l_i = 0; l_i < l_group->m_count; ++l_i)
+    {
+      LoadClient              l_client = { static_cast<uint32>(l_clients.size()), l_group->m_kind, l_group->m_rate,
+                                            static_cast<uint32>(l_pools.size()), nullptr, 0 };
+
+      l_clients.push_back(l_client);
+    }
+    l_pools.push_back(l_pool);
+  }
+  std::shuffle(l_clients.begin(), l_clients.end(), l_random);
+  for (uint32 l_i = 0; l_i < l_clients.size(); ++l_i)
+  {
+    l_clients[l_i].m_id = l_i;
+  }
+  if (false == l_script.m_report.empty())
+  {
+    l_report.open(l_script.m_report);
+    l_report << "second,connected,failed,disconnected,sent,received,send_errors" << std::endl;
+  }
+
+  QueryPerformanceCounter(&l_start);
+  l_now = l_start;
+  while (l_now.QuadPart - l_start.QuadPart < static_cast<LONGLONG>(l_script.m_duration) * g_frequency.QuadPart)
+  {
+    LONGLONG                  l_elapsed = l_now.QuadPart - l_start.QuadPart;
+    uint64                    l_target = l_clients.size();
+
+    if (0 != l_script.m_ramp)
+    {
+      l_target = min(l_target, static_cast<uint64>(l_elapsed * l_script.m_ramp / g_frequency.QuadPart) + 1);
+    }
+    for (; l_nextClient < l_target; ++l_nextClient)
+    {
+      LoadClient              &l_client = l_clients[l_nextClient];
+
+      if (true == connectClient(l_client, l_script, *l_pools[l_client.m_group]))
+      {
+        std::uniform_real_distribution<double> l_phase(0.0, 1.0);
+
+        l_owners[l_client.m_socket] = l_client.m_id;
+        l_client.m_next = l_now.QuadPart + static_cast<LONGLONG>(l_phase(l_random) * g_frequency.QuadPart / max(l_client.m_rate, 0.001));
+        ++l_counters.m_connected;
+      }
+      else
+      {
+        ++l_counters.m_failed;
+      }
+    }
+
+    QueryPerformanceCounter(&l_now);
+    for (std::vector<LoadClient>::iterator l_client = l_clients.begin(); l_client != l_clients.end(); ++l_client)
+    {
+      if ((LOAD_KIND_CHAT == l_client->m_kind)
+        && (nullptr != l_client->m_socket)
+        && (0.0 < l_client->m_rate)
+        && (l_now.QuadPart >= l_client->m_next))
+      {
+        LoadPacketChat        l_packet(l_client->m_socket);
+        std::exponential_distribution<double> l_interval(l_client->m_rate);
+
+        l_packet.setLogin("load" + std::to_string(l_client->m_id));
+        l_packet.setMessage(std::to_string(l_now.QuadPart));
+        l_packet.post();
+        if (EERROR_NONE == mEERROR)
+        {
+          ++l_counters.m_sent;
+        }
+        else
+        {
+          ++l_counters.m_sendErrors;
+        }
+        l_client->m_next = l_now.QuadPart + static_cast<LONGLONG>(l_interval(l_random) * g_frequency.QuadPart);
+      }
+    }
+
+    for (std::vector<LoadPool*>::iterator l_pool = l_pools.begin(); l_pool != l_pools.end(); ++l_pool)
+    {
+      drain(**l_pool, l_owners, l_clients, UINT64_MAX, l_counters, l_latencies);
+    }
+
+    if ((l_now.QuadPart - l_start.QuadPart) / g_frequency.QuadPart > l_second)
+    {
+      ++l_second;
+      std::cout << "[" << l_second << "s] connected " << l_counters.m_connected << ", failed " << l_counters.m_failed
+        << ", disconnected " << l_counters.m_disconnected << ", sent " << l_counters.m_sent
+        << ", received " << l_counters.m_received << ", send errors " << l_counters.m_sendErrors << std::endl;
+      if (true == l_report.is_open())
+      {
+        l_report << l_second << "," << l_counters.m_connected << "," << l_counters.m_failed << "," << l_counters.m_disconnected
+          << "," << l_counters.m_sent << "," << l_counters.m_received << "," << l_counters.m_sendErrors << std::endl;
+      }
+    }
+    Sleep(ELEMLOAD_TICK);
+    QueryPerformanceCounter(&l_now);
+  }
+
+  for (std::vector<LoadPool*>::iterator l_pool = l_pools.begin(); l_pool != l_pools.end(); ++l_pool)
+  {
+    for (std::vector<ELib::ENetSelector*>::iterator l_it = (*l_pool)->m_selectors.begin(); l_it != (*l_pool)->m_selectors.end(); ++l_it)
+    {
+      if (true == (*l_it)->isRunning())
+      {
+        (*l_it)->stop();
+      }
+      delete (*l_it);
+    }
+    delete (*l_pool);
+  }
+  std::sort(l_latencies.begin(), l_latencies.end());
+  std::cout << "ElemLoad " << l_script.m_hostname << ":" << l_script.m_port << ", " << l_clients.size() << " clients, "
+    << l_script.m_duration << "s, ramp " << l_script.m_ramp << "/s, seed " << l_script.m_seed << std::endl;
+  std::cout << "  connected " << l_counters.m_connected << ", failed " << l_counters.m_failed
+    << ", disconnected " << l_counters.m_disconnected << std::endl;
+  std::cout << "  sent " << l_counters.m_sent << ", received " << l_counters.m_received
+    << ", send errors " << l_counters.m_sendErrors << std::endl;
+  std::cout << "  broadcast latency p50 " << percentile(l_latencies, 0.5) << " ms, p99 " << percentile(l_latencies, 0.99)
+    << " ms, p999 " << percentile(l_latencies, 0.999) << " ms" << std::endl;
+
+  return (0);
+}
@@ -0,0 +1,277 @@
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <ENetwork\ENetPacketHandler.h>
+
+#define ELEMMICRO_WARMUP  (1000)  /**< Iterations run before measure of each stage. */
+
+/**
+  @brief ENetPacketType of MicroPacketNop.
+*/
+enum                          MicroPacketType
+{
+  MICRO_PACKET_TYPE_NOP       = ELib::ENETPACKET_TYPE_RESERVED + 1
+};
+
+static uint64                 g_allocations = 0;
+static LARGE_INTEGER          g_frequency = { 0 };
+
+/**
+  @brief Count allocations of a stage.
+*/
+void                          *operator new(size_t p_size)
+{
+  void                        *l_ptr = malloc((0 != p_size) ? p_size : 1);
+
+  if (nullptr == l_ptr)
+  {
+    throw (std::bad_alloc());
+  }
+  ++g_allocations;
+
+  return (l_ptr);
+}
+
+void                          operator delete(void *p_ptr) noexcept
+{
+  free(p_ptr);
+}
+
+/**
+  @brief In-memory connection, so stages measure ELib on a real ENetSocket without kernel round trip.
+  @details m_client sends into m_stream, m_server receives from it.
+  @details Cost of ENetSocket on the stream is measured alone by stageStream, to be subtracted from other stages.
+*/
+class                         MicroLink
+{
+public:
+  MicroLink() :
+    m_stream(),
+    m_client(),
+    m_server()
+  {
+  }
+
+  /**
+    @brief Connect m_client to m_server through m_stream.
+  */
+  void                        open()
+  {
+    m_client.setMemory(&m_stream);
+    m_server.setMemory(&m_stream);
+  }
+
+  /**
+    @brief Receive and discard bytes sent by m_client, so the stream never grows.
+    @param p_len Bytes to be received.
+  */
+  void                        drain(int32 p_len)
+  {
+    char                      l_datas[ENETSOCKET_UDP_MAX];
+    int32                     l_len = 0;
+
+    while ((0 < p_len)
+      && (0 < (l_len = m_server.recv(l_datas, static_cast<uint16>(min(p_len, static_cast<int32>(ENETSOCKET_UDP_MAX)))))))
+    {
+      p_len -= l_len;
+    }
+  }
+
+  std::string                 m_stream;   /**< Bytes sent by m_client and not received yet by m_server. */
+  ELib::ENetSocket            m_client;   /**< Sending side. */
+  ELib::ENetSocket            m_server;   /**< Receiving side. */
+};
+
+/**
+  @brief ENetPacket without payload, so dispatch is measured alone.
+*/
+class                         MicroPacketNop : public ELib::ENetPacket
+{
+public:
+  MicroPacketNop(ELib::ENetSocket *p_src = nullptr) :
+    ELib::ENetPacket(static_cast<ELib::ENetPacketType>(MICRO_PACKET_TYPE_NOP), p_src)
+  {
+  }
+
+  void                        recv()
+  {
+  }
+
+  void                        read(const char *p_datas = nullptr, int32 p_len = 0)
+  {
+  }
+
+  void                        send(ELib::ENetSocket *p_dst = nullptr)
+  {
+    ENetPacket::send("", 0, p_dst);
+  }
+};
+
+ELib::ENetPacket              *generatePacketNop(ELib::ENetSocket *p_src)
+{
+  return (new MicroPacketNop(p_src));
+}
+
+/**
+  @brief State shared by stages.
+*/
+struct                        MicroContext
+{
+  ELib::ENetPacketHandler     m_handler;    /**< Private ENetPacketHandler, with generator of MicroPacketNop. */
+  MicroLink                   m_link;       /**< Source and destination of every stage. */
+  ELib::ENetSendQueue         m_queue;      /**< ENetSendQueue flushed into client of m_link. */
+  ELib::ENetPacketRawDatas    *m_raw;       /**< ENetPacketRawDatas sent by stageRawSend. */
+  std::string                 m_nop;        /**< Datagram of MicroPacketNop. */
+  std::string                 m_payload;    /**< Length and datas of ENetPacketRawDatas, without its ENetPacketType. */
+  std::string                 m_frame;      /**< Whole frame of ENetPacketRawDatas. */
+};
+
+typedef void                  (*MicroStage)(MicroContext &p_context);
+
+/**
+  @brief Stream cost of a frame: send() on client of the MicroLink, then recv() on server.
+*/
+static void                   stageStream(MicroContext &p_context)
+{
+  p_context.m_link.m_client.send(p_context.m_frame.data(), static_cast<uint16>(p_context.m_frame.size()));
+  p_context.m_link.drain(static_cast<int32>(p_context.m_frame.size()));
+}
+
+/**
+  @brief Generator lookup, allocation and channel queue of ENetPacketHandler::read(), then popPacket().
+*/
+static void                   stageDispatch(MicroContext &p_context)
+{
+  p_context.m_handler.read(&p_context.m_nop[0], static_cast<int32>(p_context.m_nop.size()), &p_context.m_link.m_server);
+  delete (p_context.m_handler.popPacket());
+}
+
+/**
+  @brief Decode of ENetPacketRawDatas::read().
+*/
+static void                   stageRawRead(MicroContext &p_context)
+{
+  ELib::ENetPacketRawDatas    l_packet(&p_context.m_link.m_server);
+
+  l_packet.read(p_context.m_payload.data(), static_cast<int32>(p_context.m_payload.size()));
+}
+
+/**
+  @brief Encode of ENetPacketRawDatas::send(), written directly to the MicroLink. Includes stageStream.
+*/
+static void                   stageRawSend(MicroContext &p_context)
+{
+  p_context.m_raw->send();
+  p_context.m_link.drain(static_cast<int32>(p_context.m_frame.size()));
+}
+
+/**
+  @brief Whole connected receive path: ENetPacketHandler::recvPacket() of ENetPacketRawDatas, then popPacket(). Includes stageStream.
+*/
+static void                   stageRecvPacket(MicroContext &p_context)
+{
+  p_context.m_link.m_client.send(p_context.m_frame.data(), static_cast<uint16>(p_context.m_frame.size()));
+  p_context.m_handler.recvPacket(&p_context.m_link.m_server);
+  delete (p_context.m_handler.popPacket());
+}
+
+/**
+  @brief ENetSendQueue::push() of a frame, then flush() to the MicroLink. Includes stageStream.
+*/
+static void                   stageSendQueue(MicroContext &p_context)
+{
+  ELib::ENetChannel           l_channel = { ENETCHANNEL_DEFAULT, 1, ENETSENDQUEUE_FLUSH_MAX / 4 };
+
+  p_context.m_queue.push(&p_context.m_link.m_client, p_context.m_frame.data(), static_cast<int32>(p_context.m_frame.size()),
+    ELib::ENETPACKET_TYPE_RAW_DATAS, l_channel);
+  p_context.m_queue.flush(&p_context.m_link.m_client);
+  p_context.m_link.drain(static_cast<int32>(p_context.m_frame.size()));
+}
+
+/**
+  @brief Run a stage and print its cost.
+  @param p_name Name of stage.
+  @param p_stage Stage.
+  @param p_context State shared by stages.
+  @param p_iterations Iterations measured.
+*/
+static void                   run(const std::string &p_name, MicroStage p_stage, MicroContext &p_context, uint32 p_iterations)
+{
+  LARGE_INTEGER               l_start = { 0 };
+  LARGE_INTEGER               l_end = { 0 };
+  uint64                      l_allocations = 0;
+  uint32                      l_errors = 0;
+
+  for (uint32 l_i = 0; l_i < ELEMMICRO_WARMUP; ++l_i)
+  {
+    p_stage(p_context);
+  }
+  l_allocations = g_allocations;
+  QueryPerformanceCounter(&l_start);
+  for (uint32 l_i = 0; l_i < p_iterations; ++l_i)
+  {
+    p_stage(p_context);
+    if (EERROR_NONE != mEERROR)
+    {
+      ++l_errors;
+    }
+  }
+  QueryPerformanceCounter(&l_end);
+  l_allocations = g_allocations - l_allocations;
+
+  std::cout << "  " << p_name << std::string((16 > p_name.size()) ? 16 - p_name.size() : 1, ' ')
+    << static_cast<double>(l_end.QuadPart - l_start.QuadPart) * 1000000000.0 / static_cast<double>(g_frequency.QuadPart) / p_iterations
+    << " ns/op, " << static_cast<double>(l_allocations) / p_iterations << " allocs/op";
+  if (0 != l_errors)
+  {
+    std::cout << ", " << l_errors << " errors";
+  }
+  std::cout << std::endl;
+}
+
+/**
+  @brief Microbenchmarks of packet hot path. Usage: ElemMicro [iterations] [size].
+  @details Each stage runs in isolation on an in-memory MicroLink, no remote peer nor kernel call is needed.
+    Stages crossing the MicroLink include the stream cost measured by stageStream.
+  @details Stages run on one thread: mutexes are taken but never contended.
+*/
+int                           main(int argc, char **argv)
+{
+  MicroContext                *l_context = nullptr;
+  uint32                      l_iterations = (1 < argc) ? static_cast<uint32>(strtoul(argv[1], nullptr, 10)) : 1000000;
+  int32                       l_size = (2 < argc) ? static_cast<int32>(strtol(argv[2], nullptr, 10)) : 64;
+  ELib::ENetPacketType        l_type = ELib::ENETPACKET_TYPE_RAW_DATAS;
+  char                        *l_datas = nullptr;
+
+  l_context = new MicroContext();
+  l_context->m_link.open();
+  QueryPerformanceFrequency(&g_frequency);
+  l_iterations = max(l_iterations, static_cast<uint32>(1));
+  l_size = min(max(l_size, 0), ENETPACKETRAWDATAS_MAX);
+
+  l_type = static_cast<ELib::ENetPacketType>(MICRO_PACKET_TYPE_NOP);
+  l_context->m_nop.assign(reinterpret_cast<const char*>(&l_type), sizeof(ELib::ENetPacketType));
+  l_context->m_payload.assign(reinterpret_cast<const char*>(&l_size), sizeof(int32));
+  l_context->m_payload.append(l_size, 'E');
+  l_type = ELib::ENETPACKET_TYPE_RAW_DATAS;
+  l_context->m_frame.assign(reinterpret_cast<const char*>(&l_type), sizeof(ELib::ENetPacketType));
+  l_context->m_frame.append(l_context->m_payload);
+  l_context->m_handler.setGenerator(static_cast<ELib::ENetPacketType>(MICRO_PACKET_TYPE_NOP), generatePacketNop);
+  l_datas = new char[(0 < l_size) ? l_size : 1]();
+  l_context->m_raw = new ELib::ENetPacketRawDatas(&l_context->m_link.m_client);
+  l_context->m_raw->setDatas(l_datas, l_size);
+
+  std::cout << "ElemMicro " << l_iterations << " iterations, " << l_size << " bytes payload" << std::endl;
+  run("stream", stageStream, *l_context, l_iterations);
+  run("dispatch", stageDispatch, *l_context, l_iterations);
+  run("rawdatas read", stageRawRead, *l_context, l_iterations);
+  run("rawdatas send", stageRawSend, *l_context, l_iterations);
+  run("recvPacket", stageRecvPacket, *l_context, l_iterations);
+  run("sendqueue", stageSendQueue, *l_context, l_iterations);
+
+  delete (l_context->m_raw);
+  delete (l_context);
+
+  return (0);
+}
@@ -0,0 +1,351 @@
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <ENetwork\ENetCapture.h>
+#include <ENetwork\ENetPacketHandler.h>
+
+#define ELEMREPLAY_DRAIN_SIZE   (4096)  /**< Bytes read at once from a replay connection. */
+#define ELEMREPLAY_DRAIN_EVERY  (64)    /**< Frames sent between two drains of replay connections. */
+
+/**
+  @brief Options of a replay.
+*/
+struct                        ReplayOptions
+{
+  std::string                 m_path;     /**< Capture file. */
+  double                      m_speed;    /**< Speed factor, 0 for max speed. */
+  std::string                 m_hostname; /**< Server address, empty to replay through an ENetPacketHandler. */
+  uint16                      m_port;     /**< Server port. */
+};
+
+/**
+  @brief Counters of a replay.
+*/
+struct                        ReplayCounters
+{
+  uint64                      m_frames;       /**< Frames replayed. */
+  uint64                      m_bytes;        /**< Bytes of frames replayed. */
+  uint64                      m_skipped;      /**< Frames not replayed: unknown ENetPacketType, or failed sending of a datagram. */
+  uint64                      m_connections;  /**< Connections opened to server. */
+  std::map<uint32, uint64>    m_types;        /**< Frames replayed per ENetPacketType. */
+};
+
+static LARGE_INTEGER          g_frequency = { 0 };
+
+/**
+  @brief Elapsed nanoseconds since a performance counter value.
+  @param p_start Performance counter at start.
+  @return Elapsed nanoseconds.
+*/
+static uint64                 elapsed(const LARGE_INTEGER &p_start)
+{
+  LARGE_INTEGER               l_now = { 0 };
+
+  QueryPerformanceCounter(&l_now);
+
+  return (static_cast<uint64>((l_now.QuadPart - p_start.QuadPart) * 1000000000.0 / g_frequency.QuadPart));
+}
+
+/**
+  @brief Wait until a frame is due.
+  @param p_start Performance counter at start of replay.
+  @param p_time Nanoseconds between start of capture and reception of frame.
+  @param p_speed Speed factor, 0 for max speed.
+*/
+static void                   wait(const LARGE_INTEGER &p_start, uint64 p_time, double p_speed)
+{
+  if (0.0 < p_speed)
+  {
+    uint64                    l_due = static_cast<uint64>(p_time / p_speed);
+    uint64                    l_now = elapsed(p_start);
+
+    while (l_now < l_due)
+    {
+      if (2000000 < l_due - l_now)
+      {
+        Sleep(static_cast<DWORD>((l_due - l_now) / 1000000) - 1);
+      }
+      else
+      {
+        SwitchToThread();
+      }
+      l_now = elapsed(p_start);
+    }
+  }
+}
+
+/**
+  @brief Read answers of server on one replay connection, until none is waiting.
+  @param p_socket SOCKET of replay connection, non-blocking.
+*/
+static void                   drain(SOCKET p_socket)
+{
+  char                        l_datas[ELEMREPLAY_DRAIN_SIZE];
+
+  while (0 < ::recv(p_socket, l_datas, ELEMREPLAY_DRAIN_SIZE, 0))
+  {
+  }
+}
+
+/**
+  @brief Read answers of server, so it is never slowed down by the replay.
+  @param p_connections Replay connections, non-blocking.
+*/
+static void                   drain(std::map<uint64, ELib::ENetSocket*> &p_connections)
+{
+  for (std::map<uint64, ELib::ENetSocket*>::iterator l_it = p_connections.begin(); l_it != p_connections.end(); ++l_it)
+  {
+    if (nullptr != l_it->second)
+    {
+      drain(static_cast<SOCKET>(*l_it->second));
+    }
+  }
+}
+
+/**
+  @brief Send a whole frame on a non-blocking replay connection.
+  @details Short writes are continued. On WSAEWOULDBLOCK, wait in select() until the connection is writable,
+    draining answers meanwhile so server never blocks on a full receive buffer of the replay.
+  @param p_socket SOCKET of replay connection, non-blocking.
+  @param p_datas Frame.
+  @param p_len Frame length.
+  @return true if the whole frame is sent.
+  @return false on sending failure: the stream is broken.
+*/
+static bool                   send(SOCKET p_socket, const char *p_datas, int32 p_len)
+{
+  int32                       l_offset = 0;
+  bool                        l_isSent = true;
+
+  while ((true == l_isSent)
+    && (l_offset < p_len))
+  {
+    int                       l_ret = ::send(p_socket, p_datas + l_offset, p_len - l_offset, 0);
+
+    if (0 < l_ret)
+    {
+      l_offset += l_ret;
+    }
+    else if ((SOCKET_ERROR == l_ret)
+      && (WSAEWOULDBLOCK == WSAGetLastError()))
+    {
+      fd_set                  l_readSet = { 0 };
+      fd_set                  l_writeSet = { 0 };
+
+      FD_ZERO(&l_readSet);
+      FD_ZERO(&l_writeSet);
+      FD_SET(p_socket, &l_readSet);
+      FD_SET(p_socket, &l_writeSet);
+      l_isSent = (SOCKET_ERROR != ::select(0, &l_readSet, &l_writeSet, nullptr, nullptr));
+      if ((true == l_isSent)
+        && (0 != FD_ISSET(p_socket, &l_readSet)))
+      {
+        drain(p_socket);
+      }
+    }
+    else
+    {
+      l_isSent = false;
+    }
+  }
+
+  return (l_isSent);
+}
+
+/**
+  @brief Parse options. Usage: ElemReplay file [speed|max] [hostname port].
+  @param p_argc Number of arguments.
+  @param p_argv Arguments.
+  @param p_options Options to be filled.
+  @return false if capture file is missing.
+*/
+static bool                   parseOptions(int p_argc, char **p_argv, ReplayOptions &p_options)
+{
+  p_options = { "", 1.0, "", 0 };
+  if (1 < p_argc)
+  {
+    p_options.m_path = p_argv[1];
+  }
+  if (2 < p_argc)
+  {
+    p_options.m_speed = (std::string("max") == p_argv[2]) ? 0.0 : std::stod(p_argv[2]);
+  }
+  if (4 < p_argc)
+  {
+    p_options.m_hostname = p_argv[3];
+    p_options.m_port = static_cast<uint16>(std::stoul(p_argv[4]));
+  }
+
+  return (false == p_options.m_path.empty());
+}
+
+/**
+  @brief Replay a capture file of ENetCapture.
+  @details Without server, frames are read by an ENetPacketHandler and popped at once, one fake ENetSocket per
+    captured connection: it measures decoding of real traffic. Frames of unknown ENetPacketType are skipped.
+  @details With server, each captured connection is opened on first frame and closed on its ENetPacketDisconnect,
+    frames are sent as captured. Datagrams are sent from a single connectionless ENetSocket.
+  @details Connections are non-blocking, so answers are drained between frames. Each frame is sent whole:
+    a short write would split it and corrupt the rest of its stream.
+  @details Frames are replayed at captured pace divided by speed, or as fast as possible with max.
+*/
+int                           main(int argc, char **argv)
+{
+  ReplayOptions               l_options;
+  ReplayCounters              l_counters = { 0, 0, 0, 0, {} };
+  ELib::ENetPacketHandler     l_handler;
+  std::map<uint64, ELib::ENetSocket*> l_connections;
+  ELib::ENetSocket            l_datagram;
+  ELib::ENetSocket            l_server;
+  ELib::ENetCaptureHeader     l_header = { 0 };
+  ELib::ENetCaptureRecord     l_record = { 0 };
+  std::ifstream               l_file;
+  std::string                 l_frame;
+  LARGE_INTEGER               l_start = { 0 };
+  double                      l_duration = 0.0;
+
+  if (false == parseOptions(argc, argv, l_options))
+  {
+    std::cout << "Usage: ElemReplay file [speed|max] [hostname port]" << std::endl;
+    return (1);
+  }
+  l_file.open(l_options.m_path, std::ios::in | std::ios::binary);
+  l_file.read(reinterpret_cast<char*>(&l_header), sizeof(ELib::ENetCaptureHeader));
+  if ((false == l_file.good())
+    || (ENETCAPTURE_MAGIC != l_header.m_magic)
+    || (ENETCAPTURE_VERSION != l_header.m_version))
+  {
+    std::cout << "ElemReplay: " << l_options.m_path << " is not a capture file." << std::endl;
+    return (1);
+  }
+  if (false == l_options.m_hostname.empty())
+  {
+    l_datagram.socket(ELib::ENETSOCKET_FLAGS_PROTOCOL_UDP);
+    l_server.setAddress(l_options.m_hostname, l_options.m_port);
+  }
+
+  QueryPerformanceFrequency(&g_frequency);
+  QueryPerformanceCounter(&l_start);
+  while (true == l_file.read(reinterpret_cast<char*>(&l_record), sizeof(ELib::ENetCaptureRecord)).good())
+  {
+    ELib::ENetPacketType      l_type = ELib::ENETPACKET_TYPE_DISCONNECT;
+    bool                      l_isReplayed = false;
+
+    l_frame.resize(l_record.m_len);
+    if ((sizeof(ELib::ENetPacketType) > l_record.m_len)
+      || (false == l_file.read(&l_frame[0], l_record.m_len).good()))
+    {
+      break;
+    }
+    memcpy(&l_type, l_frame.data(), sizeof(ELib::ENetPacketType));
+    wait(l_start, l_record.m_time, l_options.m_speed);
+
+    if (true == l_options.m_hostname.empty())
+    {
+      ELib::ENetSocket        *&l_src = l_connections[l_record.m_connection];
+      ELib::ENetPacket        *l_packet = nullptr;
+
+      if (nullptr == l_src)
+      {
+        l_src = new ELib::ENetSocket();
+      }
+      l_handler.read(&l_frame[0], static_cast<int32>(l_frame.size()), l_src);
+      l_isReplayed = (EERROR_NONE == mEERROR);
+      while (nullptr != (l_packet = l_handler.popPacket()))
+      {
+        delete (l_packet);
+      }
+    }
+    else if (ELib::ENETSOCKET_FLAGS_PROTOCOL_UDP == l_record.m_protocol)
+    {
+      if (UINT16_MAX >= l_frame.size())
+      {
+        l_datagram.sendto(l_frame.data(), static_cast<uint16>(l_frame.size()), &l_server);
+        l_isReplayed = (EERROR_NONE == mEERROR);
+      }
+    }
+    else if (ELib::ENETPACKET_TYPE_DISCONNECT == l_type)
+    {
+      std::map<uint64, ELib::ENetSocket*>::iterator l_it = l_connections.find(l_record.m_connection);
+
+      if (l_connections.end() != l_it)
+      {
+        delete (l_it->second);
+        l_connections.erase(l_it);
+        l_isReplayed = true;
+      }
+    }
+    else
+    {
+      ELib::ENetSocket        *&l_connection = l_connections[l_record.m_connection];
+
+      if (nullptr == l_connection)
+      {
+        u_long                l_mode = 1;
+
+        l_connection = new ELib::ENetSocket();
+        l_connection->socket(ELib::ENETSOCKET_FLAGS_PROTOCOL_TCP);
+        if (EERROR_NONE == mEERROR)
+        {
+          l_connection->connect(l_options.m_hostname, l_options.m_port);
+        }
+        if (EERROR_NONE == mEERROR)
+        {
+          ioctlsocket(static_cast<SOCKET>(*l_connection), FIONBIO, &l_mode);
+          ++l_counters.m_connections;
+        }
+        else
+        {
+          std::cout << "ElemReplay: Could not connect to " << l_options.m_hostname << ":" << l_options.m_port << "." << std::endl;
+          return (1);
+        }
+      }
+      if (false == send(static_cast<SOCKET>(*l_connection), l_frame.data(), static_cast<int32>(l_frame.size())))
+      {
+        std::cout << "ElemReplay: Connection to " << l_options.m_hostname << ":" << l_options.m_port << " lost." << std::endl;
+        return (1);
+      }
+      l_isReplayed = true;
+    }
+
+    if (true == l_isReplayed)
+    {
+      ++l_counters.m_frames;
+      l_counters.m_bytes += l_frame.size();
+      ++l_counters.m_types[l_type];
+    }
+    else
+    {
+      ++l_counters.m_skipped;
+    }
+    if ((false == l_options.m_hostname.empty())
+      && (0 == (l_counters.m_frames + l_counters.m_skipped) % ELEMREPLAY_DRAIN_EVERY))
+    {
+      drain(l_connections);
+    }
+  }
+  l_duration = elapsed(l_start) / 1000000000.0;
+
+  while (false == l_connections.empty())
+  {
+    delete (l_connections.begin()->second);
+    l_connections.erase(l_connections.begin());
+  }
+  std::cout << "ElemReplay " << l_options.m_path << " speed=" << ((0.0 < l_options.m_speed) ? std::to_string(l_options.m_speed) : "max")
+    << " target=" << ((true == l_options.m_hostname.empty()) ? "ENetPacketHandler" : l_options.m_hostname + ":" + std::to_string(l_options.m_port)) << std::endl;
+  std::cout << "  duration  " << l_duration << " s" << std::endl;
+  std::cout << "  frames    " << l_counters.m_frames << ", skipped " << l_counters.m_skipped << std::endl;
+  std::cout << "  frames/s  " << ((0.0 < l_duration) ? l_counters.m_frames / l_duration : 0.0) << std::endl;
+  std::cout << "  bytes/s   " << ((0.0 < l_duration) ? l_counters.m_bytes / l_duration : 0.0) << std::endl;
+  if (false == l_options.m_hostname.empty())
+  {
+    std::cout << "  connections " << l_counters.m_connections << std::endl;
+  }
+  for (std::map<uint32, uint64>::const_iterator l_it = l_counters.m_types.begin(); l_it != l_counters.m_types.end(); ++l_it)
+  {
+    std::cout << "  type " << l_it->first << ": " << l_it->second << std::endl;
+  }
+
+  return (0);
+}
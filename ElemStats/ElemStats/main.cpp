@@ -0,0 +1,129 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <ENetwork\ENetSelector.h>
+#include <ENetwork\ENetServer.h>
+
+#define ELEMSTATS_INTERVAL  (1000)  /**< Default milliseconds between two requests. */
+#define ELEMSTATS_TIMEOUT   (5000)  /**< Milliseconds before a request is counted as unanswered. */
+#define ELEMSTATS_IDLE      (10)    /**< Milliseconds slept while waiting for an answer. */
+
+/**
+  @brief Print a snapshot answered by ENetServer::getStats().
+  @param p_datas Datas of ENetPacketStats response.
+  @return false if datas are not a snapshot of this version.
+*/
+static bool                   printStats(const std::string &p_datas)
+{
+  ELib::ENetStatsHeader       l_header = { 0 };
+  std::vector<ELib::ENetStatsGroup> l_groups;
+  ELib::EMetricsSnapshot      *l_snapshot = nullptr;
+
+  if (sizeof(ELib::ENetStatsHeader) > p_datas.size())
+  {
+    return (false);
+  }
+  memcpy(&l_header, p_datas.data(), sizeof(ELib::ENetStatsHeader));
+  if ((ENETSTATS_VERSION != l_header.m_version)
+    || (sizeof(ELib::ENetStatsHeader) + l_header.m_groups * sizeof(ELib::ENetStatsGroup) + sizeof(ELib::EMetricsSnapshot) != p_datas.size()))
+  {
+    return (false);
+  }
+  l_groups.resize(l_header.m_groups);
+  if (0 != l_header.m_groups)
+  {
+    memcpy(l_groups.data(), p_datas.data() + sizeof(ELib::ENetStatsHeader), l_header.m_groups * sizeof(ELib::ENetStatsGroup));
+  }
+  l_snapshot = new ELib::EMetricsSnapshot();
+  memcpy(l_snapshot, p_datas.data() + sizeof(ELib::ENetStatsHeader) + l_header.m_groups * sizeof(ELib::ENetStatsGroup), sizeof(ELib::EMetricsSnapshot));
+
+  std::cout << "uptime " << l_header.m_uptime / 1000 << "s, shards " << l_header.m_shards
+    << ", datagram peers " << l_header.m_peers << std::endl;
+  for (std::vector<ELib::ENetStatsGroup>::const_iterator l_it = l_groups.begin(); l_it != l_groups.end(); ++l_it)
+  {
+    if (ENETSTATS_NO_SHARD == l_it->m_shard)
+    {
+      std::cout << "  selector: " << l_it->m_clients << " clients" << std::endl;
+    }
+    else
+    {
+      std::cout << "  shard " << l_it->m_shard << ": " << l_it->m_clients << " clients" << std::endl;
+    }
+  }
+  std::cout << l_snapshot->toString() << std::endl;
+  delete (l_snapshot);
+
+  return (true);
+}
+
+/**
+  @brief Poll statistics of a running ENetServer.
+  @details Usage: ElemStats hostname port token [interval in milliseconds].
+  @details Answers are read by an ENetSelector into a private ENetPacketHandler keeping ENetPacketStats apart.
+    A refused token is not answered: the request is counted as unanswered after ELEMSTATS_TIMEOUT.
+*/
+int                           main(int argc, char **argv)
+{
+  ELib::ENetPacketHandler     l_handler;
+  ELib::ENetSelector          l_selector(&l_handler);
+  ELib::ENetSocket            *l_socket = new ELib::ENetSocket();
+  std::string                 l_token;
+  DWORD                       l_interval = ELEMSTATS_INTERVAL;
+
+  if (4 > argc)
+  {
+    std::cout << "Usage: ElemStats hostname port token [interval]" << std::endl;
+    return (1);
+  }
+  l_token = argv[3];
+  if (4 < argc)
+  {
+    l_interval = static_cast<DWORD>(std::stoul(argv[4]));
+  }
+  l_handler.setAdmin(true);
+  l_socket->socket(ELib::ENETSOCKET_FLAGS_PROTOCOL_TCP);
+  if (EERROR_NONE == mEERROR)
+  {
+    l_socket->connect(argv[1], static_cast<uint16>(std::stoul(argv[2])));
+  }
+  if ((EERROR_NONE != mEERROR)
+    || (false == l_selector.addClient(l_socket)))
+  {
+    std::cout << "ElemStats: Could not connect to " << argv[1] << ":" << argv[2] << "." << std::endl;
+    return (1);
+  }
+  l_selector.start();
+
+  while (true == l_selector.isRunning())
+  {
+    ELib::ENetPacketStats     l_request(l_socket);
+    ELib::ENetPacket          *l_response = nullptr;
+    ULONGLONG                 l_start = GetTickCount64();
+
+    l_request.setDatas(l_token);
+    l_request.send();
+    while ((nullptr == (l_response = l_handler.popAdmin()))
+      && (true == l_selector.isRunning())
+      && (GetTickCount64() - l_start < ELEMSTATS_TIMEOUT))
+    {
+      Sleep(ELEMSTATS_IDLE);
+    }
+    if (nullptr != l_response)
+    {
+      if (false == printStats(static_cast<ELib::ENetPacketStats*>(l_response)->getDatas()))
+      {
+        std::cout << "ElemStats: Unknown snapshot version." << std::endl;
+      }
+      delete (l_response);
+      Sleep(l_interval);
+    }
+    else if (true == l_selector.isRunning())
+    {
+      std::cout << "ElemStats: Request unanswered, check token." << std::endl;
+    }
+  }
+  std::cout << "ElemStats: Connection closed." << std::endl;
+
+  return (0);
+}